@@ -59,6 +59,15 @@ module core_video_mig_interface_top_tb();
     logic [127:0] core_motion_wrdata;
     logic [127:0] core_motion_rddata;
     
+    // dma core; not exercised here;
+    logic core_dma_wr_request = 1'b0;
+    logic core_dma_rd_request = 1'b0;
+    logic [22:0] core_dma_addr = 0;
+    logic [127:0] core_dma_wrdata = 0;
+    logic [127:0] core_dma_rddata;
+    logic core_dma_MIG_ready;
+    logic core_dma_MIG_transaction_complete;
+    
     // MIG DDR2 status 
     logic core_MIG_init_complete;   // MIG DDR2 initialization complete
     logic core_MIG_ready;           // MIG DDR2 ready to accept any request
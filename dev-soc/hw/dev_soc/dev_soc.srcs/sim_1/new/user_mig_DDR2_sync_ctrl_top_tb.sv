@@ -36,10 +36,13 @@ module user_mig_DDR2_sync_ctrl_top_tb();
     // user signals for the uut;
     logic user_wr_strobe;             // write request;
     logic user_rd_strobe;             // read request;
+    logic user_wr_request = 1'b0;     // one-shot write request; not used here;
+    logic user_rd_request = 1'b0;     // one-shot read request; not used here;
     logic [22:0] user_addr;           // address;
     
     // data;
     logic [127:0] user_wr_data;       
+    logic [15:0] user_wr_mask = 16'h0000;   // byte mask; all bytes written here;
     logic [127:0] user_rd_data;   
     
     // status
@@ -69,6 +69,17 @@ module user_mig_HW_test_sequential_top_tb();
     
     logic [3:0] debug_ctrl_FSM;
     
+    // bench mode; not used here; the LED demo runs;
+    logic bench_mode = 1'b0;
+    logic bench_start = 1'b0;
+    logic [4:0] bench_op = 5'b0;
+    logic [22:0] bench_addr = 23'b0;
+    logic [23:0] bench_len = 24'b0;
+    logic bench_busy;
+    logic bench_done;
+    logic [15:0] bench_err_cnt;
+    logic bench_wr_request;
+    logic bench_rd_request;
      
     // uut signal mapping;
     assign clk_sys_100M = clkout_100M;
@@ -81,6 +92,9 @@ module user_mig_HW_test_sequential_top_tb();
     logic rst_sys;
     //logic user_wr_strobe;
     //logic user_rd_strobe;
+    logic user_wr_request = 1'b0;   // one-shot requests; not used by the hw test;
+    logic user_rd_request = 1'b0;
+    logic [15:0] user_wr_mask = 16'h0000;   // byte mask; the hw test writes all bytes;
     //logic [22:0] user_addr;
     //logic [127:0] user_wr_data;   
     //logic [127:0] user_rd_data;         
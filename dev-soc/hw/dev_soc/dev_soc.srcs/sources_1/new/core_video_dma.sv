@@ -0,0 +1,540 @@
+`timescale 1ns / 1ps
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date: 17.10.2026 10:12:31
+// Design Name:
+// Module Name: core_video_dma
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description:
+//
+// Dependencies:
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`ifndef CORE_VIDEO_DMA_SV
+`define CORE_VIDEO_DMA_SV
+
+`include "IO_map.svh"
+
+/*****************************************************************
+V6_DMA
+-----------------
+Purpose: to move DDR2 lines (128-bit) without the cpu;
+1. DDR2 to DDR2;
+2. DDR2 to the LCD stream fifo;
+3. DCMI (camera fifo) to DDR2;
+
+Construction:
+1. a chain of descriptors is run in order; up to 8 descriptors;
+2. a descriptor moves a block of lines: rows x lines per row;
+    each row starts a stride away from the previous row;
+3. a descriptor is written through the window of Register 4-7;
+    Register 3 selects the descriptor; writing Register 7 moves to the next one;
+4. the DDR2 is reached through V5_MIG_INTERFACE with its select set to the dma;
+    one line in flight at a time;
+    the dma waits (busy) until the mig is handed over;
+5. DDR2 to LCD: a line is streamed byte by byte from bit[7:0] onwards;
+    V2_DISP_SRC_MUX must select the dma and the lcd must be in the stream mode;
+6. DCMI to DDR2: 16 bytes make a line; the first byte goes to bit[7:0];
+    the pixel converter is cut off from the dcmi fifo while such a descriptor runs;
+7. the done counter counts the descriptors completed;
+
+Register Map
+1. Register 0 (Offset 0): control register;
+2. Register 1 (Offset 1): status register;
+3. Register 2 (Offset 2): chain length;
+4. Register 3 (Offset 3): descriptor select;
+5. Register 4 (Offset 4): descriptor source address;
+6. Register 5 (Offset 5): descriptor destination address;
+7. Register 6 (Offset 6): descriptor size and kind;
+8. Register 7 (Offset 7): descriptor strides;
+
+Register Definition:
+1. Register 0 (Offset 0): control register;
+        bit[0]: start the chain from descriptor 0; ignored when busy;
+        bit[1]: abort the chain; after the line in flight, if any;
+            at once while waiting for the mig (no request in flight),
+            for the dcmi or for the lcd; the line being collected or streamed is dropped;
+        both are one-shot; no clear is needed;
+
+2. Register 1 (Offset 1): status register;
+        bit[0]: busy; active high;
+        bit[1]: error; the chain stopped at a descriptor of the reserved kind; cleared by a start;
+        bit[2]: aborted; the chain stopped on an abort; cleared by a start;
+        bit[6:4]: descriptor being run;
+        bit[15:8]: descriptors completed; wraps around; never cleared;
+        bit[31:16]: lines moved since the start; wraps around;
+
+3. Register 2 (Offset 2): chain length;
+        bit[3:0]: number of descriptors to run; 1 to 8; 0 runs none;
+
+4. Register 3 (Offset 3): descriptor select;
+        bit[2:0]: descriptor written through Register 4-7;
+
+5. Register 4 (Offset 4): bit[22:0]: source line address; (DDR2 sources only);
+6. Register 5 (Offset 5): bit[22:0]: destination line address; (DDR2 destinations only);
+7. Register 6 (Offset 6): size and kind;
+        bit[15:0]: lines per row; 0 is taken as 1;
+        bit[27:16]: rows; 0 is taken as 1;
+        bit[29:28]: kind;
+            2'b00: DDR2 to DDR2;
+            2'b01: DDR2 to LCD;
+            2'b10: DCMI to DDR2;
+            2'b11: reserved; error;
+8. Register 7 (Offset 7): strides;
+        bit[15:0]: source row stride in lines;
+        bit[31:16]: destination row stride in lines;
+        writing it moves the descriptor select to the next descriptor;
+
+Register IO:
+1. Register 0: write only;
+2. Register 1: read only;
+3. Register 2: read and write;
+4. Register 3: read and write;
+5. Register 4-7: write only;
+
+*****************************************************************/
+
+module core_video_dma
+    (
+        // general;
+        input logic clk,    // 100MHz system;
+        input logic reset,  // async;
+
+        //> given interface with video controller (which interfaces with the bus);
+        // note that not all interfacce will be used;
+        input logic cs,
+        input logic write,
+        input logic read,
+        input logic [`VIDEO_REG_ADDR_BIT_SIZE_G-1:0] addr,
+        input logic [`REG_DATA_WIDTH_G-1:0]  wr_data,
+        output logic [`REG_DATA_WIDTH_G-1:0]  rd_data,
+
+        /* --------------------------------------------------------------------------
+        * with the MIG interface core (select: dma);
+        ---------------------------------------------------------------------------*/
+        output logic mig_wr_request,        // one-shot write request;
+        output logic mig_rd_request,        // one-shot read request;
+        output logic [22:0] mig_addr,       // held while the request is in flight;
+        output logic [127:0] mig_wrdata,
+        input logic [127:0] mig_rddata,
+        input logic mig_ready,              // LOW unless the mig is handed over to the dma;
+        input logic mig_transaction_complete,   // a pulse;
+
+        /* --------------------------------------------------------------------------
+        * to the lcd fifo through the src mux;
+        ---------------------------------------------------------------------------*/
+        output logic [7:0] lcd_data,
+        output logic lcd_valid,
+        input logic lcd_ready,
+
+        /* --------------------------------------------------------------------------
+        * from the dcmi fifo;
+        ---------------------------------------------------------------------------*/
+        input logic [7:0] dcmi_data,
+        input logic dcmi_valid,
+        output logic dcmi_ready,
+        output logic dcmi_active    // a dcmi descriptor is being run; the dcmi fifo is for the dma;
+    );
+
+    ///////////////////////////////////////
+    // CONSTANTS
+    ///////////////////////////////////////
+    // address;
+    localparam DMA_REG_CTRL         = `V6_DMA_REG_CTRL;
+    localparam DMA_REG_STATUS       = `V6_DMA_REG_STATUS;
+    localparam DMA_REG_CHAIN        = `V6_DMA_REG_CHAIN;
+    localparam DMA_REG_DESC_SEL     = `V6_DMA_REG_DESC_SEL;
+    localparam DMA_REG_DESC_SRC     = `V6_DMA_REG_DESC_SRC;
+    localparam DMA_REG_DESC_DST     = `V6_DMA_REG_DESC_DST;
+    localparam DMA_REG_DESC_LEN     = `V6_DMA_REG_DESC_LEN;
+    localparam DMA_REG_DESC_STRIDE  = `V6_DMA_REG_DESC_STRIDE;
+
+    // bit position;
+    localparam DMA_REG_CTRL_BIT_POS_START = `V6_DMA_REG_BIT_POS_CTRL_START;
+    localparam DMA_REG_CTRL_BIT_POS_ABORT = `V6_DMA_REG_BIT_POS_CTRL_ABORT;
+
+    // kind;
+    localparam KIND_DDR2_TO_DDR2 = `V6_DMA_KIND_DDR2_TO_DDR2;
+    localparam KIND_DDR2_TO_LCD  = `V6_DMA_KIND_DDR2_TO_LCD;
+    localparam KIND_DCMI_TO_DDR2 = `V6_DMA_KIND_DCMI_TO_DDR2;
+
+    // descriptor table;
+    localparam DESC_ADDR_WIDTH = `V6_DMA_DESC_ADDR_WIDTH;
+    localparam DESC_NUM = 2**DESC_ADDR_WIDTH;
+
+    ///////////////////////////////////////
+    // SIGNAL DECLARATION
+    ///////////////////////////////////////
+    // enabler;
+    logic wr_en;
+    logic rd_en;
+    logic wr_en_reg_ctrl;
+    logic wr_en_reg_chain;
+    logic wr_en_reg_desc_sel;
+    logic wr_en_reg_desc_src;
+    logic wr_en_reg_desc_dst;
+    logic wr_en_reg_desc_len;
+    logic wr_en_reg_desc_stride;
+    logic start;
+    logic abort;
+
+    // descriptor table;
+    logic [22:0] desc_src_array[DESC_NUM-1:0];
+    logic [22:0] desc_dst_array[DESC_NUM-1:0];
+    logic [31:0] desc_len_array[DESC_NUM-1:0];
+    logic [31:0] desc_stride_array[DESC_NUM-1:0];
+    logic [DESC_ADDR_WIDTH-1:0] desc_sel_reg;
+    logic [DESC_ADDR_WIDTH:0] chain_reg;
+
+    // descriptor being run;
+    logic [DESC_ADDR_WIDTH-1:0] desc_idx_reg, desc_idx_next;
+    logic [1:0] kind_reg, kind_next;
+    logic [15:0] line_num_reg, line_num_next;   // lines per row;
+    logic [15:0] line_left_reg, line_left_next;
+    logic [11:0] row_left_reg, row_left_next;
+    logic [15:0] src_stride_reg, src_stride_next;
+    logic [15:0] dst_stride_reg, dst_stride_next;
+    logic [22:0] src_row_reg, src_row_next;     // first line of the row;
+    logic [22:0] dst_row_reg, dst_row_next;
+    logic [22:0] src_ptr_reg, src_ptr_next;     // line being moved;
+    logic [22:0] dst_ptr_reg, dst_ptr_next;
+
+    // line buffer;
+    logic [127:0] line_reg, line_next;
+    logic [3:0] byte_idx_reg, byte_idx_next;
+
+    // status;
+    logic abort_reg, abort_next;
+    logic aborted_reg, aborted_next;
+    logic error_reg, error_next;
+    logic abort_now;                // an abort written now or pending;
+    logic [7:0] done_cnt_reg, done_cnt_next;
+    logic [15:0] line_cnt_reg, line_cnt_next;
+    logic busy;
+
+    /* state
+    1. ST_IDLE      : nothing to run;
+    2. ST_LOAD      : take the descriptor from the table;
+    3. ST_RD_REQ    : read the source line once the mig is handed over;
+    4. ST_RD_WAIT   : wait for the read data;
+    5. ST_LCD       : stream the line to the lcd fifo;
+    6. ST_DCMI      : collect a line from the dcmi fifo;
+    7. ST_WR_REQ    : write the line once the mig is handed over;
+    8. ST_WR_WAIT   : wait for the write to complete;
+    9. ST_NEXT      : move to the next line, row or descriptor;
+    */
+    typedef enum{ST_IDLE, ST_LOAD, ST_RD_REQ, ST_RD_WAIT, ST_LCD, ST_DCMI, ST_WR_REQ, ST_WR_WAIT, ST_NEXT} state_type;
+    state_type state_reg, state_next;
+
+    ////////////////////////////////////////////
+    // addres decoding;
+    ///////////////////////////////////////////
+    assign wr_en = cs && write;
+    assign rd_en = cs && read;
+    assign wr_en_reg_ctrl       = wr_en && (addr[3:0] == DMA_REG_CTRL);
+    assign wr_en_reg_chain      = wr_en && (addr[3:0] == DMA_REG_CHAIN);
+    assign wr_en_reg_desc_sel   = wr_en && (addr[3:0] == DMA_REG_DESC_SEL);
+    assign wr_en_reg_desc_src   = wr_en && (addr[3:0] == DMA_REG_DESC_SRC);
+    assign wr_en_reg_desc_dst   = wr_en && (addr[3:0] == DMA_REG_DESC_DST);
+    assign wr_en_reg_desc_len   = wr_en && (addr[3:0] == DMA_REG_DESC_LEN);
+    assign wr_en_reg_desc_stride = wr_en && (addr[3:0] == DMA_REG_DESC_STRIDE);
+
+    assign start = wr_en_reg_ctrl && wr_data[DMA_REG_CTRL_BIT_POS_START];
+    assign abort = wr_en_reg_ctrl && wr_data[DMA_REG_CTRL_BIT_POS_ABORT];
+
+    ////////////////////////////////////////////
+    // descriptor table;
+    // written by the cpu only; not reset;
+    ///////////////////////////////////////////
+    always_ff @(posedge clk) begin
+        if(wr_en_reg_desc_src)
+            desc_src_array[desc_sel_reg] <= wr_data[22:0];
+        if(wr_en_reg_desc_dst)
+            desc_dst_array[desc_sel_reg] <= wr_data[22:0];
+        if(wr_en_reg_desc_len)
+            desc_len_array[desc_sel_reg] <= wr_data;
+        if(wr_en_reg_desc_stride)
+            desc_stride_array[desc_sel_reg] <= wr_data;
+    end
+
+    always_ff @(posedge clk, posedge reset) begin
+        if(reset) begin
+            desc_sel_reg <= 0;
+            chain_reg <= 0;
+        end
+        else begin
+            // the window moves on with the last register of a descriptor;
+            if(wr_en_reg_desc_sel)
+                desc_sel_reg <= wr_data[DESC_ADDR_WIDTH-1:0];
+            else if(wr_en_reg_desc_stride)
+                desc_sel_reg <= desc_sel_reg + 1;
+
+            if(wr_en_reg_chain)
+                chain_reg <= (wr_data[DESC_ADDR_WIDTH:0] > DESC_NUM) ? DESC_NUM : wr_data[DESC_ADDR_WIDTH:0];
+        end
+    end
+
+    ////////////////////////////////////////////
+    // fsm;
+    ///////////////////////////////////////////
+    always_ff @(posedge clk, posedge reset) begin
+        if(reset) begin
+            state_reg <= ST_IDLE;
+            desc_idx_reg <= 0;
+            kind_reg <= 0;
+            line_num_reg <= 0;
+            line_left_reg <= 0;
+            row_left_reg <= 0;
+            src_stride_reg <= 0;
+            dst_stride_reg <= 0;
+            src_row_reg <= 0;
+            dst_row_reg <= 0;
+            src_ptr_reg <= 0;
+            dst_ptr_reg <= 0;
+            line_reg <= 0;
+            byte_idx_reg <= 0;
+            abort_reg <= 1'b0;
+            aborted_reg <= 1'b0;
+            error_reg <= 1'b0;
+            done_cnt_reg <= 0;
+            line_cnt_reg <= 0;
+        end
+        else begin
+            state_reg <= state_next;
+            desc_idx_reg <= desc_idx_next;
+            kind_reg <= kind_next;
+            line_num_reg <= line_num_next;
+            line_left_reg <= line_left_next;
+            row_left_reg <= row_left_next;
+            src_stride_reg <= src_stride_next;
+            dst_stride_reg <= dst_stride_next;
+            src_row_reg <= src_row_next;
+            dst_row_reg <= dst_row_next;
+            src_ptr_reg <= src_ptr_next;
+            dst_ptr_reg <= dst_ptr_next;
+            line_reg <= line_next;
+            byte_idx_reg <= byte_idx_next;
+            abort_reg <= abort_next;
+            aborted_reg <= aborted_next;
+            error_reg <= error_next;
+            done_cnt_reg <= done_cnt_next;
+            line_cnt_reg <= line_cnt_next;
+        end
+    end
+
+    always_comb begin
+        // default;
+        state_next = state_reg;
+        desc_idx_next = desc_idx_reg;
+        kind_next = kind_reg;
+        line_num_next = line_num_reg;
+        line_left_next = line_left_reg;
+        row_left_next = row_left_reg;
+        src_stride_next = src_stride_reg;
+        dst_stride_next = dst_stride_reg;
+        src_row_next = src_row_reg;
+        dst_row_next = dst_row_reg;
+        src_ptr_next = src_ptr_reg;
+        dst_ptr_next = dst_ptr_reg;
+        line_next = line_reg;
+        byte_idx_next = byte_idx_reg;
+        abort_next = abort_reg;
+        aborted_next = aborted_reg;
+        error_next = error_reg;
+        done_cnt_next = done_cnt_reg;
+        line_cnt_next = line_cnt_reg;
+
+        mig_wr_request = 1'b0;
+        mig_rd_request = 1'b0;
+        lcd_valid = 1'b0;
+        dcmi_ready = 1'b0;
+
+        // an abort is taken at the next line boundary;
+        // or at once in a state with no mig request in flight;
+        if(abort && (state_reg != ST_IDLE)) begin
+            abort_next = 1'b1;
+        end
+
+        case(state_reg)
+            ST_IDLE: begin
+                if(start) begin
+                    desc_idx_next = 0;
+                    abort_next = 1'b0;
+                    aborted_next = 1'b0;
+                    error_next = 1'b0;
+                    line_cnt_next = 0;
+                    if(chain_reg != 0) begin
+                        state_next = ST_LOAD;
+                    end
+                end
+            end
+
+            ST_LOAD: begin
+                kind_next = desc_len_array[desc_idx_reg][29:28];
+                line_num_next = (desc_len_array[desc_idx_reg][15:0] == 0) ? 1 : desc_len_array[desc_idx_reg][15:0];
+                line_left_next = (desc_len_array[desc_idx_reg][15:0] == 0) ? 1 : desc_len_array[desc_idx_reg][15:0];
+                row_left_next = (desc_len_array[desc_idx_reg][27:16] == 0) ? 1 : desc_len_array[desc_idx_reg][27:16];
+                src_stride_next = desc_stride_array[desc_idx_reg][15:0];
+                dst_stride_next = desc_stride_array[desc_idx_reg][31:16];
+                src_row_next = desc_src_array[desc_idx_reg];
+                dst_row_next = desc_dst_array[desc_idx_reg];
+                src_ptr_next = desc_src_array[desc_idx_reg];
+                dst_ptr_next = desc_dst_array[desc_idx_reg];
+                byte_idx_next = 0;
+
+                case(desc_len_array[desc_idx_reg][29:28])
+                    KIND_DDR2_TO_DDR2, KIND_DDR2_TO_LCD:    state_next = ST_RD_REQ;
+                    KIND_DCMI_TO_DDR2:                      state_next = ST_DCMI;
+                    default: begin
+                        error_next = 1'b1;
+                        state_next = ST_IDLE;
+                    end
+                endcase
+            end
+
+            ST_RD_REQ: begin
+                if(abort_now) begin
+                    abort_next = 1'b0;
+                    aborted_next = 1'b1;
+                    state_next = ST_IDLE;
+                end
+                else if(mig_ready) begin
+                    mig_rd_request = 1'b1;
+                    state_next = ST_RD_WAIT;
+                end
+            end
+
+            ST_RD_WAIT: begin
+                // the read data is stable by the complete pulse;
+                if(mig_transaction_complete) begin
+                    line_next = mig_rddata;
+                    byte_idx_next = 0;
+                    state_next = (kind_reg == KIND_DDR2_TO_LCD) ? ST_LCD : ST_WR_REQ;
+                end
+            end
+
+            ST_LCD: begin
+                lcd_valid = ~abort_now;
+                if(abort_now) begin
+                    abort_next = 1'b0;
+                    aborted_next = 1'b1;
+                    state_next = ST_IDLE;
+                end
+                else if(lcd_ready) begin
+                    byte_idx_next = byte_idx_reg + 1;
+                    if(byte_idx_reg == 4'hF) begin
+                        state_next = ST_NEXT;
+                    end
+                end
+            end
+
+            ST_DCMI: begin
+                dcmi_ready = ~abort_now;
+                if(abort_now) begin
+                    abort_next = 1'b0;
+                    aborted_next = 1'b1;
+                    state_next = ST_IDLE;
+                end
+                else if(dcmi_valid) begin
+                    line_next[byte_idx_reg*8 +: 8] = dcmi_data;
+                    byte_idx_next = byte_idx_reg + 1;
+                    if(byte_idx_reg == 4'hF) begin
+                        state_next = ST_WR_REQ;
+                    end
+                end
+            end
+
+            ST_WR_REQ: begin
+                if(abort_now) begin
+                    abort_next = 1'b0;
+                    aborted_next = 1'b1;
+                    state_next = ST_IDLE;
+                end
+                else if(mig_ready) begin
+                    mig_wr_request = 1'b1;
+                    state_next = ST_WR_WAIT;
+                end
+            end
+
+            ST_WR_WAIT: begin
+                if(mig_transaction_complete) begin
+                    state_next = ST_NEXT;
+                end
+            end
+
+            ST_NEXT: begin
+                line_cnt_next = line_cnt_reg + 1;
+                byte_idx_next = 0;
+                state_next = (kind_reg == KIND_DCMI_TO_DDR2) ? ST_DCMI : ST_RD_REQ;
+
+                if(line_left_reg != 1) begin
+                    line_left_next = line_left_reg - 1;
+                    src_ptr_next = src_ptr_reg + 1;
+                    dst_ptr_next = dst_ptr_reg + 1;
+                end
+                else if(row_left_reg != 1) begin
+                    line_left_next = line_num_reg;
+                    row_left_next = row_left_reg - 1;
+                    src_row_next = src_row_reg + src_stride_reg;
+                    dst_row_next = dst_row_reg + dst_stride_reg;
+                    src_ptr_next = src_row_reg + src_stride_reg;
+                    dst_ptr_next = dst_row_reg + dst_stride_reg;
+                end
+                else begin
+                    // descriptor done;
+                    done_cnt_next = done_cnt_reg + 1;
+                    desc_idx_next = desc_idx_reg + 1;
+                    state_next = ((desc_idx_reg + 1) == chain_reg) ? ST_IDLE : ST_LOAD;
+                end
+
+                if(abort_now) begin
+                    abort_next = 1'b0;
+                    aborted_next = 1'b1;
+                    state_next = ST_IDLE;
+                end
+            end
+
+            default: state_next = ST_IDLE;
+        endcase
+    end
+
+    assign busy = (state_reg != ST_IDLE);
+    assign abort_now = abort_reg || abort;
+
+    // the address is held by the state; it does not change while in flight;
+    assign mig_addr = ((state_reg == ST_WR_REQ) || (state_reg == ST_WR_WAIT)) ? dst_ptr_reg : src_ptr_reg;
+    assign mig_wrdata = line_reg;
+
+    // lcd stream; from bit[7:0] onwards;
+    assign lcd_data = line_reg[byte_idx_reg*8 +: 8];
+
+    // the dcmi fifo is taken from the pixel converter for the whole descriptor;
+    assign dcmi_active = busy && (kind_reg == KIND_DCMI_TO_DDR2) && (state_reg != ST_LOAD);
+
+    ////////////////////////////////////////////
+    // read multiplexing for the cpu;
+    ///////////////////////////////////////////
+    always_comb begin
+        // default;
+        rd_data = 32'b0;
+        case({rd_en, addr[3:0]})
+            // {lines moved, descriptors completed, descriptor being run, aborted, error, busy};
+            {1'b1, DMA_REG_STATUS}  : rd_data = {line_cnt_reg, done_cnt_reg, 1'b0, desc_idx_reg, 1'b0, aborted_reg, error_reg, busy};
+            {1'b1, DMA_REG_CHAIN}   : rd_data = {{(31-DESC_ADDR_WIDTH){1'b0}}, chain_reg};
+            {1'b1, DMA_REG_DESC_SEL}: rd_data = {{(32-DESC_ADDR_WIDTH){1'b0}}, desc_sel_reg};
+            default: ; // nop;
+        endcase
+    end
+
+endmodule
+
+`endif //CORE_VIDEO_DMA_SV
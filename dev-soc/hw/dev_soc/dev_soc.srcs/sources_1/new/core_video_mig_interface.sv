@@ -32,6 +32,7 @@ It is either interfacing with:
 1. CPU;
 2. other video core: motion detection?
 3. a HW testing circuit;
+4. the dma core (V6_DMA);
 
 Construction:
 1. DDR2 read/write transaction is 128-bit.
@@ -72,7 +73,16 @@ Register Definition:
         3'b000: NONE
         3'b001: CPU
         3'b010: Motion Detection Core
+        3'b011: DMA Core (V6_DMA);
         3'b100: HW Testing Circuit;
+    hand-over: a write takes effect once the source that has the MIG is out of
+        its transaction (request sent, complete pulse not back yet);
+        meanwhile the MIG ready seen by that source is LOW (no new request);
+        so are the posted writes, the read-ahead and the fill of the cpu;
+        writing the source that has the MIG cancels a pending hand-over;
+    read:
+        bit[2:0]: the source that has the MIG;
+        bit[3]: hand-over pending; active high;
         
 2. Register 1 (Offset 1): Status Register
         bit[0]: MIG DDR2 initialization complete status; active high;
@@ -81,6 +91,15 @@ Register Definition:
                 common for both read and write; 
                 once asserted, it will remain as it is until new write/read strobe is requested;                
         bit[3]: MIG controller idle status; active high;
+        bit[4]: stream mode as set in Register 12; active high;
+        bit[5]: posted mode as set in Register 12; active high;
+        bit[6]: read-ahead line ready in Register 8-11; active high;
+        bit[7]: read-ahead next line ready in the shadow registers; active high;
+        bit[10:8]: posted writes outstanding (in the command fifo or in flight);
+        bit[11]: read-ahead read in flight; active high;
+        bit[12]: fill running (Register 13); active high;
+        bit[13]: fill done; set as the last line is written; cleared by the next start;
+        bit[23:16]: cpu transactions completed; wraps around; never cleared;
             
 3. Register 2 (Offset 2): address common for read and write;
         bit[22:0] address;
@@ -96,6 +115,63 @@ Register Definition:
        
 9. Register 8-11: to store the 128-bit read data as noted in the construction;
 
+10. Register 12 (Offset 12): Mode Register;
+        bit[0]: stream mode for the cpu; active high;
+            1. the address register post-increments after every cpu transaction;
+            2. writing Register 7 submits the write request by itself;
+            3. writing Register 3 submits a one-shot request; no clear is needed;
+        bit[1]: posted mode for the cpu writes; active high;
+            1. writing Register 7 posts {address, write data} into a command fifo (4 deep);
+                and post-increments the address register;
+            2. the fifo is drained to the MIG one write at a time;
+            3. a post into a full fifo is dropped; see the outstanding count;
+            4. no other cpu request until the outstanding count is zero;
+        bit[2]: read-ahead mode for the cpu reads; active high;
+            1. the core reads from the address register onwards by itself;
+                the address register post-increments on every read;
+            2. line N is held in Register 8-11 while line N+1 is read into shadow registers;
+            3. reading Register 11 takes line N; the shadow moves in and line N+2 is read;
+            4. writing Register 2 or Register 12 restarts it; a read in flight is dropped;
+            5. no other cpu request until no read is in flight (status bit[11]);
+
+11. Register 13 (Offset 13): Fill Register;
+        write: bit[23:0] number of lines; starts the fill;
+            1. the lines from Register 2 onwards are written with the 128-bit pattern in Register 4-7;
+            2. one write at a time; the next one goes out a cycle after the complete pulse;
+            3. the address register is left as it is;
+            4. ignored for 0 lines, while a fill runs, while posted writes are outstanding
+                or while a read-ahead read is in flight;
+            5. no other cpu request until the fill is done (status bit[12]);
+            6. it holds while another source has the MIG;
+            7. the pattern is pushed with the stream and posted modes off;
+                Register 7 would submit (post) a write otherwise;
+        read: bit[23:0] lines written since the start;
+
+12. Register 14 (Offset 14): Write Mask Register;
+        bit[15:0]: byte mask of the 128-bit write data; bit i HIGH masks byte i (write_data[8i+7:8i]);
+            1. a masked byte is not written; the DDR2 keeps it (MIG app_wdf_mask);
+            2. 16'h0000 writes all bytes; reset value;
+            3. it applies to every cpu write: single, stream, posted and fill;
+                a posted write takes the mask along with its address and data;
+            4. the other sources always write all bytes;
+
+13. Register 15 (Offset 15): HW Test Register; the hw testing circuit in the bench mode;
+        write:
+            bit[23:0]: number of lines;
+            bit[28:24]: march element; bit[0] write; bit[1] write the complement;
+                        bit[2] read and check first; bit[3] expect the complement;
+                        bit[4] from the last line down to the first;
+            bit[31]: bench mode; active high; the LED demo otherwise;
+            1. a write with bit[31] HIGH and a non-zero number of lines starts the element
+                from Register 2 onwards; ignored while one runs;
+            2. the data is the address in address: every 32-bit word of line A holds A;
+            3. the circuit only reaches the DDR2 while selected in Register 0;
+        read:
+            bit[15:0]: lines read back wrong since the start; saturates;
+            bit[16]: element running; active high;
+            bit[17]: element done; cleared by the next start;
+            bit[31]: bench mode;
+
 Register IO:
 1. Register 0: read and write;
 2. Register 1: read only;
@@ -108,7 +184,11 @@ Register IO:
 9. Register 8: read only;
 10. Register 9: read only;
 11. Register 10: read only;
-12. Register 11: read only;
+12. Register 11: read only; (read-ahead mode: reading it takes the line);
+13. Register 12: write only;
+14. Register 13: read and write;
+15. Register 14: read and write;
+16. Register 15: read and write;
  
 *****************************************************************/
 
@@ -153,6 +233,18 @@ module core_video_mig_interface
         input logic [127:0] core_motion_wrdata,
         output logic [127:0] core_motion_rddata,
         
+        /* --------------------------------------------------------------------------
+        * (Multiplexed) Input Interface with this video core: dma (V6_DMA);
+        * one-shot requests; the address is held until the complete pulse;
+        ---------------------------------------------------------------------------*/
+        input logic core_dma_wr_request,
+        input logic core_dma_rd_request,
+        input logic [22:0] core_dma_addr,
+        input logic [127:0] core_dma_wrdata,
+        output logic [127:0] core_dma_rddata,
+        output logic core_dma_MIG_ready,    // LOW unless the dma is selected;
+        output logic core_dma_MIG_transaction_complete,
+        
         /* --------------------------------------------------------------------------
         * MIG DDR2 status; 
         ---------------------------------------------------------------------------*/
@@ -220,16 +312,40 @@ module core_video_mig_interface
     localparam MIG_INTERFACE_REG_RDDATA_03 = `V5_MIG_INTERFACE_REG_RDDATA_03;
     localparam MIG_INTERFACE_REG_RDDATA_04 = `V5_MIG_INTERFACE_REG_RDDATA_04;
     
+    localparam MIG_INTERFACE_REG_MODE      = `V5_MIG_INTERFACE_REG_MODE;
+    localparam MIG_INTERFACE_REG_FILL      = `V5_MIG_INTERFACE_REG_FILL;
+    localparam MIG_INTERFACE_REG_WRMASK    = `V5_MIG_INTERFACE_REG_WRMASK;
+    localparam MIG_INTERFACE_REG_TEST      = `V5_MIG_INTERFACE_REG_TEST;
+    
     // multiplexing;
     localparam MIG_INTERFACE_REG_SEL_NONE    = 3'b000;  // none;
     localparam MIG_INTERFACE_REG_SEL_CPU     = 3'b001;  // cpu;
     localparam MIG_INTERFACE_REG_SEL_MOTION  = 3'b010;  // motion detection video cores;
+    localparam MIG_INTERFACE_REG_SEL_DMA     = 3'b011;  // dma core;
     localparam MIG_INTERFACE_REG_SEL_TEST    = 3'b100;  // hw testing circuit;
     
     
     //bit position;
     localparam MIG_INTERFACE_REG_CTRL_BIT_POS_WRSTROBE = 0;
     localparam MIG_INTERFACE_REG_CTRL_BIT_POS_RDSTROBE = 1;
+    localparam MIG_INTERFACE_REG_MODE_BIT_POS_STREAM   = `V5_MIG_INTERFACE_REG_BIT_POS_MODE_STREAM;
+    localparam MIG_INTERFACE_REG_MODE_BIT_POS_POSTED   = `V5_MIG_INTERFACE_REG_BIT_POS_MODE_POSTED;
+    localparam MIG_INTERFACE_REG_MODE_BIT_POS_PREFETCH = `V5_MIG_INTERFACE_REG_BIT_POS_MODE_PREFETCH;
+    
+    // write mask; one bit per byte of the write data;
+    localparam WRMASK_WIDTH = `V5_MIG_INTERFACE_WRMASK_WIDTH;
+    
+    // posted write command fifo; {address, write mask, write data};
+    localparam POST_FIFO_ADDR_WIDTH = `V5_MIG_INTERFACE_POST_FIFO_ADDR_WIDTH;
+    localparam POST_FIFO_DATA_WIDTH = 23 + WRMASK_WIDTH + 128;
+    
+    // fill; number of lines;
+    localparam FILL_LEN_WIDTH = `V5_MIG_INTERFACE_FILL_LEN_WIDTH;
+    
+    // hw test circuit; bench mode;
+    localparam TEST_LEN_WIDTH = `V5_MIG_INTERFACE_TEST_LEN_WIDTH;
+    localparam MIG_INTERFACE_REG_TEST_BIT_POS_OP   = `V5_MIG_INTERFACE_REG_BIT_POS_TEST_OP;
+    localparam MIG_INTERFACE_REG_TEST_BIT_POS_MODE = `V5_MIG_INTERFACE_REG_BIT_POS_TEST_MODE;
     
     ///////////////////////////////////////
     // SIGNAL DECLARATION
@@ -246,6 +362,10 @@ module core_video_mig_interface
     logic wr_en_reg_mux;
     logic wr_en_reg_addr;
     logic wr_en_reg_ctrl;
+    logic wr_en_reg_mode;
+    logic wr_en_reg_fill;
+    logic wr_en_reg_wrmask;
+    logic wr_en_reg_test;
     
     // mig ddr2 write is 128-bit; so need to shift in the four 32-bit cpu registers; 
     logic wr_en_reg_cpu_ddr2_wrdata_01;
@@ -261,15 +381,62 @@ module core_video_mig_interface
     logic [31:0] cpu_ddr2_wrdata_04_reg;
            
     ////// cpu register;
-    logic [2:0] mux_reg, mux_next;    // multiplexing;
-    logic [3:0] status_reg, status_next;    // aggregating status from various parts;
+    logic [2:0] mux_reg, mux_next;    // multiplexing; the source that has the MIG;
+    logic [2:0] mux_target_reg;       // the source written; see the hand-over below;
+    logic owner_busy_reg, owner_busy_next;  // the source that has the MIG waits for a complete pulse;
+    logic owner_strobe_prev_reg;      // level strobes of the source; for the rising edge;
+    logic handover_pending;
+    logic handover_take;
+    logic [4:0] status_reg, status_next;    // aggregating status from various parts;
     logic MIG_CPU_transaction_complete_status_reg, MIG_CPU_transaction_complete_status_next;    // to register the transaction completion flag;  
     logic [22:0] cpu_addr_reg;
     logic [31:0] cpu_ctrl_reg;
+    logic [31:0] cpu_mode_reg;
+    logic [WRMASK_WIDTH-1:0] cpu_wrmask_reg;    // see register 14;
+    logic cpu_stream_mode;  // see register 12;
+    logic cpu_wr_request;   // one-shot requests in the stream mode;
+    logic cpu_rd_request;
+    logic [7:0] cpu_complete_cnt_reg;   // completed cpu transactions; wraps around;
+    
+    ////// posted writes;
+    logic cpu_posted_mode;  // see register 12;
+    logic post_push;        // a post into the command fifo;
+    logic post_pop;         // head written to the ddr2;
+    logic post_issue;       // one-shot write request for the head;
+    logic post_busy_reg, post_busy_next;    // head submitted; waiting for its completion;
+    logic [POST_FIFO_ADDR_WIDTH:0] post_cnt_reg; // outstanding; in the fifo or in flight;
+    logic post_fifo_empty;
+    logic post_fifo_full;
+    logic [POST_FIFO_DATA_WIDTH-1:0] post_fifo_wr_data;
+    logic [POST_FIFO_DATA_WIDTH-1:0] post_fifo_rd_data;
+    
+    ////// read-ahead;
+    logic cpu_prefetch_mode;    // see register 12;
+    logic pf_restart;           // address or mode written; start over;
+    logic pf_issue;             // one-shot read request for the next line;
+    logic pf_land;              // the line read ahead has arrived;
+    logic pf_pop;               // the cpu takes the line in Register 8-11;
+    logic pf_busy_reg, pf_busy_next;    // a read in flight;
+    logic pf_drop_reg, pf_drop_next;    // the read in flight is from before a restart;
+    logic pf_line_valid_reg, pf_line_valid_next;    // Register 8-11 holds line N;
+    logic pf_next_valid_reg, pf_next_valid_next;    // the shadow holds line N+1;
+    logic [22:0] pf_addr_reg;   // address of the read in flight;
+    logic [127:0] pf_next_reg;  // shadow registers;
     logic [31:0] cpu_rddata_01_reg;
     logic [31:0] cpu_rddata_02_reg;
     logic [31:0] cpu_rddata_03_reg;
     logic [31:0] cpu_rddata_04_reg;
+    
+    ////// fill;
+    logic fill_run;             // lines left to write;
+    logic fill_start;           // Register 13 written and taken;
+    logic fill_issue;           // one-shot write request for the next line;
+    logic fill_land;            // the line in flight is written;
+    logic fill_busy_reg, fill_busy_next;    // a write in flight;
+    logic fill_done_reg, fill_done_next;    // the last line is written;
+    logic [FILL_LEN_WIDTH-1:0] fill_left_reg;   // lines not written yet;
+    logic [FILL_LEN_WIDTH-1:0] fill_cnt_reg;    // lines written since the start;
+    logic [22:0] fill_addr_reg;                 // address of the next line;
         
     /*------------------------------------------------
     // signals for module: user_mig_DDR2_sync_ctrl 
@@ -278,8 +445,11 @@ module core_video_mig_interface
     //logic MMCM_locked;    // this is already declared as an output port;
     logic user_wr_strobe;
     logic user_rd_strobe;
+    logic user_wr_request;
+    logic user_rd_request;
     logic [22:0] user_addr;
     logic [127:0] user_wr_data;
+    logic [WRMASK_WIDTH-1:0] user_wr_mask;
     logic [127:0] user_rd_data;
     logic MIG_user_init_complete;
     logic MIG_user_ready;
@@ -314,6 +484,15 @@ module core_video_mig_interface
     logic [127:0] core_hw_test_wr_data;
     logic [127:0] core_hw_test_rd_data;
     logic [15:0] core_hw_test_LED;
+    
+    // bench mode; see register 15;
+    logic core_hw_test_mode_reg;    // bench mode instead of the LED demo;
+    logic core_hw_test_start;       // register 15 written with a command;
+    logic core_hw_test_busy;
+    logic core_hw_test_done;
+    logic [15:0] core_hw_test_err_cnt;
+    logic core_hw_test_wr_request;  // one-shot requests in the bench mode;
+    logic core_hw_test_rd_request;
                 
     /////////////////////////////////////////////////////////////////////////////////
     /* -------------------------------------------------------------------
@@ -404,10 +583,13 @@ module core_video_mig_interface
         //  interface between the user system and the memory controller,
         .user_wr_strobe(user_wr_strobe),             // write request,
         .user_rd_strobe(user_rd_strobe),             // read request,
+        .user_wr_request(user_wr_request),           // one-shot write request,
+        .user_rd_request(user_rd_request),           // one-shot read request,
         .user_addr(user_addr),           // address,
         
         // data,
         .user_wr_data(user_wr_data),   
+        .user_wr_mask(user_wr_mask),
         .user_rd_data(user_rd_data),         
         
         // status
@@ -506,11 +688,41 @@ module core_video_mig_interface
         //.MIG_ctrl_status_idle(MIG_ctrl_status_idle),
         
         // debugging port;
-        .debug_ctrl_FSM(debug_ctrl_FSM) // FSM of user_mig_DDR2_sync_ctrl module;
+        .debug_ctrl_FSM(debug_ctrl_FSM), // FSM of user_mig_DDR2_sync_ctrl module;
+        
+        // bench mode; register 15; from the address register onwards;
+        .bench_mode(core_hw_test_mode_reg),
+        .bench_start(core_hw_test_start),
+        .bench_op(wr_data[MIG_INTERFACE_REG_TEST_BIT_POS_OP +: 5]),
+        .bench_addr(cpu_addr_reg),
+        .bench_len(wr_data[TEST_LEN_WIDTH-1:0]),
+        .bench_busy(core_hw_test_busy),
+        .bench_done(core_hw_test_done),
+        .bench_err_cnt(core_hw_test_err_cnt),
+        .bench_wr_request(core_hw_test_wr_request),
+        .bench_rd_request(core_hw_test_rd_request)
     );
     
     
     
+    // posted cpu writes; {address, write data};
+    FIFO
+    #(
+        .DATA_WIDTH(POST_FIFO_DATA_WIDTH),
+        .ADDR_WIDTH(POST_FIFO_ADDR_WIDTH)
+    )
+    post_fifo_unit
+    (
+        .clk(clk_sys),
+        .reset(reset_sys),
+        .ctrl_rd(post_pop),
+        .ctrl_wr(post_push),
+        .flag_empty(post_fifo_empty),
+        .flag_full(post_fifo_full),
+        .rd_data(post_fifo_rd_data),
+        .wr_data(post_fifo_wr_data)
+    );
+    
     ////////////////////////////////////////////////////////////////
     /// BUS INTERFACING    
     ////////////////////////////////////////////////////////////////       
@@ -518,8 +730,28 @@ module core_video_mig_interface
     always_ff @(posedge clk_sys, posedge reset_sys) begin
         if(reset_sys) begin
             mux_reg <= MIG_INTERFACE_REG_SEL_NONE;
+            mux_target_reg <= MIG_INTERFACE_REG_SEL_NONE;
+            owner_busy_reg <= 1'b0;
+            owner_strobe_prev_reg <= 1'b0;
             status_reg <= 0;
             cpu_ctrl_reg <= 0;
+            cpu_mode_reg <= 0;
+            cpu_wrmask_reg <= 0;
+            cpu_complete_cnt_reg <= 0;
+            post_busy_reg <= 1'b0;
+            post_cnt_reg <= 0;
+            pf_busy_reg <= 1'b0;
+            pf_drop_reg <= 1'b0;
+            pf_line_valid_reg <= 1'b0;
+            pf_next_valid_reg <= 1'b0;
+            pf_addr_reg <= 0;
+            pf_next_reg <= 0;
+            fill_busy_reg <= 1'b0;
+            fill_done_reg <= 1'b0;
+            fill_left_reg <= 0;
+            fill_cnt_reg <= 0;
+            fill_addr_reg <= 0;
+            core_hw_test_mode_reg <= 1'b0;
             core_hw_test_enable_ready_reg <= 1'b0;                            
             cpu_addr_reg <= 0;        
             MIG_CPU_transaction_complete_status_reg <= 0;
@@ -543,30 +775,112 @@ module core_video_mig_interface
             MIG_CPU_transaction_complete_status_reg <= MIG_CPU_transaction_complete_status_next;
             
             // selecting which core/source to interface with the ddr2;
+            // the hand-over waits for the source to be out of its transaction;
             if(wr_en_reg_mux) begin
-                mux_reg <= mux_next;                                                
+                mux_target_reg <= mux_next;                                                
             end;
+            if(handover_take) begin
+                mux_reg <= mux_target_reg;
+            end
+            owner_busy_reg <= owner_busy_next;
+            owner_strobe_prev_reg <= user_wr_strobe || user_rd_strobe;
+            
+            post_busy_reg <= post_busy_next;
+            pf_busy_reg <= pf_busy_next;
+            pf_drop_reg <= pf_drop_next;
+            pf_line_valid_reg <= pf_line_valid_next;
+            pf_next_valid_reg <= pf_next_valid_next;
+            fill_busy_reg <= fill_busy_next;
+            fill_done_reg <= fill_done_next;
             
             // ddr2 address specified by the cpu;
+            // stream mode: post-increment after every cpu transaction;
+            // the address has been sampled by then;
+            // posted mode: post-increment on every post; the fifo holds the address;
+            // read-ahead mode: post-increment on every read issued; pf_addr_reg holds the address;
             if(wr_en_reg_addr) begin
                 cpu_addr_reg <= wr_data[22:0];
             end
+            else if(post_push || pf_issue) begin
+                cpu_addr_reg <= cpu_addr_reg + 1;
+            end
+            else if(cpu_stream_mode && !post_busy_reg && !pf_busy_reg && !fill_busy_reg && (mux_reg == MIG_INTERFACE_REG_SEL_CPU) && MIG_user_transaction_complete) begin
+                cpu_addr_reg <= cpu_addr_reg + 1;
+            end
+            
+            if(pf_issue) begin
+                pf_addr_reg <= cpu_addr_reg;
+            end
+            
+            // fill; from the address register onwards; that is left as it is;
+            if(fill_start) begin
+                fill_left_reg <= wr_data[FILL_LEN_WIDTH-1:0];
+                fill_cnt_reg <= 0;
+                fill_addr_reg <= cpu_addr_reg;
+            end
+            else if(fill_land) begin
+                fill_left_reg <= fill_left_reg - 1;
+                fill_cnt_reg <= fill_cnt_reg + 1;
+                fill_addr_reg <= fill_addr_reg + 1;
+            end
+            
+            // sticky completion count; the cpu cannot miss it;
+            if((mux_reg == MIG_INTERFACE_REG_SEL_CPU) && MIG_user_transaction_complete) begin
+                cpu_complete_cnt_reg <= cpu_complete_cnt_reg + 1;
+            end
+            
+            // outstanding posted writes;
+            case({post_push, post_pop})
+                2'b10:  post_cnt_reg <= post_cnt_reg + 1;
+                2'b01:  post_cnt_reg <= post_cnt_reg - 1;
+                default: ;
+            endcase
             
             // control register;
+            // stream mode: the strobes are one-shot requests; nothing is held;
             if(wr_en_reg_ctrl) begin
-                cpu_ctrl_reg <= wr_data;
+                cpu_ctrl_reg <= (cpu_stream_mode) ? 0 : wr_data;
+            end
+            
+            // mode register;
+            if(wr_en_reg_mode) begin
+                cpu_mode_reg <= wr_data;
+            end
+            
+            // write mask register;
+            if(wr_en_reg_wrmask) begin
+                cpu_wrmask_reg <= wr_data[WRMASK_WIDTH-1:0];
+            end
+            
+            // hw test register; the bench mode is a level;
+            if(wr_en_reg_test) begin
+                core_hw_test_mode_reg <= wr_data[MIG_INTERFACE_REG_TEST_BIT_POS_MODE];
             end
             
             // keep on reading after init is complete;
             // should be fine since the read data validity is ...
             // asserted by the transaction complete flag;
-            if(MIG_user_init_complete) begin
+            // read-ahead mode: only loaded with a line read ahead;
+            if(cpu_prefetch_mode) begin
+                if(pf_land && (!pf_line_valid_reg || pf_pop)) begin
+                    {cpu_rddata_04_reg, cpu_rddata_03_reg, cpu_rddata_02_reg, cpu_rddata_01_reg} <= user_rd_data;
+                end
+                else if(pf_pop && pf_next_valid_reg) begin
+                    {cpu_rddata_04_reg, cpu_rddata_03_reg, cpu_rddata_02_reg, cpu_rddata_01_reg} <= pf_next_reg;
+                end
+            end
+            else if(MIG_user_init_complete) begin
                 cpu_rddata_01_reg <= user_rd_data[31:0];
                 cpu_rddata_02_reg <= user_rd_data[63:32];
                 cpu_rddata_03_reg <= user_rd_data[95:64];
                 cpu_rddata_04_reg <= user_rd_data[127:96];
             end
             
+            // shadow registers;
+            if(pf_land && pf_line_valid_reg && !pf_pop) begin
+                pf_next_reg <= user_rd_data;
+            end
+            
             // ddr2 write data;
             if(wr_en_reg_cpu_ddr2_wrdata_01) begin
                 cpu_ddr2_wrdata_01_reg <= wr_data;
@@ -595,13 +909,38 @@ module core_video_mig_interface
     ///////// register 0; selector;    
     assign wr_en_reg_mux = (wr_en) && (addr[3:0] == MIG_INTERFACE_REG_SEL);
     assign mux_next = wr_data[2:0];
+    
+    ////////////////////////////////////
+    // hand-over;
+    // 1. the source that has the MIG is busy from its request (one-shot, or the rising edge
+    //      of a level strobe) to the complete pulse; the pulse still goes to it;
+    // 2. a hand-over is pending while the source written differs from the one that has the MIG;
+    //      the MIG ready of that source is LOW meanwhile; the cpu issues nothing on its own;
+    // 3. it is taken once the source is not busy, sends no request and holds no strobe;
+    //      the strobe would otherwise reach the controller after the switch;
+    // 4. level strobes: a transaction started again by a strobe held over its complete pulse
+    //      (see user_mig_DDR2_sync_ctrl.sv) is not tracked; the cpu clears its strobe itself;
+    ////////////////////////////////////
+    assign handover_pending = (mux_target_reg != mux_reg);
+    assign handover_take = handover_pending && !owner_busy_reg && !user_wr_request && !user_rd_request 
+                            && !user_wr_strobe && !user_rd_strobe;
+    
+    always_comb begin
+        owner_busy_next = owner_busy_reg;
+        if(user_wr_request || user_rd_request || ((user_wr_strobe || user_rd_strobe) && !owner_strobe_prev_reg)) begin
+            owner_busy_next = 1'b1;
+        end
+        else if(MIG_user_transaction_complete) begin
+            owner_busy_next = 1'b0;
+        end
+    end
         
     ///////// register 1: status;        
     //assign status_next = {MIG_ctrl_status_idle, MIG_user_transaction_complete, MIG_user_ready, MIG_user_init_complete};    
     //assign status_next = {MIG_ctrl_status_idle, MIG_CPU_transaction_complete_status_reg, MIG_user_ready, MIG_user_init_complete};
     
     // look ahead for transaction completion status;
-    assign status_next = {MIG_ctrl_status_idle, MIG_CPU_transaction_complete_status_next, MIG_user_ready, MIG_user_init_complete};
+    assign status_next = {cpu_stream_mode, MIG_ctrl_status_idle, MIG_CPU_transaction_complete_status_next, MIG_user_ready, MIG_user_init_complete};
     
     ///////// register 2: addr;   
     assign wr_en_reg_addr = (wr_en) && (addr[3:0] == MIG_INTERFACE_REG_ADDR);
@@ -614,6 +953,136 @@ module core_video_mig_interface
     assign wr_en_reg_cpu_ddr2_wrdata_02 = (wr_en) && (addr[3:0] == MIG_INTERFACE_REG_WRDATA_02);
     assign wr_en_reg_cpu_ddr2_wrdata_03 = (wr_en) && (addr[3:0] == MIG_INTERFACE_REG_WRDATA_03);
     assign wr_en_reg_cpu_ddr2_wrdata_04 = (wr_en) && (addr[3:0] == MIG_INTERFACE_REG_WRDATA_04);
+    
+    ///////// register 12: mode register;
+    assign wr_en_reg_mode = (wr_en) && (addr[3:0] == MIG_INTERFACE_REG_MODE);
+    assign cpu_stream_mode = cpu_mode_reg[MIG_INTERFACE_REG_MODE_BIT_POS_STREAM];
+    
+    ///////// register 13: fill register;
+    assign wr_en_reg_fill = (wr_en) && (addr[3:0] == MIG_INTERFACE_REG_FILL);
+    
+    ///////// register 14: write mask register;
+    assign wr_en_reg_wrmask = (wr_en) && (addr[3:0] == MIG_INTERFACE_REG_WRMASK);
+    
+    ///////// register 15: hw test register;
+    // the circuit takes the command (op, lines, address register) on the start pulse;
+    assign wr_en_reg_test = (wr_en) && (addr[3:0] == MIG_INTERFACE_REG_TEST);
+    assign core_hw_test_start = wr_en_reg_test && wr_data[MIG_INTERFACE_REG_TEST_BIT_POS_MODE];
+    
+    // stream mode: the last write data register submits the write by itself;
+    // a control register write submits once; one system clock pulse each;
+    // posted mode: the last write data register posts instead;
+    assign cpu_wr_request = cpu_stream_mode && ((wr_en_reg_cpu_ddr2_wrdata_04 && !cpu_posted_mode) || (wr_en_reg_ctrl && wr_data[MIG_INTERFACE_REG_CTRL_BIT_POS_WRSTROBE]));
+    assign cpu_rd_request = cpu_stream_mode && wr_en_reg_ctrl && wr_data[MIG_INTERFACE_REG_CTRL_BIT_POS_RDSTROBE];
+    
+    ////////////////////////////////////
+    // posted writes;
+    // 1. the last write data register pushes {address, write mask, write data} into the fifo;
+    //      the word being written is taken from the bus directly;
+    // 2. the head is submitted with a one-shot request; one at a time;
+    // 3. it is popped on its complete pulse; the next one is submitted a cycle later;
+    // 4. the mig sees the head as long as the fifo is not empty;
+    ////////////////////////////////////
+    assign cpu_posted_mode = cpu_mode_reg[MIG_INTERFACE_REG_MODE_BIT_POS_POSTED];
+    assign post_push = cpu_posted_mode && wr_en_reg_cpu_ddr2_wrdata_04 && !post_fifo_full;
+    assign post_fifo_wr_data = {cpu_addr_reg, cpu_wrmask_reg, wr_data, cpu_ddr2_wrdata_03_reg, cpu_ddr2_wrdata_02_reg, cpu_ddr2_wrdata_01_reg};
+    assign post_issue = !post_busy_reg && !post_fifo_empty && !fill_run && (mux_reg == MIG_INTERFACE_REG_SEL_CPU) && !handover_pending;
+    assign post_pop = post_busy_reg && MIG_user_transaction_complete;
+    
+    always_comb begin
+        post_busy_next = post_busy_reg;
+        if(post_issue) begin
+            post_busy_next = 1'b1;
+        end
+        else if(post_pop) begin
+            post_busy_next = 1'b0;
+        end
+    end
+    
+    ////////////////////////////////////
+    // read-ahead;
+    // 1. a read is issued whenever none is in flight and the shadow is free;
+    //      Register 8-11 first, then the shadow;
+    // 2. reading Register 11 pops the line; the shadow moves in;
+    // 3. at most one read in flight; it is in the mig on its own address (pf_addr_reg);
+    //      as the mig takes the address combinationally from user_addr;
+    // 4. a restart while a read is in flight drops that read on arrival;
+    // 5. the read data is taken on the complete pulse; 
+    //      user_rd_data has been stable for the synchronizer delay by then;
+    ////////////////////////////////////
+    assign cpu_prefetch_mode = cpu_mode_reg[MIG_INTERFACE_REG_MODE_BIT_POS_PREFETCH];
+    assign pf_restart = wr_en_reg_addr || wr_en_reg_mode;
+    assign pf_issue = cpu_prefetch_mode && !pf_restart && !pf_busy_reg && !pf_next_valid_reg 
+                        && post_fifo_empty && !fill_run && (mux_reg == MIG_INTERFACE_REG_SEL_CPU) && !handover_pending;
+    assign pf_land = cpu_prefetch_mode && pf_busy_reg && !pf_drop_reg && MIG_user_transaction_complete;
+    assign pf_pop = cpu_prefetch_mode && rd_en && (addr[3:0] == MIG_INTERFACE_REG_RDDATA_04) && pf_line_valid_reg;
+    
+    always_comb begin
+        pf_busy_next = pf_busy_reg;
+        pf_drop_next = pf_drop_reg;
+        pf_line_valid_next = pf_line_valid_reg;
+        pf_next_valid_next = pf_next_valid_reg;
+        
+        // in flight;
+        if(pf_issue) begin
+            pf_busy_next = 1'b1;
+        end
+        else if(pf_busy_reg && MIG_user_transaction_complete) begin
+            pf_busy_next = 1'b0;
+            pf_drop_next = 1'b0;
+        end
+        
+        if(pf_restart) begin
+            pf_line_valid_next = 1'b0;
+            pf_next_valid_next = 1'b0;
+            // the complete pulse of the read in flight has not been seen yet;
+            if(pf_busy_reg && !MIG_user_transaction_complete) begin
+                pf_drop_next = 1'b1;
+            end
+        end
+        else begin
+            // a read in flight implies a free shadow;
+            if(pf_land) begin
+                pf_line_valid_next = 1'b1;
+                pf_next_valid_next = pf_line_valid_reg && !pf_pop;
+            end
+            else if(pf_pop) begin
+                pf_line_valid_next = pf_next_valid_reg;
+                pf_next_valid_next = 1'b0;
+            end
+        end
+    end
+        
+    ////////////////////////////////////
+    // fill;
+    // 1. Register 13 loads the number of lines; the address is taken from Register 2;
+    // 2. one line at a time with a one-shot request; the pattern is Register 4-7;
+    // 3. the next line goes out a cycle after the complete pulse; as the posted writes;
+    // 4. the mig sees the fill address as long as lines are left;
+    ////////////////////////////////////
+    assign fill_run = (fill_left_reg != 0);
+    assign fill_start = wr_en_reg_fill && !fill_run && (wr_data[FILL_LEN_WIDTH-1:0] != 0)
+                        && post_fifo_empty && !post_busy_reg && !pf_busy_reg;
+    assign fill_issue = fill_run && !fill_busy_reg && (mux_reg == MIG_INTERFACE_REG_SEL_CPU) && !handover_pending;
+    assign fill_land = fill_busy_reg && MIG_user_transaction_complete;
+    
+    always_comb begin
+        fill_busy_next = fill_busy_reg;
+        fill_done_next = fill_done_reg;
+        if(fill_issue) begin
+            fill_busy_next = 1'b1;
+        end
+        else if(fill_land) begin
+            fill_busy_next = 1'b0;
+        end
+        
+        if(fill_start) begin
+            fill_done_next = 1'b0;
+        end
+        else if(fill_land && (fill_left_reg == 1)) begin
+            fill_done_next = 1'b1;
+        end
+    end
         
    ////////////////////////////////////
    // ISSUE: to address the transaction completion flag issue;
@@ -625,7 +1094,11 @@ module core_video_mig_interface
    // 2. This is a wait-check-then-submit method for the SW;
    ////////////////////////////////////
    always_comb begin
-        if(MIG_user_transaction_complete && ~(user_wr_strobe||user_rd_strobe)) begin
+        // a one-shot request is newer than any complete pulse on its way;
+        if(user_wr_request || user_rd_request) begin
+            MIG_CPU_transaction_complete_status_next = 1'b0;
+        end
+        else if(MIG_user_transaction_complete && ~(user_wr_strobe||user_rd_strobe)) begin
             MIG_CPU_transaction_complete_status_next = 1'b1;
         end
         // clear it since new request has been submitted;
@@ -645,9 +1118,12 @@ module core_video_mig_interface
         ////////// default; ////////////
         // common for mig ddr2 sync interface (controller);
         user_wr_data = 0;
+        user_wr_mask = 0;   // all bytes written;
         user_addr = 0;
         user_wr_strobe = 0;
         user_rd_strobe = 0;
+        user_wr_request = 0;
+        user_rd_request = 0;
         
         ///// display the state of the mig/ddr2 for debugging convenience;
         // led[15] - mmcm locked status;
@@ -669,20 +1145,45 @@ module core_video_mig_interface
         core_MIG_transaction_complete = 0;
         core_MIG_ctrl_status_idle = 0;
         
+        // dma core;
+        core_dma_rddata = 0;
+        core_dma_MIG_ready = 0;
+        core_dma_MIG_transaction_complete = 0;
+        
         ////////// start the machinery; /////////////
         /*
         localparam MIG_INTERFACE_REG_SEL_NONE    = 3'b000;  // none;
         localparam MIG_INTERFACE_REG_SEL_CPU     = 3'b001;  // cpu;
         localparam MIG_INTERFACE_REG_SEL_MOTION  = 3'b010;  // motion detection video cores;
+        localparam MIG_INTERFACE_REG_SEL_DMA     = 3'b011;  // dma core;
         localparam MIG_INTERFACE_REG_SEL_TEST    = 3'b100;  // hw testing circuit;
         */
         case(mux_reg)
             MIG_INTERFACE_REG_SEL_CPU: begin                
                 // signal assignment to the ddr2 mig interface;               
-                user_addr = cpu_addr_reg;
-                user_wr_data = {cpu_ddr2_wrdata_04_reg, cpu_ddr2_wrdata_03_reg, cpu_ddr2_wrdata_02_reg, cpu_ddr2_wrdata_01_reg};
+                // posted writes pending: the fifo head; with its own mask;
+                // fill: the next line; the pattern is the write data;
+                // read-ahead: the address of the read in flight;
+                user_wr_mask = cpu_wrmask_reg;
+                if(!post_fifo_empty) begin
+                    {user_addr, user_wr_mask, user_wr_data} = post_fifo_rd_data;
+                end
+                else if(fill_run) begin
+                    user_addr = fill_addr_reg;
+                    user_wr_data = {cpu_ddr2_wrdata_04_reg, cpu_ddr2_wrdata_03_reg, cpu_ddr2_wrdata_02_reg, cpu_ddr2_wrdata_01_reg};
+                end
+                else if(pf_busy_reg) begin
+                    user_addr = pf_addr_reg;
+                    user_wr_data = {cpu_ddr2_wrdata_04_reg, cpu_ddr2_wrdata_03_reg, cpu_ddr2_wrdata_02_reg, cpu_ddr2_wrdata_01_reg};
+                end
+                else begin
+                    user_addr = cpu_addr_reg;
+                    user_wr_data = {cpu_ddr2_wrdata_04_reg, cpu_ddr2_wrdata_03_reg, cpu_ddr2_wrdata_02_reg, cpu_ddr2_wrdata_01_reg};
+                end
                 user_wr_strobe = cpu_ctrl_reg[MIG_INTERFACE_REG_CTRL_BIT_POS_WRSTROBE];
                 user_rd_strobe = cpu_ctrl_reg[MIG_INTERFACE_REG_CTRL_BIT_POS_RDSTROBE];                                
+                user_wr_request = cpu_wr_request || post_issue || fill_issue;
+                user_rd_request = cpu_rd_request || pf_issue;
             end
             
             MIG_INTERFACE_REG_SEL_MOTION: begin
@@ -697,15 +1198,32 @@ module core_video_mig_interface
                 
                 // status;
                 core_MIG_init_complete = MIG_user_init_complete;  // MIG DDR2 initialization complete;
-                core_MIG_ready = MIG_user_ready;          // MIG DDR2 ready to accept any request;
+                core_MIG_ready = MIG_user_ready && !handover_pending;   // MIG DDR2 ready to accept any request;
                 core_MIG_transaction_complete = MIG_user_transaction_complete;// a pulse indicating the read/write request has been serviced;
                 core_MIG_ctrl_status_idle = MIG_ctrl_status_idle;   // MIG synchronous interface controller idle status;                      
             end
             
+            MIG_INTERFACE_REG_SEL_DMA: begin
+                // one-shot requests; as the cpu stream mode;
+                user_wr_request = core_dma_wr_request;
+                user_rd_request = core_dma_rd_request;
+                user_addr = core_dma_addr;
+                
+                // data;
+                user_wr_data = core_dma_wrdata;
+                core_dma_rddata = user_rd_data;
+                
+                // status;
+                core_dma_MIG_ready = MIG_user_ready && !handover_pending;
+                core_dma_MIG_transaction_complete = MIG_user_transaction_complete;
+            end
+            
             MIG_INTERFACE_REG_SEL_TEST: begin                
-                core_hw_test_enable_ready_next = MIG_user_ready && 1'b1;
+                core_hw_test_enable_ready_next = MIG_user_ready && !handover_pending;
                 user_wr_strobe = core_hw_test_wr_strobe;
                 user_rd_strobe = core_hw_test_rd_strobe;
+                user_wr_request = core_hw_test_wr_request;  // bench mode;
+                user_rd_request = core_hw_test_rd_request;
                 user_addr = core_hw_test_addr;
                 user_wr_data = core_hw_test_wr_data;
                 core_hw_test_rd_data = user_rd_data;                
@@ -726,14 +1244,25 @@ module core_video_mig_interface
         rd_data = 32'b0;
         case({rd_en, addr[3:0]})
             // mux register;
-            {1'b1, MIG_INTERFACE_REG_SEL}   : rd_data = {29'b0, mux_reg};
+            {1'b1, MIG_INTERFACE_REG_SEL}   : rd_data = {28'b0, handover_pending, mux_reg};
             
             // status register
-            {1'b1, MIG_INTERFACE_REG_STATUS}: rd_data = {28'b0, status_reg};
+            // {complete count, fill done, fill running, read-ahead in flight, outstanding posts, read-ahead lines ready, posted mode, status};
+            {1'b1, MIG_INTERFACE_REG_STATUS}: rd_data = {8'b0, cpu_complete_cnt_reg, 2'b0, fill_done_reg, fill_run, pf_busy_reg, post_cnt_reg, 
+                                                            pf_next_valid_reg, pf_line_valid_reg, cpu_posted_mode, status_reg};
             
             // address register;
             {1'b1, MIG_INTERFACE_REG_ADDR}  : rd_data = {9'b0, cpu_addr_reg};
             
+            // fill register; lines written;
+            {1'b1, MIG_INTERFACE_REG_FILL}  : rd_data = {{(32-FILL_LEN_WIDTH){1'b0}}, fill_cnt_reg};
+            
+            // write mask register;
+            {1'b1, MIG_INTERFACE_REG_WRMASK}: rd_data = {{(32-WRMASK_WIDTH){1'b0}}, cpu_wrmask_reg};
+            
+            // hw test register; {bench mode, done, running, lines read back wrong};
+            {1'b1, MIG_INTERFACE_REG_TEST}  : rd_data = {core_hw_test_mode_reg, 13'b0, core_hw_test_done, core_hw_test_busy, core_hw_test_err_cnt};
+            
             ////////// to shift in (unpack) the 128-bit ddr2 data into four 32-bit batches;
             // first batch;
             {1'b1, MIG_INTERFACE_REG_RDDATA_01}: rd_data = cpu_rddata_01_reg;
@@ -36,6 +36,7 @@ Register Map
         bit[2:0] for multiplexing;
         3'b001: test pattern generator;
         3'b010: camera ov7670;
+        3'b011: dma (V6_DMA);
         3'b100: none;
         
 Register Definition:
@@ -88,7 +89,12 @@ module core_video_src_mux
         // from the camera;
         input logic [SINK_BITS_PER_PIXEL-1:0] camera_rgb,   // pixel source;
         output logic camera_ready, // from lcd fifo to the camera;
-        input logic camera_valid   // from the camera to the lcd fifo;
+        input logic camera_valid,  // from the camera to the lcd fifo;
+        
+        // from the dma;
+        input logic [SINK_BITS_PER_PIXEL-1:0] dma_rgb,  // pixel source;
+        output logic dma_ready,    // from lcd fifo to the dma;
+        input logic dma_valid      // from the dma to the lcd fifo;
         
         /* note */
         // for none; this is done here; so no explicit signals for this;
@@ -99,6 +105,7 @@ module core_video_src_mux
     // constants;
     localparam SEL_TEST = `V2_DISP_SRC_MUX_REG_SEL_TEST;
     localparam SEL_CAM  = `V2_DISP_SRC_MUX_REG_SEL_CAM;
+    localparam SEL_DMA  = `V2_DISP_SRC_MUX_REG_SEL_DMA;
     localparam SEL_NONE = `V2_DISP_SRC_MUX_REG_SEL_NONE;
     
     /// signals;
@@ -134,6 +141,7 @@ module core_video_src_mux
         stream_out_rgb  = {SINK_BITS_PER_PIXEL{1'b0}};  // black pixels;
         pattern_ready   = 1'b0;
         camera_ready    = 1'b0;
+        dma_ready       = 1'b0;
         sink_valid      = 1'b0;
         
         // main machinery;
@@ -148,6 +156,11 @@ module core_video_src_mux
                 camera_ready   = sink_ready;
                 sink_valid     = camera_valid;                    
             end
+            SEL_DMA: begin
+                stream_out_rgb = dma_rgb;
+                dma_ready      = sink_ready;
+                sink_valid     = dma_valid;
+            end
                 
             SEL_NONE: begin
                 stream_out_rgb = {SINK_BITS_PER_PIXEL{1'b0}};  // dont care; black pixel;
@@ -61,6 +61,9 @@ CDC:
     this criteria is so that there willl be no missed events; 
 5. if the signal to sample is a pulse generated from the fast clock domain, and the fast clock rate is at least 1.5 times 
     faster than slow clock rate, then a toggle synchronizer is needed; otherwise, there will be missed events; 
+6. the user strobes are levels; the FSM starts over if a strobe is still HIGH when it is back in idle;
+    the user requests are one-shot instead: a one system clock pulse is carried over by a toggle synchronizer
+    and held pending in the UI clock domain until the FSM takes it; it is taken once;
 
 Write Construction:
 1. By above, when writing, two clock cycles are required to complete the entire 128-bit data;
@@ -90,6 +93,8 @@ Background + Address Mapping;
 User Setup:
 1. by above, we have the write and read data to be 128-bit wide;
 2. we could always do the masking outside of the mig; so not critical;
+2.1 a byte mask (user_wr_mask) is taken along with the write data for partial writes; 
+    one bit per byte; HIGH masks the byte; zero writes all;
 3. by above, the user address shall be 23-bit wide (27-1-3 = 23) where -1 is for the rank; -3 is for the column as discussed above;
 
 Application Setup:
@@ -128,10 +133,13 @@ module user_mig_DDR2_sync_ctrl
         ------------------------------------------------------*/
         input logic user_wr_strobe,             // write request;
         input logic user_rd_strobe,             // read request;
+        input logic user_wr_request,            // one-shot write request; one system clock pulse;
+        input logic user_rd_request,            // one-shot read request; one system clock pulse;
         input logic [USER_ADDR_WIDTH-1:0] user_addr,           // address;
         
         // data;
         input logic [DATA_WIDTH-1:0] user_wr_data,   
+        input logic [2*DATA_MASK_WIDTH-1:0] user_wr_mask,   // byte mask; HIGH masks the byte; held as the write data;
         output logic [DATA_WIDTH-1:0] user_rd_data,         
         
         // status
@@ -238,6 +246,10 @@ module user_mig_DDR2_sync_ctrl
     // synchronization signals for CDC;
     logic user_wr_strobe_sync;          // input; user to request write operation;
     logic user_rd_strobe_sync;          // input; user to request read operation;
+    logic user_wr_request_sync;         // input; one ui clock pulse per one-shot write request;
+    logic user_rd_request_sync;         // input; one ui clock pulse per one-shot read request;
+    logic wr_request_pending_reg, wr_request_pending_next;  // one-shot write request not yet taken;
+    logic rd_request_pending_reg, rd_request_pending_next;  // one-shot read request not yet taken;
     logic init_calib_complete_async;    // output;
     logic app_rdy_async;
     logic transaction_complete_async;   // output;
@@ -271,11 +283,15 @@ module user_mig_DDR2_sync_ctrl
             state_reg <= ST_WAIT_INIT_COMPLETE;            
             app_rd_data_fbatch_reg <= 0;
             app_rd_data_sbatch_reg <= 0;
+            wr_request_pending_reg <= 1'b0;
+            rd_request_pending_reg <= 1'b0;
         end
         else begin
             state_reg <= state_next;
             app_rd_data_fbatch_reg <= app_rd_data_fbatch_next;
             app_rd_data_sbatch_reg <= app_rd_data_sbatch_next;            
+            wr_request_pending_reg <= wr_request_pending_next;
+            rd_request_pending_reg <= rd_request_pending_next;
         end
     end 
     
@@ -373,6 +389,36 @@ module user_mig_DDR2_sync_ctrl
         .f_rst_n(~ui_clk_sync_rst),
         .out_sync(user_rd_strobe_sync)
     );
+    
+    // one-shot requests; a one system clock pulse each;
+    // a double FF synchronizer could catch it twice or not at all;
+    toggle_synchronizer
+    toggle_synchronizer_wr_request_unit 
+    (
+        // src;
+        .clk_src(clk_sys),
+        .rst_src(rst_sys),
+        .in_async(user_wr_request),
+        
+        // dest;
+        .clk_dest(ui_clk),
+        .rst_dest(ui_clk_sync_rst),
+        .out_sync(user_wr_request_sync)
+    );
+    
+    toggle_synchronizer
+    toggle_synchronizer_rd_request_unit 
+    (
+        // src;
+        .clk_src(clk_sys),
+        .rst_src(rst_sys),
+        .in_async(user_rd_request),
+        
+        // dest;
+        .clk_dest(ui_clk),
+        .rst_dest(ui_clk_sync_rst),
+        .out_sync(user_rd_request_sync)
+    );
         
     /* mig interface unit */      
     mig_7series_0 mig_unit (
@@ -484,6 +530,10 @@ module user_mig_DDR2_sync_ctrl
         app_rd_data_sbatch_next = app_rd_data_sbatch_reg;
         
         app_wdf_data    = 0;  
+        
+        // one-shot requests are held until the FSM takes them in ST_IDLE;
+        wr_request_pending_next = wr_request_pending_reg || user_wr_request_sync;
+        rd_request_pending_next = rd_request_pending_reg || user_rd_request_sync;
                 
         // debugging;
         debug_FSM = 0;             
@@ -524,11 +574,13 @@ module user_mig_DDR2_sync_ctrl
                 4. a periodic read is being inserted;
                 */
                 if(app_rdy) begin
-                    if(user_wr_strobe_sync) begin
+                    if(user_wr_strobe_sync || wr_request_pending_reg) begin
                         state_next = ST_WRITE_FIRST;                    
+                        wr_request_pending_next = user_wr_request_sync;
                     end
-                    else if(user_rd_strobe_sync) begin
+                    else if(user_rd_strobe_sync || rd_request_pending_reg) begin
                         state_next = ST_READ_SUBMIT;                                              
+                        rd_request_pending_next = user_rd_request_sync;
                     end
                  end
             end
@@ -547,8 +599,8 @@ module user_mig_DDR2_sync_ctrl
                     each bit represents a byte;
                     there are 8-bits; hence 64-bit chunk;
                     */
-                    // all data shall be written; so enable the mask;
-                    app_wdf_mask = 8'h00;
+                    // the user mask of the first 64-bit chunk; zero writes all;
+                    app_wdf_mask = user_wr_mask[DATA_MASK_WIDTH-1:0];
                     // extract the first 64-bit chunk from the user;
                     app_wdf_data = user_wr_data[63:0];
                     
@@ -569,8 +621,8 @@ module user_mig_DDR2_sync_ctrl
                 debug_FSM = 4;
                 
                 if(app_rdy && app_wdf_rdy) begin
-                    // all data shall be written; so enable the mask;
-                    app_wdf_mask = 8'h00;
+                    // the user mask of the second 64-bit chunk;
+                    app_wdf_mask = user_wr_mask[2*DATA_MASK_WIDTH-1:DATA_MASK_WIDTH];
                     // extract the first 64-bit chunk from the user;
                     app_wdf_data = user_wr_data[127:64];
                                         
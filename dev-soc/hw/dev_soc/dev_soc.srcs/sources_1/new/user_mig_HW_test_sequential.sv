@@ -35,6 +35,22 @@ Note:
 1. by above, this test is not exhaustive;
 2. merely to test the communication with the real DDR2 external memory;
 
+Bench mode (bench_mode HIGH; see core_video_mig_interface.sv Register 15):
+1. the LED demo stops after the transaction in flight; the circuit waits for a command;
+2. a command is one march element over a run of lines; bench_start takes it;
+    bench_op: bit[0] write; bit[1] write the complement;
+              bit[2] read and check first; bit[3] expect the complement;
+              bit[4] from the last line down to the first;
+3. the data is the address in address: every 32-bit word of line A holds A;
+    P(A) = {4{9'b0, A}}; or its complement ~P(A);
+4. per line: read and compare (if bit[2]), then write (if bit[0]);
+    one-shot requests (as the dma); one transaction at a time;
+5. bench_err_cnt counts the lines read back wrong since the start; saturates;
+6. bench_busy is HIGH from the start to the last line; bench_done is sticky;
+    a start is ignored while busy;
+7. a run goes on to its last line when bench_mode drops;
+    the LED demo resumes once the circuit is idle;
+
 */    
 
 module user_mig_HW_test_sequential    
@@ -84,8 +100,21 @@ module user_mig_HW_test_sequential
         //input logic MIG_ctrl_status_idle,          
         
         // debugging port;
-        input logic [3:0] debug_ctrl_FSM // FSM of user_mig_DDR2_sync_ctrl module;
-                   
+        input logic [3:0] debug_ctrl_FSM, // FSM of user_mig_DDR2_sync_ctrl module;
+        
+        /*-------------------------------------------------------
+        * bench mode; commanded by the cpu;
+        -------------------------------------------------------*/
+        input logic bench_mode,             // HIGH: march elements instead of the LED demo;
+        input logic bench_start,            // one-shot; takes the command below;
+        input logic [4:0] bench_op,         // see above;
+        input logic [22:0] bench_addr,      // first line;
+        input logic [23:0] bench_len,       // number of lines; 0 is ignored;
+        output logic bench_busy,
+        output logic bench_done,            // sticky; cleared by the next start;
+        output logic [15:0] bench_err_cnt,  // lines read back wrong; saturates;
+        output logic bench_wr_request,      // one-shot write request;
+        output logic bench_rd_request       // one-shot read request;
     );
             
     /*--------------------------------------
@@ -105,8 +134,15 @@ module user_mig_HW_test_sequential
     9. ST_READ_WAIT     : wait for the read data to be valid;
     10. ST_LED_WAIT      : timer wait for led display;    
     11. ST_GEN           : to generate the next test data;
+    12. ST_BENCH_IDLE    : bench mode; wait for a command;
+    13. ST_BENCH_RD      : read request for the line;
+    14. ST_BENCH_RD_WAIT : wait for the read data; compare;
+    15. ST_BENCH_WR      : write request for the line;
+    16. ST_BENCH_WR_WAIT : wait for the write to complete;
+    17. ST_BENCH_NEXT    : next line; back to idle after the last one;
     */    
-    typedef enum{ST_CHECK_INIT, ST_WRITE_SETUP, ST_WRITE, ST_WRITE_EXTEND, ST_WRITE_WAIT, ST_READ_SETUP, ST_READ, ST_READ_EXTEND, ST_READ_WAIT, ST_LED_WAIT, ST_GEN} state_type;
+    typedef enum{ST_CHECK_INIT, ST_WRITE_SETUP, ST_WRITE, ST_WRITE_EXTEND, ST_WRITE_WAIT, ST_READ_SETUP, ST_READ, ST_READ_EXTEND, ST_READ_WAIT, ST_LED_WAIT, ST_GEN,
+                ST_BENCH_IDLE, ST_BENCH_RD, ST_BENCH_RD_WAIT, ST_BENCH_WR, ST_BENCH_WR_WAIT, ST_BENCH_NEXT} state_type;
     state_type state_reg, state_next;    
     
     ///// debugging state;
@@ -130,6 +166,22 @@ module user_mig_HW_test_sequential
     // here we just simply use incremental basis;
     logic [16:0] index_reg, index_next;
     
+    // bench mode;
+    localparam BENCH_OP_BIT_WR      = 0;
+    localparam BENCH_OP_BIT_WR_INV  = 1;
+    localparam BENCH_OP_BIT_RD      = 2;
+    localparam BENCH_OP_BIT_RD_INV  = 3;
+    localparam BENCH_OP_BIT_DOWN    = 4;
+    
+    logic [4:0] bench_op_reg, bench_op_next;            // command being run;
+    logic [22:0] bench_ptr_reg, bench_ptr_next;         // line being tested;
+    logic [23:0] bench_left_reg, bench_left_next;       // lines left; the run is on while not zero;
+    logic [15:0] bench_err_reg, bench_err_next;
+    logic bench_done_reg, bench_done_next;
+    logic [127:0] bench_pattern;                        // address in address of the line;
+    logic [127:0] bench_wr_data;
+    logic [127:0] bench_rd_expect;
+    
     ////////////////////////////////////////////////////////////////////////////////////
         
     // ff;
@@ -140,7 +192,11 @@ module user_mig_HW_test_sequential
             index_reg <= 0;
             state_reg <= ST_CHECK_INIT;
             user_addr_reg <= 0;                                                         
-             
+            bench_op_reg <= 0;
+            bench_ptr_reg <= 0;
+            bench_left_reg <= 0;
+            bench_err_reg <= 0;
+            bench_done_reg <= 1'b0;
         end
         else begin
             wr_data_reg <= wr_data_next;
@@ -148,9 +204,25 @@ module user_mig_HW_test_sequential
             index_reg <= index_next;
             state_reg <= state_next;
             user_addr_reg <= user_addr_next;                                    
+            bench_op_reg <= bench_op_next;
+            bench_ptr_reg <= bench_ptr_next;
+            bench_left_reg <= bench_left_next;
+            bench_err_reg <= bench_err_next;
+            bench_done_reg <= bench_done_next;
         end
     end
     
+    // bench mode; the data of the line being tested;
+    assign bench_pattern = {4{9'b0, bench_ptr_reg}};
+    assign bench_wr_data = (bench_op_reg[BENCH_OP_BIT_WR_INV]) ? ~bench_pattern : bench_pattern;
+    assign bench_rd_expect = (bench_op_reg[BENCH_OP_BIT_RD_INV]) ? ~bench_pattern : bench_pattern;
+    
+    // a run is on from the start to its last line;
+    // it runs once the LED demo is out of its transaction;
+    assign bench_busy = (bench_left_reg != 0);
+    assign bench_done = bench_done_reg;
+    assign bench_err_cnt = bench_err_reg;
+    
     
     // fsm;
     always_comb begin
@@ -160,15 +232,31 @@ module user_mig_HW_test_sequential
         index_next = index_reg;
         state_next = state_reg;
         user_addr_next = user_addr_reg;
+        bench_op_next = bench_op_reg;
+        bench_ptr_next = bench_ptr_reg;
+        bench_left_next = bench_left_reg;
+        bench_err_next = bench_err_reg;
+        bench_done_next = bench_done_reg;
                 
         user_wr_strobe = 1'b0;
         user_rd_strobe = 1'b0;
+        bench_wr_request = 1'b0;
+        bench_rd_request = 1'b0;
         
         user_addr = user_addr_reg;
         user_wr_data = wr_data_reg;
         
         debug_FSM_reg = 0;
         
+        // bench mode; a command is taken whatever the state; it runs from ST_BENCH_IDLE;
+        if(bench_start && !bench_busy && (bench_len != 0)) begin
+            bench_op_next = bench_op;
+            bench_ptr_next = (bench_op[BENCH_OP_BIT_DOWN]) ? (bench_addr + bench_len[22:0] - 1) : bench_addr;
+            bench_left_next = bench_len;
+            bench_err_next = 0;
+            bench_done_next = 1'b0;
+        end
+        
         /* 
         state:
         1. ST_CHECK_INIT    : wait for the memory initialization to complete before starting everything else;
@@ -198,7 +286,7 @@ module user_mig_HW_test_sequential
                 // important to wait for the memory to be initialized/calibrated;
                 // block until it finishes;
                 if(MIG_user_init_complete) begin
-                    state_next = ST_WRITE_SETUP;
+                    state_next = (bench_mode) ? ST_BENCH_IDLE : ST_WRITE_SETUP;
                 end
             end      
             
@@ -206,7 +294,10 @@ module user_mig_HW_test_sequential
                 // debugging;
                 debug_FSM_reg = 2;
                 
-                if(MIG_user_ready) begin 
+                if(bench_mode) begin
+                    state_next = ST_BENCH_IDLE;
+                end
+                else if(MIG_user_ready) begin 
                     // prepare the write data and address and hold them
                     // stable for the upcoming write request;
                     wr_data_next = index_reg;
@@ -304,7 +395,8 @@ module user_mig_HW_test_sequential
                 debug_FSM_reg = 8;
                 
                 // do not move on after the timer has expired;
-                if(timer_reg == (TIMER_THRESHOLD-1)) begin
+                // bench mode: no wait;
+                if(bench_mode || (timer_reg == (TIMER_THRESHOLD-1))) begin
                     state_next = ST_GEN;
                 end 
                 else begin
@@ -328,6 +420,89 @@ module user_mig_HW_test_sequential
                 end                                            
             end
             
+            ST_BENCH_IDLE: begin
+                // debugging;
+                debug_FSM_reg = 10;
+                
+                // a command waiting; read first if asked to;
+                if(bench_busy) begin
+                    if(bench_op_reg[BENCH_OP_BIT_RD]) begin
+                        state_next = ST_BENCH_RD;
+                    end
+                    else if(bench_op_reg[BENCH_OP_BIT_WR]) begin
+                        state_next = ST_BENCH_WR;
+                    end
+                    else begin
+                        // nothing to do;
+                        bench_left_next = 0;
+                        bench_done_next = 1'b1;
+                    end
+                end
+                else if(!bench_mode) begin
+                    state_next = ST_WRITE_SETUP;
+                end
+            end
+            
+            ST_BENCH_RD: begin
+                // debugging;
+                debug_FSM_reg = 11;
+                user_addr = bench_ptr_reg;
+                if(MIG_user_ready) begin
+                    bench_rd_request = 1'b1;
+                    state_next = ST_BENCH_RD_WAIT;
+                end
+            end
+            
+            ST_BENCH_RD_WAIT: begin
+                // debugging;
+                debug_FSM_reg = 12;
+                user_addr = bench_ptr_reg;
+                
+                // the read data is stable by the complete pulse;
+                if(MIG_user_transaction_complete) begin
+                    if((user_rd_data != bench_rd_expect) && (bench_err_reg != 16'hFFFF)) begin
+                        bench_err_next = bench_err_reg + 1;
+                    end
+                    state_next = (bench_op_reg[BENCH_OP_BIT_WR]) ? ST_BENCH_WR : ST_BENCH_NEXT;
+                end
+            end
+            
+            ST_BENCH_WR: begin
+                // debugging;
+                debug_FSM_reg = 13;
+                user_addr = bench_ptr_reg;
+                user_wr_data = bench_wr_data;
+                if(MIG_user_ready) begin
+                    bench_wr_request = 1'b1;
+                    state_next = ST_BENCH_WR_WAIT;
+                end
+            end
+            
+            ST_BENCH_WR_WAIT: begin
+                // debugging;
+                debug_FSM_reg = 14;
+                user_addr = bench_ptr_reg;
+                user_wr_data = bench_wr_data;
+                if(MIG_user_transaction_complete) begin
+                    state_next = ST_BENCH_NEXT;
+                end
+            end
+            
+            ST_BENCH_NEXT: begin
+                // debugging;
+                debug_FSM_reg = 15;
+                
+                bench_left_next = bench_left_reg - 1;
+                bench_ptr_next = (bench_op_reg[BENCH_OP_BIT_DOWN]) ? (bench_ptr_reg - 1) : (bench_ptr_reg + 1);
+                if(bench_left_reg == 1) begin
+                    bench_done_next = 1'b1;
+                    state_next = ST_BENCH_IDLE;
+                end
+                else begin
+                    state_next = (bench_op_reg[BENCH_OP_BIT_RD]) ? ST_BENCH_RD : ST_BENCH_WR;
+                end
+            end
+            
             // should not reach this state;
             default: begin
                 state_next = ST_CHECK_INIT;
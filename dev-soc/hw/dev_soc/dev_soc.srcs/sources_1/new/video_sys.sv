@@ -156,6 +156,31 @@ module video_sys
     logic video_src_mux_camera_ready;
     logic video_src_mux_camera_valid;
     
+    /*-------------------------------------------------------------- 
+    * signals for core_video_dma 
+    --------------------------------------------------------------*/
+    // with the mig interface;
+    logic dma_mig_wr_request;
+    logic dma_mig_rd_request;
+    logic [22:0] dma_mig_addr;
+    logic [127:0] dma_mig_wrdata;
+    logic [127:0] dma_mig_rddata;
+    logic dma_mig_ready;
+    logic dma_mig_transaction_complete;
+    
+    // to the lcd fifo through the src mux;
+    logic [BPP_8B-1:0] dma_lcd_data;
+    logic dma_lcd_valid;
+    logic dma_lcd_ready;
+    
+    // from the dcmi fifo;
+    // the dma takes the dcmi fifo from the pixel converter while active;
+    logic dma_dcmi_valid;
+    logic dma_dcmi_ready;
+    logic dma_dcmi_active;
+    logic converter_src_valid;
+    logic converter_src_ready;
+    
     /************************ instantiation *****************************/
     /*------------------------------------------------
     * video controller; 
@@ -303,7 +328,12 @@ module video_sys
         // from the upstream (camera) through some intermediate processing element(s);
         .camera_rgb(video_src_mux_camera_rgb_data),   // pixel source;
         .camera_ready(video_src_mux_camera_ready),     // from lcd fifo to the upstream;
-        .camera_valid(video_src_mux_camera_valid)      // from the upstream to the fifo;; 
+        .camera_valid(video_src_mux_camera_valid),     // from the upstream to the fifo;; 
+        
+        // from the dma;
+        .dma_rgb(dma_lcd_data),
+        .dma_ready(dma_lcd_ready),
+        .dma_valid(dma_lcd_valid)
                           
     );
     
@@ -414,8 +444,8 @@ module video_sys
         
         /* ------------ specific */
         // interface with the upstream;
-        .src_valid(DCMI_sink_valid),
-        .src_ready(DCMI_sink_ready),
+        .src_valid(converter_src_valid),
+        .src_ready(converter_src_ready),
         .src_data(DCMI_stream_out_data),
         
         // interface with the downstream;
@@ -514,6 +544,17 @@ module video_sys
         .core_MIG_ready(),           // MIG DDR2 ready to accept any request;
         .core_MIG_transaction_complete(), // a pulse indicating the read/write request has been serviced;
         .core_MIG_ctrl_status_idle(),    // MIG synchronous interface controller idle status;
+        
+        /* --------------------------------------------------------------------------
+        * (Multiplexed) Input Interface with this video core: dma 
+        ---------------------------------------------------------------------------*/
+        .core_dma_wr_request(dma_mig_wr_request),
+        .core_dma_rd_request(dma_mig_rd_request),
+        .core_dma_addr(dma_mig_addr),
+        .core_dma_wrdata(dma_mig_wrdata),
+        .core_dma_rddata(dma_mig_rddata),
+        .core_dma_MIG_ready(dma_mig_ready),
+        .core_dma_MIG_transaction_complete(dma_mig_transaction_complete),
                 
         /*-----------------------------
         * external pin;
@@ -555,13 +596,56 @@ module video_sys
     );
     
     
+    /*--------------------------------------------
+    * DMA: DDR2 to DDR2, DDR2 to LCD, DCMI to DDR2;
+    -------------------------------------------*/
+    core_video_dma video_dma_unit
+    (
+        // general;
+        .clk(clk_sys),
+        .reset(reset),
+        
+        // IO interface
+        .cs(core_ctrl_cs_array[`V6_DMA]),
+        .write(core_ctrl_wr_array[`V6_DMA]),
+        .read(core_ctrl_rd_array[`V6_DMA]),
+        .addr(core_addr_reg_array[`V6_DMA]),
+        .wr_data(core_data_wr_array[`V6_DMA]),
+        .rd_data(core_data_rd_array[`V6_DMA]),
+        
+        // with the mig interface (select: dma);
+        .mig_wr_request(dma_mig_wr_request),
+        .mig_rd_request(dma_mig_rd_request),
+        .mig_addr(dma_mig_addr),
+        .mig_wrdata(dma_mig_wrdata),
+        .mig_rddata(dma_mig_rddata),
+        .mig_ready(dma_mig_ready),
+        .mig_transaction_complete(dma_mig_transaction_complete),
+        
+        // to the lcd fifo through the src mux;
+        .lcd_data(dma_lcd_data),
+        .lcd_valid(dma_lcd_valid),
+        .lcd_ready(dma_lcd_ready),
+        
+        // from the dcmi fifo;
+        .dcmi_data(DCMI_stream_out_data),
+        .dcmi_valid(dma_dcmi_valid),
+        .dcmi_ready(dma_dcmi_ready),
+        .dcmi_active(dma_dcmi_active)
+    );
+    
+    // the dcmi fifo goes either to the pixel converter or to the dma;
+    assign converter_src_valid = DCMI_sink_valid && !dma_dcmi_active;
+    assign dma_dcmi_valid = DCMI_sink_valid && dma_dcmi_active;
+    assign DCMI_sink_ready = (dma_dcmi_active) ? dma_dcmi_ready : converter_src_ready;
+    
     /* -------------------------------------------------------------------
     * ground the the read data signals from the unconstructed video cores 
     * for vivao synthesis optimization to opt out these unused signals 
      -------------------------------------------------------------------*/
     generate
         genvar i;
-            for(i = 6; i < VIDEO_CORE_NUM_TOTAL; i++)
+            for(i = 7; i < VIDEO_CORE_NUM_TOTAL; i++)
             begin
                 // always HIGH ==> idle ==> not signals;
                 assign core_data_rd_array[i] = 32'hFFFF_FFFF;
@@ -0,0 +1,483 @@
+#include "cosim_bus.h"
+#include "host_ili9341_model.h"
+#include "host_ov7670_model.h"
+#include "Vcosim_top.h"
+#include "verilated.h"
+
+/* entry points */
+uint32_t cosim_bus_read(uint32_t base_addr, uint32_t offset){
+    return cosim_bus_get().read(base_addr, offset);
+}
+
+void cosim_bus_write(uint32_t base_addr, uint32_t offset, uint32_t wr_data){
+    cosim_bus_get().write(base_addr, offset, wr_data);
+}
+
+cosim_bus &cosim_bus_get(void){
+    /*
+    @brief  : the bus instance the drivers talk to;
+    @param  : none
+    @retval : the bus;
+    @note   : function-local static so that the RTL is out of reset
+                before the first REG_WRITE() of any global driver object;
+    */
+    static cosim_bus bus;
+    return bus;
+}
+
+cosim_bus::cosim_bus(){
+    /*
+    @brief  : build the RTL and run it through the reset;
+    @note   : the cpu timing defaults to the host bus estimates;
+                rd: 3 (handshake) + 6 (sw); wr: 2 + 6; see host_bus_timing;
+    */
+    top = new Vcosim_top;
+    panel = new host_ili9341_model;
+    cam = new host_ov7670_model;
+
+    timing.rd_cycle = 9;
+    timing.wr_cycle = 8;
+
+    // clocks; all LOW at time 0;
+    time_ps = 0;
+    next_sys_ps = CLK_SYS_HALF_PS;
+    next_mem_ps = CLK_MEM_HALF_PS;
+    next_ui_ps = CLK_UI_HALF_PS;
+    next_pclk_ps = 0;
+    pclk_half_ps = 0;
+    top->clk_sys = 0;
+    top->clk_mem = 0;
+    top->clk_ui = 0;
+    top->dcmi_pclk = 0;
+
+    // bus idle;
+    top->io_addr_strobe = 0;
+    top->io_read_strobe = 0;
+    top->io_write_strobe = 0;
+    top->io_byte_enable = 0;
+    top->io_address = 0;
+    top->io_write_data = 0;
+
+    // pins idle;
+    top->sw = 0;
+    top->uart_rx = 1;
+    top->spi_miso = 0;
+    top->i2c_sda_dev_low = 0;
+    top->lcd_panel_drive = 0;
+    top->lcd_panel_data = 0;
+    top->dcmi_vsync = 1;
+    top->dcmi_href = 0;
+    top->dcmi_pixel = 0;
+    prev_wrx = 1;
+    prev_rdx = 1;
+    prev_scl = 1;
+    prev_sda = 1;
+
+    // reset; the MMCM is locked from the start;
+    top->MMCM_locked = 1;
+    top->reset = 1;
+    top->eval();
+    for(int i = 0; i < RESET_CYCLE; i++){
+        step_sys_rising();
+    }
+    top->reset = 0;
+    top->eval();
+
+    cycle = 0;
+    clear_count();
+}
+
+cosim_bus::~cosim_bus(){
+    top->final();
+    delete top;
+    delete panel;
+    delete cam;
+}
+
+/* ------------------------------------------------
+* simulation;
+--------------------------------------------------*/
+void cosim_bus::step(void){
+    /*
+    @brief  : advance to the next clock edge and evaluate;
+    @param  : none
+    @retval : none
+    @note   : clocks with an edge at the same time toggle together;
+    */
+    uint64_t next = next_sys_ps;
+
+    if(next_mem_ps < next){
+        next = next_mem_ps;
+    }
+    if(next_ui_ps < next){
+        next = next_ui_ps;
+    }
+    if(pclk_half_ps && next_pclk_ps < next){
+        next = next_pclk_ps;
+    }
+    time_ps = next;
+
+    if(next_sys_ps == time_ps){
+        top->clk_sys = !top->clk_sys;
+        next_sys_ps += CLK_SYS_HALF_PS;
+        if(top->clk_sys){
+            cycle++;
+        }
+    }
+    if(next_mem_ps == time_ps){
+        top->clk_mem = !top->clk_mem;
+        next_mem_ps += CLK_MEM_HALF_PS;
+    }
+    if(next_ui_ps == time_ps){
+        top->clk_ui = !top->clk_ui;
+        next_ui_ps += CLK_UI_HALF_PS;
+    }
+    if(pclk_half_ps && next_pclk_ps == time_ps){
+        top->dcmi_pclk = !top->dcmi_pclk;
+        next_pclk_ps += pclk_half_ps;
+    }
+    top->eval();
+    service_pins();
+}
+
+void cosim_bus::step_sys_rising(void){
+    uint64_t start = cycle;
+    while(cycle == start){
+        step();
+    }
+}
+
+void cosim_bus::cycle_idle(uint32_t cycle_num){
+    for(uint32_t i = 0; i < cycle_num; i++){
+        step_sys_rising();
+    }
+}
+
+void cosim_bus::service_pins(void){
+    /*
+    @brief  : devices on the pins; after every evaluation;
+    @param  : none
+    @retval : none
+    @note   :
+        lcd: a byte is taken on the WRX rising edge (as the ILI9341 latches it);
+             the panel drives the bus from the RDX falling edge to the rising edge;
+        i2c: start/stop on a sda edge while scl is HIGH;
+             the device samples on the scl rising edge and
+             sets up its next bit on the scl falling edge;
+    */
+    int wrx = top->lcd_drive_wrx;
+    int rdx = top->lcd_drive_rdx;
+    int scl = top->i2c_scl_level;
+    int sda = top->i2c_sda_level;
+
+    /* lcd */
+    if(!top->lcd_drive_csx){
+        if(!prev_wrx && wrx){
+            panel->write(top->lcd_drive_dcx, top->lcd_data_level);
+        }
+        if(prev_rdx && !rdx){
+            top->lcd_panel_data = panel->read();
+            top->lcd_panel_drive = 1;
+            top->eval();
+        }
+    }
+    if(!prev_rdx && rdx && top->lcd_panel_drive){
+        top->lcd_panel_drive = 0;
+        top->eval();
+    }
+    prev_wrx = wrx;
+    prev_rdx = rdx;
+
+    /* i2c */
+    if(scl && prev_scl && (sda != prev_sda)){
+        if(sda){
+            cam->stop();
+        }
+        else{
+            cam->start();
+        }
+        top->i2c_sda_dev_low = !cam->drive();
+        top->eval();
+    }
+    else if(scl && !prev_scl){
+        cam->sample(sda);
+    }
+    else if(!scl && prev_scl){
+        top->i2c_sda_dev_low = !cam->drive();
+        top->eval();
+    }
+    prev_scl = scl;
+    prev_sda = top->i2c_sda_level;
+}
+
+/* ------------------------------------------------
+* bus transaction;
+--------------------------------------------------*/
+cosim_bus_count *cosim_bus::decode(uint32_t byte_addr){
+    /*
+    @brief  : counter of the slot an address decodes to;
+    @param  : byte_addr - address as issued by the cpu;
+    @retval : the counter; NULL if the address is outside the user space;
+    @note   : counting only; the RTL does the actual decoding;
+    */
+    uint32_t word_addr;
+
+    if((byte_addr & 0xFF000000) != (BUS_MICROBLAZE_IO_BASE_ADDR_G & 0xFF000000)){
+        return NULL;
+    }
+    word_addr = byte_addr >> 2;
+    if(byte_addr & USER_VIDEO_BYTE_SELECT_BIT){
+        return &video_count[(word_addr >> CORE_BIT_POS) & VIDEO_CORE_MASK];
+    }
+    return &mmio_count[(word_addr >> CORE_BIT_POS) & MMIO_CORE_MASK];
+}
+
+uint32_t cosim_bus::read(uint32_t base_addr, uint32_t offset){
+    /*
+    @brief  : one MCS IO read;
+    @param  :
+        base_addr   : base address of the core;
+        offset      : register offset;
+    @retval : io_read_data at the clk_sys edge that ends the strobe;
+    */
+    uint32_t byte_addr = base_addr + REG_WORD_BYTE*offset;
+    cosim_bus_count *count = decode(byte_addr);
+    uint32_t rd_data = 0;
+
+    if(count == NULL){
+        bad_access_cnt++;
+    }
+    else{
+        count->rd_cnt++;
+    }
+    for(size_t i = 0; i < probe_stack.size(); i++){
+        probe_stack[i]->rd_cnt++;
+    }
+
+    // (a) after the rising edge;
+    top->io_address = byte_addr;
+    top->io_addr_strobe = 1;
+    top->io_read_strobe = 1;
+    top->io_byte_enable = 0xF;
+    top->eval();
+
+    // (b) the read path is combinational on clk_sys registers,
+    // so the data now is the data just before the next rising edge;
+    rd_data = top->io_read_data;
+    step_sys_rising();
+
+    // (c) release; the cpu side of the access;
+    top->io_addr_strobe = 0;
+    top->io_read_strobe = 0;
+    top->io_byte_enable = 0;
+    top->eval();
+    if(timing.rd_cycle > 1){
+        cycle_idle(timing.rd_cycle - 1);
+    }
+    return rd_data;
+}
+
+void cosim_bus::write(uint32_t base_addr, uint32_t offset, uint32_t wr_data){
+    /*
+    @brief  : one MCS IO write;
+    @param  :
+        base_addr   : base address of the core;
+        offset      : register offset;
+        wr_data     : 32-bit data;
+    @retval : none
+    */
+    uint32_t byte_addr = base_addr + REG_WORD_BYTE*offset;
+    cosim_bus_count *count = decode(byte_addr);
+
+    if(count == NULL){
+        bad_access_cnt++;
+    }
+    else{
+        count->wr_cnt++;
+    }
+    for(size_t i = 0; i < probe_stack.size(); i++){
+        probe_stack[i]->wr_cnt++;
+    }
+
+    top->io_address = byte_addr;
+    top->io_write_data = wr_data;
+    top->io_addr_strobe = 1;
+    top->io_write_strobe = 1;
+    top->io_byte_enable = 0xF;
+    top->eval();
+    step_sys_rising();
+
+    top->io_addr_strobe = 0;
+    top->io_write_strobe = 0;
+    top->io_byte_enable = 0;
+    top->eval();
+    if(timing.wr_cycle > 1){
+        cycle_idle(timing.wr_cycle - 1);
+    }
+}
+
+/* ------------------------------------------------
+* time;
+--------------------------------------------------*/
+uint64_t cosim_bus::get_cycle(void){
+    return cycle;
+}
+
+void cosim_bus::idle(uint64_t cycle_num){
+    for(uint64_t i = 0; i < cycle_num; i++){
+        step_sys_rising();
+    }
+}
+
+void cosim_bus::set_cpu_timing(cosim_cpu_timing usr_timing){
+    timing = usr_timing;
+    if(timing.rd_cycle == 0){
+        timing.rd_cycle = 1;
+    }
+    if(timing.wr_cycle == 0){
+        timing.wr_cycle = 1;
+    }
+}
+
+cosim_cpu_timing cosim_bus::get_cpu_timing(void){
+    return timing;
+}
+
+void cosim_bus::set_pclk_khz(uint32_t khz){
+    /*
+    @brief  : start or stop the camera pixel clock;
+    @param  : khz - pixel clock; 0 to hold it LOW;
+    @retval : none
+    */
+    if(khz == 0){
+        pclk_half_ps = 0;
+        top->dcmi_pclk = 0;
+        top->eval();
+        return;
+    }
+    pclk_half_ps = (uint32_t)(500000000ULL/khz);
+    next_pclk_ps = time_ps + pclk_half_ps;
+}
+
+/* ------------------------------------------------
+* devices;
+--------------------------------------------------*/
+host_ili9341_model *cosim_bus::get_panel(void){
+    return panel;
+}
+
+host_ov7670_model *cosim_bus::get_camera(void){
+    return cam;
+}
+
+/* ------------------------------------------------
+* counters;
+--------------------------------------------------*/
+void cosim_bus::probe_enter(const char *label){
+    cosim_bus_count *entry = &probe_count[label];
+    entry->call_cnt++;
+    probe_stack.push_back(entry);
+    probe_start.push_back(cycle);
+}
+
+void cosim_bus::probe_exit(void){
+    if(!probe_stack.empty()){
+        probe_stack.back()->cycle += cycle - probe_start.back();
+        probe_stack.pop_back();
+        probe_start.pop_back();
+    }
+}
+
+cosim_bus_count cosim_bus::get_mmio_count(int slot){
+    return mmio_count[slot & MMIO_CORE_MASK];
+}
+
+cosim_bus_count cosim_bus::get_video_count(int slot){
+    return video_count[slot & VIDEO_CORE_MASK];
+}
+
+cosim_bus_count cosim_bus::get_probe_count(const char *label){
+    /*
+    @brief  : counters of a probe;
+    @param  : label as given to probe_enter();
+    @retval : counters; all zero if the probe has never been entered;
+    */
+    cosim_bus_count zero = {0, 0, 0, 0};
+    std::map<std::string, cosim_bus_count>::iterator it = probe_count.find(label);
+    if(it == probe_count.end()){
+        return zero;
+    }
+    return it->second;
+}
+
+uint64_t cosim_bus::get_total_access(void){
+    uint64_t total = bad_access_cnt;
+    for(int i = 0; i < TOTAL_MMIO_SLOT; i++){
+        total += mmio_count[i].rd_cnt + mmio_count[i].wr_cnt;
+    }
+    for(int i = 0; i < TOTAL_VIDEO_SLOT; i++){
+        total += video_count[i].rd_cnt + video_count[i].wr_cnt;
+    }
+    return total;
+}
+
+void cosim_bus::clear_count(void){
+    cosim_bus_count zero = {0, 0, 0, 0};
+    for(int i = 0; i < TOTAL_MMIO_SLOT; i++){
+        mmio_count[i] = zero;
+    }
+    for(int i = 0; i < TOTAL_VIDEO_SLOT; i++){
+        video_count[i] = zero;
+    }
+    probe_count.clear();
+    probe_stack.clear();
+    probe_start.clear();
+    bad_access_cnt = 0;
+}
+
+void cosim_bus::report(FILE *fp){
+    /*
+    @brief  : print the counters and the exact cycles per probe;
+    @param  : fp - output stream;
+    @retval : none
+    @note   : slots without any access are skipped;
+                time at SYS_CLK_FREQ_MHZ;
+    */
+    int i;
+
+    fprintf(fp, "%-8s %-4s %12s %12s\n", "system", "slot", "reads", "writes");
+    for(i = 0; i < TOTAL_MMIO_SLOT; i++){
+        if(mmio_count[i].rd_cnt + mmio_count[i].wr_cnt){
+            fprintf(fp, "%-8s %-4d %12" PRIu64 " %12" PRIu64 "\n", "mmio", i, mmio_count[i].rd_cnt, mmio_count[i].wr_cnt);
+        }
+    }
+    for(i = 0; i < TOTAL_VIDEO_SLOT; i++){
+        if(video_count[i].rd_cnt + video_count[i].wr_cnt){
+            fprintf(fp, "%-8s %-4d %12" PRIu64 " %12" PRIu64 "\n", "video", i, video_count[i].rd_cnt, video_count[i].wr_cnt);
+        }
+    }
+    if(bad_access_cnt){
+        fprintf(fp, "access outside the user address space: %" PRIu64 "\n", bad_access_cnt);
+    }
+
+    if(probe_count.empty()){
+        return;
+    }
+    fprintf(fp, "\n%-28s %8s %10s %10s %14s %12s %12s\n", "probe", "calls", "reads", "writes", "cycle", "cycle/call", "time(us)");
+    for(std::map<std::string, cosim_bus_count>::iterator it = probe_count.begin(); it != probe_count.end(); ++it){
+        cosim_bus_count *c = &it->second;
+        fprintf(fp, "%-28s %8" PRIu64 " %10" PRIu64 " %10" PRIu64 " %14" PRIu64 " %12.1f %12.1f\n",
+            it->first.c_str(), c->call_cnt, c->rd_cnt, c->wr_cnt, c->cycle,
+            c->call_cnt ? (double)c->cycle/c->call_cnt : 0.0,
+            (double)c->cycle/SYS_CLK_FREQ_MHZ);
+    }
+}
+
+/* probe scope guard */
+cosim_probe::cosim_probe(const char *label){
+    cosim_bus_get().probe_enter(label);
+}
+
+cosim_probe::~cosim_probe(){
+    cosim_bus_get().probe_exit();
+}
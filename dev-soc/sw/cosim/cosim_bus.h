@@ -0,0 +1,201 @@
+#ifndef _COSIM_BUS_H
+#define _COSIM_BUS_H
+
+/* ---------------------------------------------
+Purpose: verilator co-simulation backend of the MCS IO bus;
+1. selected at compile time with _COSIM; see io_reg_util.h;
+2. every REG_READ()/REG_WRITE() of the drivers is driven as an
+    MCS IO bus transaction into the verilated RTL (rtl/cosim_top.sv):
+    mcs_bus_bridge + mmio_sys + video_sys, as in mcs_top.sv;
+3. the time is the RTL system clock; a driver call costs
+    the exact number of clk_sys cycles it takes, including
+    every spin-poll on a core status bit;
+4. reads and writes are counted per core slot and per probe
+    (a named scope around a driver call), as host_bus.h;
+5. devices on the pins are the host models:
+    lcd : host_ili9341_model on the 8080 bus (WRX/RDX edges);
+    i2c : host_ov7670_model on the open drain scl/sda lines;
+    the uart, spi and gpio pins are left idle;
+
+Construction:
+1. the clocks are driven from here in picoseconds:
+    clk_sys 100MHz; clk_mem 200MHz; clk_ui 150MHz (MIG UI; behavioral);
+    dcmi_pclk on request (set_pclk_khz()); held LOW otherwise;
+2. the MIG and the FIFO_DUALCLOCK_MACRO are behavioral stand-ins;
+    see rtl/mig_7series_0_behav.sv and rtl/FIFO_DUALCLOCK_MACRO_behav.sv;
+3. one access:
+    (a) the strobes, address and write data are set after a clk_sys rising edge;
+    (b) the read data is sampled as it is just before the next rising edge;
+        io_ready is tied HIGH (mcs_bus_bridge.sv), so the cores
+        take the access on that edge;
+    (c) the strobes are released and the cpu side of the access
+        is spent as idle clk_sys cycles; see cosim_cpu_timing;
+
+@note:
+1. the cpu side (the load/store, the address arithmetic and the
+    driver method call) is not simulated; it is a fixed cost
+    per access taken from the host bus defaults; see host_bus_timing;
+    only the cycles spent in the RTL are exact;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "io_map.h"
+#include "io_reg_util.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+/* entry points for REG_READ() and REG_WRITE(); */
+uint32_t cosim_bus_read(uint32_t base_addr, uint32_t offset);
+void cosim_bus_write(uint32_t base_addr, uint32_t offset, uint32_t wr_data);
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#include <map>
+#include <string>
+#include <vector>
+
+class Vcosim_top;           // verilated rtl/cosim_top.sv;
+class host_ili9341_model;
+class host_ov7670_model;
+
+/*-------------------------------------------------------
+* cpu side of an access; clk_sys cycles from one strobe to the next;
+* at least 1 (the strobe cycle itself);
+-------------------------------------------------------*/
+struct cosim_cpu_timing{
+    uint32_t rd_cycle;      // per REG_READ();
+    uint32_t wr_cycle;      // per REG_WRITE();
+};
+
+// access count;
+struct cosim_bus_count{
+    uint64_t rd_cnt;        // number of REG_READ();
+    uint64_t wr_cnt;        // number of REG_WRITE();
+    uint64_t call_cnt;      // number of times a probe is entered; unused for core slots;
+    uint64_t cycle;         // clk_sys cycles; probes only;
+};
+
+class cosim_bus{
+    // address decoding; see io_map.h;
+    enum{
+        REG_OFFSET_MASK     = 0xF,              // 4-bit register offset;
+        MMIO_CORE_MASK      = 0x1F,             // 32 mmio cores;
+        VIDEO_CORE_MASK     = 0xF,              // 16 video cores;
+        CORE_BIT_POS        = REG_ADDR_SIZE_G   // core field starts after the register offset (word address);
+    };
+
+    // clock half periods in ps;
+    enum{
+        CLK_SYS_HALF_PS     = 5000,             // 100MHz;
+        CLK_MEM_HALF_PS     = 2500,             // 200MHz;
+        CLK_UI_HALF_PS      = 3333,             // 150MHz;
+        RESET_CYCLE         = 16                // clk_sys cycles of reset;
+    };
+
+    public:
+        enum{
+            TOTAL_MMIO_SLOT     = MIMO_CORE_TOTAL_G,
+            TOTAL_VIDEO_SLOT    = VIDEO_CORE_TOTAL_G
+        };
+
+        cosim_bus();
+        ~cosim_bus();
+
+        /* bus transaction */
+        uint32_t read(uint32_t base_addr, uint32_t offset);
+        void write(uint32_t base_addr, uint32_t offset, uint32_t wr_data);
+
+        /* time;
+        get_cycle(): clk_sys rising edges since the reset was released;
+        idle()     : let the RTL run without any access;
+        */
+        uint64_t get_cycle(void);
+        void idle(uint64_t cycle_num);
+        void set_cpu_timing(cosim_cpu_timing usr_timing);
+        cosim_cpu_timing get_cpu_timing(void);
+
+        /* camera pixel clock; 0 to hold it LOW;
+        the sync and pixel pins stay idle (vsync HIGH, href LOW);
+        */
+        void set_pclk_khz(uint32_t khz);
+
+        /* devices on the pins; owned by the bus */
+        host_ili9341_model *get_panel(void);
+        host_ov7670_model *get_camera(void);
+
+        /* per driver call counting; as host_bus;
+        counts are inclusive;
+        */
+        void probe_enter(const char *label);
+        void probe_exit(void);
+
+        /* counters */
+        cosim_bus_count get_mmio_count(int slot);
+        cosim_bus_count get_video_count(int slot);
+        cosim_bus_count get_probe_count(const char *label);
+        uint64_t get_total_access(void);
+        void clear_count(void);
+        void report(FILE *fp);
+
+    private:
+        // simulation;
+        void step(void);                // to the next clock edge;
+        void step_sys_rising(void);     // up to and including the next clk_sys rising edge;
+        void service_pins(void);
+        void cycle_idle(uint32_t cycle_num);
+        cosim_bus_count *decode(uint32_t byte_addr);
+
+        Vcosim_top *top;
+        uint64_t time_ps;
+        uint64_t next_sys_ps;
+        uint64_t next_mem_ps;
+        uint64_t next_ui_ps;
+        uint64_t next_pclk_ps;
+        uint32_t pclk_half_ps;
+        uint64_t cycle;
+        cosim_cpu_timing timing;
+
+        // devices;
+        host_ili9341_model *panel;
+        host_ov7670_model *cam;
+        int prev_wrx;
+        int prev_rdx;
+        int prev_scl;
+        int prev_sda;
+
+        // counters;
+        cosim_bus_count mmio_count[TOTAL_MMIO_SLOT];
+        cosim_bus_count video_count[TOTAL_VIDEO_SLOT];
+        std::map<std::string, cosim_bus_count> probe_count;
+        std::vector<cosim_bus_count *> probe_stack;
+        std::vector<uint64_t> probe_start;
+        uint64_t bad_access_cnt;
+};
+
+/* the bus instance the drivers talk to;
+constructed (and the RTL reset) on first use, so that it is ready
+for the drivers instantiated as global objects;
+*/
+cosim_bus &cosim_bus_get(void);
+
+/* scope guard for the per driver call counting;
+usage:
+    {
+        cosim_probe probe("lcd.write_pixel");
+        obj_lcd.write_pixel(colour);
+    }
+*/
+class cosim_probe{
+    public:
+        cosim_probe(const char *label);
+        ~cosim_probe();
+};
+
+#endif //_COSIM_BUS_H
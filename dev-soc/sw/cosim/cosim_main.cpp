@@ -0,0 +1,135 @@
+/* ---------------------------------------------
+Purpose: co-simulation run of the driver hot paths;
+1. the drivers in user_src are built unmodified against the verilated RTL;
+2. each driver call is wrapped in a probe;
+3. the exact clk_sys cycles per driver call are reported
+    together with the bus access count per core;
+4. the figures are comparable with host_model/host_run,
+    which models the same calls;
+5. usage: cosim_run [ppm];
+    the lcd panel is dumped to ppm if given;
+
+@note: ov7670_init() is left out; its settling delays are
+    hundreds of milliseconds of simulated time;
+---------------------------------------------*/
+
+#include "main.h"
+#include "cosim_bus.h"
+#include "host_ili9341_model.h"
+#include "string.h"
+
+/* global instance of the cores not covered by the device directive */
+core_spi obj_spi(GET_MMIO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, S5_SPI));
+video_core_mig_interface vid_mig(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, V5_MIG_INTERFACE));
+
+// ddr2 stream mode round trip;
+enum{
+    STREAM_LINE_NUM = 64
+};
+static uint32_t stream_buffer[4*STREAM_LINE_NUM];
+
+int main(int argc, char **argv){
+    cosim_bus &bus = cosim_bus_get();
+    lcd_ili9341_sw_driver obj_lcd;
+    host_ili9341_model *panel = bus.get_panel();
+    uint32_t lcd_mismatch = 0;
+    uint32_t read_buffer[4];
+    uint32_t mismatch = 0;
+    uint32_t i;
+
+    bus.clear_count();
+
+    /* lcd */
+    {
+        cosim_probe probe("lcd.init");
+        obj_lcd.init();
+    }
+    {
+        cosim_probe probe("lcd.set_area");
+        obj_lcd.set_area(0, 0, LCD_ILI9341_DIMENSION_LOW_240 - 1, LCD_ILI9341_DIMENSION_HIGH_320 - 1);
+    }
+    for(i = 0; i < 1000; i++){
+        cosim_probe probe("lcd.write_pixel");
+        obj_lcd.write_pixel((uint16_t)i);
+    }
+    {
+        cosim_probe probe("lcd.fill_colour");
+        obj_lcd.fill_colour(RGB565_COLOUR_RED);
+    }
+    for(i = 0; i < LCD_ILI9341_PIXEL_NUM; i++){
+        if(panel->get_gram()[i] != RGB565_COLOUR_RED){
+            lcd_mismatch++;
+        }
+    }
+    if(argc > 1){
+        panel->dump_ppm(argv[1]);
+    }
+
+    /* ddr2 */
+    {
+        cosim_probe probe("mig.init_calib");
+        while(!vid_mig.is_mig_init_complete()){};
+    }
+    if(vid_mig.set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        mismatch++;
+    }
+    while(!vid_mig.is_mig_app_ready()){};
+    for(i = 0; i < 1000; i++){
+        cosim_probe probe("mig.write_ddr2");
+        vid_mig.write_ddr2(i, i, i + 1, i + 2, i + 3);
+    }
+    for(i = 0; i < 1000; i++){
+        cosim_probe probe("mig.read_ddr2");
+        vid_mig.read_ddr2(i, read_buffer);
+        if(read_buffer[0] != i || read_buffer[3] != i + 3){
+            mismatch++;
+        }
+    }
+    {
+        cosim_probe probe("mig.init_ddr2");
+        if(vid_mig.init_ddr2(0, 0, 1000) != 0){
+            mismatch++;
+        }
+    }
+
+    // stream mode; one-shot requests and the address post-increment in the RTL;
+    if(vid_mig.set_stream_mode(1) != 0){
+        mismatch++;
+    }
+    for(i = 0; i < 4*STREAM_LINE_NUM; i++){
+        stream_buffer[i] = ~i;
+    }
+    {
+        cosim_probe probe("mig.write_ddr2_burst_stream");
+        vid_mig.write_ddr2_burst(2000, stream_buffer, STREAM_LINE_NUM);
+    }
+    memset(stream_buffer, 0, sizeof(stream_buffer));
+    {
+        cosim_probe probe("mig.read_ddr2_burst_stream");
+        vid_mig.read_ddr2_burst(2000, stream_buffer, STREAM_LINE_NUM);
+    }
+    for(i = 0; i < 4*STREAM_LINE_NUM; i++){
+        if(stream_buffer[i] != ~i){
+            mismatch++;
+        }
+    }
+    vid_mig.set_stream_mode(0);
+
+    /* camera */
+    for(i = 0; i < 100; i++){
+        cosim_probe probe("ov7670_write");
+        ov7670_write(OV7670_REG_COM10, 0x00);
+    }
+
+    /* spi */
+    for(i = 0; i < 1000; i++){
+        cosim_probe probe("spi.full_duplex_transfer");
+        obj_spi.full_duplex_transfer((uint8_t)i);
+    }
+
+    bus.report(stdout);
+    printf("\nclk_sys cycles: %" PRIu64 "\n", bus.get_cycle());
+    printf("lcd gram mismatch: %u\n", lcd_mismatch);
+    printf("ddr2 read back mismatch: %u\n", mismatch);
+    return (lcd_mismatch || mismatch) ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+`timescale 1ns / 1ps
+//////////////////////////////////////////////////////////////////////////////////
+// Module Name: FIFO_DUALCLOCK_MACRO (behavioral; co-simulation only)
+//////////////////////////////////////////////////////////////////////////////////
+
+/*----------------------------------------
+Purpose:
+1. behavioral stand-in of the Xilinx unisim FIFO_DUALCLOCK_MACRO
+    for the verilator co-simulation; see ../cosim_bus.h;
+2. same module name, parameters and ports as the macro, so that
+    core_video_cam_dcmi_interface.sv is compiled unmodified;
+
+-----------------------------
+CONSTRUCTION
+-------------
+1. depth by DATA_WIDTH and FIFO_SIZE as the macro table
+    (e.g. 5-9 bits, "18Kb": 2048 words, 11-bit counts);
+2. the write and read pointers are Gray coded and passed to
+    the other clock domain through a 2FF synchronizer;
+    hence EMPTY, FULL and the almost flags are pessimistic
+    by the synchronizer latency, as with the BRAM FIFO;
+3. first word fall through only: DO shows the oldest word while !EMPTY;
+4. RDCOUNT, WRCOUNT: the read and write pointers (not the occupancy);
+5. WRERR (RDERR): a write (read) while FULL (EMPTY); for one cycle;
+6. RST is asynchronous; the macro reset sequence
+    (FIFO_DUALCLOCK_MACRO_reset_system.sv) is not checked;
+----------------------------------------*/
+
+`ifndef _FIFO_DUALCLOCK_MACRO_BEHAV_SV
+`define _FIFO_DUALCLOCK_MACRO_BEHAV_SV
+
+module FIFO_DUALCLOCK_MACRO
+    #(
+        parameter
+        ALMOST_EMPTY_OFFSET = 9'h080,
+        ALMOST_FULL_OFFSET = 9'h080,
+        DATA_WIDTH = 8,
+        DEVICE = "7SERIES",
+        FIFO_SIZE = "18Kb",
+        FIRST_WORD_FALL_THROUGH = "TRUE",
+
+        // from the macro table;
+        DEPTH_BIT = (DATA_WIDTH > 36) ? 9 :
+                    (DATA_WIDTH > 18) ? ((FIFO_SIZE == "36Kb") ? 10 : 9) :
+                    (DATA_WIDTH > 9)  ? ((FIFO_SIZE == "36Kb") ? 11 : 10) :
+                    (DATA_WIDTH > 4)  ? ((FIFO_SIZE == "36Kb") ? 12 : 11) :
+                                        ((FIFO_SIZE == "36Kb") ? 13 : 12)
+    )
+    (
+        output logic ALMOSTEMPTY,
+        output logic ALMOSTFULL,
+        output logic [DATA_WIDTH-1:0] DO,
+        output logic EMPTY,
+        output logic FULL,
+        output logic [DEPTH_BIT-1:0] RDCOUNT,
+        output logic RDERR,
+        output logic [DEPTH_BIT-1:0] WRCOUNT,
+        output logic WRERR,
+        input logic [DATA_WIDTH-1:0] DI,
+        input logic RDCLK,
+        input logic RDEN,
+        input logic RST,
+        input logic WRCLK,
+        input logic WREN
+    );
+
+    /* constants */
+    localparam DEPTH = (1 << DEPTH_BIT);
+
+    /* signals */
+    logic [DATA_WIDTH-1:0] mem [DEPTH-1:0];
+
+    // pointers carry one extra bit to tell full from empty;
+    logic [DEPTH_BIT:0] wr_ptr, wr_ptr_gray;
+    logic [DEPTH_BIT:0] rd_ptr, rd_ptr_gray;
+
+    // synchronized into the other domain;
+    logic [DEPTH_BIT:0] rd_ptr_gray_w1, rd_ptr_gray_w2, rd_ptr_w;
+    logic [DEPTH_BIT:0] wr_ptr_gray_r1, wr_ptr_gray_r2, wr_ptr_r;
+
+    logic [DEPTH_BIT:0] wr_fill;    // as seen by the write side;
+    logic [DEPTH_BIT:0] rd_fill;    // as seen by the read side;
+
+    function automatic logic [DEPTH_BIT:0] gray_to_bin(input logic [DEPTH_BIT:0] gray);
+        logic [DEPTH_BIT:0] bin;
+        bin[DEPTH_BIT] = gray[DEPTH_BIT];
+        for(int i = DEPTH_BIT-1; i >= 0; i--) begin
+            bin[i] = bin[i+1] ^ gray[i];
+        end
+        return bin;
+    endfunction
+
+    /* ----- write domain; */
+    assign wr_ptr_gray  = wr_ptr ^ (wr_ptr >> 1);
+    assign rd_ptr_w     = gray_to_bin(rd_ptr_gray_w2);
+    assign wr_fill      = wr_ptr - rd_ptr_w;
+    assign FULL         = (wr_fill == DEPTH);
+    assign ALMOSTFULL   = (wr_fill >= DEPTH - ALMOST_FULL_OFFSET);
+    assign WRCOUNT      = wr_ptr[DEPTH_BIT-1:0];
+
+    always_ff @(posedge WRCLK, posedge RST) begin
+        if(RST) begin
+            wr_ptr          <= 0;
+            rd_ptr_gray_w1  <= 0;
+            rd_ptr_gray_w2  <= 0;
+            WRERR           <= 1'b0;
+        end
+        else begin
+            rd_ptr_gray_w1  <= rd_ptr_gray;
+            rd_ptr_gray_w2  <= rd_ptr_gray_w1;
+            WRERR           <= (WREN && FULL);
+            if(WREN && !FULL) begin
+                mem[wr_ptr[DEPTH_BIT-1:0]]  <= DI;
+                wr_ptr                      <= wr_ptr + 1;
+            end
+        end
+    end
+
+    /* ----- read domain; */
+    assign rd_ptr_gray  = rd_ptr ^ (rd_ptr >> 1);
+    assign wr_ptr_r     = gray_to_bin(wr_ptr_gray_r2);
+    assign rd_fill      = wr_ptr_r - rd_ptr;
+    assign EMPTY        = (rd_fill == 0);
+    assign ALMOSTEMPTY  = (rd_fill <= ALMOST_EMPTY_OFFSET);
+    assign RDCOUNT      = rd_ptr[DEPTH_BIT-1:0];
+    assign DO           = mem[rd_ptr[DEPTH_BIT-1:0]];    // first word fall through;
+
+    always_ff @(posedge RDCLK, posedge RST) begin
+        if(RST) begin
+            rd_ptr          <= 0;
+            wr_ptr_gray_r1  <= 0;
+            wr_ptr_gray_r2  <= 0;
+            RDERR           <= 1'b0;
+        end
+        else begin
+            wr_ptr_gray_r1  <= wr_ptr_gray;
+            wr_ptr_gray_r2  <= wr_ptr_gray_r1;
+            RDERR           <= (RDEN && EMPTY);
+            if(RDEN && !EMPTY) begin
+                rd_ptr      <= rd_ptr + 1;
+            end
+        end
+    end
+
+endmodule
+
+`endif //_FIFO_DUALCLOCK_MACRO_BEHAV_SV
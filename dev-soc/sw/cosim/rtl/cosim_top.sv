@@ -0,0 +1,224 @@
+`timescale 1ns / 1ps
+//////////////////////////////////////////////////////////////////////////////////
+// Module Name: cosim_top (verilator co-simulation only)
+//////////////////////////////////////////////////////////////////////////////////
+
+/*----------------------------------------
+Purpose:
+1. mcs_top.sv without the MicroBlaze MCS and the MMCM;
+2. the MCS IO bus is driven by the C++ harness (../cosim_bus.cpp)
+    on behalf of the drivers; the bridge, mmio_sys and video_sys
+    are the real cores with the parameters of mcs_top.sv;
+3. the clocks come from the harness:
+    clk_sys : 100MHz; system clock;
+    clk_mem : 200MHz; MIG system clock (sys_clk_i);
+    clk_ui  : 150MHz; MIG UI clock; see rtl/mig_7series_0_behav.sv;
+4. the tristate pins are resolved here; the harness sees
+    the line levels and says when a device drives a line;
+    i2c : open drain with pull-up; i2c_sda_dev_low pulls sda LOW;
+    lcd : the panel drives lcd_dinout with lcd_panel_data while lcd_panel_drive;
+    gpio: pulled up; not connected;
+
+Note:
+1. reset is async and active HIGH as reset_sys_stretch_reg of mcs_top.sv;
+    the harness holds it for a few clk_sys cycles;
+2. the DDR2 pins are left unconnected;
+----------------------------------------*/
+
+`ifndef _COSIM_TOP_SV
+`define _COSIM_TOP_SV
+
+`include "IO_map.svh"
+
+module cosim_top
+    (
+        // clocks and reset;
+        input logic clk_sys,
+        input logic clk_mem,
+        input logic clk_ui,
+        input logic reset,
+        input logic MMCM_locked,
+
+        // microblaze mcs io bus;
+        input logic io_addr_strobe,
+        input logic io_read_strobe,
+        input logic io_write_strobe,
+        input logic [3:0] io_byte_enable,
+        input logic [31:0] io_address,
+        input logic [31:0] io_write_data,
+        output logic [31:0] io_read_data,
+        output logic io_ready,
+
+        // mmio pins;
+        input logic [15:0] sw,
+        output logic [15:0] led,
+        input logic uart_rx,
+        output logic uart_tx,
+        output logic spi_sclk,
+        output logic spi_mosi,
+        input logic spi_miso,
+        output logic spi_ss_n,
+        output logic spi_data_or_command,
+
+        // i2c line levels;
+        output logic i2c_scl_level,
+        output logic i2c_sda_level,
+        input logic i2c_sda_dev_low,
+
+        // lcd;
+        output logic lcd_drive_wrx,
+        output logic lcd_drive_rdx,
+        output logic lcd_drive_csx,
+        output logic lcd_drive_dcx,
+        output logic [7:0] lcd_data_level,
+        input logic lcd_panel_drive,
+        input logic [7:0] lcd_panel_data,
+
+        // camera;
+        input logic dcmi_pclk,
+        input logic dcmi_vsync,
+        input logic dcmi_href,
+        input logic [7:0] dcmi_pixel,
+
+        // mig status leds;
+        output logic [15:0] video_led
+    );
+
+    /* signals */
+    logic user_mmio_cs;
+    logic user_video_cs;
+    logic user_wr;
+    logic user_rd;
+    logic [`BUS_USER_SIZE_G-1:0] user_addr;
+    logic [`REG_DATA_WIDTH_G-1:0] user_wr_data;
+    logic [`REG_DATA_WIDTH_G-1:0] user_rd_data;
+    logic [`REG_DATA_WIDTH_G-1:0] user_rd_data_mmio;
+    logic [`REG_DATA_WIDTH_G-1:0] user_rd_data_video;
+
+    // tristate lines;
+    tri1 i2c_scl;
+    tri1 i2c_sda;
+    tri1 [1:0] gpio;
+    tri [7:0] lcd_dinout;
+
+    /* ----- tristate resolution; */
+    assign i2c_sda          = (i2c_sda_dev_low) ? 1'b0 : 1'bz;
+    assign i2c_scl_level    = i2c_scl;
+    assign i2c_sda_level    = i2c_sda;
+
+    assign lcd_dinout       = (lcd_panel_drive) ? lcd_panel_data : 8'bz;
+    assign lcd_data_level   = lcd_dinout;
+
+    // bridge;
+    mcs_bus_bridge bridge_unit
+    (
+        .mcs_bridge_base_addr(`BUS_MICROBLAZE_IO_BASE_ADDR_G),
+        .io_addr_strobe(io_addr_strobe),
+        .io_read_strobe(io_read_strobe),
+        .io_write_strobe(io_write_strobe),
+        .io_byte_enable(io_byte_enable),
+        .io_address(io_address),
+        .io_write_data(io_write_data),
+        .io_read_data(io_read_data),
+        .io_ready(io_ready),
+
+        .user_mmio_cs(user_mmio_cs),
+        .user_video_cs(user_video_cs),
+        .user_wr(user_wr),
+        .user_rd(user_rd),
+        .user_addr(user_addr),
+        .user_wr_data(user_wr_data),
+        .user_rd_data(user_rd_data)
+    );
+
+    // as mcs_top.sv;
+    assign user_rd_data = (user_mmio_cs) ? user_rd_data_mmio : user_rd_data_video;
+
+    // mmio system; parameters as mcs_top.sv;
+    mmio_sys
+    #(.SW_NUM(16),
+        .LED_NUM(16),
+        .UART_DATA_BIT(8),
+        .UART_STOP_BIT_SAMPLING_NUM(16),
+        .SPI_DATA_BIT(8),
+        .SPI_SLAVE_NUM(1),
+        .I2C_DATA_BIT(8),
+        .GPIO_PORT_NUM(2)
+    )
+    mmio_unit
+    (
+        .clk(clk_sys),
+        .reset(reset),
+        .mmio_addr(user_addr),
+        .mmio_cs(user_mmio_cs),
+        .mmio_wr(user_wr),
+        .mmio_rd(user_rd),
+        .mmio_wr_data(user_wr_data),
+        .mmio_rd_data(user_rd_data_mmio),
+        .sw(sw),
+        .led(led),
+        .uart_tx(uart_tx),
+        .uart_rx(uart_rx),
+        .spi_sclk(spi_sclk),
+        .spi_mosi(spi_mosi),
+        .spi_miso(spi_miso),
+        .spi_ss_n(spi_ss_n),
+        .spi_data_or_command(spi_data_or_command),
+        .i2c_scl(i2c_scl),
+        .i2c_sda(i2c_sda),
+        .gpio(gpio)
+    );
+
+    // video system; parameters as mcs_top.sv;
+    video_sys
+    #(
+        .BITS_PER_PIXEL(16),
+        .LCD_DISPLAY_DATA_WIDTH(8),
+        .FIFO_LCD_ADDR_WIDTH(8)
+    )
+    video_unit
+    (
+        .clk_sys(clk_sys),
+        .reset(reset),
+        .video_cs(user_video_cs),
+        .video_wr(user_wr),
+        .video_rd(user_rd),
+        .video_addr(user_addr),
+        .video_wr_data(user_wr_data),
+        .video_rd_data(user_rd_data_video),
+
+        .lcd_drive_csx(lcd_drive_csx),
+        .lcd_drive_dcx(lcd_drive_dcx),
+        .lcd_drive_wrx(lcd_drive_wrx),
+        .lcd_drive_rdx(lcd_drive_rdx),
+        .lcd_dinout(lcd_dinout),
+
+        .dcmi_pclk(dcmi_pclk),
+        .dcmi_vsync(dcmi_vsync),
+        .dcmi_href(dcmi_href),
+        .dcmi_pixel(dcmi_pixel),
+
+        .LED(video_led),
+        .MMCM_locked(MMCM_locked),
+        .clk_mem(clk_mem),
+
+        // not connected;
+        .ddr2_addr(),
+        .ddr2_ba(),
+        .ddr2_cas_n(),
+        .ddr2_ck_n(),
+        .ddr2_ck_p(),
+        .ddr2_cke(),
+        .ddr2_ras_n(),
+        .ddr2_we_n(),
+        .ddr2_dq(),
+        .ddr2_dqs_n(),
+        .ddr2_dqs_p(),
+        .ddr2_cs_n(),
+        .ddr2_dm(),
+        .ddr2_odt()
+    );
+
+endmodule
+
+`endif //_COSIM_TOP_SV
@@ -0,0 +1,257 @@
+`timescale 1ns / 1ps
+//////////////////////////////////////////////////////////////////////////////////
+// Module Name: mig_7series_0 (behavioral; co-simulation only)
+//////////////////////////////////////////////////////////////////////////////////
+
+/*----------------------------------------
+Purpose:
+1. behavioral stand-in of the Xilinx IP-generated MIG (DDR2) for the
+    verilator co-simulation; see ../cosim_bus.h;
+2. same module name and port list as the IP, so that
+    user_mig_DDR2_sync_ctrl.sv is compiled unmodified;
+3. only the application (UI) interface is modelled;
+    the DDR2 pins are left idle;
+
+-----------------------------
+CONSTRUCTION
+-------------
+1. ui_clk:
+    the IP derives it from sys_clk_i (150MHz on this board);
+    verilator has no MMCM, hence it is taken from the top level
+    clock cosim_top.clk_ui which the C++ harness drives at 150MHz;
+2. reset and calibration:
+    ui_clk_sync_rst follows sys_rst (active LOW) through a 2FF synchronizer;
+    init_calib_complete rises INIT_LATENCY ui_clk cycles after the reset;
+3. app_rdy and app_wdf_rdy are HIGH once calibrated (no back-pressure);
+4. write:
+    a write data beat (app_wdf_wren) is queued;
+    a write command (app_en, cmd 3'b000) takes the two oldest beats;
+    beat 1 is the lower 64-bit, beat 2 (app_wdf_end) the upper 64-bit;
+    a byte is written when its app_wdf_mask bit is LOW;
+    the command may come before, with or after its data;
+5. read:
+    a read command (app_en, cmd 3'b001) returns the line in two beats,
+    lower 64-bit first; the first beat RD_LATENCY ui_clk cycles later;
+    reads return in order;
+6. memory: 2^23 lines of 128-bit, sparse (associative);
+    a line never written reads as zero;
+
+Note:
+1. the defaults follow host_model/host_mig_model.cpp
+    (150MHz, 15000 cycles init, 22 cycles read latency);
+----------------------------------------*/
+
+`ifndef _MIG_7SERIES_0_BEHAV_SV
+`define _MIG_7SERIES_0_BEHAV_SV
+
+module mig_7series_0
+    #(
+        parameter
+        INIT_LATENCY = 15000,   // ui_clk cycles; reset to init_calib_complete;
+        RD_LATENCY = 22         // ui_clk cycles; read command to the first beat;
+    )
+    (
+        // Memory interface ports; idle;
+        output logic [12:0] ddr2_addr,
+        output logic [2:0] ddr2_ba,
+        output logic ddr2_cas_n,
+        output logic [0:0] ddr2_ck_n,
+        output logic [0:0] ddr2_ck_p,
+        output logic [0:0] ddr2_cke,
+        output logic ddr2_ras_n,
+        output logic ddr2_we_n,
+        inout tri [15:0] ddr2_dq,
+        inout tri [1:0] ddr2_dqs_n,
+        inout tri [1:0] ddr2_dqs_p,
+        output logic init_calib_complete,
+        output logic [0:0] ddr2_cs_n,
+        output logic [1:0] ddr2_dm,
+        output logic [0:0] ddr2_odt,
+
+        // Application interface ports
+        input logic [26:0] app_addr,
+        input logic [2:0] app_cmd,
+        input logic app_en,
+        input logic [63:0] app_wdf_data,
+        input logic app_wdf_end,
+        input logic app_wdf_wren,
+        output logic [63:0] app_rd_data,
+        output logic app_rd_data_end,
+        output logic app_rd_data_valid,
+        output logic app_rdy,
+        output logic app_wdf_rdy,
+        input logic app_sr_req,
+        input logic app_ref_req,
+        input logic app_zq_req,
+        output logic app_sr_active,
+        output logic app_ref_ack,
+        output logic app_zq_ack,
+        output logic ui_clk,
+        output logic ui_clk_sync_rst,
+        input logic [7:0] app_wdf_mask,
+
+        // System Clock Ports
+        input logic sys_clk_i,
+        input logic sys_rst     // active LOW;
+    );
+
+    /* constants */
+    localparam CMD_WRITE = 3'b000;
+    localparam CMD_READ  = 3'b001;
+
+    /* signals */
+    logic rst_reg;
+    logic rst_sync;
+    logic [31:0] calib_cnt;
+    logic calib_done;
+
+    // memory; one entry per 128-bit line;
+    logic [127:0] mem [logic [22:0]];
+
+    // write data beats {mask, data} and write commands (line address);
+    logic [71:0] wdf_q [$];
+    logic [22:0] wr_cmd_q [$];
+
+    // read commands; line address and the due cycle of the first beat;
+    logic [22:0] rd_addr_q [$];
+    logic [31:0] rd_due_q [$];
+    logic [31:0] ui_cycle;
+    logic rd_second_beat;       // HIGH when the second beat is due;
+    logic [63:0] rd_upper;      // second beat;
+
+    /* ----- clock and reset; */
+    assign ui_clk = cosim_top.clk_ui;
+
+    always_ff @(posedge ui_clk, negedge sys_rst) begin
+        if(!sys_rst) begin
+            rst_reg     <= 1'b1;
+            rst_sync    <= 1'b1;
+        end
+        else begin
+            rst_reg     <= 1'b0;
+            rst_sync    <= rst_reg;
+        end
+    end
+    assign ui_clk_sync_rst = rst_sync;
+
+    always_ff @(posedge ui_clk) begin
+        if(rst_sync) begin
+            calib_cnt   <= 0;
+            calib_done  <= 1'b0;
+        end
+        else if(calib_cnt == INIT_LATENCY) begin
+            calib_done  <= 1'b1;
+        end
+        else begin
+            calib_cnt   <= calib_cnt + 1;
+        end
+    end
+    assign init_calib_complete  = calib_done;
+    assign app_rdy              = calib_done;
+    assign app_wdf_rdy          = calib_done;
+
+    /* ----- write and read; */
+    function automatic logic [127:0] read_line(input logic [22:0] line_addr);
+        if(mem.exists(line_addr)) begin
+            return mem[line_addr];
+        end
+        return 128'b0;
+    endfunction
+
+    function automatic logic [63:0] merge_beat(input logic [63:0] old_data, input logic [71:0] beat);
+        logic [63:0] merged;
+        merged = old_data;
+        for(int i = 0; i < 8; i++) begin
+            // byte written when its mask bit is LOW;
+            if(!beat[64 + i]) begin
+                merged[8*i +: 8] = beat[8*i +: 8];
+            end
+        end
+        return merged;
+    endfunction
+
+    always_ff @(posedge ui_clk) begin
+        logic [127:0] line;
+        logic [71:0] beat_lo;
+        logic [71:0] beat_hi;
+        logic [22:0] line_addr;
+
+        app_rd_data_valid   <= 1'b0;
+        app_rd_data_end     <= 1'b0;
+
+        if(rst_sync) begin
+            wdf_q.delete();
+            wr_cmd_q.delete();
+            rd_addr_q.delete();
+            rd_due_q.delete();
+            ui_cycle        <= 0;
+            rd_second_beat  <= 1'b0;
+            app_rd_data     <= 0;
+        end
+        else begin
+            ui_cycle <= ui_cycle + 1;
+
+            // accept;
+            if(calib_done && app_wdf_wren) begin
+                wdf_q.push_back({app_wdf_mask, app_wdf_data});
+            end
+            if(calib_done && app_en) begin
+                if(app_cmd == CMD_WRITE) begin
+                    wr_cmd_q.push_back(app_addr[25:3]);
+                end
+                else if(app_cmd == CMD_READ) begin
+                    rd_addr_q.push_back(app_addr[25:3]);
+                    rd_due_q.push_back(ui_cycle + RD_LATENCY);
+                end
+            end
+
+            // commit a write once both its beats are in;
+            // the beats of this cycle are pushed already (blocking queue calls);
+            if(wr_cmd_q.size() > 0 && wdf_q.size() >= 2) begin
+                line_addr   = wr_cmd_q.pop_front();
+                beat_lo     = wdf_q.pop_front();
+                beat_hi     = wdf_q.pop_front();
+                line        = read_line(line_addr);
+                line[63:0]  = merge_beat(line[63:0], beat_lo);
+                line[127:64]= merge_beat(line[127:64], beat_hi);
+                mem[line_addr] = line;
+            end
+
+            // return the read data in order;
+            if(rd_second_beat) begin
+                app_rd_data         <= rd_upper;
+                app_rd_data_valid   <= 1'b1;
+                app_rd_data_end     <= 1'b1;
+                rd_second_beat      <= 1'b0;
+            end
+            else if(rd_addr_q.size() > 0 && rd_due_q[0] <= ui_cycle) begin
+                void'(rd_due_q.pop_front());
+                line                = read_line(rd_addr_q.pop_front());
+                app_rd_data         <= line[63:0];
+                app_rd_data_valid   <= 1'b1;
+                rd_upper            <= line[127:64];
+                rd_second_beat      <= 1'b1;
+            end
+        end
+    end
+
+    /* ----- not used; */
+    assign app_sr_active    = 1'b0;
+    assign app_ref_ack      = 1'b0;
+    assign app_zq_ack       = 1'b0;
+
+    assign ddr2_addr    = 0;
+    assign ddr2_ba      = 0;
+    assign ddr2_cas_n   = 1'b1;
+    assign ddr2_ck_n    = 1'b1;
+    assign ddr2_ck_p    = 1'b0;
+    assign ddr2_cke     = 1'b0;
+    assign ddr2_ras_n   = 1'b1;
+    assign ddr2_we_n    = 1'b1;
+    assign ddr2_cs_n    = 1'b1;
+    assign ddr2_dm      = 0;
+    assign ddr2_odt     = 1'b0;
+
+endmodule
+
+`endif //_MIG_7SERIES_0_BEHAV_SV
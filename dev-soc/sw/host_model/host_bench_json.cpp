@@ -0,0 +1,198 @@
+#include "host_bench_json.h"
+#include "string.h"
+#include "stdlib.h"
+
+/* ------------------------------------------------
+* writer;
+--------------------------------------------------*/
+int host_bench_write_json(FILE *fp, const char *source, const bench_result_t *result, int result_num){
+    /*
+    @brief  : write the results as JSON; one case per line;
+    @param  :
+        fp          : output stream;
+        source      : producer of the figures, e.g. "host";
+        result      : results of bench_run_all();
+        result_num  : number of results;
+    @retval : 0 if OK; -1 on a write error;
+    */
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"source\": \"%s\",\n", source);
+    fprintf(fp, "  \"clk_freq_hz\": %u,\n", (uint32_t)SYS_CLK_FREQ_HZ);
+    fprintf(fp, "  \"cases\": [\n");
+    for(int i = 0; i < result_num; i++){
+        const bench_result_t *r = &result[i];
+        double op = r->op_cnt ? (double)r->op_cnt : 1.0;
+        double sec = (double)r->cycle/SYS_CLK_FREQ_HZ;
+
+        fprintf(fp, "    {\"name\": \"%s\", \"ops\": %u, \"byte_per_op\": %u, \"cycle\": %" PRIu64 ", \"access\": %" PRIu64
+                ", \"cycle_per_op\": %.2f, \"access_per_op\": %.2f, \"ops_per_sec\": %.1f, \"byte_per_sec\": %.1f}%s\n",
+                r->name, r->op_cnt, r->byte_per_op, r->cycle, r->access_cnt,
+                (double)r->cycle/op, (double)r->access_cnt/op,
+                sec ? r->op_cnt/sec : 0.0,
+                sec ? (double)r->op_cnt*r->byte_per_op/sec : 0.0,
+                (i + 1 < result_num) ? "," : "");
+    }
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+    return ferror(fp) ? -1 : 0;
+}
+
+/* ------------------------------------------------
+* reader;
+--------------------------------------------------*/
+static int json_get_uint(const char *line, const char *key, uint64_t *value){
+    /*
+    @brief  : value of "key": <number> within a line;
+    @retval : 0 if found; -1 otherwise;
+    */
+    char pattern[64];
+    const char *pos;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    pos = strstr(line, pattern);
+    if(pos == NULL){
+        return -1;
+    }
+    *value = strtoull(pos + strlen(pattern), NULL, 10);
+    return 0;
+}
+
+static int json_get_string(const char *line, const char *key, std::string &value){
+    /*
+    @brief  : value of "key": "<string>" within a line; no escapes;
+    @retval : 0 if found; -1 otherwise;
+    */
+    char pattern[64];
+    const char *start;
+    const char *end;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    start = strstr(line, pattern);
+    if(start == NULL){
+        return -1;
+    }
+    start = strchr(start + strlen(pattern), '"');
+    if(start == NULL){
+        return -1;
+    }
+    end = strchr(start + 1, '"');
+    if(end == NULL){
+        return -1;
+    }
+    value.assign(start + 1, end - start - 1);
+    return 0;
+}
+
+int host_bench_read_json(const char *path, std::vector<host_bench_entry> &entry){
+    /*
+    @brief  : read a result file;
+    @param  :
+        path    : file written by host_bench_write_json() or bench_print_json_uart();
+        entry   : (output) one per case, in file order;
+    @retval : 0 if OK; -1 if the file cannot be read or has no case;
+    @note   : a line is a case when it has a name and the raw figures;
+                access is optional (not counted on the board by default);
+    */
+    FILE *fp = fopen(path, "r");
+    char line[1024];
+
+    if(fp == NULL){
+        return -1;
+    }
+    entry.clear();
+    while(fgets(line, sizeof(line), fp)){
+        host_bench_entry e;
+        if(json_get_string(line, "name", e.name) != 0 ||
+            json_get_uint(line, "ops", &e.op_cnt) != 0 ||
+            json_get_uint(line, "byte_per_op", &e.byte_per_op) != 0 ||
+            json_get_uint(line, "cycle", &e.cycle) != 0){
+            continue;
+        }
+        if(json_get_uint(line, "access", &e.access_cnt) != 0){
+            e.access_cnt = 0;
+        }
+        entry.push_back(e);
+    }
+    fclose(fp);
+    return entry.empty() ? -1 : 0;
+}
+
+/* ------------------------------------------------
+* compare;
+--------------------------------------------------*/
+static double per_op(uint64_t total, uint64_t op_cnt){
+    return op_cnt ? (double)total/op_cnt : 0.0;
+}
+
+static double change_pct(double before, double after){
+    if(before == 0.0){
+        return (after == 0.0) ? 0.0 : 100.0;
+    }
+    return (after - before)*100.0/before;
+}
+
+int host_bench_compare(const std::vector<host_bench_entry> &baseline, const std::vector<host_bench_entry> &result,
+                        double threshold_pct, FILE *fp){
+    /*
+    @brief  : flag the cases that regress against a baseline;
+    @param  :
+        baseline        : reference figures (checked in);
+        result          : figures of this run;
+        threshold_pct   : allowed growth of cycles/op and accesses/op;
+        fp              : one line per case;
+    @retval : number of regressions;
+    @note   : accesses/op is only compared when both sides counted them;
+    */
+    int regress_cnt = 0;
+    size_t i, j;
+
+    fprintf(fp, "%-28s %12s %12s %8s %10s %10s %8s  %s\n", "case", "cycle/op", "baseline", "change", "access/op", "baseline", "change", "status");
+    for(i = 0; i < baseline.size(); i++){
+        const host_bench_entry *b = &baseline[i];
+        const host_bench_entry *r = NULL;
+        double cycle_b, cycle_r, access_b, access_r, cycle_chg, access_chg;
+        int is_regress;
+
+        for(j = 0; j < result.size(); j++){
+            if(result[j].name == b->name){
+                r = &result[j];
+                break;
+            }
+        }
+        if(r == NULL){
+            fprintf(fp, "%-28s %12s %12.2f %8s %10s %10s %8s  %s\n", b->name.c_str(), "-", per_op(b->cycle, b->op_cnt), "-", "-", "-", "-", "MISSING");
+            regress_cnt++;
+            continue;
+        }
+
+        cycle_b = per_op(b->cycle, b->op_cnt);
+        cycle_r = per_op(r->cycle, r->op_cnt);
+        access_b = per_op(b->access_cnt, b->op_cnt);
+        access_r = per_op(r->access_cnt, r->op_cnt);
+        cycle_chg = change_pct(cycle_b, cycle_r);
+        access_chg = (b->access_cnt && r->access_cnt) ? change_pct(access_b, access_r) : 0.0;
+
+        is_regress = (cycle_chg > threshold_pct) || (access_chg > threshold_pct);
+        regress_cnt += is_regress;
+        fprintf(fp, "%-28s %12.2f %12.2f %+7.1f%% %10.2f %10.2f %+7.1f%%  %s\n",
+                b->name.c_str(), cycle_r, cycle_b, cycle_chg, access_r, access_b, access_chg,
+                is_regress ? "REGRESSION" : ((cycle_chg < -threshold_pct) ? "faster" : "ok"));
+    }
+
+    // new cases; no baseline yet;
+    for(j = 0; j < result.size(); j++){
+        int found = 0;
+        for(i = 0; i < baseline.size(); i++){
+            if(baseline[i].name == result[j].name){
+                found = 1;
+                break;
+            }
+        }
+        if(!found){
+            fprintf(fp, "%-28s %12.2f %12s %8s %10.2f %10s %8s  %s\n", result[j].name.c_str(),
+                    per_op(result[j].cycle, result[j].op_cnt), "-", "-", per_op(result[j].access_cnt, result[j].op_cnt), "-", "-", "new");
+        }
+    }
+    fprintf(fp, "threshold %.1f%%: %d regression(s)\n", threshold_pct, regress_cnt);
+    return regress_cnt;
+}
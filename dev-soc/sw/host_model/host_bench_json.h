@@ -0,0 +1,64 @@
+#ifndef _HOST_BENCH_JSON_H
+#define _HOST_BENCH_JSON_H
+
+/* ---------------------------------------------
+Purpose: machine readable benchmark results and the regression check;
+1. a result file is JSON; one case per line:
+    {"name": "lcd.write_pixel", "ops": 1000, "byte_per_op": 2, "cycle": 66000, "access": 8000, ...}
+    name, ops, byte_per_op, cycle and access are the raw figures;
+    the host adds the derived figures (per op, per second) for reading;
+2. the same file comes from the host (host_bench json) or from the board
+    (bench_print_json_uart() in test_driver/bench_util.h; raw figures only);
+3. compare: a case regresses when its cycles per op or its register
+    accesses per op grow beyond the threshold against the baseline;
+    a case missing from the result is a regression as well;
+    a new case is reported, not flagged;
+
+@note: the reader only takes what the writers here produce
+    (one case object per line); it is not a general JSON parser;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "bench_util.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+#include <string>
+#include <vector>
+
+// one case as read back;
+struct host_bench_entry{
+    std::string name;
+    uint64_t op_cnt;
+    uint64_t byte_per_op;
+    uint64_t cycle;
+    uint64_t access_cnt;    // 0 if not counted;
+};
+
+/* write the results; source names the producer (e.g. "host");
+retval 0 if OK; -1 on a write error;
+*/
+int host_bench_write_json(FILE *fp, const char *source, const bench_result_t *result, int result_num);
+
+/* read a result file;
+retval 0 if OK; -1 if the file cannot be read or has no case;
+*/
+int host_bench_read_json(const char *path, std::vector<host_bench_entry> &entry);
+
+/* compare a result against a baseline; one line per case to fp;
+threshold_pct: allowed growth of cycles/op and accesses/op in percent;
+retval: number of regressions;
+*/
+int host_bench_compare(const std::vector<host_bench_entry> &baseline, const std::vector<host_bench_entry> &result,
+                        double threshold_pct, FILE *fp);
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_HOST_BENCH_JSON_H
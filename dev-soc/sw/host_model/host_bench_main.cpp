@@ -0,0 +1,202 @@
+/* ---------------------------------------------
+Purpose: driver microbenchmark on the host models;
+1. the suite is test_driver/bench_util.h; the board runs the same cases;
+2. time is the modelled bus time; see host_bus_timing;
+3. one line per hot path: ops/s, register accesses per op and bytes/s;
+4. the results can be written as JSON and checked against a baseline;
+    see host_bench_json.h;
+5. the table alone is followed by the DDR2 plane placement; the motion detector
+    planes back to back in one bank against planes dealt over the banks (ddr2_arena);
+    with the row hit rate of the DDR2 model; see memtest_planes_cpu();
+6. usage:
+    host_bench                                      : the table
+    host_bench json <out|->                         : the table and the JSON results
+    host_bench compare <baseline> [threshold %]     : run and check against the baseline
+    host_bench diff <baseline> <result> [threshold %]: check a result file (e.g. from the board)
+    exit code: 0 OK; 1 regression; 2 usage or file error;
+---------------------------------------------*/
+
+#include "main.h"
+#include "bench_util.h"
+#include "host_bus.h"
+#include "host_core_model.h"
+#include "host_bench_json.h"
+#include "host_mig_model.h"
+#include "memtest_util.h"
+#include "ddr2_arena.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+/* global instance of the cores not covered by the device directive */
+core_spi obj_spi(GET_MMIO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, S5_SPI));
+video_core_mig_interface vid_mig(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, V5_MIG_INTERFACE));
+video_core_dma vid_dma(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, V6_DMA));
+
+// from user_util.cpp;
+extern core_uart sys_uart;
+
+enum{
+    BENCH_RESULT_MAX = 32,
+    PLACE_PLANE_NUM = 3         // frame, mean, variance;
+};
+
+#define BENCH_THRESHOLD_PCT     5.0     // default allowed growth per case;
+
+static int usage(void){
+    fprintf(stderr, "usage: host_bench\n");
+    fprintf(stderr, "       host_bench json <out|->\n");
+    fprintf(stderr, "       host_bench compare <baseline> [threshold %%]\n");
+    fprintf(stderr, "       host_bench diff <baseline> <result> [threshold %%]\n");
+    return 2;
+}
+
+static int compare_file(const char *baseline_path, std::vector<host_bench_entry> &result, double threshold_pct){
+    std::vector<host_bench_entry> baseline;
+
+    if(host_bench_read_json(baseline_path, baseline) != 0){
+        fprintf(stderr, "%s: cannot read the baseline\n", baseline_path);
+        return 2;
+    }
+    printf("\n---- against %s ----\n", baseline_path);
+    return host_bench_compare(baseline, result, threshold_pct, stdout) ? 1 : 0;
+}
+
+static void place_print(const memtest_plane_t *r, const host_mig_stat *from, const host_mig_stat *to){
+    uint64_t hit = to->row_hit_cnt - from->row_hit_cnt;
+    uint64_t all = hit + (to->row_empty_cnt - from->row_empty_cnt) + (to->row_conflict_cnt - from->row_conflict_cnt);
+
+    printf("%-28s %12" PRIu64 " %10.2f %10.1f%%\n",
+            r->name, r->cycle,
+            (double)memtest_get_byte_per_sec(r->byte, r->cycle)/1e6,
+            all ? 100.0*hit/all : 0.0);
+}
+
+static void place_report(host_bus &bus){
+    /*
+    @brief  : the same plane streams with the planes in one bank and in separate banks;
+    @param  : bus; for the DDR2 model statistics;
+    @retval : none
+    @note   : naive: back to back from line 0 (bank 0); apart: ddr2_arena::alloc_apart();
+    */
+    host_mig_model *mig = (host_mig_model *)bus.get_video_core(V5_MIG_INTERFACE);
+    ddr2_arena arena(DDR2_ARENA_BASE);
+    ddr2_region_t region[PLACE_PLANE_NUM];
+    uint32_t naive[PLACE_PLANE_NUM];
+    uint32_t apart[PLACE_PLANE_NUM];
+    memtest_plane_t r[2][2];
+    host_mig_stat from;
+    host_mig_stat to;
+    int k;
+
+    for(k = 0; k < PLACE_PLANE_NUM; k++){
+        naive[k] = k*DDR2_ARENA_PLANE_LINE_NUM;
+        if(arena.alloc_apart(&region[k], 240, 320, DDR2_ARENA_FMT_Y8, region, k) != 0){
+            printf("placement: no plane left\n");
+            return;
+        }
+        apart[k] = region[k].addr;
+    }
+
+    printf("\n---- ddr2 plane placement; %d planes of %d lines ----\n", PLACE_PLANE_NUM, DDR2_ARENA_PLANE_LINE_NUM);
+    printf("%-28s %12s %10s %11s\n", "case", "cycles", "MB/s", "row hit");
+    for(k = 0; k < 2; k++){
+        const uint32_t *plane = k ? apart : naive;
+
+        from = mig->get_stat();
+        memtest_planes_cpu(&vid_mig, plane, PLACE_PLANE_NUM, DDR2_ARENA_PLANE_LINE_NUM, k ? "cpu.planes_apart" : "cpu.planes_one_bank", &r[0][k]);
+        to = mig->get_stat();
+        place_print(&r[0][k], &from, &to);
+
+        from = to;
+        memtest_planes_dma(&vid_mig, &vid_dma, plane, DDR2_ARENA_PLANE_LINE_NUM, k ? "dma.planes_apart" : "dma.planes_one_bank", &r[1][k]);
+        to = mig->get_stat();
+        place_print(&r[1][k], &from, &to);
+    }
+    for(k = 0; k < 2; k++){
+        printf("%s gain: %+.1f%%\n", k ? "dma" : "cpu", 100.0*((double)r[k][0].cycle/r[k][1].cycle - 1.0));
+    }
+    for(k = PLACE_PLANE_NUM - 1; k >= 0; k--){
+        arena.release(&region[k]);
+    }
+}
+
+int main(int argc, char **argv){
+    host_bus &bus = host_bus_get();
+    lcd_ili9341_sw_driver obj_lcd;
+    bench_target_t target;
+    bench_result_t result[BENCH_RESULT_MAX];
+    int result_num;
+    std::vector<host_bench_entry> entry;
+    FILE *fp;
+
+    // no run needed to check a result file;
+    if((argc >= 4) && (strcmp(argv[1], "diff") == 0)){
+        if(host_bench_read_json(argv[3], entry) != 0){
+            fprintf(stderr, "%s: cannot read the result\n", argv[3]);
+            return 2;
+        }
+        return compare_file(argv[2], entry, (argc > 4) ? atof(argv[4]) : BENCH_THRESHOLD_PCT);
+    }
+    if((argc > 1) && strcmp(argv[1], "json") && strcmp(argv[1], "compare")){
+        return usage();
+    }
+    if((argc > 1) && (argc < 3)){
+        return usage();
+    }
+
+    // keep the report readable;
+    ((host_uart_model *)bus.get_mmio_core(S1_UART_DEBUG))->set_stream(NULL);
+
+    // preconditions; see bench_util.h;
+    obj_lcd.init();
+    while(!vid_mig.is_mig_init_complete()){};
+
+    target.lcd = &obj_lcd;
+    target.mig = &vid_mig;
+    target.dma = &vid_dma;
+    target.spi = &obj_spi;
+    target.uart = &sys_uart;
+    result_num = bench_run_all(&target, result, BENCH_RESULT_MAX);
+
+    printf("%-28s %8s %12s %14s %10s %14s %12s\n", "case", "ops", "cycles", "ops/s", "access/op", "bytes/s", "us/op");
+    for(int i = 0; i < result_num; i++){
+        bench_result_t *r = &result[i];
+        double sec = (double)r->cycle/SYS_CLK_FREQ_HZ;
+
+        printf("%-28s %8u %12" PRIu64 " %14.1f %10.2f %14.1f %12.3f\n",
+                r->name, r->op_cnt, r->cycle,
+                r->op_cnt/sec,
+                (double)r->access_cnt/r->op_cnt,
+                (double)r->op_cnt*r->byte_per_op/sec,
+                sec*1e6/r->op_cnt);
+    }
+
+    if((argc > 2) && (strcmp(argv[1], "json") == 0)){
+        fp = strcmp(argv[2], "-") ? fopen(argv[2], "w") : stdout;
+        if(fp == NULL){
+            fprintf(stderr, "%s: cannot open\n", argv[2]);
+            return 2;
+        }
+        host_bench_write_json(fp, "host", result, result_num);
+        if(fp != stdout){
+            fclose(fp);
+        }
+        return 0;
+    }
+
+    if((argc > 2) && (strcmp(argv[1], "compare") == 0)){
+        for(int i = 0; i < result_num; i++){
+            host_bench_entry e;
+            e.name = result[i].name;
+            e.op_cnt = result[i].op_cnt;
+            e.byte_per_op = result[i].byte_per_op;
+            e.cycle = result[i].cycle;
+            e.access_cnt = result[i].access_cnt;
+            entry.push_back(e);
+        }
+        return compare_file(argv[2], entry, (argc > 3) ? atof(argv[3]) : BENCH_THRESHOLD_PCT);
+    }
+    place_report(bus);
+    return 0;
+}
@@ -0,0 +1,431 @@
+#include "host_bus.h"
+#include "host_core_model.h"
+#include "host_mig_model.h"
+#include "host_i2c_model.h"
+#include "host_dcmi_model.h"
+#include "host_dma_model.h"
+#include "host_trace.h"
+#include "io_reg_util.h"
+
+/* entry points for REG_READ() and REG_WRITE(); */
+uint32_t host_bus_read(uint32_t base_addr, uint32_t offset){
+    return host_bus_get().read(base_addr, offset);
+}
+
+void host_bus_write(uint32_t base_addr, uint32_t offset, uint32_t wr_data){
+    host_bus_get().write(base_addr, offset, wr_data);
+}
+
+host_bus &host_bus_get(void){
+    /*
+    @brief  : the bus instance the drivers talk to;
+    @param  : none
+    @retval : the bus;
+    @note   : function-local static so that the bus is constructed
+                before the first REG_WRITE() of any global driver object;
+    */
+    static host_bus bus;
+    return bus;
+}
+
+/* class definition; */
+host_bus::host_bus(){
+    /*
+    @brief  : construct the bus with the default soc;
+    @param  : none
+    @retval : none
+    @note   : the slot assignment follows io_map.h;
+    */
+    int i;
+
+    // every slot starts as a plain register file;
+    // a bus access to an unused slot is harmless on the hw as well;
+    for(i = 0; i < TOTAL_MMIO_SLOT; i++){
+        mmio_core[i] = new host_reg_file_model("mmio_unused");
+        default_core.push_back(mmio_core[i]);
+    }
+    for(i = 0; i < TOTAL_VIDEO_SLOT; i++){
+        video_core[i] = new host_reg_file_model("video_unused");
+        default_core.push_back(video_core[i]);
+    }
+
+    // mmio system;
+    mmio_core[S0_SYS_TIMER]     = new host_timer_model(this);
+    mmio_core[S1_UART_DEBUG]    = new host_uart_model();
+    mmio_core[S2_GPO_LED]       = new host_reg_file_model("gpo_led");
+    mmio_core[S3_GPI_SW]        = new host_reg_file_model("gpi_sw");
+    mmio_core[S4_GPIO_PORT]     = new host_reg_file_model("gpio_port");
+    mmio_core[S5_SPI]           = new host_spi_model();
+    mmio_core[S6_I2C_MASTER]    = new host_i2c_model(this);
+    for(i = S0_SYS_TIMER; i <= S6_I2C_MASTER; i++){
+        default_core.push_back(mmio_core[i]);
+    }
+
+    // video system;
+    video_core[V0_DISP_LCD]                 = new host_lcd_model(this);
+    video_core[V1_DISP_TEST_PATTERN]        = new host_reg_file_model("test_pattern");
+    video_core[V2_DISP_SRC_MUX]             = new host_reg_file_model("src_mux");
+    video_core[V3_CAM_DCMI_IF]              = new host_dcmi_model(this);
+    video_core[V4_PIXEL_COLOUR_CONVERTER]   = new host_reg_file_model("pixel_converter");
+    video_core[V5_MIG_INTERFACE]            = new host_mig_model(this);
+    video_core[V6_DMA]                      = new host_dma_model(this);
+    for(i = V0_DISP_LCD; i <= V6_DMA; i++){
+        default_core.push_back(video_core[i]);
+    }
+
+    // default timing; see host_bus.h;
+    timing.rd_handshake = 3;
+    timing.wr_handshake = 2;
+    timing.sw_access    = 6;
+    timing.sw_poll      = 4;
+
+    cycle = 0;
+    trace = NULL;
+    for(i = 0; i < 3; i++){
+        history[i] = TOTAL_REG_SLOT*2;  // matches nothing;
+        wait_history[i] = TOTAL_REG_SLOT*2;
+    }
+    clear_count();
+}
+
+host_bus::~host_bus(){
+    for(size_t i = 0; i < default_core.size(); i++){
+        delete default_core[i];
+    }
+}
+
+host_core_model *host_bus::decode(uint32_t byte_addr, host_bus_count **slot_count, uint32_t *reg_offset, uint32_t *reg_slot){
+    /*
+    @brief  : decode a byte address into the core model and register offset;
+    @param  :
+        byte_addr   : address as issued by the cpu;
+        slot_count  : (output) counter of the decoded slot;
+        reg_offset  : (output) register offset within the core;
+        reg_slot    : (output) unique index of the register across both systems;
+    @retval : the core model; NULL if the address is outside the user space;
+    @note   : mirrors mcs_bus_bridge.sv + mmio_ctrl.sv + video_ctrl.sv;
+    */
+    uint32_t word_addr;
+    int slot;
+
+    // bridge_en;
+    if((byte_addr & BUS_BASE_MASK) != (BUS_MICROBLAZE_IO_BASE_ADDR_G & BUS_BASE_MASK)){
+        return NULL;
+    }
+
+    // word alignment;
+    word_addr = byte_addr >> 2;
+    *reg_offset = word_addr & REG_OFFSET_MASK;
+
+    // system select;
+    if(byte_addr & USER_VIDEO_BYTE_SELECT_BIT){
+        slot = (word_addr >> CORE_BIT_POS) & VIDEO_CORE_MASK;
+        *slot_count = &video_count[slot];
+        *reg_slot = (TOTAL_MMIO_SLOT + slot)*TOTAL_VIDEO_REG_NUM + *reg_offset;
+        return video_core[slot];
+    }
+    slot = (word_addr >> CORE_BIT_POS) & MMIO_CORE_MASK;
+    *slot_count = &mmio_count[slot];
+    *reg_slot = slot*TOTAL_VIDEO_REG_NUM + *reg_offset;
+    return mmio_core[slot];
+}
+
+void host_bus::charge(host_bus_count *count, int is_write, int is_poll, uint32_t handshake){
+    /*
+    @brief  : charge one access to a counter;
+    @param  :
+        count       : counter of a slot or a probe;
+        is_write    : 1 for write; 0 for read;
+        is_poll     : 1 if the read is a spin-poll iteration;
+        handshake   : handshake cycles of the access;
+    @retval : none
+    */
+    if(is_write){
+        count->wr_cnt++;
+    }else{
+        count->rd_cnt++;
+    }
+
+    if(is_poll){
+        count->poll_cnt++;
+        count->poll_cycle += handshake + timing.sw_poll;
+    }else{
+        count->io_cycle += handshake;
+        count->sw_cycle += timing.sw_access;
+    }
+}
+
+int host_bus::is_poll_read(const uint32_t *hist, uint32_t reg_slot){
+    /*
+    @brief  : is this read a spin-poll iteration?
+    @param  :
+        hist        : history or wait_history;
+        reg_slot    : register being read;
+    @retval : 1 if so; 0 otherwise;
+    @note   :
+        1. history holds the register index of a read
+            and the index offset by TOTAL_REG_SLOT for a write;
+            so that a read never matches a write;
+        2. period one : R(a), R(a);
+        3. period two : R(a), R(b), R(a), R(b);
+        4. the system timer reads are seen in history only;
+            e.g. R(a), R(t), R(t), R(a) is period one for a;
+            so that the timing of a is the same in a trace without the timer;
+    */
+    if(reg_slot == hist[0]){
+        return 1;
+    }
+    if((hist[0] < TOTAL_REG_SLOT) && (reg_slot == hist[1]) && (hist[0] == hist[2])){
+        return 1;
+    }
+    return 0;
+}
+
+void host_bus::push_history(uint32_t *hist, uint32_t key){
+    hist[2] = hist[1];
+    hist[1] = hist[0];
+    hist[0] = key;
+}
+
+uint32_t host_bus::read(uint32_t base_addr, uint32_t offset){
+    /*
+    @brief  : one bus read transaction;
+    @param  : base_addr, offset as given to REG_READ();
+    @retval : read data; zero if the address is not decoded;
+    @note   : the time advances before the core samples the read;
+    */
+    host_bus_count *slot_count;
+    uint32_t reg_offset;
+    uint32_t reg_slot;
+    host_core_model *core;
+    uint64_t issue = cycle;
+    uint32_t rd_data;
+    int is_poll;
+
+    core = decode(base_addr + REG_WORD_BYTE*offset, &slot_count, &reg_offset, &reg_slot);
+    if(core == NULL){
+        bad_access_cnt++;
+        cycle += timing.rd_handshake + timing.sw_access;
+        return 0;
+    }
+
+    // spin-poll detection;
+    if(core == mmio_core[S0_SYS_TIMER]){
+        is_poll = is_poll_read(history, reg_slot);
+    }else{
+        is_poll = is_poll_read(wait_history, reg_slot);
+        push_history(wait_history, reg_slot);
+    }
+    push_history(history, reg_slot);
+
+    cycle += timing.rd_handshake + (is_poll ? timing.sw_poll : timing.sw_access);
+    charge(slot_count, 0, is_poll, timing.rd_handshake);
+    for(size_t i = 0; i < probe_stack.size(); i++){
+        charge(probe_stack[i], 0, is_poll, timing.rd_handshake);
+    }
+    rd_data = core->read(reg_offset);
+    if(trace){
+        trace->record(issue, base_addr, offset, 0, rd_data);
+    }
+    return rd_data;
+}
+
+void host_bus::write(uint32_t base_addr, uint32_t offset, uint32_t wr_data){
+    /*
+    @brief  : one bus write transaction;
+    @param  : base_addr, offset, wr_data as given to REG_WRITE();
+    @retval : none
+    @note   : a write outside the user space is dropped;
+    */
+    host_bus_count *slot_count;
+    uint32_t reg_offset;
+    uint32_t reg_slot;
+    host_core_model *core;
+    uint64_t issue = cycle;
+
+    cycle += timing.wr_handshake + timing.sw_access;
+
+    core = decode(base_addr + REG_WORD_BYTE*offset, &slot_count, &reg_offset, &reg_slot);
+    if(core == NULL){
+        bad_access_cnt++;
+        return;
+    }
+    push_history(history, TOTAL_REG_SLOT + reg_slot);
+    push_history(wait_history, TOTAL_REG_SLOT + reg_slot);
+    charge(slot_count, 1, 0, timing.wr_handshake);
+    for(size_t i = 0; i < probe_stack.size(); i++){
+        charge(probe_stack[i], 1, 0, timing.wr_handshake);
+    }
+    core->write(reg_offset, wr_data);
+    if(trace){
+        trace->record(issue, base_addr, offset, 1, wr_data);
+    }
+}
+
+void host_bus::attach_mmio_core(int slot, host_core_model *model){
+    mmio_core[slot & MMIO_CORE_MASK] = model;
+}
+
+void host_bus::attach_video_core(int slot, host_core_model *model){
+    video_core[slot & VIDEO_CORE_MASK] = model;
+}
+
+host_core_model *host_bus::get_mmio_core(int slot){
+    return mmio_core[slot & MMIO_CORE_MASK];
+}
+
+host_core_model *host_bus::get_video_core(int slot){
+    return video_core[slot & VIDEO_CORE_MASK];
+}
+
+uint64_t host_bus::get_cycle(void){
+    /*
+    @brief  : modelled time;
+    @param  : none
+    @retval : elapsed system clock cycles;
+    @note   : each bus transaction advances the time by its cost;
+    */
+    return cycle;
+}
+
+void host_bus::set_timing(host_bus_timing usr_timing){
+    timing = usr_timing;
+}
+
+host_bus_timing host_bus::get_timing(void){
+    return timing;
+}
+
+void host_bus::advance_to(uint64_t at_cycle){
+    /*
+    @brief  : move the modelled time forward, as if the cpu were busy elsewhere;
+    @param  : at_cycle - the new time; ignored if in the past;
+    @retval : none
+    */
+    if(at_cycle > cycle){
+        cycle = at_cycle;
+    }
+}
+
+void host_bus::set_trace(host_trace_writer *writer){
+    trace = writer;
+}
+
+void host_bus::probe_enter(const char *label){
+    host_bus_count *entry = &probe_count[label];
+    entry->call_cnt++;
+    probe_stack.push_back(entry);
+}
+
+void host_bus::probe_exit(void){
+    if(!probe_stack.empty()){
+        probe_stack.pop_back();
+    }
+}
+
+host_bus_count host_bus::get_mmio_count(int slot){
+    return mmio_count[slot & MMIO_CORE_MASK];
+}
+
+host_bus_count host_bus::get_video_count(int slot){
+    return video_count[slot & VIDEO_CORE_MASK];
+}
+
+host_bus_count host_bus::get_probe_count(const char *label){
+    /*
+    @brief  : counters of a probe;
+    @param  : label as given to probe_enter();
+    @retval : counters; all zero if the probe has never been entered;
+    */
+    host_bus_count zero = {0, 0, 0, 0, 0, 0, 0};
+    std::map<std::string, host_bus_count>::iterator it = probe_count.find(label);
+    if(it == probe_count.end()){
+        return zero;
+    }
+    return it->second;
+}
+
+uint64_t host_bus::get_total_access(void){
+    uint64_t total = 0;
+    int i;
+    for(i = 0; i < TOTAL_MMIO_SLOT; i++){
+        total += mmio_count[i].rd_cnt + mmio_count[i].wr_cnt;
+    }
+    for(i = 0; i < TOTAL_VIDEO_SLOT; i++){
+        total += video_count[i].rd_cnt + video_count[i].wr_cnt;
+    }
+    return total;
+}
+
+void host_bus::clear_count(void){
+    /*
+    @brief  : reset all the counters;
+    @param  : none
+    @retval : none
+    @note   : the modelled time is not reset;
+                probes currently entered are dropped;
+    */
+    host_bus_count zero = {0, 0, 0, 0, 0, 0, 0};
+    int i;
+    for(i = 0; i < TOTAL_MMIO_SLOT; i++){
+        mmio_count[i] = zero;
+    }
+    for(i = 0; i < TOTAL_VIDEO_SLOT; i++){
+        video_count[i] = zero;
+    }
+    probe_stack.clear();
+    probe_count.clear();
+    bad_access_cnt = 0;
+}
+
+void host_bus::report(FILE *fp){
+    /*
+    @brief  : print the counters and the cycle breakdown;
+    @param  : fp - output stream;
+    @retval : none
+    @note   : slots without any access are skipped;
+                time is estimated at SYS_CLK_FREQ_MHZ;
+    */
+    int i;
+
+    fprintf(fp, "%-8s %-4s %-20s %12s %12s %12s\n", "system", "slot", "core", "reads", "writes", "polls");
+    for(i = 0; i < TOTAL_MMIO_SLOT; i++){
+        if(mmio_count[i].rd_cnt + mmio_count[i].wr_cnt){
+            fprintf(fp, "%-8s %-4d %-20s %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n", "mmio", i, mmio_core[i]->get_name(),
+                mmio_count[i].rd_cnt, mmio_count[i].wr_cnt, mmio_count[i].poll_cnt);
+        }
+    }
+    for(i = 0; i < TOTAL_VIDEO_SLOT; i++){
+        if(video_count[i].rd_cnt + video_count[i].wr_cnt){
+            fprintf(fp, "%-8s %-4d %-20s %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n", "video", i, video_core[i]->get_name(),
+                video_count[i].rd_cnt, video_count[i].wr_cnt, video_count[i].poll_cnt);
+        }
+    }
+    if(bad_access_cnt){
+        fprintf(fp, "access outside the user address space: %" PRIu64 "\n", bad_access_cnt);
+    }
+
+    if(probe_count.empty()){
+        return;
+    }
+    fprintf(fp, "\n%-28s %8s %10s %10s %10s %12s %12s %12s %12s %12s\n", "probe", "calls", "reads", "writes", "polls",
+        "io_cycle", "sw_cycle", "poll_cycle", "cycle/call", "time(us)");
+    for(std::map<std::string, host_bus_count>::iterator it = probe_count.begin(); it != probe_count.end(); ++it){
+        host_bus_count *c = &it->second;
+        uint64_t total = c->io_cycle + c->sw_cycle + c->poll_cycle;
+        fprintf(fp, "%-28s %8" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12.1f %12.1f\n",
+            it->first.c_str(), c->call_cnt, c->rd_cnt, c->wr_cnt, c->poll_cnt,
+            c->io_cycle, c->sw_cycle, c->poll_cycle,
+            c->call_cnt ? (double)total/c->call_cnt : 0.0,
+            (double)total/SYS_CLK_FREQ_MHZ);
+    }
+}
+
+/* probe scope guard */
+host_bus_probe::host_bus_probe(const char *label){
+    host_bus_get().probe_enter(label);
+}
+
+host_bus_probe::~host_bus_probe(){
+    host_bus_get().probe_exit();
+}
@@ -0,0 +1,195 @@
+#ifndef _HOST_BUS_H
+#define _HOST_BUS_H
+
+/* ---------------------------------------------
+Purpose: host (linux) backend of the MCS IO bus;
+1. selected at compile time with _HOST_MODEL; see io_reg_util.h;
+2. every REG_READ()/REG_WRITE() of the drivers lands here;
+3. the address is decoded as mcs_bus_bridge.sv, mmio_ctrl.sv
+    and video_ctrl.sv do, then routed to the register model
+    attached to the decoded core slot;
+4. reads and writes are counted per core slot and per probe
+    (a named scope around a driver call);
+5. each access advances the modelled time by its cycle cost;
+    see host_bus_timing below;
+6. every access can be recorded into a trace file; see host_trace.h;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "io_map.h"
+#include "io_reg_util.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+/* entry points for REG_READ() and REG_WRITE(); */
+uint32_t host_bus_read(uint32_t base_addr, uint32_t offset);
+void host_bus_write(uint32_t base_addr, uint32_t offset, uint32_t wr_data);
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#include <map>
+#include <string>
+#include <vector>
+
+class host_core_model;  // forward declaration;
+class host_trace_writer;
+
+/*-------------------------------------------------------
+* cycle cost of the MCS IO bus (system clock cycles, 100MHz);
+*
+* construction (mcs_bus_bridge.sv, mmio_ctrl.sv, video_ctrl.sv):
+* 1. the bridge and both controllers are pure decode logic;
+* 2. io_ready is tied HIGH, so every IO_addr_strobe completes
+*       in the minimum MCS IO module handshake;
+* 3. the rest of the cost is on the cpu side: the load/store itself,
+*       the address arithmetic and the driver method call around it;
+*
+* an access is either:
+* 1. a plain access: handshake + sw overhead;
+* 2. a spin-poll iteration: handshake + loop overhead (compare and branch);
+*       detected as a read that repeats the read just before it
+*       (e.g. while(!is_ready()){}) or that repeats a pair of reads
+*       issued alternately (e.g. the 64-bit timer in delay_busy_us());
+*       the system timer reads between are not counted for the other cores;
+*       a wait which looks at the timer now and then is still a spin-poll;
+*
+* the defaults are estimates; calibrate against core_timer on the board;
+-------------------------------------------------------*/
+struct host_bus_timing{
+    uint32_t rd_handshake;  // IO_addr_strobe/IO_read_strobe to IO_ready, read data latched;
+    uint32_t wr_handshake;  // IO_addr_strobe/IO_write_strobe to IO_ready;
+    uint32_t sw_access;     // cpu cycles around a plain access;
+    uint32_t sw_poll;       // cpu cycles of one spin-poll loop iteration;
+};
+
+// access count and cycle breakdown;
+struct host_bus_count{
+    uint64_t rd_cnt;        // number of REG_READ();
+    uint64_t wr_cnt;        // number of REG_WRITE();
+    uint64_t call_cnt;      // number of times a probe is entered; unused for core slots;
+
+    uint64_t poll_cnt;      // number of spin-poll iterations (subset of rd_cnt);
+    uint64_t io_cycle;      // handshake of the plain accesses;
+    uint64_t sw_cycle;      // cpu overhead of the plain accesses;
+    uint64_t poll_cycle;    // handshake + loop overhead of the spin-poll iterations;
+};
+
+class host_bus{
+    // address decoding; see io_map.h;
+    enum{
+        SYS_MMIO    = 0,
+        SYS_VIDEO   = 1,
+
+        BUS_BASE_MASK       = 0xFF000000,       // bridge_en compares the 8 MSB only;
+        TOTAL_REG_SLOT      = (MIMO_CORE_TOTAL_G + VIDEO_CORE_TOTAL_G)*TOTAL_VIDEO_REG_NUM,
+        REG_OFFSET_MASK     = 0xF,              // 4-bit register offset;
+        MMIO_CORE_MASK      = 0x1F,             // 32 mmio cores;
+        VIDEO_CORE_MASK     = 0xF,              // 16 video cores;
+        CORE_BIT_POS        = REG_ADDR_SIZE_G   // core field starts after the register offset (word address);
+    };
+
+    public:
+        enum{
+            TOTAL_MMIO_SLOT     = MIMO_CORE_TOTAL_G,
+            TOTAL_VIDEO_SLOT    = VIDEO_CORE_TOTAL_G
+        };
+
+        host_bus();
+        ~host_bus();
+
+        /* bus transaction */
+        uint32_t read(uint32_t base_addr, uint32_t offset);
+        void write(uint32_t base_addr, uint32_t offset, uint32_t wr_data);
+
+        /* replace the register model of a core slot;
+        the bus does not take the ownership of the model;
+        */
+        void attach_mmio_core(int slot, host_core_model *model);
+        void attach_video_core(int slot, host_core_model *model);
+        host_core_model *get_mmio_core(int slot);
+        host_core_model *get_video_core(int slot);
+
+        /* modelled time in system clock cycles (100MHz) */
+        uint64_t get_cycle(void);
+        void set_timing(host_bus_timing usr_timing);
+        host_bus_timing get_timing(void);
+        void advance_to(uint64_t at_cycle);     // forward only; for a trace replay;
+
+        /* record every access from now on; NULL to stop;
+        the bus does not take the ownership of the writer;
+        */
+        void set_trace(host_trace_writer *writer);
+
+        /* per driver call counting;
+        counts are inclusive, i.e. a nested probe is also
+        charged to all the enclosing probes;
+        */
+        void probe_enter(const char *label);
+        void probe_exit(void);
+
+        /* counters */
+        host_bus_count get_mmio_count(int slot);
+        host_bus_count get_video_count(int slot);
+        host_bus_count get_probe_count(const char *label);
+        uint64_t get_total_access(void);
+        void clear_count(void);
+        void report(FILE *fp);
+
+    private:
+        host_core_model *decode(uint32_t byte_addr, host_bus_count **slot_count, uint32_t *reg_offset, uint32_t *reg_slot);
+        void charge(host_bus_count *count, int is_write, int is_poll, uint32_t cost);
+
+        // default soc; one model per slot;
+        std::vector<host_core_model *> default_core;
+        host_core_model *mmio_core[TOTAL_MMIO_SLOT];
+        host_core_model *video_core[TOTAL_VIDEO_SLOT];
+
+        // counters;
+        host_bus_count mmio_count[TOTAL_MMIO_SLOT];
+        host_bus_count video_count[TOTAL_VIDEO_SLOT];
+        std::map<std::string, host_bus_count> probe_count;
+        std::vector<host_bus_count *> probe_stack;
+        uint64_t bad_access_cnt;    // outside the user address space;
+
+        // timing;
+        uint64_t cycle;
+        host_bus_timing timing;
+
+        host_trace_writer *trace;
+
+        // spin-poll detection;
+        // the last three accesses; see is_poll_read();
+        // wait_history leaves out the system timer reads (a bounded wait);
+        int is_poll_read(const uint32_t *hist, uint32_t reg_slot);
+        void push_history(uint32_t *hist, uint32_t key);
+        uint32_t history[3];
+        uint32_t wait_history[3];
+};
+
+/* the bus instance the drivers talk to;
+constructed on first use, so that it is ready for
+the drivers instantiated as global objects;
+*/
+host_bus &host_bus_get(void);
+
+/* scope guard for the per driver call counting;
+usage:
+    {
+        host_bus_probe probe("lcd.write_pixel");
+        obj_lcd.write_pixel(colour);
+    }
+*/
+class host_bus_probe{
+    public:
+        host_bus_probe(const char *label);
+        ~host_bus_probe();
+};
+
+#endif //_HOST_BUS_H
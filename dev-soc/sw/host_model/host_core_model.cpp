@@ -0,0 +1,254 @@
+#include "host_core_model.h"
+#include "host_bus.h"
+
+/*-------------------------------------------------------
+* base class;
+-------------------------------------------------------*/
+host_core_model::host_core_model(const char *core_name){
+    name = core_name;
+}
+
+host_core_model::~host_core_model(){}
+
+const char *host_core_model::get_name(void){
+    return name;
+}
+
+/*-------------------------------------------------------
+* plain register file;
+-------------------------------------------------------*/
+host_reg_file_model::host_reg_file_model(const char *core_name) : host_core_model(core_name){
+    for(int i = 0; i < TOTAL_VIDEO_REG_NUM; i++){
+        reg[i] = 0;
+    }
+}
+
+host_reg_file_model::~host_reg_file_model(){}
+
+uint32_t host_reg_file_model::read(uint32_t reg_offset){
+    return reg[reg_offset];
+}
+
+void host_reg_file_model::write(uint32_t reg_offset, uint32_t wr_data){
+    reg[reg_offset] = wr_data;
+}
+
+/*-------------------------------------------------------
+* S0_SYS_TIMER;
+-------------------------------------------------------*/
+host_timer_model::host_timer_model(host_bus *bus) : host_core_model("sys_timer"){
+    this->bus = bus;
+    ctrl = 0;
+    count = 0;
+    last_cycle = 0;
+}
+
+host_timer_model::~host_timer_model(){}
+
+void host_timer_model::update(void){
+    /*
+    @brief  : advance the counter to the current bus cycle;
+    @param  : none
+    @retval : none
+    @note   : clear supersedes go; as in core_timer.sv;
+    */
+    uint64_t now = bus->get_cycle();
+    if(ctrl & CTRL_CLEAR_MASK){
+        count = 0;
+    }
+    else if(ctrl & CTRL_GO_MASK){
+        count += (now - last_cycle);
+    }
+    last_cycle = now;
+}
+
+uint32_t host_timer_model::read(uint32_t reg_offset){
+    update();
+    switch(reg_offset){
+        case REG_CNTLOW_OFFSET:
+            return (uint32_t)count;
+        case REG_CNTHIGH_OFFSET:
+            return (uint32_t)(count >> 32);
+        default:
+            return 0;
+    }
+}
+
+void host_timer_model::write(uint32_t reg_offset, uint32_t wr_data){
+    update();
+    if(reg_offset == REG_CTRL_OFFSET){
+        ctrl = wr_data;
+        // clear takes effect at once;
+        update();
+    }
+}
+
+/*-------------------------------------------------------
+* S1_UART_DEBUG;
+-------------------------------------------------------*/
+host_uart_model::host_uart_model() : host_core_model("uart_debug"){
+    tx_stream = stdout;
+    tx_byte_count = 0;
+}
+
+host_uart_model::~host_uart_model(){}
+
+uint32_t host_uart_model::read(uint32_t reg_offset){
+    // rx fifo is always empty; tx fifo is never full;
+    if(reg_offset == REG_STATUS_OFFSET){
+        return STATUS_RX_EMPTY_MASK;
+    }
+    return 0;
+}
+
+void host_uart_model::write(uint32_t reg_offset, uint32_t wr_data){
+    if(reg_offset != REG_TX_WRITE_OFFSET){
+        return;
+    }
+    tx_byte_count++;
+    if(tx_stream){
+        fputc((int)(wr_data & 0xFF), tx_stream);
+    }
+}
+
+void host_uart_model::set_stream(FILE *stream){
+    tx_stream = stream;
+}
+
+uint64_t host_uart_model::get_tx_byte_count(void){
+    return tx_byte_count;
+}
+
+/*-------------------------------------------------------
+* S5_SPI;
+-------------------------------------------------------*/
+host_spi_model::host_spi_model() : host_reg_file_model("spi"){}
+
+host_spi_model::~host_spi_model(){}
+
+uint32_t host_spi_model::read(uint32_t reg_offset){
+    switch(reg_offset){
+        case S5_SPI_REG_STATUS_OFFSET:
+            return BIT_MASK(S5_SPI_REG_STATUS_BIT_POS_READY);
+        case S5_SPI_REG_MISO_RD_OFFSET:
+            return reg[S5_SPI_REG_MOSI_WR_OFFSET] & 0xFF;
+        default:
+            return reg[reg_offset];
+    }
+}
+
+/*-------------------------------------------------------
+* V0_DISP_LCD;
+-------------------------------------------------------*/
+host_lcd_model::host_lcd_model(host_bus *bus) : host_reg_file_model("lcd_display"){
+    this->bus = bus;
+    busy_until = 0;
+    rd_byte = 0;
+    repeat_cnt = 0;
+}
+
+host_lcd_model::~host_lcd_model(){}
+
+uint64_t host_lcd_model::get_period(uint32_t clockmod){
+    // each half counts from 0 to its modulus inclusive;
+    // plus one cycle in ST_IDLE to accept the command;
+    return (uint64_t)(clockmod & 0xFFFF) + 1 + (uint64_t)(clockmod >> CLKMOD_SHALF_BIT_POS) + 1 + 1;
+}
+
+void host_lcd_model::start(uint64_t at_cycle){
+    /*
+    @brief  : ST_IDLE takes the command in the write register;
+    @param  : bus cycle at which it is taken;
+    @retval : none
+    @note   : the panel sees the byte only if the chip is selected (CSX register 1)
+                and the cpu has the control (stream control register 0);
+    @note   : DCX register 1 drives DCX LOW, i.e. a command byte;
+    */
+    uint32_t wr = reg[V0_DISP_LCD_REG_WR_DATA_OFFSET];
+    uint32_t cmd = (wr >> CMD_BIT_POS) & CMD_MASK;
+    int to_panel = (reg[V0_DISP_LCD_REG_CSX_OFFSET] & 0x1) && !(reg[V0_DISP_LCD_REG_STREAM_CTRL_OFFSET] & 0x1);
+
+    if(cmd == CMD_WR){
+        busy_until = at_cycle + get_period(reg[V0_DISP_LCD_REG_WR_CLOCKMOD_OFFSET]);
+        if(to_panel){
+            panel.write(!(reg[V0_DISP_LCD_REG_DCX_OFFSET] & 0x1), (uint8_t)(wr & 0xFF));
+        }
+    }
+    else if(cmd == CMD_RD){
+        busy_until = at_cycle + get_period(reg[V0_DISP_LCD_REG_RD_CLOCKMOD_OFFSET]);
+        rd_byte = to_panel ? panel.read() : 0;
+    }
+}
+
+void host_lcd_model::update(void){
+    /*
+    @brief  : to replay the commands taken again up to the current bus cycle;
+    @param  : none
+    @retval : none
+    */
+    uint64_t now = bus->get_cycle();
+    uint32_t cmd = (reg[V0_DISP_LCD_REG_WR_DATA_OFFSET] >> CMD_BIT_POS) & CMD_MASK;
+
+    while(cmd != CMD_NOP && busy_until <= now){
+        repeat_cnt++;
+        start(busy_until);
+    }
+}
+
+uint32_t host_lcd_model::read(uint32_t reg_offset){
+    uint32_t status;
+
+    update();
+    if(reg_offset == V0_DISP_LCD_REG_RD_DATA_OFFSET){
+        status = rd_byte;
+        if(bus->get_cycle() >= busy_until){
+            status |= BIT_MASK(V0_DISP_LCD_REG_STATUS_BIT_POS_READY) | BIT_MASK(V0_DISP_LCD_REG_STATUS_BIT_POS_DONE);
+        }
+        return status;
+    }
+    return 0;
+}
+
+void host_lcd_model::write(uint32_t reg_offset, uint32_t wr_data){
+    uint32_t cmd;
+
+    update();
+    reg[reg_offset] = wr_data;
+    if(reg_offset != V0_DISP_LCD_REG_WR_DATA_OFFSET){
+        return;
+    }
+
+    // taken at once if idle; otherwise when the controller returns to idle;
+    cmd = (wr_data >> CMD_BIT_POS) & CMD_MASK;
+    if(cmd != CMD_NOP && bus->get_cycle() >= busy_until){
+        start(bus->get_cycle());
+    }
+}
+
+host_ili9341_model *host_lcd_model::get_panel(void){
+    return &panel;
+}
+
+uint64_t host_lcd_model::get_repeat_count(void){
+    return repeat_cnt;
+}
+
+uint64_t host_lcd_model::get_wr_period(void){
+    return get_period(reg[V0_DISP_LCD_REG_WR_CLOCKMOD_OFFSET]);
+}
+
+int host_lcd_model::stream_byte(uint8_t data){
+    /*
+    @brief  : a byte of the video stream (lcd fifo);
+    @param  : pixel byte;
+    @retval : 0 if taken; -1 if the cpu has the control, i.e. the stream is held;
+    @note   : the panel sees it as data (DCX HIGH) if the chip is selected;
+    */
+    if(!(reg[V0_DISP_LCD_REG_STREAM_CTRL_OFFSET] & 0x1)){
+        return -1;
+    }
+    if(reg[V0_DISP_LCD_REG_CSX_OFFSET] & 0x1){
+        panel.write(1, data);
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+#ifndef _HOST_CORE_MODEL_H
+#define _HOST_CORE_MODEL_H
+
+/* ---------------------------------------------
+Purpose: host register models of the IO cores;
+1. each model stands in for one core slot of mmio_sys.sv or video_sys.sv;
+2. a model only sees the decoded register offset (4-bit),
+    exactly as the core does behind mmio_ctrl.sv / video_ctrl.sv;
+3. the models here are the default "SoC" the host bus is built with;
+    richer device models could replace them via host_bus::attach_mmio_core()
+    and host_bus::attach_video_core(); see host_mig_model.h for the DDR2
+    host_i2c_model.h for the i2c master and the camera
+    host_dcmi_model.h for the camera dcmi path
+    and host_dma_model.h for the dma;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "io_map.h"
+#include "io_reg_util.h"
+#include "host_ili9341_model.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+class host_bus;     // forward declaration;
+
+/*-------------------------------------------------------
+* base class of all the core models;
+* read() and write() are called once per bus transaction;
+-------------------------------------------------------*/
+class host_core_model{
+    public:
+        host_core_model(const char *core_name);
+        virtual ~host_core_model();
+
+        virtual uint32_t read(uint32_t reg_offset) = 0;
+        virtual void write(uint32_t reg_offset, uint32_t wr_data) = 0;
+
+        const char *get_name(void);
+
+    private:
+        const char *name;   // for reporting;
+};
+
+/*-------------------------------------------------------
+* plain register file;
+* whatever is written could be read back;
+* used for the cores without side effects (gpo, src mux etc)
+* and for the unused slots;
+-------------------------------------------------------*/
+class host_reg_file_model : public host_core_model{
+    public:
+        host_reg_file_model(const char *core_name);
+        ~host_reg_file_model();
+
+        uint32_t read(uint32_t reg_offset);
+        void write(uint32_t reg_offset, uint32_t wr_data);
+
+    protected:
+        uint32_t reg[TOTAL_VIDEO_REG_NUM];
+};
+
+/*-------------------------------------------------------
+* S0_SYS_TIMER: core_timer.sv;
+* the counter follows the cycle count of the host bus;
+* so that delay_busy_us() terminates in modelled time;
+-------------------------------------------------------*/
+class host_timer_model : public host_core_model{
+    enum{
+        REG_CNTLOW_OFFSET   = 0,
+        REG_CNTHIGH_OFFSET  = 1,
+        REG_CTRL_OFFSET     = 2,
+
+        CTRL_GO_MASK        = BIT_MASK(0),
+        CTRL_CLEAR_MASK     = BIT_MASK(1)
+    };
+
+    public:
+        host_timer_model(host_bus *bus);
+        ~host_timer_model();
+
+        uint32_t read(uint32_t reg_offset);
+        void write(uint32_t reg_offset, uint32_t wr_data);
+
+    private:
+        void update(void);
+
+        host_bus *bus;
+        uint32_t ctrl;
+        uint64_t count;
+        uint64_t last_cycle;    // bus cycle at the last update;
+};
+
+/*-------------------------------------------------------
+* S1_UART_DEBUG: core_uart.sv;
+* tx fifo never fills up; rx fifo is always empty;
+* transmitted bytes go to a host stream (stdout by default);
+-------------------------------------------------------*/
+class host_uart_model : public host_core_model{
+    enum{
+        REG_STATUS_OFFSET       = S1_UART_REG_STATUS_OFFSET,
+        REG_TX_WRITE_OFFSET     = S1_UART_REG_TX_WRITE_REQUEST_OFFSET,
+        REG_RX_DATA_OFFSET      = S1_UART_REG_RX_READ_DATA_OFFSET,
+
+        STATUS_RX_EMPTY_MASK    = BIT_MASK(S1_UART_REG_STATUS_BIT_POS_RX_EMPTY)
+    };
+
+    public:
+        host_uart_model();
+        ~host_uart_model();
+
+        uint32_t read(uint32_t reg_offset);
+        void write(uint32_t reg_offset, uint32_t wr_data);
+
+        void set_stream(FILE *stream);  // NULL to discard;
+        uint64_t get_tx_byte_count(void);
+
+    private:
+        FILE *tx_stream;
+        uint64_t tx_byte_count;
+};
+
+/*-------------------------------------------------------
+* S5_SPI: core_spi.sv;
+* always ready; miso loops back the last mosi byte;
+-------------------------------------------------------*/
+class host_spi_model : public host_reg_file_model{
+    public:
+        host_spi_model();
+        ~host_spi_model();
+
+        uint32_t read(uint32_t reg_offset);
+};
+
+/*-------------------------------------------------------
+* V0_DISP_LCD: core_video_lcd_display.sv;
+* lcd_8080_interface_controller.sv takes a command whenever it is idle
+* and the command field of the write register is not NOP;
+* so a command still held when the WRX (RDX) period ends is taken again;
+* the driver writes NOP right after, as on the hw;
+*
+* each WRX (RDX) cycle is one byte to (from) the ILI9341 panel model,
+* provided the chip is selected and the cpu has the control;
+*
+* in the stream mode the pixel bytes of the video stream reach the panel
+* as data through stream_byte(); the caller does the timing;
+-------------------------------------------------------*/
+class host_lcd_model : public host_reg_file_model{
+    enum{
+        CMD_BIT_POS     = 8,
+        CMD_MASK        = 0x3,
+        CMD_NOP         = 0,
+        CMD_WR          = 1,
+        CMD_RD          = 2,
+        CLKMOD_SHALF_BIT_POS = 16
+    };
+
+    public:
+        host_lcd_model(host_bus *bus);
+        ~host_lcd_model();
+
+        uint32_t read(uint32_t reg_offset);
+        void write(uint32_t reg_offset, uint32_t wr_data);
+
+        host_ili9341_model *get_panel(void);
+        uint64_t get_repeat_count(void);    // commands taken again as they were held;
+        uint64_t get_wr_period(void);       // WRX period in system clock cycles; see host_dcmi_model.h;
+        int stream_byte(uint8_t data);      // 0 if taken; -1 if the cpu has the control;
+
+    private:
+        uint64_t get_period(uint32_t clockmod);
+        void update(void);
+        void start(uint64_t at_cycle);
+
+        host_bus *bus;
+        host_ili9341_model panel;
+        uint64_t busy_until;    // bus cycle at which the controller returns to idle;
+        uint8_t rd_byte;        // rd_data_reg;
+        uint64_t repeat_cnt;
+};
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_HOST_CORE_MODEL_H
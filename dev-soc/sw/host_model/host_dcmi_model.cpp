@@ -0,0 +1,649 @@
+#include "host_dcmi_model.h"
+#include "host_bus.h"
+#include "host_dma_model.h"
+
+// no event scheduled;
+#define HOST_DCMI_NEVER     UINT64_MAX
+
+/*-------------------------------------------------------
+* frame timing presets;
+-------------------------------------------------------*/
+host_dcmi_config host_dcmi_emulator_timing(void){
+    /*
+    @brief  : dcmi_emulator.sv with its default parameters;
+    @param  : none
+    @retval : the timing;
+    @note   : the emulator restarts a frame one PCLK cycle after
+                it returns to ST_IDLE, as long as start is held;
+    */
+    host_dcmi_config timing;
+
+    timing.pclk_khz     = 25000;    // PCLK_MOD = 4;
+    timing.vsync_low    = 10;
+    timing.buffer_start = 7;
+    timing.href_byte    = 640;
+    timing.href_low     = 5;
+    timing.href_total   = 240;
+    timing.buffer_end   = 5;
+    timing.frame_gap    = 1;
+    timing.sink_period  = 0;
+    return timing;
+}
+
+host_dcmi_config host_dcmi_ov7670_timing(uint32_t pclk_khz){
+    /*
+    @brief  : OV7670 QVGA output as configured by ov7670_set_QVGA_size();
+    @param  : pclk_khz, the PCLK after the COM14 divider;
+    @retval : the timing;
+    @note   : VGA frame timing of the datasheet (tline = 784 tp, 510 tline per frame)
+                with tp = one (divided) PCLK cycle;
+                QVGA keeps every second line; 640 bytes each;
+    */
+    host_dcmi_config timing;
+
+    timing.pclk_khz     = pclk_khz;
+    timing.vsync_low    = 3*784;
+    timing.buffer_start = 17*784;
+    timing.href_byte    = 640;
+    timing.href_low     = 2*784 - 640;
+    timing.href_total   = 240;
+    timing.buffer_end   = 10*784;
+    timing.frame_gap    = 0;
+    timing.sink_period  = 0;
+    return timing;
+}
+
+/*-------------------------------------------------------
+* V3_CAM_DCMI_IF;
+-------------------------------------------------------*/
+host_dcmi_model::host_dcmi_model(host_bus *bus) : host_core_model("cam_dcmi_if"){
+    /*
+    @brief  : constructor;
+    @param  : the bus the model is attached to; the source of time;
+    @retval : none
+    @note   : nothing is taken by the sink until set_config() says so;
+    */
+    this->bus = bus;
+    sys_period_ps = 1000000 / SYS_CLK_FREQ_MHZ;
+
+    config = host_dcmi_emulator_timing();
+    pclk_period_ps = 1000000000ULL / config.pclk_khz;
+    pclk_edge_ps = pclk_period_ps;
+    src_pos = 0;
+
+    ctrl_reg = 0;
+    dec_state = ST_IDLE;
+    vsync_prev = 0;
+    href_cnt = 0;
+    frame_cnt = 0;
+    frame_dropped = 0;
+    start_tick_ps = HOST_DCMI_NEVER;
+    end_tick_ps = HOST_DCMI_NEVER;
+
+    // the reset system runs once after the system reset;
+    rst_hold = 0;
+    rst_ready_ps = (FIFO_RST_HIGH + FIFO_RST_LOW)*pclk_period_ps + 4*sys_period_ps;
+
+    last_rd_ps = 0;
+    dma = NULL;
+    dma_sink = DMA_SINK_OFF;
+    fifo_reset(0);
+    clear_stat();
+}
+
+host_dcmi_model::~host_dcmi_model(){}
+
+void host_dcmi_model::set_config(host_dcmi_config usr_config){
+    /*
+    @brief  : to change the frame timing, the PCLK and the sink rate;
+    @param  : configuration; see host_dcmi_model.h;
+    @retval : none
+    @note   : the source restarts from the beginning of a frame;
+    */
+    uint64_t now_ps;
+
+    update();
+    now_ps = bus->get_cycle()*sys_period_ps;
+
+    config = usr_config;
+    if(config.pclk_khz == 0){
+        config.pclk_khz = 25000;
+    }
+    pclk_period_ps = 1000000000ULL / config.pclk_khz;
+    pclk_edge_ps = now_ps + pclk_period_ps;
+    src_pos = 0;
+
+    // the sink picks up the new rate at its next byte;
+    if(get_sink_period() == 0){
+        sink_wait = 1;
+        sink_edge_ps = HOST_DCMI_NEVER;
+    }
+    else if(!sink_wait){
+        sink_edge_ps = now_ps + get_sink_period()*sys_period_ps;
+    }
+    else if(wr_ptr != rd_ptr){
+        sink_wake(now_ps);
+    }
+}
+
+host_dcmi_config host_dcmi_model::get_config(void){
+    return config;
+}
+
+/*-------------------------------------------------------
+* frame source;
+-------------------------------------------------------*/
+uint64_t host_dcmi_model::get_frame_length(void){
+    return (uint64_t)config.vsync_low + config.buffer_start +
+            (uint64_t)config.href_total*(config.href_byte + config.href_low) +
+            config.buffer_end + config.frame_gap;
+}
+
+void host_dcmi_model::source(uint64_t pos, int *vsync, int *href, uint8_t *data){
+    /*
+    @brief  : the source output at a PCLK cycle of the frame;
+    @param  :
+        pos     : PCLK cycle within the frame;
+        vsync, href, data: output;
+    @retval : none
+    @note   : the data byte is the byte index within the frame (lower 8 bits);
+    */
+    uint64_t line_len = (uint64_t)config.href_byte + config.href_low;
+    uint64_t line;
+    uint64_t col;
+
+    *vsync = 1;
+    *href = 0;
+    *data = 0;
+
+    if(pos < config.vsync_low){
+        *vsync = 0;
+        return;
+    }
+    pos -= config.vsync_low;
+    if(pos < config.buffer_start){
+        return;
+    }
+    pos -= config.buffer_start;
+    if(pos < config.href_total*line_len){
+        line = pos / line_len;
+        col = pos % line_len;
+        if(col < config.href_byte){
+            *href = 1;
+            *data = (uint8_t)(line*config.href_byte + col);
+        }
+    }
+}
+
+/*-------------------------------------------------------
+* clock domains;
+-------------------------------------------------------*/
+int host_dcmi_model::is_rst_ready(uint64_t at_ps){
+    // FIFO_rst_ready;
+    return !rst_hold && at_ps >= rst_ready_ps;
+}
+
+void host_dcmi_model::fifo_reset(uint64_t at_ps){
+    // RST clears the pointers and the flags; not the memory;
+    wr_ptr = 0;
+    rd_ptr = 0;
+    hist_clear(&wr_hist);
+    hist_clear(&rd_hist);
+    hist_push(&wr_hist, at_ps, 0);
+    hist_push(&rd_hist, at_ps, 0);
+    sink_wait = 1;
+    sink_edge_ps = HOST_DCMI_NEVER;
+}
+
+void host_dcmi_model::sink_wake(uint64_t at_ps){
+    /*
+    @brief  : the sink sees a byte written at at_ps;
+    @param  : at_ps, time of the write;
+    @retval : none
+    @note   : EMPTY deasserts SYNC_STAGE system clock cycles later;
+                the sink keeps its rate;
+    */
+    uint64_t edge_ps;
+
+    if(!sink_wait || get_sink_period() == 0){
+        return;
+    }
+    edge_ps = at_ps + SYNC_STAGE*sys_period_ps;
+    edge_ps = ((edge_ps + sys_period_ps - 1) / sys_period_ps)*sys_period_ps;
+    if(edge_ps < last_rd_ps + get_sink_period()*sys_period_ps){
+        edge_ps = last_rd_ps + get_sink_period()*sys_period_ps;
+    }
+    sink_edge_ps = edge_ps;
+    sink_wait = 0;
+}
+
+uint32_t host_dcmi_model::get_sink_period(void){
+    // system clock cycles per byte taken; 0: nothing taken;
+    switch(dma_sink){
+        case DMA_SINK_TAKE:
+            return 1;
+        case DMA_SINK_PAUSE:
+            return 0;
+        default:
+            return config.sink_period;
+    }
+}
+
+void host_dcmi_model::pclk_edge(void){
+    /*
+    @brief  : one PCLK rising edge; dcmi_decoder.sv and the fifo write side;
+    @param  : none
+    @retval : none
+    */
+    uint64_t t = pclk_edge_ps;
+    uint64_t rd_seen;
+    uint64_t fill;
+    int vsync, href;
+    uint8_t data;
+    int detect;
+    int rst_ready;
+    int afull, full;
+    int data_ready;
+    int sample_en;
+    int state_next;
+    uint32_t href_cnt_next;
+    uint32_t frame_cnt_next;
+
+    source(src_pos, &vsync, &href, &data);
+    rst_ready = is_rst_ready(t);
+
+    // rising_edge_detector;
+    detect = vsync && !vsync_prev;
+    vsync_prev = vsync;
+
+    // write side flags; the read pointer arrives late;
+    rd_seen = hist_at(&rd_hist, (t > SYNC_STAGE*pclk_period_ps) ? t - SYNC_STAGE*pclk_period_ps : 0);
+    fill = wr_ptr - rd_seen;
+    full = rst_ready && (fill >= FIFO_DEPTH);
+    afull = rst_ready && (fill >= FIFO_DEPTH - FIFO_AFULL_OFFSET);
+    if(afull){
+        stat.afull_pclk++;
+    }
+    data_ready = rst_ready && !afull;
+
+    // dcmi_decoder.sv;
+    state_next = dec_state;
+    href_cnt_next = href_cnt;
+    frame_cnt_next = frame_cnt;
+    sample_en = 0;
+    switch(dec_state){
+        case ST_IDLE:
+            if(rst_ready && (ctrl_reg & CTRL_START_MASK)){
+                state_next = ST_WAIT_VSYNC;
+            }
+            break;
+        case ST_WAIT_VSYNC:
+            if(detect){
+                href_cnt_next = 0;
+                state_next = ST_WAIT_HREF;
+                start_tick_ps = t;
+            }
+            break;
+        case ST_WAIT_HREF:
+            if(href){
+                sample_en = 1;
+                state_next = ST_CHECK_HREF;
+            }
+            break;
+        case ST_CHECK_HREF:
+            sample_en = 1;
+            if(!href){
+                state_next = ST_WAIT_HREF;
+                href_cnt_next = href_cnt + 1;
+                if(href_cnt == config.href_total - 1){
+                    frame_cnt_next = frame_cnt + 1;
+                    state_next = ST_IDLE;
+                    end_tick_ps = t;
+                    if(frame_dropped){
+                        stat.drop_frame_cnt++;
+                    }
+                }
+            }
+            break;
+        default:
+            break;
+    }
+
+    // the synchronous clear holds the whole FSM;
+    if(ctrl_reg & CTRL_FRAME_RST_MASK){
+        frame_cnt = 0;
+    }else{
+        if(dec_state == ST_WAIT_VSYNC && state_next == ST_WAIT_HREF){
+            frame_dropped = 0;
+        }
+        dec_state = state_next;
+        href_cnt = href_cnt_next;
+        frame_cnt = frame_cnt_next;
+    }
+
+    // data_valid = sample_en && href && data_ready;
+    // WREN = rst_ready && data_valid && !FULL && !WRERR;
+    if(sample_en && href && rst_ready){
+        stat.byte_cnt++;
+        if(!data_ready){
+            stat.drop_cnt++;
+            frame_dropped = 1;
+            if(stat.first_drop_cycle == 0){
+                stat.first_drop_cycle = t / sys_period_ps;
+            }
+        }
+        else if(!full){
+            mem[wr_ptr & FIFO_CNT_MASK] = data;
+            wr_ptr++;
+            hist_push(&wr_hist, t, wr_ptr);
+            stat.wr_cnt++;
+            if(fill + 1 > stat.max_fill){
+                stat.max_fill = (uint32_t)(fill + 1);
+            }
+            sink_wake(t);
+        }
+    }
+
+    // next;
+    src_pos++;
+    if(src_pos >= get_frame_length()){
+        src_pos = 0;
+        stat.frame_cnt++;
+    }
+    pclk_edge_ps += pclk_period_ps;
+}
+
+void host_dcmi_model::sink_edge(void){
+    /*
+    @brief  : the sink takes a byte; the fifo read side;
+    @param  : none
+    @retval : none
+    @note   : RDEN = rst_ready && sink_ready && !EMPTY && !RDERR;
+    @note   : the dma is told last; it may pause the sink;
+    */
+    uint64_t t = sink_edge_ps;
+    uint64_t wr_seen;
+    uint8_t data;
+
+    wr_seen = hist_at(&wr_hist, (t > SYNC_STAGE*sys_period_ps) ? t - SYNC_STAGE*sys_period_ps : 0);
+    if(!is_rst_ready(t) || wr_seen <= rd_ptr){
+        sink_wait = 1;
+        sink_edge_ps = HOST_DCMI_NEVER;
+        return;
+    }
+    data = mem[rd_ptr & FIFO_CNT_MASK];
+    rd_ptr++;
+    hist_push(&rd_hist, t, rd_ptr);
+    stat.rd_cnt++;
+    last_rd_ps = t;
+    sink_edge_ps = t + get_sink_period()*sys_period_ps;
+    if(dma_sink == DMA_SINK_TAKE && dma != NULL){
+        dma->dcmi_take(data, t);
+    }
+}
+
+int host_dcmi_model::can_skip(void){
+    // nothing is sampled and nothing is in flight;
+    return dec_state == ST_IDLE && !(ctrl_reg & CTRL_START_MASK) && wr_ptr == rd_ptr && sink_wait;
+}
+
+void host_dcmi_model::skip(uint64_t now_ps){
+    /*
+    @brief  : to run the source up to now_ps without stepping it;
+    @param  : now_ps
+    @retval : none
+    */
+    uint64_t frame_len = get_frame_length();
+    uint64_t edge_cnt;
+    int vsync, href;
+    uint8_t data;
+
+    if(pclk_edge_ps > now_ps || frame_len == 0){
+        return;
+    }
+    edge_cnt = (now_ps - pclk_edge_ps) / pclk_period_ps + 1;
+    stat.frame_cnt += (src_pos + edge_cnt) / frame_len;
+    source((src_pos + edge_cnt - 1) % frame_len, &vsync, &href, &data);
+    vsync_prev = vsync;
+    src_pos = (src_pos + edge_cnt) % frame_len;
+    pclk_edge_ps += edge_cnt*pclk_period_ps;
+    if(ctrl_reg & CTRL_FRAME_RST_MASK){
+        frame_cnt = 0;
+    }
+}
+
+void host_dcmi_model::update(void){
+    /*
+    @brief  : to run both clock domains up to the current bus cycle;
+    @param  : none
+    @retval : none
+    */
+    run_to(bus->get_cycle()*sys_period_ps);
+}
+
+void host_dcmi_model::run_to(uint64_t at_ps){
+    /*
+    @brief  : to run both clock domains up to the given time;
+    @param  : time; not behind the bus cycle of the last register access;
+    @retval : none
+    */
+    uint64_t now_ps = at_ps;
+
+    while(1){
+        if(can_skip()){
+            skip(now_ps);
+        }
+        if(pclk_edge_ps <= sink_edge_ps){
+            if(pclk_edge_ps > now_ps){
+                break;
+            }
+            pclk_edge();
+        }else{
+            if(sink_edge_ps > now_ps){
+                break;
+            }
+            sink_edge();
+        }
+    }
+}
+
+/*-------------------------------------------------------
+* dma;
+-------------------------------------------------------*/
+void host_dcmi_model::set_dma(host_dma_model *dma){
+    this->dma = dma;
+}
+
+void host_dcmi_model::set_dma_sink(int mode, uint64_t at_ps){
+    /*
+    @brief  : dcmi_active and dcmi_ready of the dma;
+    @param  :
+        1. mode     : DMA_SINK_*;
+        2. at_ps    : system clock edge from which it applies;
+    @retval : none
+    @note   : the sink keeps its rate limit from the last byte taken;
+    @note   : an empty fifo wakes the sink on the next write as before;
+    */
+    uint64_t edge_ps;
+
+    dma_sink = mode;
+    sink_wait = 1;
+    sink_edge_ps = HOST_DCMI_NEVER;
+    if(get_sink_period() == 0 || wr_ptr == rd_ptr){
+        return;
+    }
+    edge_ps = ((at_ps + sys_period_ps - 1) / sys_period_ps)*sys_period_ps;
+    if(edge_ps < last_rd_ps + get_sink_period()*sys_period_ps){
+        edge_ps = last_rd_ps + get_sink_period()*sys_period_ps;
+    }
+    sink_edge_ps = edge_ps;
+    sink_wait = 0;
+}
+
+/*-------------------------------------------------------
+* pointer history;
+-------------------------------------------------------*/
+void host_dcmi_model::hist_clear(ptr_hist *hist){
+    for(int i = 0; i < HIST_SIZE; i++){
+        hist->ps[i] = 0;
+        hist->cnt[i] = 0;
+    }
+    hist->head = 0;
+}
+
+void host_dcmi_model::hist_push(ptr_hist *hist, uint64_t at_ps, uint64_t cnt){
+    hist->head = (hist->head + 1) % HIST_SIZE;
+    hist->ps[hist->head] = at_ps;
+    hist->cnt[hist->head] = cnt;
+}
+
+uint64_t host_dcmi_model::hist_at(ptr_hist *hist, uint64_t at_ps){
+    /*
+    @brief  : the pointer as it was at at_ps;
+    @param  : hist, at_ps;
+    @retval : the latest count pushed at or before at_ps;
+                the oldest count kept if all are later;
+    */
+    int idx = hist->head;
+
+    for(int i = 0; i < HIST_SIZE - 1; i++){
+        if(hist->ps[idx] <= at_ps){
+            return hist->cnt[idx];
+        }
+        idx = (idx + HIST_SIZE - 1) % HIST_SIZE;
+    }
+    return hist->cnt[idx];
+}
+
+/*-------------------------------------------------------
+* register interface;
+-------------------------------------------------------*/
+uint32_t host_dcmi_model::read(uint32_t reg_offset){
+    uint64_t now_ps;
+    uint64_t wr_seen, rd_seen;
+    uint32_t rd_data = 0;
+    int rst_ready;
+
+    update();
+    now_ps = bus->get_cycle()*sys_period_ps;
+    rst_ready = is_rst_ready(now_ps);
+
+    switch(reg_offset){
+        case REG_CTRL_OFFSET:
+            return ctrl_reg;
+        case REG_DEC_STATUS_OFFSET:
+            // the ticks are one PCLK cycle wide; a slow poll misses them;
+            if(start_tick_ps != HOST_DCMI_NEVER && now_ps >= start_tick_ps && now_ps < start_tick_ps + pclk_period_ps){
+                rd_data |= BIT_MASK(V3_CAM_DCMI_IF_REG_DECODER_STATUS_BIT_POS_START);
+            }
+            if(end_tick_ps != HOST_DCMI_NEVER && now_ps >= end_tick_ps && now_ps < end_tick_ps + pclk_period_ps){
+                rd_data |= BIT_MASK(V3_CAM_DCMI_IF_REG_DECODER_STATUS_BIT_POS_END);
+            }
+            if(dec_state == ST_IDLE){
+                rd_data |= BIT_MASK(V3_CAM_DCMI_IF_REG_DECODER_STATUS_BIT_POS_READY);
+            }
+            return rd_data;
+        case REG_FRAME_OFFSET:
+            return frame_cnt;
+        case REG_FIFO_STATUS_OFFSET:
+            // RDERR and WRERR never set; RDEN and WREN are gated by EMPTY and FULL;
+            wr_seen = hist_at(&wr_hist, (now_ps > SYNC_STAGE*sys_period_ps) ? now_ps - SYNC_STAGE*sys_period_ps : 0);
+            rd_seen = hist_at(&rd_hist, (now_ps > SYNC_STAGE*pclk_period_ps) ? now_ps - SYNC_STAGE*pclk_period_ps : 0);
+            if(!rst_ready || wr_seen <= rd_ptr){
+                rd_data |= BIT_MASK(V3_CAM_DCMI_IF_REG_FIFO_STATUS_BIT_POS_EMPTY);
+            }
+            if(!rst_ready || wr_seen - rd_ptr <= FIFO_AEMPTY_OFFSET){
+                rd_data |= BIT_MASK(V3_CAM_DCMI_IF_REG_FIFO_STATUS_BIT_POS_AEMPTY);
+            }
+            if(rst_ready && wr_ptr - rd_seen >= FIFO_DEPTH){
+                rd_data |= BIT_MASK(V3_CAM_DCMI_IF_REG_FIFO_STATUS_BIT_POS_FULL);
+            }
+            if(rst_ready && wr_ptr - rd_seen >= FIFO_DEPTH - FIFO_AFULL_OFFSET){
+                rd_data |= BIT_MASK(V3_CAM_DCMI_IF_REG_FIFO_STATUS_BIT_POS_AFULL);
+            }
+            return rd_data;
+        case REG_FIFO_CNT_OFFSET:
+            // {5'b0, WRCOUNT, 5'b0, RDCOUNT};
+            return (uint32_t)((wr_ptr & FIFO_CNT_MASK) << 16) | (uint32_t)(rd_ptr & FIFO_CNT_MASK);
+        case REG_SYS_READY_OFFSET:
+            return (uint32_t)rst_ready;
+        default:
+            return 0;
+    }
+}
+
+void host_dcmi_model::write(uint32_t reg_offset, uint32_t wr_data){
+    uint64_t now_ps;
+    uint32_t prev;
+
+    // only the control register is writable;
+    if(reg_offset != REG_CTRL_OFFSET){
+        return;
+    }
+    update();
+    now_ps = bus->get_cycle()*sys_period_ps;
+    prev = ctrl_reg;
+    ctrl_reg = wr_data;
+
+    // the fifo reset bit holds the reset system;
+    // once released, RST_FIFO is HIGH for FIFO_RST_HIGH PCLK cycles,
+    // then LOW for FIFO_RST_LOW PCLK cycles, before the system is ready again;
+    if((ctrl_reg & CTRL_FIFO_RST_MASK) && !(prev & CTRL_FIFO_RST_MASK)){
+        rst_hold = 1;
+        fifo_reset(now_ps);
+    }
+    else if(!(ctrl_reg & CTRL_FIFO_RST_MASK) && (prev & CTRL_FIFO_RST_MASK)){
+        rst_hold = 0;
+        rst_ready_ps = now_ps + (FIFO_RST_HIGH + FIFO_RST_LOW)*pclk_period_ps + 4*sys_period_ps;
+        fifo_reset(now_ps);
+    }
+}
+
+/*-------------------------------------------------------
+* observation;
+-------------------------------------------------------*/
+uint32_t host_dcmi_model::get_fill(void){
+    update();
+    return (uint32_t)(wr_ptr - rd_ptr);
+}
+
+host_dcmi_stat host_dcmi_model::get_stat(void){
+    update();
+    return stat;
+}
+
+void host_dcmi_model::clear_stat(void){
+    stat.frame_cnt = 0;
+    stat.byte_cnt = 0;
+    stat.wr_cnt = 0;
+    stat.rd_cnt = 0;
+    stat.drop_cnt = 0;
+    stat.drop_frame_cnt = 0;
+    stat.afull_pclk = 0;
+    stat.max_fill = 0;
+    stat.first_drop_cycle = 0;
+}
+
+void host_dcmi_model::report(FILE *fp){
+    uint64_t frame_len = get_frame_length();
+    double line_rate;
+    double frame_rate;
+
+    update();
+    // bytes per us (MB/s): within HREF and averaged over the frame;
+    line_rate = (double)config.pclk_khz / 1000.0;
+    frame_rate = frame_len ? line_rate*config.href_byte*config.href_total/frame_len : 0.0;
+
+    fprintf(fp, "\n---- dcmi model (pclk %.3f MHz, frame %" PRIu64 " pclk, sink every %u cycles) ----\n",
+            line_rate, frame_len, config.sink_period);
+    fprintf(fp, "source rate     : %.3f MB/s in href, %.3f MB/s per frame\n", line_rate, frame_rate);
+    fprintf(fp, "sink rate       : %.3f MB/s\n",
+            config.sink_period ? (double)SYS_CLK_FREQ_MHZ/config.sink_period : 0.0);
+    fprintf(fp, "frames produced : %" PRIu64 ", decoded %u\n", stat.frame_cnt, frame_cnt);
+    fprintf(fp, "bytes sampled   : %" PRIu64 "\n", stat.byte_cnt);
+    fprintf(fp, "fifo write/read : %" PRIu64 " / %" PRIu64 " (max fill %u of %d)\n",
+            stat.wr_cnt, stat.rd_cnt, stat.max_fill, (int)FIFO_DEPTH);
+    fprintf(fp, "dropped         : %" PRIu64 " bytes in %" PRIu64 " frames (almost full %" PRIu64 " pclk)\n",
+            stat.drop_cnt, stat.drop_frame_cnt, stat.afull_pclk);
+    fprintf(fp, "wr_error        : never; WREN is gated by FULL\n");
+}
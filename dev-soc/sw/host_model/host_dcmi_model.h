@@ -0,0 +1,245 @@
+#ifndef _HOST_DCMI_MODEL_H
+#define _HOST_DCMI_MODEL_H
+
+/* ---------------------------------------------
+Purpose: model of the camera path into the video system;
+1. a DCMI frame source in the manner of dcmi_emulator.sv
+    (or of the OV7670 itself); PCLK, VSYNC, HREF and the data byte;
+2. V3_CAM_DCMI_IF: core_video_cam_dcmi_interface.sv; the register file,
+    dcmi_decoder.sv, FIFO_DUALCLOCK_MACRO_reset_system.sv and
+    the 2^11 x 8-bit dual-clock BRAM FIFO (FIFO_DUALCLOCK_MACRO, FWFT);
+3. the sink: the downstream stream interface (pixel converter, source mux,
+    lcd fifo and the lcd 8080 controller in stream mode) is reduced to
+    one byte taken every sink_period system clock cycles,
+    i.e. one WRX period of the lcd; see host_lcd_model::get_wr_period();
+4. or the dma (V6_DMA) while it runs a DCMI to DDR2 descriptor;
+    one byte per system clock cycle while it collects a line; see host_dma_model.h;
+
+Construction:
+1. the model is lazy; it is run up to the current bus cycle
+    whenever a register is accessed;
+2. the write side is stepped once per PCLK rising edge,
+    the read side once per byte taken by the sink;
+3. while the decoder is idle and the fifo is empty,
+    the frame source is skipped over arithmetically;
+4. the fifo flags see the pointer of the other clock domain
+    SYNC_STAGE clock cycles late (of the flag's own clock);
+
+Overflow (as the HW does it, reproduced, not fixed):
+1. FIFO WREN is gated by FULL and by WRERR;
+    dcmi_decoder data_valid is gated by data_ready = !ALMOSTFULL;
+2. so the fifo never sees a write while FULL; WRERR (wr_error) does not set;
+3. instead, the pixel bytes arriving while ALMOSTFULL is HIGH are
+    silently dropped by the decoder; see host_dcmi_stat::drop_cnt;
+    a single dropped byte swaps the byte order of every
+    RGB565 pixel after it in the frame;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "io_map.h"
+#include "io_reg_util.h"
+#include "host_core_model.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+class host_dma_model;   // forward declaration;
+
+/*-------------------------------------------------------
+* frame timing in PCLK cycles; the same fields as dcmi_emulator.sv;
+* one frame:
+*   VSYNC LOW for vsync_low;
+*   buffer_start;
+*   href_total x (HREF HIGH for href_byte, HREF LOW for href_low);
+*   buffer_end;
+*   frame_gap (VSYNC HIGH, idle);
+* the decoder starts a frame at the VSYNC rising edge;
+-------------------------------------------------------*/
+struct host_dcmi_config{
+    uint32_t pclk_khz;
+    uint32_t vsync_low;
+    uint32_t buffer_start;
+    uint32_t href_byte;         // bytes per line; 640 for QVGA RGB565;
+    uint32_t href_low;
+    uint32_t href_total;        // lines per frame; the decoder expects 240;
+    uint32_t buffer_end;
+    uint32_t frame_gap;
+    uint32_t sink_period;       // system clock cycles per byte taken; 0: nothing taken;
+};
+
+// dcmi_emulator.sv with its default parameters; 25MHz PCLK;
+host_dcmi_config host_dcmi_emulator_timing(void);
+
+// OV7670 QVGA (VGA scaled down; PCLK divided by 2); datasheet frame timing;
+host_dcmi_config host_dcmi_ov7670_timing(uint32_t pclk_khz);
+
+// event count;
+struct host_dcmi_stat{
+    uint64_t frame_cnt;         // frames produced by the source;
+    uint64_t byte_cnt;          // bytes sampled by the decoder (sample_en and HREF);
+    uint64_t wr_cnt;            // bytes written into the fifo;
+    uint64_t rd_cnt;            // bytes taken by the sink;
+    uint64_t drop_cnt;          // bytes sampled but dropped; ALMOSTFULL;
+    uint64_t drop_frame_cnt;    // decoded frames with at least a byte dropped;
+    uint64_t afull_pclk;        // PCLK cycles with ALMOSTFULL HIGH;
+    uint32_t max_fill;          // fifo occupancy; as seen by the write side;
+    uint64_t first_drop_cycle;  // bus cycle of the first drop; 0 if none;
+};
+
+/*-------------------------------------------------------
+* V3_CAM_DCMI_IF + frame source + sink;
+-------------------------------------------------------*/
+class host_dcmi_model : public host_core_model{
+    // register map and fields; see io_map.h;
+    enum{
+        REG_CTRL_OFFSET         = V3_CAM_DCMI_IF_REG_CTRL_OFFSET,
+        REG_DEC_STATUS_OFFSET   = V3_CAM_DCMI_IF_REG_DECODER_STATUS_OFFSET,
+        REG_FRAME_OFFSET        = V3_CAM_DCMI_IF_REG_FRAME_RD_OFFSET,
+        REG_FIFO_STATUS_OFFSET  = V3_CAM_DCMI_IF_REG_FIFO_STATUS_OFFSET,
+        REG_FIFO_CNT_OFFSET     = V3_CAM_DCMI_IF_REG_FIFO_CNT_OFFSET,
+        REG_SYS_READY_OFFSET    = V3_CAM_DCMI_IF_REG_SYS_READY_STATUS_OFFSET,
+
+        CTRL_START_MASK         = BIT_MASK(V3_CAM_DCMI_IF_REG_CTRL_BIT_POS_DEC_START),
+        CTRL_FRAME_RST_MASK     = BIT_MASK(V3_CAM_DCMI_IF_REG_CTRL_BIT_POS_DEC_FRAME_RST),
+        CTRL_FIFO_RST_MASK      = BIT_MASK(V3_CAM_DCMI_IF_REG_CTRL_BIT_POS_DEC_FIFO_RST)
+    };
+
+    // FIFO_DUALCLOCK_MACRO; 18Kb, 8-bit;
+    enum{
+        FIFO_DEPTH          = 2048,     // 2^11;
+        FIFO_CNT_MASK       = 0x7FF,    // RDCOUNT, WRCOUNT;
+        FIFO_AFULL_OFFSET   = 0x080,
+        FIFO_AEMPTY_OFFSET  = 0x080,
+        SYNC_STAGE          = 2,
+        HIST_SIZE           = 16
+    };
+
+    // FIFO_DUALCLOCK_MACRO_reset_system.sv; in PCLK cycles;
+    enum{
+        FIFO_RST_HIGH       = 8,
+        FIFO_RST_LOW        = 5
+    };
+
+    // dcmi_decoder.sv;
+    enum{
+        ST_IDLE = 0,
+        ST_WAIT_VSYNC,
+        ST_WAIT_HREF,
+        ST_CHECK_HREF
+    };
+
+    // pointer of one clock domain, as it was a while ago;
+    struct ptr_hist{
+        uint64_t ps[HIST_SIZE];
+        uint64_t cnt[HIST_SIZE];
+        int head;
+    };
+
+    public:
+        // sink of the fifo; see set_dma_sink();
+        enum{
+            DMA_SINK_OFF = 0,   // the downstream stream interface; sink_period;
+            DMA_SINK_PAUSE,     // the dma has the fifo; dcmi_ready LOW;
+            DMA_SINK_TAKE       // the dma has the fifo; one byte per system clock cycle;
+        };
+
+        host_dcmi_model(host_bus *bus);
+        ~host_dcmi_model();
+
+        uint32_t read(uint32_t reg_offset);
+        void write(uint32_t reg_offset, uint32_t wr_data);
+
+        /* configuration;
+        the source restarts from the beginning of a frame;
+        the fifo content is kept;
+        */
+        void set_config(host_dcmi_config usr_config);
+        host_dcmi_config get_config(void);
+
+        /* dma;
+        set_dma_sink() hands the fifo to the dma or back from the given time;
+        the bytes taken by the dma go to host_dma_model::dcmi_take();
+        run_to() advances the model up to the given time; for the models run in lock step;
+        */
+        void set_dma(host_dma_model *dma);
+        void set_dma_sink(int mode, uint64_t at_ps);
+        void run_to(uint64_t at_ps);
+
+        /* observation */
+        uint32_t get_fill(void);        // as seen by the write side;
+        host_dcmi_stat get_stat(void);
+        void clear_stat(void);
+        void report(FILE *fp);
+
+    private:
+        // frame source;
+        void source(uint64_t pos, int *vsync, int *href, uint8_t *data);
+        uint64_t get_frame_length(void);
+
+        // clock domains;
+        int is_rst_ready(uint64_t at_ps);
+        void pclk_edge(void);
+        void sink_edge(void);
+        int can_skip(void);
+        void skip(uint64_t now_ps);
+        void sink_wake(uint64_t at_ps);
+        uint32_t get_sink_period(void);
+        void update(void);
+        void fifo_reset(uint64_t at_ps);
+
+        void hist_clear(ptr_hist *hist);
+        void hist_push(ptr_hist *hist, uint64_t at_ps, uint64_t cnt);
+        uint64_t hist_at(ptr_hist *hist, uint64_t at_ps);
+
+        host_bus *bus;
+        host_dcmi_config config;
+        host_dcmi_stat stat;
+
+        // registers;
+        uint32_t ctrl_reg;
+
+        // time;
+        uint64_t sys_period_ps;
+        uint64_t pclk_period_ps;
+        uint64_t pclk_edge_ps;      // next PCLK rising edge;
+        uint64_t sink_edge_ps;      // next byte taken by the sink;
+        uint64_t last_rd_ps;
+
+        // frame source;
+        uint64_t src_pos;           // PCLK cycle within the frame;
+
+        // dcmi_decoder.sv;
+        int dec_state;
+        int vsync_prev;             // rising_edge_detector;
+        uint32_t href_cnt;
+        uint32_t frame_cnt;
+        int frame_dropped;
+        uint64_t start_tick_ps;     // the ticks last one PCLK cycle;
+        uint64_t end_tick_ps;
+
+        // fifo reset system;
+        int rst_hold;               // control bit HIGH;
+        uint64_t rst_ready_ps;
+
+        // fifo;
+        uint8_t mem[FIFO_DEPTH];
+        uint64_t wr_ptr;
+        uint64_t rd_ptr;
+        ptr_hist wr_hist;           // for the read side;
+        ptr_hist rd_hist;           // for the write side;
+        int sink_wait;              // the sink found the fifo empty;
+
+        // dma;
+        host_dma_model *dma;
+        int dma_sink;               // DMA_SINK_*;
+};
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_HOST_DCMI_MODEL_H
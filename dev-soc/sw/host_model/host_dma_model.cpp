@@ -0,0 +1,482 @@
+#include "host_dma_model.h"
+#include "host_bus.h"
+#include "host_mig_model.h"
+#include "host_dcmi_model.h"
+#include "string.h"
+
+host_dma_model::host_dma_model(host_bus *bus) : host_core_model("dma"){
+    /*
+    @brief  : constructor;
+    @param  : the bus the model is attached to; the source of time and of the other models;
+    @retval : none
+    @note   : the other models are taken when a chain starts;
+    */
+    int i;
+
+    this->bus = bus;
+    mig = NULL;
+    dcmi = NULL;
+    lcd = NULL;
+    sys_period_ps = 1000000 / SYS_CLK_FREQ_MHZ;
+
+    // the table is not reset on the hw;
+    for(i = 0; i < DESC_NUM; i++){
+        desc_src[i] = 0;
+        desc_dst[i] = 0;
+        desc_len[i] = 0;
+        desc_stride[i] = 0;
+    }
+    desc_sel_reg = 0;
+    chain_reg = 0;
+
+    state = ST_IDLE;
+    desc_idx = 0;
+    kind = 0;
+    line_num = 0;
+    line_left = 0;
+    row_left = 0;
+    src_stride = 0;
+    dst_stride = 0;
+    src_row = 0;
+    dst_row = 0;
+    src_ptr = 0;
+    dst_ptr = 0;
+    for(i = 0; i < LINE_WORD; i++){
+        line[i] = 0;
+    }
+    byte_idx = 0;
+
+    abort_reg = 0;
+    aborted_reg = 0;
+    error_reg = 0;
+    done_cnt_reg = 0;
+    line_cnt_reg = 0;
+
+    state_ps = 0;
+    start_ps = 0;
+    run_ps = 0;
+    idle_ps = 0;
+    lcd_drain_ps = 0;
+    lcd_hold = 0;
+    clear_stat();
+}
+
+host_dma_model::~host_dma_model(){}
+
+host_dma_stat host_dma_model::get_stat(void){
+    update();
+    return stat;
+}
+
+void host_dma_model::clear_stat(void){
+    memset(&stat, 0, sizeof(stat));
+}
+
+int host_dma_model::is_busy(void){
+    // the FSM may have finished ahead of the bus;
+    return state != ST_IDLE || bus->get_cycle()*sys_period_ps < idle_ps;
+}
+
+/*-------------------------------------------------------
+* FSM;
+-------------------------------------------------------*/
+void host_dma_model::enter(int next_state, uint64_t at_ps){
+    /*
+    @brief  : the FSM is in next_state from the system clock edge at_ps;
+    @param  :
+        1. next_state   : ST_*;
+        2. at_ps        : system clock edge;
+    @retval : none
+    @note   : the states which do not wait for an event run on at once;
+    @note   : an abort pending stops the states with no mig request in flight;
+    */
+    state = next_state;
+    state_ps = at_ps;
+    if(abort_reg && (state == ST_RD_REQ || state == ST_WR_REQ || state == ST_LCD || state == ST_DCMI)){
+        abort_stop(at_ps);
+        return;
+    }
+    switch(state){
+        case ST_IDLE:
+            stop(at_ps);
+            break;
+        case ST_LOAD:
+            load(at_ps);
+            break;
+        case ST_RD_REQ:
+        case ST_WR_REQ:
+            request(at_ps);
+            break;
+        case ST_LCD:
+            push_lcd(at_ps);
+            break;
+        case ST_DCMI:
+            // dcmi_ready; one byte per cycle;
+            dcmi->set_dma_sink(host_dcmi_model::DMA_SINK_TAKE, at_ps);
+            break;
+        case ST_NEXT:
+            next(at_ps);
+            break;
+        default:
+            // ST_RD_WAIT, ST_WR_WAIT: the complete pulse;
+            break;
+    }
+}
+
+void host_dma_model::load(uint64_t at_ps){
+    // ST_LOAD; take the descriptor from the table;
+    uint32_t len = desc_len[desc_idx];
+
+    kind = (len >> V6_DMA_REG_BIT_POS_LEN_KIND) & 0x3;
+    line_num = (len >> V6_DMA_REG_BIT_POS_LEN_LINE) & 0xFFFF;
+    if(line_num == 0){
+        line_num = 1;
+    }
+    line_left = line_num;
+    row_left = (len >> V6_DMA_REG_BIT_POS_LEN_ROW) & 0xFFF;
+    if(row_left == 0){
+        row_left = 1;
+    }
+    src_stride = (desc_stride[desc_idx] >> V6_DMA_REG_BIT_POS_STRIDE_SRC) & 0xFFFF;
+    dst_stride = (desc_stride[desc_idx] >> V6_DMA_REG_BIT_POS_STRIDE_DST) & 0xFFFF;
+    src_row = desc_src[desc_idx];
+    dst_row = desc_dst[desc_idx];
+    src_ptr = src_row;
+    dst_ptr = dst_row;
+    byte_idx = 0;
+
+    switch(kind){
+        case V6_DMA_KIND_DDR2_TO_DDR2:
+        case V6_DMA_KIND_DDR2_TO_LCD:
+            enter(ST_RD_REQ, at_ps + sys_period_ps);
+            break;
+        case V6_DMA_KIND_DCMI_TO_DDR2:
+            enter(ST_DCMI, at_ps + sys_period_ps);
+            break;
+        default:
+            error_reg = 1;
+            enter(ST_IDLE, at_ps + sys_period_ps);
+            break;
+    }
+}
+
+void host_dma_model::request(uint64_t at_ps){
+    /*
+    @brief  : ST_RD_REQ/ST_WR_REQ; a one-shot request to the mig;
+    @param  : system clock edge of the request pulse;
+    @retval : none
+    @note   : held until mig_grant() if another source has the mig;
+    */
+    int is_write = (state == ST_WR_REQ);
+
+    if(mig->dma_request(is_write, is_write ? dst_ptr : src_ptr, line, at_ps) != 0){
+        stat.grant_wait_cnt++;
+        return;
+    }
+    state = is_write ? ST_WR_WAIT : ST_RD_WAIT;
+    state_ps = at_ps;
+}
+
+void host_dma_model::push_lcd(uint64_t at_ps){
+    /*
+    @brief  : ST_LCD; the line into the lcd fifo; from bit[7:0] onwards;
+    @param  : system clock edge of the first byte;
+    @retval : none
+    @note   : a byte waits while the fifo holds LCD_FIFO_DEPTH bytes not yet drained;
+    @note   : held if the src mux does not select the dma or the cpu has the lcd;
+    */
+    uint64_t wr_period_ps = lcd->get_wr_period()*sys_period_ps;
+    uint64_t push_ps = at_ps;
+    uint8_t data;
+
+    if(bus->get_video_core(V2_DISP_SRC_MUX)->read(V2_DISP_SRC_MUX_REG_SEL_OFFSET) != V2_DISP_SRC_MUX_REG_SEL_DMA){
+        stat.lcd_hold_cnt += !lcd_hold;
+        lcd_hold = 1;
+        return;
+    }
+    for(; byte_idx < LINE_BYTE; byte_idx++){
+        // lcd_ready; the fifo level falls by one every WRX period;
+        if(lcd_drain_ps > push_ps + LCD_FIFO_DEPTH*wr_period_ps){
+            push_ps = lcd_drain_ps - LCD_FIFO_DEPTH*wr_period_ps;
+            push_ps = ((push_ps + sys_period_ps - 1)/sys_period_ps)*sys_period_ps;
+        }
+        data = (uint8_t)(line[byte_idx/4] >> (8*(byte_idx % 4)));
+        if(lcd->stream_byte(data) != 0){
+            stat.lcd_hold_cnt += !lcd_hold;
+            lcd_hold = 1;
+            state_ps = push_ps;
+            return;
+        }
+        lcd_drain_ps = ((lcd_drain_ps > push_ps) ? lcd_drain_ps : push_ps) + wr_period_ps;
+        stat.lcd_byte_cnt++;
+        push_ps += sys_period_ps;
+    }
+    lcd_hold = 0;
+    byte_idx = 0;
+    enter(ST_NEXT, push_ps);
+}
+
+void host_dma_model::next(uint64_t at_ps){
+    // ST_NEXT; the next line, row or descriptor; an abort is taken here;
+    int next_state = (kind == V6_DMA_KIND_DCMI_TO_DDR2) ? ST_DCMI : ST_RD_REQ;
+
+    line_cnt_reg = (line_cnt_reg + 1) & 0xFFFF;
+    stat.line_cnt++;
+    byte_idx = 0;
+
+    if(line_left != 1){
+        line_left--;
+        src_ptr = (src_ptr + 1) & ADDR_MASK;
+        dst_ptr = (dst_ptr + 1) & ADDR_MASK;
+    }
+    else if(row_left != 1){
+        line_left = line_num;
+        row_left--;
+        src_row = (src_row + src_stride) & ADDR_MASK;
+        dst_row = (dst_row + dst_stride) & ADDR_MASK;
+        src_ptr = src_row;
+        dst_ptr = dst_row;
+    }
+    else{
+        // descriptor done;
+        done_cnt_reg = (done_cnt_reg + 1) & 0xFF;
+        stat.desc_cnt++;
+        next_state = (desc_idx + 1 == chain_reg) ? ST_IDLE : ST_LOAD;
+        desc_idx = (desc_idx + 1) & (DESC_NUM - 1);
+    }
+
+    if(abort_reg){
+        abort_reg = 0;
+        aborted_reg = 1;
+        next_state = ST_IDLE;
+    }
+
+    // dcmi_active drops in ST_LOAD and ST_IDLE;
+    if(kind == V6_DMA_KIND_DCMI_TO_DDR2 && next_state != ST_DCMI){
+        dcmi->set_dma_sink(host_dcmi_model::DMA_SINK_OFF, at_ps + sys_period_ps);
+    }
+    enter(next_state, at_ps + sys_period_ps);
+}
+
+void host_dma_model::abort_stop(uint64_t at_ps){
+    /*
+    @brief  : an abort taken in ST_RD_REQ, ST_WR_REQ, ST_LCD or ST_DCMI;
+    @param  : system clock edge of the state; ST_IDLE from the next one;
+    @retval : none
+    @note   : a request held is not made; the line being collected or streamed is dropped;
+    */
+    abort_reg = 0;
+    aborted_reg = 1;
+    lcd_hold = 0;
+    byte_idx = 0;
+    if(kind == V6_DMA_KIND_DCMI_TO_DDR2){
+        dcmi->set_dma_sink(host_dcmi_model::DMA_SINK_OFF, at_ps + sys_period_ps);
+    }
+    enter(ST_IDLE, at_ps + sys_period_ps);
+}
+
+void host_dma_model::stop(uint64_t at_ps){
+    // back to ST_IDLE; busy is LOW from at_ps;
+    idle_ps = at_ps;
+    stat.busy_cycle += (at_ps - start_ps)/sys_period_ps;
+}
+
+/*-------------------------------------------------------
+* events;
+-------------------------------------------------------*/
+void host_dma_model::mig_complete(const uint32_t *rd_data, uint64_t at_ps){
+    /*
+    @brief  : mig_transaction_complete;
+    @param  :
+        1. rd_data  : mig_rddata; stable on the pulse;
+        2. at_ps    : the pulse in the system clock domain;
+    @retval : none
+    @note   : the FSM moves on at the next system clock edge;
+    */
+    uint64_t edge_ps = ((at_ps + sys_period_ps - 1)/sys_period_ps)*sys_period_ps;
+
+    if(state == ST_RD_WAIT){
+        memcpy(line, rd_data, sizeof(line));
+        byte_idx = 0;
+        enter((kind == V6_DMA_KIND_DDR2_TO_LCD) ? ST_LCD : ST_WR_REQ, edge_ps + sys_period_ps);
+    }
+    else if(state == ST_WR_WAIT){
+        enter(ST_NEXT, edge_ps + sys_period_ps);
+    }
+}
+
+void host_dma_model::mig_grant(uint64_t at_ps){
+    // the mig select is set to the dma; a request held goes out;
+    if(state == ST_RD_REQ || state == ST_WR_REQ){
+        request((at_ps > state_ps) ? at_ps : state_ps);
+    }
+}
+
+void host_dma_model::dcmi_take(uint8_t data, uint64_t at_ps){
+    /*
+    @brief  : ST_DCMI; a byte taken from the dcmi fifo;
+    @param  :
+        1. data     : dcmi_data;
+        2. at_ps    : system clock edge it is taken at;
+    @retval : none
+    @note   : the 16th byte makes a line; dcmi_ready is LOW from the next cycle;
+    */
+    uint32_t shift = 8*(byte_idx % 4);
+
+    if(state != ST_DCMI){
+        return;
+    }
+    line[byte_idx/4] = (line[byte_idx/4] & ~((uint32_t)0xFF << shift)) | ((uint32_t)data << shift);
+    stat.dcmi_byte_cnt++;
+    if(++byte_idx == LINE_BYTE){
+        byte_idx = 0;
+        dcmi->set_dma_sink(host_dcmi_model::DMA_SINK_PAUSE, at_ps + sys_period_ps);
+        enter(ST_WR_REQ, at_ps + sys_period_ps);
+    }
+}
+
+void host_dma_model::update(void){
+    /*
+    @brief  : to run the models wired to it up to the current bus cycle;
+    @param  : none
+    @retval : none
+    @note   : the dcmi first; a line it completes is written within the same slice;
+    */
+    uint64_t now_ps = bus->get_cycle()*sys_period_ps;
+    uint64_t slice_ps;
+
+    if(state == ST_IDLE){
+        return;
+    }
+    while(state != ST_IDLE && kind == V6_DMA_KIND_DCMI_TO_DDR2 && run_ps < now_ps){
+        slice_ps = run_ps + SLICE_CYCLE*sys_period_ps;
+        if(slice_ps > now_ps){
+            slice_ps = now_ps;
+        }
+        dcmi->run_to(slice_ps);
+        mig->run_to(slice_ps);
+        run_ps = slice_ps;
+    }
+    run_ps = now_ps;
+    mig->run_to(now_ps);
+
+    // a line held by the lcd is tried again;
+    if(state == ST_LCD && lcd_hold){
+        push_lcd((now_ps > state_ps) ? now_ps : state_ps);
+    }
+}
+
+/*-------------------------------------------------------
+* register file;
+-------------------------------------------------------*/
+uint32_t host_dma_model::read(uint32_t reg_offset){
+    uint32_t status;
+
+    update();
+    switch(reg_offset){
+        case REG_STATUS_OFFSET:
+            // {lines moved, descriptors completed, descriptor being run, aborted, error, busy};
+            status = is_busy() ? BIT_MASK(V6_DMA_REG_BIT_POS_STATUS_BUSY) : 0;
+            status |= (uint32_t)error_reg << V6_DMA_REG_BIT_POS_STATUS_ERROR;
+            status |= (uint32_t)aborted_reg << V6_DMA_REG_BIT_POS_STATUS_ABORTED;
+            status |= desc_idx << V6_DMA_REG_BIT_POS_STATUS_DESC;
+            status |= done_cnt_reg << V6_DMA_REG_BIT_POS_STATUS_DONE_CNT;
+            status |= line_cnt_reg << V6_DMA_REG_BIT_POS_STATUS_LINE_CNT;
+            return status;
+
+        case REG_CHAIN_OFFSET:
+            return chain_reg;
+
+        case REG_DESC_SEL_OFFSET:
+            return desc_sel_reg;
+
+        default:
+            // write only;
+            return 0;
+    }
+}
+
+void host_dma_model::write(uint32_t reg_offset, uint32_t wr_data){
+    uint64_t now_ps;
+
+    update();
+    now_ps = bus->get_cycle()*sys_period_ps;
+    switch(reg_offset){
+        case REG_CTRL_OFFSET:
+            // an abort is taken at the next line boundary;
+            // at once while waiting for the mig, the lcd or the dcmi;
+            if((wr_data & CTRL_ABORT_MASK) && state != ST_IDLE){
+                abort_reg = 1;
+                if(state == ST_RD_REQ || state == ST_WR_REQ || state == ST_LCD || state == ST_DCMI){
+                    abort_stop((now_ps > state_ps) ? now_ps : state_ps);
+                }
+            }
+            if((wr_data & CTRL_START_MASK) && !is_busy()){
+                desc_idx = 0;
+                abort_reg = 0;
+                aborted_reg = 0;
+                error_reg = 0;
+                line_cnt_reg = 0;
+                if(chain_reg != 0){
+                    mig = (host_mig_model *)bus->get_video_core(V5_MIG_INTERFACE);
+                    dcmi = (host_dcmi_model *)bus->get_video_core(V3_CAM_DCMI_IF);
+                    lcd = (host_lcd_model *)bus->get_video_core(V0_DISP_LCD);
+                    mig->set_dma(this);
+                    dcmi->set_dma(this);
+                    stat.start_cnt++;
+                    start_ps = now_ps;
+                    run_ps = now_ps;
+                    enter(ST_LOAD, now_ps + sys_period_ps);
+                }
+            }
+            break;
+
+        case REG_CHAIN_OFFSET:
+            chain_reg = wr_data & 0xF;
+            if(chain_reg > DESC_NUM){
+                chain_reg = DESC_NUM;
+            }
+            break;
+
+        case REG_DESC_SEL_OFFSET:
+            desc_sel_reg = wr_data & (DESC_NUM - 1);
+            break;
+
+        case REG_SRC_OFFSET:
+            desc_src[desc_sel_reg] = wr_data & ADDR_MASK;
+            break;
+
+        case REG_DST_OFFSET:
+            desc_dst[desc_sel_reg] = wr_data & ADDR_MASK;
+            break;
+
+        case REG_LEN_OFFSET:
+            desc_len[desc_sel_reg] = wr_data;
+            break;
+
+        case REG_STRIDE_OFFSET:
+            // the window moves on with the last register of a descriptor;
+            desc_stride[desc_sel_reg] = wr_data;
+            desc_sel_reg = (desc_sel_reg + 1) & (DESC_NUM - 1);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void host_dma_model::report(FILE *fp){
+    /*
+    @brief  : to print the event count;
+    @param  : output stream;
+    @retval : none
+    */
+    update();
+    fprintf(fp, "\n---- dma model ----\n");
+    fprintf(fp, "chains started  : %" PRIu64 " (descriptors done: %" PRIu64 ")\n", stat.start_cnt, stat.desc_cnt);
+    fprintf(fp, "lines moved     : %" PRIu64 "\n", stat.line_cnt);
+    fprintf(fp, "lcd bytes       : %" PRIu64 " (lines held: %" PRIu64 ")\n", stat.lcd_byte_cnt, stat.lcd_hold_cnt);
+    fprintf(fp, "dcmi bytes      : %" PRIu64 "\n", stat.dcmi_byte_cnt);
+    fprintf(fp, "mig not granted : %" PRIu64 " requests\n", stat.grant_wait_cnt);
+    fprintf(fp, "busy            : %" PRIu64 " cycles\n", stat.busy_cycle);
+}
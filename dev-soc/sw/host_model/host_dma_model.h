@@ -0,0 +1,180 @@
+#ifndef _HOST_DMA_MODEL_H
+#define _HOST_DMA_MODEL_H
+
+/* ---------------------------------------------
+Purpose: model of the dma core of the video system;
+1. V6_DMA: core_video_dma.sv; the register file, the descriptor table and the FSM;
+2. the DDR2 side goes through host_mig_model (select: V5_MIG_INTERFACE_REG_SEL_DMA);
+    one-shot requests into user_mig_DDR2_sync_ctrl.sv, one line in flight;
+3. the lcd side: V2_DISP_SRC_MUX (a plain register file) must select the dma
+    and the lcd must be in the stream mode; the lcd fifo (256 bytes) is drained
+    one byte per WRX period; the bytes go to the panel as data;
+4. the dcmi side: the dma is the sink of host_dcmi_model while
+    a DCMI to DDR2 descriptor runs; one byte per system clock cycle;
+
+Construction:
+1. the model is lazy; it is run up to the current bus cycle whenever
+    a register is accessed;
+2. it is driven by the events of the models wired to it:
+    the complete pulse of the mig, the byte taken from the dcmi fifo
+    and the hand-over of the mig; the requests it makes in return
+    carry the system clock edge the FSM would make them at;
+3. DCMI to DDR2: the dcmi and the mig are run in lock step,
+    SLICE_CYCLE system clock cycles at a time;
+4. DDR2 to LCD: a line is pushed in one go as the fifo level allows;
+    the panel sees it when it is pushed, not when it is drained;
+    the src mux and the stream mode are checked when a line starts;
+    a line held back is tried again at the next register access;
+5. an abort stops ST_RD_REQ, ST_WR_REQ, ST_LCD and ST_DCMI at once;
+    the other states at the next line boundary (ST_NEXT);
+6. the state names follow core_video_dma.sv;
+7. the mig, the lcd and the dcmi are the default models of host_bus;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "io_map.h"
+#include "io_reg_util.h"
+#include "host_core_model.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+class host_mig_model;   // forward declaration;
+class host_dcmi_model;  // forward declaration;
+
+// event count;
+struct host_dma_stat{
+    uint64_t start_cnt;         // chains started;
+    uint64_t desc_cnt;          // descriptors completed;
+    uint64_t line_cnt;          // lines moved;
+    uint64_t lcd_byte_cnt;      // bytes pushed into the lcd fifo;
+    uint64_t dcmi_byte_cnt;     // bytes taken from the dcmi fifo;
+    uint64_t grant_wait_cnt;    // requests held as another source had the mig;
+    uint64_t lcd_hold_cnt;      // lines held as the lcd did not take the stream;
+    uint64_t busy_cycle;        // system clock cycles with busy HIGH;
+};
+
+/*-------------------------------------------------------
+* V6_DMA;
+-------------------------------------------------------*/
+class host_dma_model : public host_core_model{
+    // register map and fields; see io_map.h;
+    enum{
+        REG_CTRL_OFFSET     = V6_DMA_REG_CTRL,
+        REG_STATUS_OFFSET   = V6_DMA_REG_STATUS,
+        REG_CHAIN_OFFSET    = V6_DMA_REG_CHAIN,
+        REG_DESC_SEL_OFFSET = V6_DMA_REG_DESC_SEL,
+        REG_SRC_OFFSET      = V6_DMA_REG_DESC_SRC,
+        REG_DST_OFFSET      = V6_DMA_REG_DESC_DST,
+        REG_LEN_OFFSET      = V6_DMA_REG_DESC_LEN,
+        REG_STRIDE_OFFSET   = V6_DMA_REG_DESC_STRIDE,
+
+        CTRL_START_MASK     = BIT_MASK(V6_DMA_REG_BIT_POS_CTRL_START),
+        CTRL_ABORT_MASK     = BIT_MASK(V6_DMA_REG_BIT_POS_CTRL_ABORT),
+        ADDR_MASK           = 0x7FFFFF,     // 23-bit;
+        DESC_NUM            = V6_DMA_DESC_NUM,
+        LINE_BYTE           = 16,
+        LINE_WORD           = 4,
+        LCD_FIFO_DEPTH      = 256,
+        SLICE_CYCLE         = 16
+    };
+
+    public:
+        // core_video_dma.sv;
+        enum{
+            ST_IDLE = 0,
+            ST_LOAD,
+            ST_RD_REQ,
+            ST_RD_WAIT,
+            ST_LCD,
+            ST_DCMI,
+            ST_WR_REQ,
+            ST_WR_WAIT,
+            ST_NEXT
+        };
+
+        host_dma_model(host_bus *bus);
+        ~host_dma_model();
+
+        uint32_t read(uint32_t reg_offset);
+        void write(uint32_t reg_offset, uint32_t wr_data);
+
+        /* events from the models wired to it; */
+        void mig_complete(const uint32_t *rd_data, uint64_t at_ps);
+        void mig_grant(uint64_t at_ps);
+        void dcmi_take(uint8_t data, uint64_t at_ps);
+
+        /* observation */
+        host_dma_stat get_stat(void);
+        void clear_stat(void);
+        void report(FILE *fp);
+
+    private:
+        void update(void);
+        void enter(int next_state, uint64_t at_ps);
+        void load(uint64_t at_ps);
+        void request(uint64_t at_ps);
+        void push_lcd(uint64_t at_ps);
+        void next(uint64_t at_ps);
+        void abort_stop(uint64_t at_ps);
+        void stop(uint64_t at_ps);
+        int is_busy(void);
+
+        host_bus *bus;
+        host_mig_model *mig;
+        host_dcmi_model *dcmi;
+        host_lcd_model *lcd;
+        host_dma_stat stat;
+
+        // descriptor table;
+        uint32_t desc_src[DESC_NUM];
+        uint32_t desc_dst[DESC_NUM];
+        uint32_t desc_len[DESC_NUM];
+        uint32_t desc_stride[DESC_NUM];
+        uint32_t desc_sel_reg;
+        uint32_t chain_reg;
+
+        // descriptor being run;
+        int state;
+        uint32_t desc_idx;
+        uint32_t kind;
+        uint32_t line_num;
+        uint32_t line_left;
+        uint32_t row_left;
+        uint32_t src_stride;
+        uint32_t dst_stride;
+        uint32_t src_row;
+        uint32_t dst_row;
+        uint32_t src_ptr;
+        uint32_t dst_ptr;
+
+        // line buffer;
+        uint32_t line[LINE_WORD];
+        uint32_t byte_idx;
+
+        // status;
+        int abort_reg;
+        int aborted_reg;
+        int error_reg;
+        uint32_t done_cnt_reg;
+        uint32_t line_cnt_reg;
+
+        // time;
+        uint64_t sys_period_ps;
+        uint64_t state_ps;          // system clock edge at which the state was entered;
+        uint64_t start_ps;
+        uint64_t run_ps;            // the dcmi and the mig are run in lock step up to then;
+        uint64_t idle_ps;           // busy until then; the FSM may run ahead of the bus;
+        uint64_t lcd_drain_ps;      // the lcd fifo is empty by then;
+        int lcd_hold;               // a line waits for the lcd;
+};
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_HOST_DMA_MODEL_H
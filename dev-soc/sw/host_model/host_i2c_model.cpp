@@ -0,0 +1,196 @@
+#include "host_i2c_model.h"
+#include "host_bus.h"
+
+host_i2c_model::host_i2c_model(host_bus *bus) : host_core_model("i2c_master"){
+    this->bus = bus;
+    clkmod = 0;
+    state = ST_IDLE;
+    busy_until = 0;
+    rx_reg = 0;
+    clear_stat();
+    attach_device(&camera);
+}
+
+host_i2c_model::~host_i2c_model(){}
+
+void host_i2c_model::attach_device(host_i2c_device *dev){
+    device.push_back(dev);
+}
+
+host_ov7670_model *host_i2c_model::get_camera(void){
+    return &camera;
+}
+
+int host_i2c_model::is_ready(void){
+    return bus->get_cycle() >= busy_until;
+}
+
+uint32_t host_i2c_model::read(uint32_t reg_offset){
+    // {22'b0, ready_flag, ack, dout}; the offset is not decoded;
+    uint32_t rd_data;
+
+    rd_data = (uint32_t)(rx_reg >> 1) & 0xFF;
+    if(rx_reg & 1){
+        rd_data |= READ_ACK_MASK;
+    }
+    if(is_ready()){
+        rd_data |= READ_READY_MASK;
+    }
+    return rd_data;
+}
+
+void host_i2c_model::write(uint32_t reg_offset, uint32_t wr_data){
+    switch(reg_offset){
+        case REG_CLKMOD_OFFSET:
+            clkmod = wr_data;
+            break;
+        case REG_WRITE_OFFSET:
+            start_cmd((wr_data >> CMD_BIT_POS) & CMD_MASK, (uint8_t)(wr_data & 0xFF));
+            break;
+        default:
+            break;
+    }
+}
+
+void host_i2c_model::bus_start(void){
+    for(size_t i = 0; i < device.size(); i++){
+        device[i]->start();
+    }
+}
+
+void host_i2c_model::bus_stop(void){
+    for(size_t i = 0; i < device.size(); i++){
+        device[i]->stop();
+    }
+}
+
+void host_i2c_model::shift_byte(uint8_t tx, int last_bit){
+    /*
+    @brief  : 9 scl pulses; ST_DATA_01 to ST_DATA_04 per bit;
+    @param  :
+        tx      : sda the master drives for bits 0 to 7 (1 is released);
+        last_bit: sda the master drives for bit 8;
+    @retval : none; rx_reg holds the 9 bits sampled;
+    */
+    uint16_t rx = 0;
+    int sda;
+    int bit;
+
+    for(int i = 0; i < 9; i++){
+        // scl LOW: everyone sets up sda;
+        bit = (i < 8) ? ((tx >> (7 - i)) & 1) : (last_bit & 1);
+        sda = bit;
+        for(size_t j = 0; j < device.size(); j++){
+            sda &= device[j]->drive();
+        }
+
+        // scl HIGH: everyone samples; rx_next = {rx_reg[7:0], sda};
+        for(size_t j = 0; j < device.size(); j++){
+            device[j]->sample(sda);
+        }
+        rx = (uint16_t)((rx << 1) | sda);
+    }
+    stat.scl_cnt += 9;
+    rx_reg = rx;
+}
+
+void host_i2c_model::start_cmd(uint32_t cmd, uint8_t din){
+    /*
+    @brief  : wr_i2c pulse;
+    @param  :
+        cmd : i2c command;
+        din : data byte;
+    @retval : none
+    @note   : the bus is run to the end of the command at once;
+        the FSM reports busy until the modelled time catches up;
+    */
+    uint64_t quarter = (uint64_t)clkmod + 1;
+    uint64_t half = 2*(uint64_t)clkmod + 1;
+    uint64_t length = 0;
+
+    // the FSM only looks at wr_i2c in the ready states;
+    if(!is_ready()){
+        stat.drop_cnt++;
+        return;
+    }
+
+    if(state == ST_IDLE){
+        if(cmd != CMD_START){
+            stat.drop_cnt++;
+            return;
+        }
+        bus_start();
+        stat.start_cnt++;
+        length = 2*half;
+        state = ST_HOLD;
+    }
+    else{
+        switch(cmd){
+            case CMD_WR:
+                // the 9th bit is released for the device ACK;
+                shift_byte(din, 1);
+                if(rx_reg & 1){
+                    stat.nack_cnt++;
+                }
+                stat.wr_byte_cnt++;
+                length = 9*4*quarter + quarter;
+                break;
+            case CMD_RD:
+                // sda released for the data; the 9th bit is ACK/NACK of the master;
+                shift_byte(0xFF, din & 1);
+                stat.rd_byte_cnt++;
+                length = 9*4*quarter + quarter;
+                break;
+            case CMD_START:
+            case CMD_REPEAT:
+                bus_start();
+                stat.repeat_cnt++;
+                length = 3*half;
+                break;
+            case CMD_STOP:
+                bus_stop();
+                stat.stop_cnt++;
+                length = 2*half;
+                state = ST_IDLE;
+                break;
+            default:
+                stat.drop_cnt++;
+                return;
+        }
+    }
+    busy_until = bus->get_cycle() + 1 + length;
+    stat.busy_cycle += 1 + length;
+}
+
+host_i2c_stat host_i2c_model::get_stat(void){
+    return stat;
+}
+
+void host_i2c_model::clear_stat(void){
+    stat.start_cnt = 0;
+    stat.repeat_cnt = 0;
+    stat.stop_cnt = 0;
+    stat.wr_byte_cnt = 0;
+    stat.rd_byte_cnt = 0;
+    stat.nack_cnt = 0;
+    stat.scl_cnt = 0;
+    stat.busy_cycle = 0;
+    stat.drop_cnt = 0;
+}
+
+uint64_t host_i2c_model::get_scl_freq(void){
+    // one bit is 4 quarters;
+    return SYS_CLK_FREQ_HZ/(4*((uint64_t)clkmod + 1));
+}
+
+void host_i2c_model::report(FILE *fp){
+    fprintf(fp, "\n---- i2c master model (clkmod %u, scl %" PRIu64 " Hz) ----\n", clkmod, get_scl_freq());
+    fprintf(fp, "start           : %" PRIu64 " (repeated: %" PRIu64 ")\n", stat.start_cnt, stat.repeat_cnt);
+    fprintf(fp, "stop            : %" PRIu64 "\n", stat.stop_cnt);
+    fprintf(fp, "byte written    : %" PRIu64 " (nack: %" PRIu64 ")\n", stat.wr_byte_cnt, stat.nack_cnt);
+    fprintf(fp, "byte read       : %" PRIu64 "\n", stat.rd_byte_cnt);
+    fprintf(fp, "scl pulses      : %" PRIu64 "\n", stat.scl_cnt);
+    fprintf(fp, "busy            : %" PRIu64 " cycles (%.3f ms)\n", stat.busy_cycle,
+            (double)stat.busy_cycle*1000.0/SYS_CLK_FREQ_HZ);
+    fprintf(fp, "command dropped : %" PRIu64 "\n", stat.drop_cnt);
+}
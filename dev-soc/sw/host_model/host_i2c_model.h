@@ -0,0 +1,134 @@
+#ifndef _HOST_I2C_MODEL_H
+#define _HOST_I2C_MODEL_H
+
+/* ---------------------------------------------
+Purpose: model of the i2c master core (S6_I2C_MASTER);
+1. core_i2c_master.sv: the register interface;
+2. i2c_master_controller.sv: the command FSM and the bus timing;
+3. the i2c bus: open drain sda (wired-AND) shared with
+    the attached devices; see host_i2c_device in host_ov7670_model.h;
+4. the OV7670 camera is attached by default;
+
+Command protocol (as the HW does it):
+1. a write to the command register is a single cycle pulse (wr_i2c);
+2. the command is only taken while the controller is ready:
+    IDLE takes START only;
+    HOLD takes WR, RD, START/REPEAT (repeated start) and STOP;
+    anything else is dropped; see host_i2c_stat::drop_cnt;
+3. WR shifts din out msb first; the 9th bit is the device ACK;
+    RD releases sda for 8 bits; the 9th bit is din[0] (0: ACK, 1: NACK);
+4. the read register is {ready, ack, dout} of the last byte,
+    whatever the register offset;
+
+Timing (system clock cycles; mod is the clkmod register):
+1. quarter = mod + 1; half = 2*mod + 1;
+2. START  : 2 halves (START_01, START_02);
+3. WR, RD : 9 bits of 4 quarters each, then DATA_END (1 quarter);
+4. REPEAT : 3 halves (REPEAT, START_01, START_02);
+5. STOP   : 2 halves (STOP_01, STOP_02);
+6. the FSM leaves the ready state one cycle after the command pulse;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "io_map.h"
+#include "io_reg_util.h"
+#include "host_core_model.h"
+#include "host_ov7670_model.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+#include <vector>
+
+// bus activity;
+struct host_i2c_stat{
+    uint64_t start_cnt;         // start conditions from IDLE;
+    uint64_t repeat_cnt;        // repeated start conditions from HOLD;
+    uint64_t stop_cnt;
+    uint64_t wr_byte_cnt;       // WR commands;
+    uint64_t rd_byte_cnt;       // RD commands;
+    uint64_t nack_cnt;          // WR not acknowledged by any device;
+    uint64_t scl_cnt;           // scl clock pulses (9 per byte);
+    uint64_t busy_cycle;        // system clock cycles the controller is not ready;
+    uint64_t drop_cnt;          // command pulses the FSM did not take;
+};
+
+/*-------------------------------------------------------
+* core_i2c_master.sv + i2c_master_controller.sv + the bus;
+-------------------------------------------------------*/
+class host_i2c_model : public host_core_model{
+    // register map and fields; see io_map.h;
+    enum{
+        REG_CLKMOD_OFFSET   = S6_I2C_REG_CLKMOD_OFFSET,
+        REG_WRITE_OFFSET    = S6_I2C_REG_WRITE_OFFSET,
+
+        READ_ACK_MASK       = BIT_MASK(S6_I2C_REG_READ_BIT_POS_ACK),
+        READ_READY_MASK     = BIT_MASK(S6_I2C_REG_READ_BIT_POS_READY),
+        CMD_BIT_POS         = S6_I2C_REG_WRITE_BIT_POS_CMD_OFFSET,
+        CMD_MASK            = 0x7
+    };
+
+    // i2c_master_controller.sv;
+    enum{
+        CMD_NOP     = 0,
+        CMD_START   = 1,
+        CMD_WR      = 2,
+        CMD_RD      = 3,
+        CMD_STOP    = 4,
+        CMD_REPEAT  = 5
+    };
+
+    // ready states of the FSM;
+    enum{
+        ST_IDLE = 0,
+        ST_HOLD
+    };
+
+    public:
+        host_i2c_model(host_bus *bus);
+        ~host_i2c_model();
+
+        uint32_t read(uint32_t reg_offset);
+        void write(uint32_t reg_offset, uint32_t wr_data);
+
+        /* devices on the bus;
+        the model does not take the ownership of the device;
+        */
+        void attach_device(host_i2c_device *dev);
+        host_ov7670_model *get_camera(void);
+
+        /* observation */
+        host_i2c_stat get_stat(void);
+        void clear_stat(void);
+        uint64_t get_scl_freq(void);    // Hz; from clkmod;
+        void report(FILE *fp);
+
+    private:
+        int is_ready(void);
+        void shift_byte(uint8_t tx, int last_bit);
+        void bus_start(void);
+        void bus_stop(void);
+        void start_cmd(uint32_t cmd, uint8_t din);
+
+        host_bus *bus;
+        host_ov7670_model camera;
+        std::vector<host_i2c_device *> device;
+
+        // registers;
+        uint32_t clkmod;
+        int state;              // ST_IDLE or ST_HOLD once the command is done;
+        uint64_t busy_until;    // bus cycle at which the FSM is ready again;
+        uint16_t rx_reg;        // {dout, ack} of the last byte;
+
+        host_i2c_stat stat;
+};
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_HOST_I2C_MODEL_H
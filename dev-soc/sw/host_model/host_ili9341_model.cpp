@@ -0,0 +1,569 @@
+#include "host_ili9341_model.h"
+#include "string.h"
+#include <string>
+
+host_ili9341_model::host_ili9341_model(){
+    /*
+    @brief  : constructor; power on;
+    @param  : none
+    @retval : none
+    @note   : the gram content is undefined on the panel; black here;
+    */
+    memset(gram, 0, sizeof(gram));
+    sw_reset();
+    clear_count();
+}
+
+host_ili9341_model::~host_ili9341_model(){}
+
+void host_ili9341_model::sw_reset(void){
+    /*
+    @brief  : register defaults after SWRESET / RESX;
+    @param  : none
+    @retval : none
+    @note   : the gram is not affected;
+    */
+    madctl = 0x00;
+    colmod = 0x66;      // 18-bit;
+    wemode = 1;
+    disp_on = 0;
+    sleep_out = 0;
+    invert = 0;
+    col_start = 0;
+    col_end = WIDTH - 1;
+    page_start = 0;
+    page_end = HEIGHT - 1;
+    vs_top = 0;
+    vs_area = HEIGHT;
+    vs_bottom = 0;
+    vs_start = 0;
+
+    cmd = LCD_ILI9341_REG_NOP;
+    param_idx = 0;
+    col_ptr = 0;
+    page_ptr = 0;
+    ram_stop = 0;
+    pixel_acc = 0;
+    pixel_byte_idx = 0;
+    resp_len = 0;
+    resp_idx = 0;
+    rd_dummy = 0;
+}
+
+void host_ili9341_model::hw_reset(void){
+    sw_reset();
+}
+
+/*-------------------------------------------------------
+* 8080 bus;
+-------------------------------------------------------*/
+void host_ili9341_model::write(int is_data, uint8_t data){
+    frame.byte_cnt++;
+    if(!is_data){
+        frame.cmd_cnt++;
+        start_cmd(data);
+        return;
+    }
+
+    if(cmd == LCD_ILI9341_REG_MEM_WRITE || cmd == CMD_RAMWRC){
+        take_pixel_byte(data);
+    }
+    else{
+        frame.param_cnt++;
+        take_param(data);
+    }
+}
+
+uint8_t host_ili9341_model::read(void){
+    /*
+    @brief  : one RDX cycle;
+    @param  : none
+    @retval : the byte the panel drives;
+    @note   : the first byte after a read command is a dummy;
+    @note   : RAMRD returns 18-bit pixels; 3 bytes (R, G, B) of 6 MSB each;
+    */
+    uint8_t rd = 0;
+    uint16_t pixel = 0;
+    int x, y;
+
+    frame.byte_cnt++;
+
+    if(cmd == CMD_RAMRD || cmd == CMD_RAMRDC){
+        if(rd_dummy){
+            rd_dummy = 0;
+            return 0;
+        }
+        if(map(col_ptr, page_ptr, &x, &y)){
+            pixel = gram[y*WIDTH + x];
+        }
+        switch(pixel_byte_idx){
+            case 0:     // R5 -> R6;
+                rd = (uint8_t)((((pixel >> 11) & 0x1F) << 1 | ((pixel >> 15) & 0x1)) << 2);
+                break;
+            case 1:     // G6;
+                rd = (uint8_t)(((pixel >> 5) & 0x3F) << 2);
+                break;
+            default:    // B5 -> B6;
+                rd = (uint8_t)((((pixel & 0x1F) << 1) | ((pixel >> 4) & 0x1)) << 2);
+                break;
+        }
+        if(++pixel_byte_idx == 3){
+            pixel_byte_idx = 0;
+            advance();
+        }
+        return rd;
+    }
+
+    if(resp_idx < resp_len){
+        rd = resp[resp_idx++];
+    }
+    return rd;
+}
+
+void host_ili9341_model::start_cmd(uint8_t new_cmd){
+    /*
+    @brief  : a command byte; ends whatever command is in progress;
+    @param  : command;
+    @retval : none
+    */
+    cmd = new_cmd;
+    param_idx = 0;
+    pixel_byte_idx = 0;
+    pixel_acc = 0;
+    resp_len = 0;
+    resp_idx = 0;
+
+    switch(cmd){
+        case LCD_ILI9341_REG_SW_RESET:
+            sw_reset();
+            break;
+
+        case LCD_ILI9341_REG_SLEEP_IN:
+            sleep_out = 0;
+            break;
+
+        case LCD_ILI9341_REG_SLEEP_OUT:
+            sleep_out = 1;
+            break;
+
+        case LCD_ILI9341_REG_DISP_INV_OFF:
+            invert = 0;
+            break;
+
+        case LCD_ILI9341_REG_DISP_INV_ON:
+            invert = 1;
+            break;
+
+        case LCD_ILI9341_REG_DISP_OFF:
+            disp_on = 0;
+            break;
+
+        case LCD_ILI9341_REG_DISP_ON:
+            disp_on = 1;
+            break;
+
+        case LCD_ILI9341_REG_MEM_WRITE:
+        case CMD_RAMRD:
+            // back to the start of the window;
+            col_ptr = col_start;
+            page_ptr = page_start;
+            ram_stop = 0;
+            rd_dummy = 1;
+            frame.ramwr_cnt += (cmd == LCD_ILI9341_REG_MEM_WRITE);
+            break;
+
+        case CMD_RAMWRC:
+        case CMD_RAMRDC:
+            // carry on from the last pointer;
+            rd_dummy = 1;
+            frame.ramwr_cnt += (cmd == CMD_RAMWRC);
+            break;
+
+        /* read back; a dummy byte first; */
+        case LCD_ILI9341_REG_RDID1:
+            resp[0] = 0x00; resp[1] = 0x00;
+            resp_len = 2;
+            break;
+
+        case LCD_ILI9341_REG_RDID2:
+            resp[0] = 0x00; resp[1] = 0x80;
+            resp_len = 2;
+            break;
+
+        case LCD_ILI9341_REG_RDID3:
+            resp[0] = 0x00; resp[1] = 0x00;
+            resp_len = 2;
+            break;
+
+        case LCD_ILI9341_REG_RDID4:
+            resp[0] = 0x00; resp[1] = 0x00; resp[2] = 0x93; resp[3] = 0x41;
+            resp_len = 4;
+            break;
+
+        case LCD_ILI9341_REG_RDDST:
+            // {booster, MY, MX, MV, ML, BGR, MH, 0}, {0, IFPF, idle, partial, slpout, noron},
+            // {vscroll, 0, invon, 0, 0, dispon, 0, 0}, 0;
+            resp[0] = 0x00;
+            resp[1] = (uint8_t)((sleep_out << 7) | ((madctl >> 1) & 0x7E));
+            resp[2] = (uint8_t)(((colmod & 0x07) << 4) | (sleep_out << 1) | 0x01);
+            resp[3] = (uint8_t)((invert << 5) | (disp_on << 2));
+            resp[4] = 0x00;
+            resp_len = 5;
+            break;
+
+        case LCD_ILI9341_REG_RDDPM:
+            // {booster, idle, partial, slpout, noron, dispon, 0, 0};
+            resp[0] = 0x00;
+            resp[1] = (uint8_t)((sleep_out << 7) | (sleep_out << 4) | (1 << 3) | (disp_on << 2));
+            resp_len = 2;
+            break;
+
+        case CMD_RDDMADCTL:
+            resp[0] = 0x00; resp[1] = madctl;
+            resp_len = 2;
+            break;
+
+        case CMD_RDDCOLMOD:
+            resp[0] = 0x00; resp[1] = colmod;
+            resp_len = 2;
+            break;
+
+        case LCD_ILI9341_REG_RDDSDR:
+            resp[0] = 0x00; resp[1] = 0x00;
+            resp_len = 2;
+            break;
+
+        default:
+            // NOP ends RAMWR; power, gamma etc are ignored;
+            break;
+    }
+}
+
+void host_ili9341_model::take_param(uint8_t data){
+    /*
+    @brief  : a parameter byte of the command in progress;
+    @param  : byte;
+    @retval : none
+    @note   : a command takes effect with its last parameter;
+    */
+    uint16_t start, end;
+
+    if(param_idx < MAX_PARAM){
+        param[param_idx] = data;
+    }
+    param_idx++;
+
+    switch(cmd){
+        case LCD_ILI9341_REG_ADDR_COL_SET:
+        case LCD_ILI9341_REG_ADDR_PAGE_SET:
+            if(param_idx != 4){
+                break;
+            }
+            start = (uint16_t)((param[0] << 8) | param[1]);
+            end = (uint16_t)((param[2] << 8) | param[3]);
+            if(cmd == LCD_ILI9341_REG_ADDR_COL_SET){
+                if(start != col_start || end != col_end){
+                    frame.window_cnt++;
+                }
+                col_start = start;
+                col_end = end;
+            }
+            else{
+                if(start != page_start || end != page_end){
+                    frame.window_cnt++;
+                }
+                page_start = start;
+                page_end = end;
+            }
+            break;
+
+        case LCD_ILI9341_REG_MAC:
+            if(param_idx == 1){
+                madctl = data;
+            }
+            break;
+
+        case LCD_ILI9341_REG_PIXEL_FORMAT:
+            if(param_idx == 1){
+                colmod = data;
+            }
+            break;
+
+        case LCD_ILI9341_REG_INTERFACE_CTR:
+            if(param_idx == 1){
+                wemode = data & 0x01;
+            }
+            break;
+
+        case CMD_VSCRDEF:
+            if(param_idx == 6){
+                vs_top = (uint16_t)((param[0] << 8) | param[1]);
+                vs_area = (uint16_t)((param[2] << 8) | param[3]);
+                vs_bottom = (uint16_t)((param[4] << 8) | param[5]);
+            }
+            break;
+
+        case CMD_VSCRSADD:
+            if(param_idx == 2){
+                vs_start = (uint16_t)((param[0] << 8) | param[1]);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void host_ili9341_model::take_pixel_byte(uint8_t data){
+    /*
+    @brief  : a byte of the RAMWR data stream;
+    @param  : byte;
+    @retval : none
+    @note   : 16-bit (COLMOD 0x55): two bytes per pixel, MSB first;
+    @note   : 18-bit (COLMOD 0x66): three bytes per pixel (R, G, B) of 6 MSB each;
+    */
+    int bpp_byte = ((colmod & 0x07) == 0x05) ? 2 : 3;
+    uint16_t pixel;
+    int x, y;
+
+    pixel_acc = (pixel_acc << 8) | data;
+    if(++pixel_byte_idx < bpp_byte){
+        return;
+    }
+
+    if(bpp_byte == 2){
+        pixel = (uint16_t)pixel_acc;
+    }
+    else{
+        pixel = (uint16_t)((((pixel_acc >> 19) & 0x1F) << 11) | (((pixel_acc >> 10) & 0x3F) << 5) | ((pixel_acc >> 3) & 0x1F));
+    }
+    pixel_acc = 0;
+    pixel_byte_idx = 0;
+
+    if(ram_stop){
+        frame.clip_cnt++;
+        return;
+    }
+    if(map(col_ptr, page_ptr, &x, &y)){
+        gram[y*WIDTH + x] = pixel;
+        frame.pixel_cnt++;
+    }
+    else{
+        frame.clip_cnt++;
+    }
+    advance();
+}
+
+int host_ili9341_model::map(uint16_t col, uint16_t page, int *x, int *y){
+    /*
+    @brief  : logical (column, page) to the physical gram location;
+    @param  : pointer; output location;
+    @retval : 1 if inside the gram; 0 otherwise;
+    */
+    int px, py;
+
+    if(madctl & MADCTL_MV){
+        px = page;
+        py = col;
+    }
+    else{
+        px = col;
+        py = page;
+    }
+    if(px >= WIDTH || py >= HEIGHT){
+        return 0;
+    }
+    if(madctl & MADCTL_MX){
+        px = WIDTH - 1 - px;
+    }
+    if(madctl & MADCTL_MY){
+        py = HEIGHT - 1 - py;
+    }
+    *x = px;
+    *y = py;
+    return 1;
+}
+
+void host_ili9341_model::advance(void){
+    /*
+    @brief  : move the memory pointer; column first;
+    @param  : none
+    @retval : none
+    */
+    int full_screen;
+
+    if(col_ptr < col_end){
+        col_ptr++;
+        return;
+    }
+    col_ptr = col_start;
+    if(page_ptr < page_end){
+        page_ptr++;
+        return;
+    }
+
+    // end of the window;
+    page_ptr = page_start;
+    if(!wemode){
+        ram_stop = 1;
+    }
+    full_screen = (col_start == 0 && page_start == 0 &&
+        (uint32_t)(col_end + 1)*(uint32_t)(page_end + 1) >= (uint32_t)WIDTH*HEIGHT);
+    if(full_screen && (cmd == LCD_ILI9341_REG_MEM_WRITE || cmd == CMD_RAMWRC)){
+        end_frame();
+    }
+}
+
+/*-------------------------------------------------------
+* gram;
+-------------------------------------------------------*/
+uint16_t host_ili9341_model::get_pixel(int x, int y){
+    if(x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT){
+        return 0;
+    }
+    return gram[y*WIDTH + x];
+}
+
+const uint16_t *host_ili9341_model::get_gram(void){
+    return gram;
+}
+
+uint16_t host_ili9341_model::get_display_pixel(int x, int y){
+    /*
+    @brief  : the pixel the panel shows at (x, y);
+    @param  : physical location;
+    @retval : RGB565 as seen on the panel;
+    @note   : vertical scrolling, BGR order and inversion applied;
+    */
+    int line = y;
+    uint16_t pixel;
+
+    // the scroll area shows the gram from vs_start on, wrapped within the area;
+    if(vs_area && y >= vs_top && y < vs_top + vs_area && vs_start >= vs_top && vs_start < vs_top + vs_area){
+        line = vs_top + ((y - vs_top) + (vs_start - vs_top)) % vs_area;
+    }
+    pixel = gram[line*WIDTH + x];
+    if(madctl & MADCTL_BGR){
+        pixel = (uint16_t)(((pixel & 0x1F) << 11) | (pixel & 0x07E0) | ((pixel >> 11) & 0x1F));
+    }
+    if(invert){
+        pixel = (uint16_t)~pixel;
+    }
+    return pixel;
+}
+
+int host_ili9341_model::dump_ppm(const char *path){
+    /*
+    @brief  : to dump the displayed image as binary ppm (P6), 240 x 320;
+    @param  : file path;
+    @retval : 0 on success; -1 otherwise;
+    @note   : DISPOFF and SLPIN are not applied; the image is what the gram would show;
+    */
+    FILE *fp;
+    uint8_t rgb[3];
+    uint16_t pixel;
+    int x, y;
+
+    fp = fopen(path, "wb");
+    if(!fp){
+        return -1;
+    }
+    fprintf(fp, "P6\n%d %d\n255\n", WIDTH, HEIGHT);
+    for(y = 0; y < HEIGHT; y++){
+        for(x = 0; x < WIDTH; x++){
+            pixel = get_display_pixel(x, y);
+            rgb[0] = (uint8_t)(((pixel >> 11) & 0x1F) << 3 | ((pixel >> 13) & 0x07));
+            rgb[1] = (uint8_t)(((pixel >> 5) & 0x3F) << 2 | ((pixel >> 9) & 0x03));
+            rgb[2] = (uint8_t)((pixel & 0x1F) << 3 | ((pixel >> 2) & 0x07));
+            fwrite(rgb, 1, 3, fp);
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+uint8_t host_ili9341_model::get_madctl(void){
+    return madctl;
+}
+
+void host_ili9341_model::get_window(uint16_t *cs, uint16_t *ce, uint16_t *ps, uint16_t *pe){
+    *cs = col_start;
+    *ce = col_end;
+    *ps = page_start;
+    *pe = page_end;
+}
+
+/*-------------------------------------------------------
+* counting;
+-------------------------------------------------------*/
+host_ili9341_frame host_ili9341_model::end_frame(void){
+    /*
+    @brief  : to close the frame in progress;
+    @param  : none
+    @retval : count of the frame just closed;
+    */
+    host_ili9341_frame closed = frame;
+
+    history.push_back(frame);
+    total.byte_cnt      += frame.byte_cnt;
+    total.cmd_cnt       += frame.cmd_cnt;
+    total.param_cnt     += frame.param_cnt;
+    total.pixel_cnt     += frame.pixel_cnt;
+    total.clip_cnt      += frame.clip_cnt;
+    total.window_cnt    += frame.window_cnt;
+    total.ramwr_cnt     += frame.ramwr_cnt;
+    memset(&frame, 0, sizeof(frame));
+    return closed;
+}
+
+host_ili9341_frame host_ili9341_model::get_frame(void){
+    return frame;
+}
+
+const std::vector<host_ili9341_frame> &host_ili9341_model::get_frame_history(void){
+    return history;
+}
+
+host_ili9341_frame host_ili9341_model::get_total(void){
+    // closed frames plus the one in progress;
+    host_ili9341_frame sum = total;
+    sum.byte_cnt    += frame.byte_cnt;
+    sum.cmd_cnt     += frame.cmd_cnt;
+    sum.param_cnt   += frame.param_cnt;
+    sum.pixel_cnt   += frame.pixel_cnt;
+    sum.clip_cnt    += frame.clip_cnt;
+    sum.window_cnt  += frame.window_cnt;
+    sum.ramwr_cnt   += frame.ramwr_cnt;
+    return sum;
+}
+
+void host_ili9341_model::clear_count(void){
+    memset(&frame, 0, sizeof(frame));
+    memset(&total, 0, sizeof(total));
+    history.clear();
+}
+
+void host_ili9341_model::report(FILE *fp){
+    /*
+    @brief  : to print the bus traffic per frame;
+    @param  : output stream;
+    @retval : none
+    */
+    size_t i;
+    const host_ili9341_frame *f;
+
+    fprintf(fp, "\n---- ili9341 panel (madctl 0x%02X, colmod 0x%02X, window [%u..%u] x [%u..%u]) ----\n",
+        madctl, colmod, col_start, col_end, page_start, page_end);
+    fprintf(fp, "%-8s %12s %10s %10s %10s %8s %8s %8s %12s\n",
+        "frame", "bytes", "commands", "params", "pixels", "clipped", "windows", "ramwr", "bytes/pixel");
+    for(i = 0; i <= history.size(); i++){
+        f = (i < history.size()) ? &history[i] : &frame;
+        if(i == history.size() && f->byte_cnt == 0){
+            break;
+        }
+        fprintf(fp, "%-8s %12" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %12.3f\n",
+            (i < history.size()) ? std::to_string(i).c_str() : "open",
+            f->byte_cnt, f->cmd_cnt, f->param_cnt, f->pixel_cnt, f->clip_cnt, f->window_cnt, f->ramwr_cnt,
+            f->pixel_cnt ? (double)f->byte_cnt/(double)f->pixel_cnt : 0.0);
+    }
+}
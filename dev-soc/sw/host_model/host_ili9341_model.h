@@ -0,0 +1,165 @@
+#ifndef _HOST_ILI9341_MODEL_H
+#define _HOST_ILI9341_MODEL_H
+
+/* ---------------------------------------------
+Purpose: model of the ILI9341 lcd controller (the panel side);
+1. it sits behind host_lcd_model (V0_DISP_LCD) and consumes the
+    8080 byte stream: one call per WRX/RDX cycle the core drives;
+2. it decodes the commands the drivers use:
+    CASET, PASET, RAMWR, RAMWRC, RAMRD, RAMRDC, MADCTL, COLMOD,
+    VSCRDEF, VSCRSADD, INVON/INVOFF, DISPON/DISPOFF, SLPIN/SLPOUT,
+    SWRESET, the interface control (WEMODE) and the read id/status commands;
+    the other commands (power, gamma, timing) are counted and ignored;
+3. the GRAM is 240 (column) x 320 (page) in RGB565,
+    in the native orientation of the panel;
+4. the bus traffic is counted per frame; see host_ili9341_frame;
+
+Orientation (MADCTL; see set_orientation(), set_BGR_order()):
+1. the host addresses the GRAM with a (column, page) pointer
+    bounded by the CASET/PASET window; column runs first;
+2. MV exchanges column and page; MX then mirrors the
+    physical column, MY the physical page;
+3. BGR swaps the R and B sub-pixels of the displayed image;
+    the GRAM keeps the pixel as written;
+
+Frame:
+1. a frame ends at end_frame();
+2. or when RAMWR wraps around a window that covers the whole panel
+    (a full screen has been streamed);
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "lcd_ili9341_reg.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+#include <vector>
+
+// bus traffic of a frame;
+struct host_ili9341_frame{
+    uint64_t byte_cnt;      // bytes on the 8080 bus (written and read);
+    uint64_t cmd_cnt;       // command bytes;
+    uint64_t param_cnt;     // parameter bytes, not counting the pixel data;
+    uint64_t pixel_cnt;     // pixels written into the GRAM;
+    uint64_t clip_cnt;      // pixels addressed outside the GRAM; dropped;
+    uint64_t window_cnt;    // CASET/PASET which moved the window;
+    uint64_t ramwr_cnt;     // RAMWR and RAMWRC;
+};
+
+class host_ili9341_model{
+    // commands not in lcd_ili9341_reg.h;
+    enum{
+        CMD_RDDMADCTL   = 0x0B,
+        CMD_RDDCOLMOD   = 0x0C,
+        CMD_RAMRD       = 0x2E,
+        CMD_VSCRDEF     = 0x33,
+        CMD_VSCRSADD    = 0x37,
+        CMD_RAMWRC      = 0x3C,
+        CMD_RAMRDC      = 0x3E
+    };
+
+    // MADCTL bits;
+    enum{
+        MADCTL_MY   = 0x80,
+        MADCTL_MX   = 0x40,
+        MADCTL_MV   = 0x20,
+        MADCTL_BGR  = 0x08
+    };
+
+    enum{
+        MAX_PARAM   = 16,
+        MAX_RESP    = 8
+    };
+
+    public:
+        enum{
+            WIDTH   = 240,  // physical columns;
+            HEIGHT  = 320   // physical pages (lines);
+        };
+
+        host_ili9341_model();
+        ~host_ili9341_model();
+
+        /* 8080 bus; one call per byte;
+        is_data : DCX; 1 for data, 0 for command;
+        */
+        void write(int is_data, uint8_t data);
+        uint8_t read(void);
+
+        /* hw reset line (RESX) */
+        void hw_reset(void);
+
+        /* gram */
+        uint16_t get_pixel(int x, int y);
+        const uint16_t *get_gram(void);
+        int dump_ppm(const char *path);     // as displayed; 0 on success;
+
+        /* state */
+        uint8_t get_madctl(void);
+        void get_window(uint16_t *col_start, uint16_t *col_end, uint16_t *page_start, uint16_t *page_end);
+
+        /* per frame counting */
+        host_ili9341_frame end_frame(void);
+        host_ili9341_frame get_frame(void);                 // frame in progress;
+        const std::vector<host_ili9341_frame> &get_frame_history(void);
+        host_ili9341_frame get_total(void);
+        void clear_count(void);
+        void report(FILE *fp);
+
+    private:
+        void sw_reset(void);
+        void start_cmd(uint8_t cmd);
+        void take_param(uint8_t data);
+        void take_pixel_byte(uint8_t data);
+        int map(uint16_t col, uint16_t page, int *x, int *y);
+        void advance(void);
+        uint16_t get_display_pixel(int x, int y);
+
+        // gram;
+        uint16_t gram[WIDTH*HEIGHT];
+
+        // registers;
+        uint8_t madctl;
+        uint8_t colmod;
+        int wemode;             // 1: the pointer wraps around at the end of the window;
+        int disp_on;
+        int sleep_out;
+        int invert;
+        uint16_t col_start, col_end;
+        uint16_t page_start, page_end;
+        uint16_t vs_top, vs_area, vs_bottom;    // VSCRDEF;
+        uint16_t vs_start;                      // VSCRSADD;
+
+        // command decoding;
+        uint8_t cmd;
+        int param_idx;
+        uint8_t param[MAX_PARAM];
+
+        // memory pointer;
+        uint16_t col_ptr, page_ptr;
+        int ram_stop;           // WEMODE = 0 and the window is full;
+        uint32_t pixel_acc;     // pixel bytes collected so far;
+        int pixel_byte_idx;
+
+        // read back;
+        uint8_t resp[MAX_RESP];
+        int resp_len;
+        int resp_idx;
+        int rd_dummy;           // RAMRD: dummy byte still due;
+
+        // counting;
+        host_ili9341_frame frame;
+        host_ili9341_frame total;
+        std::vector<host_ili9341_frame> history;
+};
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_HOST_ILI9341_MODEL_H
@@ -0,0 +1,1084 @@
+/* ---------------------------------------------
+Purpose: host run of the driver hot paths;
+1. the drivers in user_src are built unmodified against the host bus;
+2. each driver call is wrapped in a probe;
+3. the bus access count per core and per driver call is reported
+    together with the cycle breakdown and the estimated time;
+4. usage: host_run [ppm|-] [trace];
+    the lcd panel is dumped to ppm if given;
+    the register accesses are recorded to trace if given
+    (all but the system timer); see host_trace.h;
+---------------------------------------------*/
+
+#include "main.h"
+#include "host_bus.h"
+#include "host_core_model.h"
+#include "host_mig_model.h"
+#include "host_i2c_model.h"
+#include "host_dcmi_model.h"
+#include "host_dma_model.h"
+#include "host_trace.h"
+#include "video_core_dma.h"
+#include "ddr2_arena.h"
+#include "memtest_util.h"
+#include "motion_sigma_delta.h"
+
+#include <string.h>
+
+/* global instance of the cores not covered by the device directive */
+core_spi obj_spi(GET_MMIO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, S5_SPI));
+video_core_mig_interface vid_mig(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, V5_MIG_INTERFACE));
+video_core_dcmi_interface vid_dcmi(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, V3_CAM_DCMI_IF));
+video_core_src_mux vid_src_mux(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, V2_DISP_SRC_MUX));
+video_core_dma vid_dma(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, V6_DMA));
+
+// from user_util.cpp;
+extern core_uart sys_uart;
+
+// ddr2 burst round trip;
+enum{
+    BURST_LINE_NUM = 256
+};
+static uint32_t burst_buffer[4*BURST_LINE_NUM];
+
+// dma round trip; a full lcd frame of RGB565 is this many DDR2 lines;
+// the frame and the capture buffer are taken from the arena;
+enum{
+    DMA_COPY_ADDR   = 20000,
+    DMA_FRAME_LINE_NUM = 2*LCD_ILI9341_PIXEL_NUM/16
+};
+static ddr2_arena arena(DDR2_ARENA_BASE);
+
+static uint16_t dma_frame_pixel(uint32_t index){
+    return (uint16_t)(index*7 + (index >> 8));
+}
+
+// motion detector golden model; the SWAR kernel against the reference;
+enum{
+    MOTION_PIX_NUM = 1003,      // not a whole number of words;
+    MOTION_FRAME_NUM = 64
+};
+
+static uint32_t motion_rand(uint32_t *state){
+    // xorshift32;
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static uint32_t motion_check(void){
+    /*
+    @brief  : motion_sd_step() against motion_sd_step_ref();
+    @retval : mismatches (pixels plus failed cases);
+    @note   : (1) the README cases and the two saturated ends by hand;
+              (2) every (I, M, V) for a few N; one step;
+              (3) random frame sequences; random N; odd offsets and sizes;
+                    the frames stay around the mean with some jumps to 0 and 255;
+    */
+    static uint8_t frame[MOTION_PIX_NUM + 8];
+    static uint8_t mean[2][MOTION_PIX_NUM + 8];
+    static uint8_t var[2][MOTION_PIX_NUM + 8];
+    static uint8_t detect[2][MOTION_PIX_NUM + 8];
+    const uint32_t amp_list[] = {1, 2, 3, 16, 255};
+    const struct{ uint8_t i, m, v, amp, m_out, v_out, d_out; } hand[] = {
+        {20, 10, 5, 2, 11, 6, MOTION_SD_DETECT_OFF},    // M up; 5 < 2 x 9; 9 >= 6;
+        {10, 20, 30, 2, 19, 29, MOTION_SD_DETECT_ON},   // M down; 30 >= 2 x 9; 9 < 29;
+        {0, 0, 7, 4, 0, 7, MOTION_SD_DETECT_ON},        // M = I = 0 stays; D = 0 keeps V;
+        {5, 5, 1, 1, 4, 0, MOTION_SD_DETECT_OFF},       // M = I goes down; 1 >= 1 x 1; 1 >= 0;
+        {255, 0, 255, 3, 1, 255, MOTION_SD_DETECT_ON},  // V = 255 stays; 255 < 3 x 254; 254 < 255;
+        {200, 100, 255, 1, 101, 254, MOTION_SD_DETECT_ON}
+    };
+    uint32_t state = 0x2545F491;
+    uint32_t mismatch = 0;
+    uint32_t amp;
+    uint32_t offset;
+    uint32_t npix;
+    uint32_t i;
+
+    for(uint32_t h = 0; h < sizeof(hand)/sizeof(hand[0]); h++){
+        for(int k = 0; k < 2; k++){
+            frame[0] = hand[h].i;
+            mean[k][0] = hand[h].m;
+            var[k][0] = hand[h].v;
+            (k ? motion_sd_step : motion_sd_step_ref)(frame, mean[k], var[k], detect[k], 1, hand[h].amp);
+            if(mean[k][0] != hand[h].m_out || var[k][0] != hand[h].v_out || detect[k][0] != hand[h].d_out){
+                mismatch++;
+            }
+        }
+    }
+    for(uint32_t a = 0; a < sizeof(amp_list)/sizeof(amp_list[0]); a++){
+        for(uint32_t x = 0; x < 256*256; x++){
+            memset(frame, x >> 8, 256);
+            for(int k = 0; k < 2; k++){
+                memset(mean[k], x & 0xFF, 256);
+                for(uint32_t v = 0; v < 256; v++){
+                    var[k][v] = (uint8_t)v;
+                }
+            }
+            motion_sd_step_ref(frame, mean[0], var[0], detect[0], 256, amp_list[a]);
+            motion_sd_step(frame, mean[1], var[1], detect[1], 256, amp_list[a]);
+            for(int k = 0; k < 3; k++){
+                const uint8_t *p = (k == 0) ? mean[0] : (k == 1) ? var[0] : detect[0];
+                const uint8_t *q = (k == 0) ? mean[1] : (k == 1) ? var[1] : detect[1];
+                if(memcmp(p, q, 256) != 0){
+                    mismatch++;
+                }
+            }
+        }
+    }
+
+    for(uint32_t run = 0; run < 32; run++){
+        amp = 1 + motion_rand(&state) % MOTION_SD_AMP_MAX;
+        offset = motion_rand(&state) % 8;
+        npix = MOTION_PIX_NUM - motion_rand(&state) % 16;
+        for(i = 0; i < npix; i++){
+            frame[offset + i] = (uint8_t)motion_rand(&state);
+        }
+        motion_sd_init(&frame[offset], mean[0] + offset, var[0] + offset, npix);
+        motion_sd_init(&frame[offset], mean[1] + offset, var[1] + offset, npix);
+        for(uint32_t t = 0; t < MOTION_FRAME_NUM; t++){
+            for(i = 0; i < npix; i++){
+                uint32_t r = motion_rand(&state);
+                uint32_t jump = r % 64;
+
+                frame[offset + i] = (jump == 0) ? 0 : (jump == 1) ? 0xFF : (jump < 8) ? (uint8_t)(r >> 8) :
+                                    (uint8_t)(mean[0][offset + i] + ((r >> 8) % 9) - 4);
+            }
+            motion_sd_step_ref(&frame[offset], mean[0] + offset, var[0] + offset, detect[0] + offset, npix, amp);
+            motion_sd_step(&frame[offset], mean[1] + offset, var[1] + offset, detect[1] + offset, npix, amp);
+            for(i = offset; i < offset + npix; i++){
+                if(mean[0][i] != mean[1][i] || var[0][i] != var[1][i] || detect[0][i] != detect[1][i]){
+                    mismatch++;
+                }
+            }
+        }
+    }
+
+    if(motion_sd_step(frame, mean[1], var[1], detect[1], 8, 0) != -1 ||
+            motion_sd_step_ref(frame, mean[0], var[0], detect[0], 8, MOTION_SD_AMP_MAX + 1) != -1){
+        mismatch++;
+    }
+    return mismatch;
+}
+
+// i2c traffic of one camera configuration;
+struct i2c_config_row{
+    const char *label;
+    host_i2c_stat stat;
+    uint64_t cycle;     // bus cycles; including the settling delays of the driver;
+};
+
+static i2c_config_row i2c_config_begin(const char *label){
+    i2c_config_row row;
+    host_bus &bus = host_bus_get();
+
+    row.label = label;
+    row.stat = ((host_i2c_model *)bus.get_mmio_core(S6_I2C_MASTER))->get_stat();
+    row.cycle = bus.get_cycle();
+    return row;
+}
+
+/* one decoded frame through the dcmi fifo;
+the lcd WRX period sets the sink rate;
+*/
+static void dcmi_stress_row(FILE *fp, const char *source_name, host_dcmi_config timing, int wrx_l, int wrx_h){
+    host_bus &bus = host_bus_get();
+    host_dcmi_model *dcmi = (host_dcmi_model *)bus.get_video_core(V3_CAM_DCMI_IF);
+    host_lcd_model *lcd = (host_lcd_model *)bus.get_video_core(V0_DISP_LCD);
+    fifo_status_t fifo_status;
+    host_dcmi_stat stat;
+
+    obj_lcd_controller.set_clockmod(wrx_l, wrx_h, 9, 39);
+    timing.sink_period = (uint32_t)lcd->get_wr_period();
+    dcmi->set_config(timing);
+
+    vid_dcmi.disable_decoder();
+    vid_dcmi.reset_fifo();
+    vid_dcmi.clear_decoder_counter();
+    dcmi->clear_stat();
+
+    vid_dcmi.enable_decoder();
+    while(vid_dcmi.get_frame_counter() < 1){};
+    vid_dcmi.disable_decoder();
+    fifo_status = vid_dcmi.get_fifo_status();
+    stat = dcmi->get_stat();
+
+    fprintf(fp, "%-10s %8.3f %4d %4d %6u %8.3f %6u %8" PRIu64 " %8" PRIu64 " %8d\n",
+            source_name, timing.pclk_khz/1000.0, wrx_l, wrx_h, timing.sink_period,
+            (double)SYS_CLK_FREQ_MHZ/timing.sink_period, stat.max_fill,
+            stat.drop_cnt, stat.wr_cnt, fifo_status.wr_error);
+}
+
+static void i2c_config_end(FILE *fp, i2c_config_row row){
+    host_bus &bus = host_bus_get();
+    host_i2c_stat now = ((host_i2c_model *)bus.get_mmio_core(S6_I2C_MASTER))->get_stat();
+
+    fprintf(fp, "%-28s %8" PRIu64 " %8" PRIu64 " %10" PRIu64 " %12.3f %12.3f\n",
+            row.label,
+            (now.start_cnt + now.repeat_cnt) - (row.stat.start_cnt + row.stat.repeat_cnt),
+            (now.wr_byte_cnt + now.rd_byte_cnt) - (row.stat.wr_byte_cnt + row.stat.rd_byte_cnt),
+            now.scl_cnt - row.stat.scl_cnt,
+            (double)(now.busy_cycle - row.stat.busy_cycle)*1000.0/SYS_CLK_FREQ_HZ,
+            (double)(bus.get_cycle() - row.cycle)*1000.0/SYS_CLK_FREQ_HZ);
+}
+
+int main(int argc, char **argv){
+    host_bus &bus = host_bus_get();
+    lcd_ili9341_sw_driver obj_lcd;
+    host_mig_model *mig = (host_mig_model *)bus.get_video_core(V5_MIG_INTERFACE);
+    host_ili9341_model *panel = ((host_lcd_model *)bus.get_video_core(V0_DISP_LCD))->get_panel();
+    host_i2c_model *i2c = (host_i2c_model *)bus.get_mmio_core(S6_I2C_MASTER);
+    host_ov7670_model *cam = i2c->get_camera();
+    uint8_t cam_expect[OV7670_REG_LAST];
+    uint32_t cam_mismatch = 0;
+    i2c_config_row row;
+    uint32_t lcd_mismatch = 0;
+    uint32_t read_buffer[4];
+    uint32_t mismatch = 0;
+    uint32_t dma_mismatch = 0;
+    uint32_t i;
+    ddr2_region_t dma_frame;
+    ddr2_region_t dma_capture;
+    host_trace_writer trace;
+
+    // keep the report readable;
+    ((host_uart_model *)bus.get_mmio_core(S1_UART_DEBUG))->set_stream(NULL);
+    bus.clear_count();
+
+    // the system timer is left out; the delays would dominate the trace;
+    if(argc > 2){
+        if(trace.open(argv[2], MMIO_TRACE_MASK_ALL & ~MMIO_TRACE_MMIO_SLOT(S0_SYS_TIMER)) != 0){
+            fprintf(stderr, "%s: cannot open the trace\n", argv[2]);
+            return 1;
+        }
+        bus.set_trace(&trace);
+    }
+
+    /* lcd */
+    {
+        host_bus_probe probe("lcd.init");
+        obj_lcd.init();
+    }
+    {
+        host_bus_probe probe("lcd.set_area");
+        obj_lcd.set_area(0, 0, LCD_ILI9341_DIMENSION_LOW_240 - 1, LCD_ILI9341_DIMENSION_HIGH_320 - 1);
+    }
+    for(i = 0; i < 1000; i++){
+        host_bus_probe probe("lcd.write_pixel");
+        obj_lcd.write_pixel((uint16_t)i);
+    }
+    {
+        host_bus_probe probe("lcd.fill_colour");
+        obj_lcd.fill_colour(RGB565_COLOUR_RED);
+    }
+    for(i = 0; i < LCD_ILI9341_PIXEL_NUM; i++){
+        if(panel->get_gram()[i] != RGB565_COLOUR_RED){
+            lcd_mismatch++;
+        }
+    }
+    if((argc > 1) && strcmp(argv[1], "-")){
+        panel->dump_ppm(argv[1]);
+    }
+
+    /* ddr2 */
+    if(vid_mig.set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        mismatch++;
+    }
+    while(!vid_mig.is_mig_app_ready()){};
+    mig->clear_stat();
+    for(i = 0; i < 1000; i++){
+        host_bus_probe probe("mig.write_ddr2");
+        vid_mig.write_ddr2(i, i, i + 1, i + 2, i + 3);
+    }
+    for(i = 0; i < 1000; i++){
+        host_bus_probe probe("mig.read_ddr2");
+        vid_mig.read_ddr2(i, read_buffer);
+        if(read_buffer[0] != i || read_buffer[3] != i + 3){
+            mismatch++;
+        }
+    }
+    {
+        host_bus_probe probe("mig.init_ddr2");
+        if(vid_mig.init_ddr2(0, 0, 1000) != 0){
+            mismatch++;
+        }
+    }
+    for(i = 0; i < 1000; i++){
+        mig->peek_line(i, read_buffer);
+        if(read_buffer[0] != 0 || read_buffer[1] != 0 || read_buffer[2] != 0 || read_buffer[3] != 0){
+            mismatch++;
+        }
+    }
+    for(i = 0; i < 4*BURST_LINE_NUM; i++){
+        burst_buffer[i] = i*0x01010101;
+    }
+    {
+        host_bus_probe probe("mig.write_ddr2_burst");
+        vid_mig.write_ddr2_burst(2000, burst_buffer, BURST_LINE_NUM);
+    }
+    memset(burst_buffer, 0, sizeof(burst_buffer));
+    {
+        host_bus_probe probe("mig.read_ddr2_burst");
+        vid_mig.read_ddr2_burst(2000, burst_buffer, BURST_LINE_NUM);
+    }
+    for(i = 0; i < 4*BURST_LINE_NUM; i++){
+        if(burst_buffer[i] != i*0x01010101){
+            mismatch++;
+        }
+    }
+
+    // stream mode; same round trip, then the single line calls;
+    if(vid_mig.set_stream_mode(1) != 0){
+        mismatch++;
+    }
+    for(i = 0; i < 4*BURST_LINE_NUM; i++){
+        burst_buffer[i] = ~i;
+    }
+    {
+        host_bus_probe probe("mig.write_ddr2_burst_stream");
+        vid_mig.write_ddr2_burst(4000, burst_buffer, BURST_LINE_NUM);
+    }
+    memset(burst_buffer, 0, sizeof(burst_buffer));
+    {
+        host_bus_probe probe("mig.read_ddr2_burst_stream");
+        vid_mig.read_ddr2_burst(4000, burst_buffer, BURST_LINE_NUM);
+    }
+    for(i = 0; i < 4*BURST_LINE_NUM; i++){
+        if(burst_buffer[i] != ~i){
+            mismatch++;
+        }
+    }
+    vid_mig.write_ddr2(5000, 1, 2, 3, 4);
+    vid_mig.read_ddr2(5000, read_buffer);
+    if(read_buffer[0] != 1 || read_buffer[3] != 4){
+        mismatch++;
+    }
+
+    // fill in the stream mode; the lines either side are left alone;
+    {
+        const uint32_t pattern[4] = {0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210};
+        {
+            host_bus_probe probe("mig.fill_ddr2_stream");
+            if(vid_mig.fill_ddr2(5001, pattern, BURST_LINE_NUM) != 0){
+                mismatch++;
+            }
+        }
+        if(vid_mig.get_fill_cnt() != BURST_LINE_NUM || !vid_mig.is_fill_done()){
+            mismatch++;
+        }
+        for(i = 0; i < BURST_LINE_NUM; i++){
+            mig->peek_line(5001 + i, read_buffer);
+            if(memcmp(read_buffer, pattern, sizeof(pattern))){
+                mismatch++;
+            }
+        }
+        mig->peek_line(5001 + BURST_LINE_NUM, read_buffer);
+        if(read_buffer[0] != 0 || read_buffer[3] != 0){
+            mismatch++;
+        }
+        vid_mig.read_ddr2(5000, read_buffer);
+        if(read_buffer[0] != 1 || read_buffer[3] != 4){
+            mismatch++;
+        }
+    }
+
+    /* partial writes into the filled lines;
+    1. stream mode: an RGB565 pixel; bytes 2 and 3;
+    2. the lower half of two words; the other two words;
+    3. a full write after them; the mask is set back;
+    */
+    {
+        const uint32_t pattern[4] = {0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210};
+        const uint32_t line[4] = {0xA5A5A5A5, 0x5A5A5A5A, 0xC3C3C3C3, 0x3C3C3C3C};
+        {
+            host_bus_probe probe("mig.write_ddr2_masked");
+            vid_mig.write_ddr2_masked(5002, line, 0xFFF3);
+            vid_mig.set_stream_mode(0);
+            vid_mig.write_ddr2_masked(5003, line, 0xCC0F);
+        }
+        vid_mig.write_ddr2(5004, 1, 2, 3, 4);
+        mig->peek_line(5002, read_buffer);
+        if(read_buffer[0] != ((line[0] & 0xFFFF0000) | (pattern[0] & 0x0000FFFF)) 
+            || memcmp(&read_buffer[1], &pattern[1], 3*sizeof(uint32_t))){
+            mismatch++;
+        }
+        mig->peek_line(5003, read_buffer);
+        if(read_buffer[0] != pattern[0] || read_buffer[1] != line[1]
+            || read_buffer[2] != ((pattern[2] & 0xFFFF0000) | (line[2] & 0x0000FFFF))
+            || read_buffer[3] != ((pattern[3] & 0xFFFF0000) | (line[3] & 0x0000FFFF))){
+            mismatch++;
+        }
+        mig->peek_line(5004, read_buffer);
+        if(read_buffer[0] != 1 || read_buffer[1] != 2 || read_buffer[2] != 3 || read_buffer[3] != 4){
+            mismatch++;
+        }
+    }
+
+    // posted writes; a jump in the address midway; read back after the fence;
+    {
+        uint32_t complete_cnt = vid_mig.get_complete_cnt();
+        host_bus_probe probe("mig.post_write");
+        for(i = 0; i < 2*BURST_LINE_NUM; i++){
+            vid_mig.post_write(6000 + i + ((i >= BURST_LINE_NUM) ? 100 : 0), i, ~i, i << 8, i >> 8);
+        }
+        if(vid_mig.fence() != video_core_mig_interface::WAIT_OK){
+            mismatch++;
+        }
+        if(((vid_mig.get_complete_cnt() - complete_cnt) & 0xFF) != ((2*BURST_LINE_NUM) & 0xFF)){
+            mismatch++;
+        }
+    }
+    for(i = 0; i < 2*BURST_LINE_NUM; i++){
+        vid_mig.read_ddr2(6000 + i + ((i >= BURST_LINE_NUM) ? 100 : 0), read_buffer);
+        if(read_buffer[0] != i || read_buffer[1] != ~i || read_buffer[2] != (i << 8) || read_buffer[3] != (i >> 8)){
+            mismatch++;
+        }
+    }
+
+    /* write-combining;
+    1. RGB565 pixels in raster order; eight per line; full lines only;
+    2. two bytes into a written line, evicted by a word into the next one;
+        the rest of both lines is left as it is;
+    */
+    vid_mig.write_ddr2(7064, 0x11111111, 0x22222222, 0x33333333, 0x44444444);
+    vid_mig.write_ddr2(7065, 0x55555555, 0x66666666, 0x77777777, 0x88888888);
+    {
+        video_core_mig_writer writer(&vid_mig);
+        {
+            host_bus_probe probe("mig_writer.write16");
+            for(i = 0; i < 8*64; i++){
+                writer.write16(16*7000 + 2*i, (uint16_t)(5*i + 1));
+            }
+        }
+        writer.write8(16*7064 + 3, 0xAB);
+        writer.write8(16*7064 + 9, 0xCD);
+        writer.write32(16*7065 + 8, 0x12345678);
+        if(writer.write16(16*7065 + 1, 0) != -1 || writer.write32(16*7065 + 2, 0) != -1){
+            mismatch++;
+        }
+        if(writer.flush() != 0){
+            mismatch++;
+        }
+        if(writer.get_store_cnt() != 8*64 + 3 || writer.get_line_cnt() != 64 + 2 || writer.get_partial_cnt() != 2){
+            mismatch++;
+        }
+    }
+    vid_mig.read_ddr2_burst(7000, burst_buffer, 64);
+    for(i = 0; i < 4*64; i++){
+        if(burst_buffer[i] != ((5*(2*i) + 1) | ((5*(2*i + 1) + 1) << 16))){
+            mismatch++;
+        }
+    }
+    vid_mig.read_ddr2(7064, read_buffer);
+    if(read_buffer[0] != 0xAB111111 || read_buffer[1] != 0x22222222 || read_buffer[2] != 0x3333CD33 || read_buffer[3] != 0x44444444){
+        mismatch++;
+    }
+    vid_mig.read_ddr2(7065, read_buffer);
+    if(read_buffer[0] != 0x55555555 || read_buffer[1] != 0x66666666 || read_buffer[2] != 0x12345678 || read_buffer[3] != 0x88888888){
+        mismatch++;
+    }
+
+    // read-ahead; the burst region above in two chunks, then a jump back;
+    {
+        video_core_mig_reader reader(&vid_mig);
+        host_bus_probe probe("mig.read_ddr2_prefetch");
+        memset(burst_buffer, 0, sizeof(burst_buffer));
+        reader.open(2000, BURST_LINE_NUM/2);
+        reader.read_lines(burst_buffer, BURST_LINE_NUM);
+        reader.open(2000 + BURST_LINE_NUM/2, BURST_LINE_NUM/2);
+        reader.read_lines(&burst_buffer[4*(BURST_LINE_NUM/2)], BURST_LINE_NUM);
+        for(i = 0; i < 4*BURST_LINE_NUM; i++){
+            if(burst_buffer[i] != i*0x01010101){
+                mismatch++;
+            }
+        }
+        reader.open(6000, 1);
+        if(reader.read(read_buffer) != 0 || read_buffer[0] != 0 || read_buffer[1] != ~0u){
+            mismatch++;
+        }
+        if(reader.read(read_buffer) != -1){
+            mismatch++;
+        }
+        reader.close();
+    }
+    vid_mig.read_ddr2(2000, read_buffer);
+    if(read_buffer[0] != 0 || read_buffer[3] != 3*0x01010101){
+        mismatch++;
+    }
+
+    /* arena;
+    1. a pool used up falls through to the next one up; then nothing is left;
+        consecutive blocks of a pool are in different banks; no two blocks overlap
+        or cross a bank;
+    2. a block released is the next one handed out;
+    3. a region is released once;
+    4. alloc_apart() keeps the planes in different banks; none left once every bank is taken;
+    */
+    {
+        ddr2_region_t plane[DDR2_ARENA_PLANE_NUM + DDR2_ARENA_FRAME_NUM];
+        ddr2_region_t extra;
+        uint32_t n = 0;
+
+        while(n < DDR2_ARENA_PLANE_NUM + DDR2_ARENA_FRAME_NUM &&
+                arena.alloc(&plane[n], LCD_ILI9341_DIMENSION_LOW_240, LCD_ILI9341_DIMENSION_HIGH_320, DDR2_ARENA_FMT_Y8) == 0){
+            if(plane[n].stride != 15 || ddr2_arena::row_addr(&plane[n], 1) != plane[n].addr + 15){
+                mismatch++;
+            }
+            if(n > 0 && plane[n].pool == plane[n - 1].pool && 
+                    ddr2_arena::get_bank(plane[n].addr) == ddr2_arena::get_bank(plane[n - 1].addr)){
+                mismatch++;
+            }
+            if(ddr2_arena::get_bank(plane[n].addr) != ddr2_arena::get_bank(plane[n].addr + plane[n].line_num - 1)){
+                mismatch++;
+            }
+            for(i = 0; i < n; i++){
+                if(plane[n].addr < plane[i].addr + plane[i].line_num && plane[i].addr < plane[n].addr + plane[n].line_num){
+                    mismatch++;
+                }
+            }
+            n++;
+        }
+        if(n != DDR2_ARENA_PLANE_NUM + DDR2_ARENA_FRAME_NUM || plane[n - 1].pool != DDR2_ARENA_POOL_FRAME ||
+                ddr2_arena::get_bank(plane[0].addr) != ddr2_arena::get_bank(arena.get_base())){
+            mismatch++;
+        }
+        if(arena.alloc(&extra, LCD_ILI9341_DIMENSION_LOW_240, LCD_ILI9341_DIMENSION_HIGH_320, DDR2_ARENA_FMT_RGB565) != -1 ||
+                arena.release(&extra) != -1){
+            mismatch++;
+        }
+        extra = plane[3];
+        if(arena.release(&plane[3]) != 0 || arena.release(&extra) != -1 ||
+                arena.alloc_lines(&plane[3], 4000) != 0 || plane[3].addr != extra.addr){
+            mismatch++;
+        }
+        for(i = 0; i < n; i++){
+            if(arena.release(&plane[i]) != 0){
+                mismatch++;
+            }
+        }
+        for(i = 0; i < DDR2_ARENA_POOL_NUM; i++){
+            if(arena.get_free_num(i)*arena.get_block_line_num(i) == 0){
+                mismatch++;
+            }
+        }
+
+        for(i = 0; i < DDR2_ARENA_BANK_SPAN; i++){
+            if(arena.alloc_apart(&plane[i], LCD_ILI9341_DIMENSION_LOW_240, LCD_ILI9341_DIMENSION_HIGH_320, DDR2_ARENA_FMT_Y8, plane, i) != 0){
+                mismatch++;
+            }
+            for(uint32_t j = 0; j < i; j++){
+                if(ddr2_arena::get_bank(plane[i].addr) == ddr2_arena::get_bank(plane[j].addr)){
+                    mismatch++;
+                }
+            }
+        }
+        if(arena.alloc_apart(&extra, 16, 1, DDR2_ARENA_FMT_RAW, plane, DDR2_ARENA_BANK_SPAN) != -1 ||
+                arena.alloc_apart(&extra, 16, 1, DDR2_ARENA_FMT_RAW, plane, 1) != 0 ||
+                ddr2_arena::get_bank(extra.addr) == ddr2_arena::get_bank(plane[0].addr) || arena.release(&extra) != 0){
+            mismatch++;
+        }
+        for(i = 0; i < DDR2_ARENA_BANK_SPAN; i++){
+            if(arena.release(&plane[i]) != 0){
+                mismatch++;
+            }
+        }
+    }
+    if(arena.alloc(&dma_frame, LCD_ILI9341_DIMENSION_LOW_240, LCD_ILI9341_DIMENSION_HIGH_320, DDR2_ARENA_FMT_RGB565) != 0 ||
+            arena.alloc(&dma_capture, LCD_ILI9341_DIMENSION_HIGH_320, LCD_ILI9341_DIMENSION_LOW_240, DDR2_ARENA_FMT_RGB565) != 0 ||
+            dma_frame.stride*dma_frame.height != DMA_FRAME_LINE_NUM){
+        mismatch++;
+    }
+
+    /* dma;
+    1. ddr2 to ddr2: the burst region above;
+    2. ddr2 to lcd: a full frame; two bytes per pixel, MSB first;
+    */
+    if(vid_mig.set_core_dma() != video_core_mig_interface::WAIT_OK){
+        dma_mismatch++;
+    }
+    {
+        host_bus_probe probe("dma.copy_ddr2");
+        if(vid_dma.copy_ddr2(2000, DMA_COPY_ADDR, BURST_LINE_NUM) != 0 || vid_dma.wait_done() != 0){
+            dma_mismatch++;
+        }
+    }
+    if(vid_mig.set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        dma_mismatch++;
+    }
+    vid_mig.read_ddr2_burst(DMA_COPY_ADDR, burst_buffer, BURST_LINE_NUM);
+    for(i = 0; i < 4*BURST_LINE_NUM; i++){
+        if(burst_buffer[i] != i*0x01010101){
+            dma_mismatch++;
+        }
+    }
+
+    /* read cache; over the write-combining lines above;
+    1. a second pass hits; a write goes through; a line 64 apart takes the slot;
+    2. the dma overwrites a cached line; the hand-over drops it;
+    3. the motion core and back drops every line;
+    */
+    {
+        video_core_mig_cache cache(&vid_mig);
+        const uint32_t line[4] = {0xCAFE0000, 0xCAFE0001, 0xCAFE0002, 0xCAFE0003};
+        uint32_t flush_cnt;
+        {
+            host_bus_probe probe("mig_cache.read");
+            for(i = 0; i < 2*16; i++){
+                cache.read(7000 + (i % 16), read_buffer);
+                if(read_buffer[1] != ((5*(8*(i % 16) + 2) + 1) | ((5*(8*(i % 16) + 3) + 1) << 16))){
+                    mismatch++;
+                }
+            }
+        }
+        if(cache.get_hit_cnt() != 16 || cache.get_miss_cnt() != 16){
+            mismatch++;
+        }
+        cache.write(7001, line);
+        cache.read(7001, read_buffer);
+        if(memcmp(read_buffer, line, sizeof(line)) || cache.get_hit_cnt() != 17){
+            mismatch++;
+        }
+        cache.read(7000 + MIG_CACHE_LINE_NUM, read_buffer);
+        cache.read(7000, read_buffer);
+        if(cache.get_miss_cnt() != 18 || read_buffer[0] != ((5*0 + 1) | ((5*1 + 1) << 16))){
+            mismatch++;
+        }
+
+        flush_cnt = cache.get_flush_cnt();
+        if(vid_mig.set_core_dma() != video_core_mig_interface::WAIT_OK){
+            dma_mismatch++;
+        }
+        if(vid_dma.copy_ddr2(7001, 7000, 1) != 0 || vid_dma.wait_done() != 0){
+            dma_mismatch++;
+        }
+        if(vid_mig.set_core_cpu() != video_core_mig_interface::WAIT_OK){
+            dma_mismatch++;
+        }
+        cache.read(7000, read_buffer);
+        if(memcmp(read_buffer, line, sizeof(line)) || cache.get_flush_cnt() != flush_cnt + 1){
+            mismatch++;
+        }
+        if(vid_mig.set_core_motion() != video_core_mig_interface::WAIT_OK){
+            mismatch++;
+        }
+        if(vid_mig.set_core_cpu() != video_core_mig_interface::WAIT_OK){
+            mismatch++;
+        }
+        cache.read(7000, read_buffer);
+        if(cache.get_flush_cnt() != flush_cnt + 2 || cache.get_miss_cnt() != 20){
+            mismatch++;
+        }
+    }
+
+    /* memory test; 256 lines at 12000;
+    1. every pattern passes; the cpu and the hw test circuit;
+    2. a read of the complement after the address in address fails every line;
+    3. the bandwidth and the latency are in the report;
+    */
+    {
+        memtest_result_t result;
+        memtest_bw_t bw;
+        memtest_hist_t hist;
+        uint32_t err_cnt = 0;
+        int (*const pattern[])(video_core_mig_interface *, uint32_t, uint32_t, memtest_result_t *) = {
+            memtest_march_c, memtest_walking_ones, memtest_addr_in_addr, memtest_hw_march_c, memtest_hw_addr_in_addr
+        };
+        for(i = 0; i < sizeof(pattern)/sizeof(pattern[0]); i++){
+            host_bus_probe probe("memtest.pattern");
+            if(pattern[i](&vid_mig, 12000, 256, &result) != 0 || result.err_cnt != 0 || result.first_err_addr != MEMTEST_ADDR_NONE){
+                mismatch++;
+            }
+        }
+        if(memtest_march_c(&vid_mig, 0x7FFFFF, 2, &result) != -1 || memtest_hw_march_c(&vid_mig, 12000, 0, &result) != -1){
+            mismatch++;
+        }
+        vid_mig.test_start(12000, 256, video_core_mig_interface::TEST_OP_WR);
+        if(vid_mig.test_wait(NULL) != video_core_mig_interface::WAIT_OK){
+            mismatch++;
+        }
+        vid_mig.test_start(12000, 256, video_core_mig_interface::TEST_OP_RD | video_core_mig_interface::TEST_OP_RD_INV);
+        if(vid_mig.test_wait(&err_cnt) != video_core_mig_interface::WAIT_OK || err_cnt != 256){
+            mismatch++;
+        }
+        if(vid_mig.test_end() != video_core_mig_interface::WAIT_OK){
+            mismatch++;
+        }
+        vid_mig.read_ddr2(12005, read_buffer);
+        if(read_buffer[0] != 12005 || read_buffer[3] != 12005){
+            mismatch++;
+        }
+
+        if(memtest_bw_cpu(&vid_mig, 12000, 256, &bw) != 0 || bw.copy_byte != 16*128){
+            mismatch++;
+        }
+        memtest_print_bw_uart(&bw);
+        if(memtest_bw_hw(&vid_mig, &vid_dma, 12000, 256, &bw) != 0 || bw.copy_byte != 16*128){
+            mismatch++;
+        }
+        memtest_print_bw_uart(&bw);
+        vid_mig.read_ddr2(12128, read_buffer);
+        if(read_buffer[0] != 12000){
+            dma_mismatch++;
+        }
+        if(memtest_latency(&vid_mig, 12000, 64, 0, 0, &hist) != 0 || hist.cnt != 64 || hist.min > hist.max){
+            mismatch++;
+        }
+        memtest_print_hist_uart(&hist);
+    }
+
+    /* time-sliced sharing; the dma copies the burst region while the cpu takes windows;
+    1. a window opens once the line of the dma in flight is done; nothing is pending after;
+    2. the dma is held in a window; the cpu writes and reads back a line;
+    3. the copy is intact once the share ends; no window overran its budget;
+    */
+    {
+        video_core_mig_share share(&vid_mig);
+        uint32_t line_cnt;
+
+        if(share.start(V5_MIG_INTERFACE_REG_SEL_DMA) != 0 || 
+                vid_dma.copy_ddr2(2000, DMA_COPY_ADDR + BURST_LINE_NUM, BURST_LINE_NUM) != 0){
+            dma_mismatch++;
+        }
+        for(i = 0; i < 4; i++){
+            // the dma runs between the windows;
+            for(uint32_t j = 0; j < 32; j++){
+                vid_dma.get_status();
+            }
+            if(i == 0 && !vid_dma.is_busy()){
+                dma_mismatch++;
+            }
+            {
+                host_bus_probe probe("mig_share.window");
+                if(share.window_open(SYS_CLK_FREQ_HZ/10000) != 0 || vid_mig.is_handover_pending()){
+                    dma_mismatch++;
+                }
+                line_cnt = vid_dma.get_line_cnt();
+                vid_mig.write_ddr2(30000 + i, 0x5A5A0000 + i, 0x5A5A0010 + i, 0x5A5A0020 + i, 0x5A5A0030 + i);
+                vid_mig.read_ddr2(30000 + i, read_buffer);
+                if(read_buffer[0] != 0x5A5A0000 + i || read_buffer[3] != 0x5A5A0030 + i){
+                    mismatch++;
+                }
+                if(vid_dma.get_line_cnt() != line_cnt || share.window_left() == 0 || share.window_close() != 0){
+                    dma_mismatch++;
+                }
+            }
+        }
+        if(vid_dma.wait_done() != 0 || share.end() != 0 || vid_mig.get_source() != V5_MIG_INTERFACE_REG_SEL_CPU){
+            dma_mismatch++;
+        }
+        if(share.get_window_cnt() != 4 || share.get_overrun_cnt() != 0 || share.get_window_max() == 0){
+            dma_mismatch++;
+        }
+        vid_mig.read_ddr2_burst(DMA_COPY_ADDR + BURST_LINE_NUM, burst_buffer, BURST_LINE_NUM);
+        for(i = 0; i < 4*BURST_LINE_NUM; i++){
+            if(burst_buffer[i] != i*0x01010101){
+                dma_mismatch++;
+            }
+        }
+    }
+
+    for(i = 0; i < DMA_FRAME_LINE_NUM; i++){
+        // 8 pixels per line;
+        for(uint32_t w = 0; w < 4; w++){
+            uint16_t p0 = dma_frame_pixel(8*i + 2*w);
+            uint16_t p1 = dma_frame_pixel(8*i + 2*w + 1);
+            burst_buffer[4*(i % BURST_LINE_NUM) + w] = (uint32_t)(p0 >> 8) | ((uint32_t)(p0 & 0xFF) << 8) |
+                                                    ((uint32_t)(p1 >> 8) << 16) | ((uint32_t)(p1 & 0xFF) << 24);
+        }
+        if((i % BURST_LINE_NUM) == BURST_LINE_NUM - 1 || i == DMA_FRAME_LINE_NUM - 1){
+            vid_mig.write_ddr2_burst(dma_frame.addr + i - (i % BURST_LINE_NUM), burst_buffer, (i % BURST_LINE_NUM) + 1);
+        }
+    }
+    obj_lcd.set_area(0, 0, LCD_ILI9341_DIMENSION_LOW_240 - 1, LCD_ILI9341_DIMENSION_HIGH_320 - 1);
+    obj_lcd.enable_memwr();
+    obj_lcd_controller.set_video_stream();
+    vid_src_mux.select_dma();
+    if(vid_mig.set_core_dma() != video_core_mig_interface::WAIT_OK){
+        dma_mismatch++;
+    }
+    {
+        host_bus_probe probe("dma.ddr2_to_lcd");
+        if(vid_dma.ddr2_to_lcd(dma_frame.addr, DMA_FRAME_LINE_NUM) != 0 || vid_dma.wait_done() != 0){
+            dma_mismatch++;
+        }
+    }
+    if(vid_mig.set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        dma_mismatch++;
+    }
+    vid_src_mux.disable_pixel_src();
+    obj_lcd_controller.set_cpu_stream();
+    for(i = 0; i < LCD_ILI9341_PIXEL_NUM; i++){
+        if(panel->get_gram()[i] != dma_frame_pixel(i)){
+            dma_mismatch++;
+        }
+    }
+
+    /* camera */
+    {
+        host_bus_probe probe("ov7670_init");
+        ov7670_init(OV7670_OUTPUT_FORMAT_RGB565);
+    }
+    for(i = 0; i < 100; i++){
+        host_bus_probe probe("ov7670_write");
+        ov7670_write(OV7670_REG_COM10, 0x00);
+    }
+
+    // i2c traffic per camera configuration;
+    // the register file is checked against the basic init array;
+    // reset through the bus, so that a trace of this run replays as it is;
+    ov7670_write(OV7670_REG_COM7, OV7670_COM7_SOFT_RESET);
+    for(i = 0; i < OV7670_REG_LAST; i++){
+        cam_expect[i] = cam->get_reset_value((uint8_t)i);
+    }
+    for(i = 0; ov7670_basic_init_array[i][0] != OV7670_REG_LAST; i++){
+        if(ov7670_basic_init_array[i][0] == OV7670_REG_COM7 && (ov7670_basic_init_array[i][1] & OV7670_COM7_SOFT_RESET)){
+            for(uint32_t j = 0; j < OV7670_REG_LAST; j++){
+                cam_expect[j] = cam->get_reset_value((uint8_t)j);
+            }
+        }
+        else if(ov7670_basic_init_array[i][0] != OV7670_REG_PID && ov7670_basic_init_array[i][0] != OV7670_REG_VER &&
+                ov7670_basic_init_array[i][0] != OV7670_REG_MIDH && ov7670_basic_init_array[i][0] != OV7670_REG_MIDL){
+            cam_expect[ov7670_basic_init_array[i][0]] = ov7670_basic_init_array[i][1];
+        }
+    }
+
+    printf("\n---- i2c per camera configuration (scl %" PRIu64 " Hz) ----\n", i2c->get_scl_freq());
+    printf("%-28s %8s %8s %10s %12s %12s\n", "configuration", "txn", "byte", "scl", "i2c (ms)", "total (ms)");
+    {
+        host_bus_probe probe("ov7670_write_array");
+        row = i2c_config_begin("ov7670_write_array(basic)");
+        ov7670_write_array(ov7670_basic_init_array);
+        i2c_config_end(stdout, row);
+    }
+    for(i = 0; i < OV7670_REG_LAST; i++){
+        if(cam->get_reg((uint8_t)i) != cam_expect[i]){
+            cam_mismatch++;
+        }
+    }
+    {
+        host_bus_probe probe("ov7670_set_QVGA_size");
+        row = i2c_config_begin("ov7670_set_QVGA_size");
+        ov7670_set_QVGA_size();
+        i2c_config_end(stdout, row);
+    }
+    {
+        host_bus_probe probe("ov7670_update_reg");
+        row = i2c_config_begin("ov7670_update_reg");
+        ov7670_update_reg(OV7670_REG_MVFP, MASK_TOGGLE_BIT_B5 | MASK_TOGGLE_BIT_B4, MASK_TOGGLE_BIT_B5);
+        i2c_config_end(stdout, row);
+    }
+    if((cam->get_reg(OV7670_REG_MVFP) & (MASK_TOGGLE_BIT_B5 | MASK_TOGGLE_BIT_B4)) != MASK_TOGGLE_BIT_B5){
+        cam_mismatch++;
+    }
+    {
+        host_bus_probe probe("ov7670_write");
+        row = i2c_config_begin("ov7670_write");
+        ov7670_write(OV7670_REG_COM10, OV7670_COM10_VS_NEG);
+        i2c_config_end(stdout, row);
+    }
+
+    bus.set_trace(NULL);
+
+    /* bounded waits;
+    1. a snapshot decodes one status read; a write and a read count their waits;
+    2. heavy app_rdy back-pressure: the level strobes may lose a complete pulse;
+        every call returns within the budget instead of spinning forever;
+    3. a hand-over behind a fill which cannot end (app_rdy held LOW) times out; the cpu keeps the MIG;
+        so does one to a source out of range;
+    4. a line of the reader which does not arrive is read again; the last line is not lost;
+    5. a wait during the calibration (after a reset) ends as WAIT_NOT_INIT;
+    the MIG is reconfigured outside the bus, so this is not traced either;
+    */
+    {
+        host_mig_config config = mig->get_config();
+        host_mig_config stall = config;
+        mig_status_t snapshot;
+        mig_wait_stat_t wait_stat;
+        uint32_t timeout_cnt = 0;
+        int err;
+
+        vid_mig.get_status_snapshot(&snapshot);
+        if(!snapshot.init_complete || !snapshot.app_ready || snapshot.raw != vid_mig.get_status()){
+            mismatch++;
+        }
+        vid_mig.clear_wait_stat();
+        if(vid_mig.write_ddr2(12300, 1, 2, 3, 4) != video_core_mig_interface::WAIT_OK ||
+                vid_mig.read_ddr2(12300, read_buffer) != video_core_mig_interface::WAIT_OK || read_buffer[3] != 4){
+            mismatch++;
+        }
+        vid_mig.get_wait_stat(&wait_stat);
+        if(wait_stat.wait_cnt != 4 || wait_stat.timeout_cnt != 0 || wait_stat.spin_cnt < 4){
+            mismatch++;
+        }
+
+        stall.busy_rate = 20;
+        stall.busy_length = 40;
+        mig->set_config(stall);
+        vid_mig.set_wait_budget(2000);
+        {
+            host_bus_probe probe("mig.write_ddr2_stall");
+            for(i = 0; i < 200; i++){
+                err = vid_mig.write_ddr2(12300 + i, i, i, i, i);
+                if(err == video_core_mig_interface::WAIT_TIMEOUT){
+                    timeout_cnt++;
+                }
+                else if(err != video_core_mig_interface::WAIT_OK){
+                    mismatch++;
+                }
+            }
+        }
+        vid_mig.get_wait_stat(&wait_stat);
+        if(wait_stat.timeout_cnt != timeout_cnt){
+            mismatch++;
+        }
+        stall.busy_rate = 1000;
+        stall.busy_length = 1;
+        mig->set_config(stall);
+        if(vid_mig.fill_start(12500, read_buffer, 200) != 0 ||
+                vid_mig.handover(V5_MIG_INTERFACE_REG_SEL_DMA, 64) != video_core_mig_interface::WAIT_TIMEOUT ||
+                vid_mig.handover(V5_MIG_INTERFACE_REG_SEL_TEST + 1, 64) != -1 ||
+                vid_mig.get_source() != V5_MIG_INTERFACE_REG_SEL_CPU){
+            mismatch++;
+        }
+        mig->set_config(config);
+        vid_mig.set_wait_budget(0);
+        if(vid_mig.fill_wait() != video_core_mig_interface::WAIT_OK){
+            mismatch++;
+        }
+        vid_mig.set_wait_budget(2000);
+        vid_mig.read_ddr2(12300 + 199, read_buffer);
+        if(read_buffer[0] != 199){
+            mismatch++;
+        }
+        {
+            video_core_mig_reader reader(&vid_mig);
+
+            mig->set_config(stall);
+            if(reader.open(12300 + 198, 2) != 0 ||
+                    reader.read(read_buffer) != video_core_mig_interface::WAIT_TIMEOUT || reader.get_left() != 2){
+                mismatch++;
+            }
+            mig->set_config(config);
+            if(reader.read(read_buffer) != 0 || reader.read(read_buffer) != 0 ||
+                    read_buffer[0] != 199 || reader.get_left() != 0 || reader.read(read_buffer) != -1){
+                mismatch++;
+            }
+            reader.close();
+        }
+
+        mig->reset();
+        if(vid_mig.wait_init_complete(64) != video_core_mig_interface::WAIT_NOT_INIT ||
+                vid_mig.read_ddr2(12300, read_buffer) != video_core_mig_interface::WAIT_NOT_INIT ||
+                vid_mig.wait_init_complete(0) != video_core_mig_interface::WAIT_OK ||
+                vid_mig.wait_app_ready(0) != video_core_mig_interface::WAIT_OK){
+            mismatch++;
+        }
+        // the reset has taken the MIG from the cpu;
+        if(vid_mig.set_core_cpu() != video_core_mig_interface::WAIT_OK){
+            mismatch++;
+        }
+        vid_mig.set_wait_budget(MIG_WAIT_BUDGET_CYCLE);
+        vid_mig.read_ddr2(12300, read_buffer);
+        if(read_buffer[0] != 0){
+            mismatch++;
+        }
+        printf("mig bounded waits: %u of 200 stalled writes timed out\n", timeout_cnt);
+    }
+
+    /* camera dcmi fifo;
+    sink rate (lcd WRX period) against the source rate (PCLK);
+    the source is reconfigured outside the bus, so the sweep is not traced;
+    */
+    printf("\n---- dcmi fifo stress; one frame each ----\n");
+    printf("%-10s %8s %4s %4s %6s %8s %6s %8s %8s %8s\n",
+            "source", "pclk MHz", "wrxl", "wrxh", "period", "sink MB/s", "fill", "dropped", "written", "wr_error");
+    for(i = 1; i <= 6; i++){
+        dcmi_stress_row(stdout, "emulator", host_dcmi_emulator_timing(), i, i);
+    }
+    for(i = 1; i <= 6; i++){
+        dcmi_stress_row(stdout, "ov7670", host_dcmi_ov7670_timing(12000), i, i);
+    }
+    for(i = 1; i <= 6; i++){
+        dcmi_stress_row(stdout, "ov7670", host_dcmi_ov7670_timing(24000), i, i);
+    }
+    obj_lcd_controller.set_clockmod(6, 6, 9, 39);
+
+    /* dma; dcmi to ddr2; one frame of the emulator;
+    the n-th byte of a frame is n & 0xFF; see host_dcmi_model.h;
+    the pixel converter takes nothing meanwhile;
+    */
+    {
+        host_dcmi_model *dcmi = (host_dcmi_model *)bus.get_video_core(V3_CAM_DCMI_IF);
+        host_dcmi_config timing = host_dcmi_emulator_timing();
+        uint32_t capture_line_num = timing.href_byte*timing.href_total/16;
+
+        if(capture_line_num > dma_capture.stride*dma_capture.height){
+            dma_mismatch++;
+        }
+
+        // the decoder may be waiting for VSYNC already;
+        // the source restarts the frame once the fifo is out of reset;
+        timing.sink_period = 0;
+        vid_dcmi.disable_decoder();
+        vid_dcmi.reset_fifo();
+        vid_dcmi.clear_decoder_counter();
+        if(vid_mig.set_core_dma() != video_core_mig_interface::WAIT_OK){
+            dma_mismatch++;
+        }
+        {
+            host_bus_probe probe("dma.dcmi_to_ddr2");
+            if(vid_dma.dcmi_to_ddr2(dma_capture.addr, capture_line_num) != 0){
+                dma_mismatch++;
+            }
+            dcmi->set_config(timing);
+            vid_dcmi.enable_decoder();
+            if(vid_dma.wait_done() != 0){
+                dma_mismatch++;
+            }
+        }
+        vid_dcmi.disable_decoder();
+        if(vid_mig.set_core_cpu() != video_core_mig_interface::WAIT_OK){
+            dma_mismatch++;
+        }
+        for(i = 0; i < capture_line_num; i++){
+            mig->peek_line(dma_capture.addr + i, read_buffer);
+            for(uint32_t b = 0; b < 16; b++){
+                if((uint8_t)(read_buffer[b/4] >> (8*(b % 4))) != (uint8_t)(16*i + b)){
+                    dma_mismatch++;
+                    break;
+                }
+            }
+        }
+    }
+    if(argc > 2){
+        bus.set_trace(&trace);
+    }
+
+    /* mmio */
+    for(i = 0; i < 1000; i++){
+        host_bus_probe probe("spi.full_duplex_transfer");
+        obj_spi.full_duplex_transfer((uint8_t)i);
+    }
+    for(i = 0; i < 100; i++){
+        host_bus_probe probe("uart.print");
+        sys_uart.print("0123456789abcdef\r\n");
+    }
+
+    bus.set_trace(NULL);
+    trace.close();
+
+    bus.report(stdout);
+    mig->report(stdout);
+    panel->report(stdout);
+    i2c->report(stdout);
+    cam->report(stdout);
+    ((host_dcmi_model *)bus.get_video_core(V3_CAM_DCMI_IF))->report(stdout);
+    ((host_dma_model *)bus.get_video_core(V6_DMA))->report(stdout);
+    printf("ddr2 read back mismatch: %u\n", mismatch);
+    printf("lcd fill mismatch: %u\n", lcd_mismatch);
+    printf("ov7670 register mismatch: %u\n", cam_mismatch);
+    printf("dma mismatch: %u\n", dma_mismatch);
+    printf("motion model mismatch: %u\n", motion_check());
+    return 0;
+}
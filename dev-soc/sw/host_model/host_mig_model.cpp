@@ -0,0 +1,1129 @@
+#include "host_mig_model.h"
+#include "host_bus.h"
+#include "host_dma_model.h"
+#include "stdlib.h"
+#include "string.h"
+
+// for the report;
+static const char *state_name[host_mig_model::TOTAL_STATE] = {
+    "ST_WAIT_INIT_COMPLETE",
+    "ST_IDLE",
+    "ST_WRITE_FIRST",
+    "ST_WRITE_SECOND",
+    "ST_WRITE_SUBMIT",
+    "ST_WRITE_DONE",
+    "ST_WRITE_RETRY",
+    "ST_READ_SUBMIT",
+    "ST_READ_WAIT"
+};
+
+host_mig_model::host_mig_model(host_bus *bus) : host_core_model("mig_interface"){
+    /*
+    @brief  : constructor;
+    @param  : the bus the model is attached to; the source of time;
+    @retval : none
+    @note   : the backing store is zero-filled and only
+                committed by the host os as it is touched;
+    */
+    this->bus = bus;
+    dma = NULL;
+
+    mem = (uint32_t *)calloc((size_t)TOTAL_LINE*LINE_WORD, sizeof(uint32_t));
+
+    // defaults; estimates for the Nexys A7 DDR2 at 2:1 UI clock ratio;
+    config.ui_clk_mhz   = 150;
+    config.init_latency = 15000;    // 100us;
+    config.rd_latency   = 22;
+    config.busy_rate    = 0;
+    config.busy_length  = 1;
+    config.retry_rate   = 0;
+    config.row_open_latency  = 2;   // 12.5ns;
+    config.row_close_latency = 2;   // 12.5ns;
+    config.seed         = 0x1F2E3D4C;
+
+    sys_period_ps = 1000000 / SYS_CLK_FREQ_MHZ;
+    ui_edge_ps = 0;
+    ui_cycle = 0;
+    set_config(config);
+    init_state();
+}
+
+host_mig_model::~host_mig_model(){
+    free(mem);
+}
+
+void host_mig_model::set_config(host_mig_config usr_config){
+    /*
+    @brief  : to change the timing and the back-pressure pattern;
+    @param  : configuration; see host_mig_model.h;
+    @retval : none
+    @note   : the calibration deadline is only taken at reset();
+    */
+    config = usr_config;
+    if(config.ui_clk_mhz == 0){
+        config.ui_clk_mhz = 150;
+    }
+    ui_period_ps = 1000000 / config.ui_clk_mhz;
+
+    // xorshift32 gets stuck on zero;
+    rand_state = config.seed ? config.seed : 1;
+}
+
+host_mig_config host_mig_model::get_config(void){
+    return config;
+}
+
+void host_mig_model::reset(void){
+    /*
+    @brief  : system reset; the MIG calibrates again;
+    @param  : none
+    @retval : none
+    @note   : the registers take their reset values;
+    @note   : the memory content is kept;
+    */
+    update();
+    init_state();
+}
+
+void host_mig_model::init_state(void){
+    int i;
+
+    sel_reg = V5_MIG_INTERFACE_REG_SEL_NONE;
+    sel_target = V5_MIG_INTERFACE_REG_SEL_NONE;
+    owner_busy = 0;
+    addr_reg = 0;
+    ctrl_reg = 0;
+    mode_reg = 0;
+    wrmask_reg = 0;
+    wdf_mask = 0;
+    for(i = 0; i < LINE_WORD; i++){
+        wrdata_reg[i] = 0;
+        rddata_reg[i] = 0;
+        wdf_data[i] = 0;
+    }
+    cpu_complete_reg = 0;
+
+    strobe = 0;
+    strobe_prev = 0;
+    strobe_change_ps = 0;
+    strobe_txn_cnt = 0;
+    request = 0;
+    post_head = 0;
+    post_level = 0;
+    post_busy = 0;
+    complete_cnt_reg = 0;
+    pf_busy = 0;
+    pf_drop = 0;
+    pf_line_valid = 0;
+    pf_next_valid = 0;
+    pf_addr = 0;
+    for(i = 0; i < LINE_WORD; i++){
+        pf_next[i] = 0;
+        ui_rddata[i] = 0;
+        dma_wrdata[i] = 0;
+    }
+    dma_addr = 0;
+    fill_left = 0;
+    fill_line = 0;
+    fill_addr = 0;
+    fill_busy = 0;
+    fill_done = 0;
+    test_mode = 0;
+    test_op = 0;
+    test_left = 0;
+    test_addr = 0;
+    test_err = 0;
+    test_done = 0;
+    test_busy = 0;
+    test_is_write = 0;
+    for(i = 0; i < LINE_WORD; i++){
+        test_wrdata[i] = 0;
+    }
+    request_due_ps[0] = 0;
+    request_due_ps[1] = 0;
+    complete_pending = 0;
+
+    state = ST_WAIT_INIT_COMPLETE;
+    app_rdy = 0;
+    busy_left = 0;
+    rd_due = 0;
+    rd_addr = 0;
+    wr_due = 0;
+    row_close_all();
+    init_done_cycle = ui_cycle + config.init_latency;
+
+    clear_stat();
+}
+
+void host_mig_model::peek_line(uint32_t addr, uint32_t *data){
+    memcpy(data, &mem[(size_t)(addr & ADDR_MASK)*LINE_WORD], LINE_WORD*sizeof(uint32_t));
+}
+
+void host_mig_model::poke_line(uint32_t addr, const uint32_t *data){
+    memcpy(&mem[(size_t)(addr & ADDR_MASK)*LINE_WORD], data, LINE_WORD*sizeof(uint32_t));
+}
+
+void host_mig_model::set_dma(host_dma_model *dma){
+    this->dma = dma;
+}
+
+int host_mig_model::dma_request(int is_write, uint32_t addr, const uint32_t *wr_data, uint64_t at_ps){
+    /*
+    @brief  : one-shot request from the dma (core_dma_wr_request/core_dma_rd_request);
+    @param  :
+        1. is_write : 1 for a write; 0 for a read;
+        2. addr     : line address; held by the dma until the complete pulse;
+        3. wr_data  : line to write; ignored for a read;
+        4. at_ps    : system clock edge of the request pulse;
+    @retval : 0 if taken; -1 if another source has the MIG (core_dma_MIG_ready LOW);
+    @note   : the model is not advanced; the request may be ahead of the bus cycle;
+    */
+    if(sel_reg != V5_MIG_INTERFACE_REG_SEL_DMA || sel_target != sel_reg){
+        return -1;
+    }
+    dma_addr = addr & ADDR_MASK;
+    if(is_write){
+        memcpy(dma_wrdata, wr_data, sizeof(dma_wrdata));
+    }
+    submit_request(is_write ? CTRL_WRSTROBE_MASK : CTRL_RDSTROBE_MASK, at_ps);
+    return 0;
+}
+
+void host_mig_model::run_to(uint64_t at_ps){
+    /*
+    @brief  : to advance the model up to the given time;
+    @param  : time; not behind the bus cycle of the last register access;
+    @retval : none
+    @note   : nothing happens in ST_IDLE without a strobe,
+                nor in ST_WAIT_INIT_COMPLETE before the calibration is done;
+                both are skipped over in one go;
+    */
+    uint64_t now_ps = at_ps;
+    uint64_t edge_cnt;
+    uint64_t skip;
+
+    while(1){
+        // system clock domain first; a complete pulse may submit the next posted write;
+        service_complete((ui_edge_ps <= now_ps) ? ui_edge_ps : now_ps);
+        if(ui_edge_ps > now_ps){
+            break;
+        }
+
+        edge_cnt = (now_ps - ui_edge_ps)/ui_period_ps + 1;
+        skip = 0;
+        if(state == ST_WAIT_INIT_COMPLETE && ui_cycle < init_done_cycle){
+            skip = init_done_cycle - ui_cycle;
+        }
+        else if(state == ST_IDLE && strobe == 0 && get_strobe_sync() == 0 && request == 0){
+            skip = edge_cnt;
+            // not past a complete pulse on its way;
+            if(complete_pending && complete_due_ps[0] >= ui_edge_ps){
+                edge_cnt = (complete_due_ps[0] - ui_edge_ps)/ui_period_ps + 1;
+            }
+        }
+        if(skip > edge_cnt){
+            skip = edge_cnt;
+        }
+
+        if(skip){
+            stat.state_cycle[state] += skip;
+            ui_cycle += skip;
+            ui_edge_ps += skip*ui_period_ps;
+            busy_left = (busy_left > skip) ? (uint32_t)(busy_left - skip) : 0;
+            app_rdy = (ui_cycle >= init_done_cycle && busy_left == 0);
+            continue;
+        }
+
+        step();
+        ui_cycle++;
+        ui_edge_ps += ui_period_ps;
+    }
+}
+
+int host_mig_model::get_state(void){
+    update();
+    return state;
+}
+
+host_mig_stat host_mig_model::get_stat(void){
+    update();
+    return stat;
+}
+
+void host_mig_model::clear_stat(void){
+    memset(&stat, 0, sizeof(stat));
+}
+
+uint32_t host_mig_model::row_access(uint32_t addr){
+    /*
+    @brief  : the row buffer of the bank of a command;
+    @param  : line address;
+    @retval : ui clock cycles before the column command; 0 for a hit;
+    @note   : the row is left open (open page);
+    */
+   uint32_t bank = (addr >> BANK_SHIFT) & (BANK_NUM - 1);
+   uint32_t row = (addr >> ROW_SHIFT) & ROW_MASK;
+   uint32_t wait;
+
+   if(open_row[bank] == row){
+        stat.row_hit_cnt++;
+        return 0;
+   }
+   if(open_row[bank] == ROW_NONE){
+        stat.row_empty_cnt++;
+        wait = config.row_open_latency;
+   }
+   else{
+        stat.row_conflict_cnt++;
+        wait = config.row_close_latency + config.row_open_latency;
+   }
+   open_row[bank] = row;
+   stat.row_wait_cycle += wait;
+   return wait;
+}
+
+void host_mig_model::row_close_all(void){
+    // precharge all; refresh;
+    for(uint32_t i = 0; i < BANK_NUM; i++){
+        open_row[i] = ROW_NONE;
+    }
+}
+
+int host_mig_model::roll(uint32_t rate){
+    /*
+    @brief  : to draw an event with the given rate;
+    @param  : rate in parts per 1000;
+    @retval : 1 if the event happens;
+    */
+    if(rate == 0){
+        return 0;
+    }
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return ((rand_state % 1000) < rate);
+}
+
+uint32_t host_mig_model::get_strobe(void){
+    // the cpu strobes only pass the source mux when the cpu is selected;
+    if(sel_reg != V5_MIG_INTERFACE_REG_SEL_CPU){
+        return 0;
+    }
+    return ctrl_reg & (CTRL_WRSTROBE_MASK | CTRL_RDSTROBE_MASK);
+}
+
+uint32_t host_mig_model::get_strobe_sync(void){
+    // as seen by the FSM at the next ui clock edge;
+    if(ui_edge_ps >= strobe_change_ps + STROBE_SYNC_STAGE*ui_period_ps){
+        return strobe;
+    }
+    return strobe_prev;
+}
+
+uint32_t host_mig_model::get_request_sync(void){
+    // pending requests as seen by the FSM at the next ui clock edge;
+    uint32_t sync = 0;
+
+    if((request & CTRL_WRSTROBE_MASK) && ui_edge_ps >= request_due_ps[0]){
+        sync |= CTRL_WRSTROBE_MASK;
+    }
+    if((request & CTRL_RDSTROBE_MASK) && ui_edge_ps >= request_due_ps[1]){
+        sync |= CTRL_RDSTROBE_MASK;
+    }
+    return sync;
+}
+
+void host_mig_model::post_request(uint32_t mask, uint64_t at_ps){
+    /*
+    @brief  : one-shot request from the cpu (stream mode) or from the posted write fifo;
+    @param  :
+        1. mask     : CTRL_WRSTROBE_MASK and/or CTRL_RDSTROBE_MASK;
+        2. at_ps    : system clock edge of the request pulse;
+    @retval : none
+    @note   : only passes the source mux when the cpu is selected;
+    */
+    if(sel_reg != V5_MIG_INTERFACE_REG_SEL_CPU){
+        return;
+    }
+    submit_request(mask, at_ps);
+}
+
+void host_mig_model::submit_request(uint32_t mask, uint64_t at_ps){
+    /*
+    @brief  : one-shot request after the source mux; into the toggle synchronizer;
+    @param  : see post_request();
+    @retval : none
+    @note   : it clears the cpu complete flag whatever the source;
+    */
+    uint64_t due_ps = at_ps + REQUEST_SYNC_STAGE*ui_period_ps;
+
+    if(mask == 0){
+        return;
+    }
+    if((mask & CTRL_WRSTROBE_MASK) && !(request & CTRL_WRSTROBE_MASK)){
+        request_due_ps[0] = due_ps;
+    }
+    if((mask & CTRL_RDSTROBE_MASK) && !(request & CTRL_RDSTROBE_MASK)){
+        request_due_ps[1] = due_ps;
+    }
+    request |= mask;
+    cpu_complete_reg = 0;
+    owner_busy = 1;
+}
+
+void host_mig_model::post_write(void){
+    /*
+    @brief  : the last write data word in the posted mode;
+    @param  : none
+    @retval : none
+    @note   : {address, data} into the fifo; the address register post-increments;
+    @note   : dropped if the fifo is full;
+    */
+    post_entry *e;
+    int i;
+
+    if(post_level == POST_FIFO_DEPTH){
+        stat.post_drop_cnt++;
+        return;
+    }
+    e = &post_fifo[(post_head + post_level) % POST_FIFO_DEPTH];
+    e->addr = addr_reg;
+    e->mask = wrmask_reg;
+    for(i = 0; i < LINE_WORD; i++){
+        e->data[i] = wrdata_reg[i];
+    }
+    post_level++;
+    addr_reg = (addr_reg + 1) & ADDR_MASK;
+    stat.post_cnt++;
+    if((uint32_t)post_level > stat.post_peak){
+        stat.post_peak = post_level;
+    }
+
+    // the head goes out a cycle after it is in the fifo;
+    post_issue(bus->get_cycle()*sys_period_ps + sys_period_ps);
+}
+
+void host_mig_model::post_issue(uint64_t at_ps){
+    // submit the head if none is in flight;
+    if(!post_busy && post_level && fill_left == 0 && sel_reg == V5_MIG_INTERFACE_REG_SEL_CPU && sel_target == sel_reg){
+        post_busy = 1;
+        post_request(CTRL_WRSTROBE_MASK, at_ps);
+    }
+}
+
+void host_mig_model::prefetch_restart(void){
+    /*
+    @brief  : the address or the mode register is written; 
+    @param  : none
+    @retval : none
+    @note   : the lines held are discarded; a read in flight is dropped on arrival;
+    @note   : the next read goes out a cycle later (read-ahead mode only);
+    */
+    pf_line_valid = 0;
+    pf_next_valid = 0;
+    if(pf_busy){
+        pf_drop = 1;
+    }
+    prefetch_issue(bus->get_cycle()*sys_period_ps + sys_period_ps);
+}
+
+void host_mig_model::prefetch_issue(uint64_t at_ps){
+    // read the next line if none is in flight and the shadow is free;
+    if((mode_reg & MODE_PREFETCH_MASK) && !pf_busy && !pf_next_valid && post_level == 0 
+        && fill_left == 0 && sel_reg == V5_MIG_INTERFACE_REG_SEL_CPU && sel_target == sel_reg){
+        pf_busy = 1;
+        pf_addr = addr_reg;
+        addr_reg = (addr_reg + 1) & ADDR_MASK;
+        stat.pf_rd_cnt++;
+        post_request(CTRL_RDSTROBE_MASK, at_ps);
+    }
+}
+
+void host_mig_model::prefetch_pop(void){
+    /*
+    @brief  : RDDATA_04 is read in the read-ahead mode;
+    @param  : none
+    @retval : none
+    @note   : the shadow moves in; the read after it goes out a cycle later;
+    */
+    int i;
+
+    if(!pf_line_valid){
+        return;
+    }
+    stat.pf_pop_cnt++;
+    if(pf_next_valid){
+        stat.pf_pop_next_cnt++;
+        for(i = 0; i < LINE_WORD; i++){
+            rddata_reg[i] = pf_next[i];
+        }
+        pf_next_valid = 0;
+        prefetch_issue(bus->get_cycle()*sys_period_ps + sys_period_ps);
+    }
+    else{
+        pf_line_valid = 0;
+    }
+}
+
+void host_mig_model::fill_start(uint32_t nlines){
+    /*
+    @brief  : the fill register is written;
+    @param  : number of lines;
+    @retval : none
+    @note   : ignored for 0 lines, while a fill runs,
+                while posted writes are pending or a read-ahead read is in flight;
+    @note   : the first line goes out a cycle later;
+    */
+    if(nlines == 0 || fill_left || post_level || pf_busy){
+        return;
+    }
+    fill_left = nlines;
+    fill_line = 0;
+    fill_addr = addr_reg;
+    fill_done = 0;
+    stat.fill_cnt++;
+    fill_issue(bus->get_cycle()*sys_period_ps + sys_period_ps);
+}
+
+void host_mig_model::fill_issue(uint64_t at_ps){
+    // write the next line if none is in flight;
+    if(fill_left && !fill_busy && sel_reg == V5_MIG_INTERFACE_REG_SEL_CPU && sel_target == sel_reg){
+        fill_busy = 1;
+        post_request(CTRL_WRSTROBE_MASK, at_ps);
+    }
+}
+
+void host_mig_model::test_start(uint32_t wr_data){
+    /*
+    @brief  : the hw test register is written;
+    @param  : register value; {bench mode, march element, lines};
+    @retval : none
+    @note   : a start with the bench mode and a non-zero number of lines;
+                ignored while an element runs;
+    @note   : the first line goes out a cycle later;
+    */
+    uint32_t nlines = wr_data & TEST_LEN_MASK;
+
+    test_mode = (wr_data >> V5_MIG_INTERFACE_REG_BIT_POS_TEST_MODE) & 0x01;
+    if(!test_mode || nlines == 0 || test_left){
+        return;
+    }
+    test_op = (wr_data >> V5_MIG_INTERFACE_REG_BIT_POS_TEST_OP) & TEST_OP_MASK;
+    test_left = nlines;
+    test_addr = (test_op & V5_MIG_INTERFACE_TEST_OP_DOWN) ? ((addr_reg + nlines - 1) & ADDR_MASK) : addr_reg;
+    test_err = 0;
+    test_done = 0;
+    stat.test_cnt++;
+    if(!(test_op & (V5_MIG_INTERFACE_TEST_OP_RD | V5_MIG_INTERFACE_TEST_OP_WR))){
+        // nothing to do;
+        test_left = 0;
+        test_done = 1;
+        return;
+    }
+    test_is_write = !(test_op & V5_MIG_INTERFACE_TEST_OP_RD);
+    test_issue(bus->get_cycle()*sys_period_ps + sys_period_ps);
+}
+
+void host_mig_model::test_pattern(int inv, uint32_t *data){
+    // the address in address; every word holds the line address;
+    int i;
+
+    for(i = 0; i < LINE_WORD; i++){
+        data[i] = inv ? ~test_addr : test_addr;
+    }
+}
+
+void host_mig_model::test_issue(uint64_t at_ps){
+    // the read or the write of the line if none is in flight;
+    if(test_left && !test_busy && sel_reg == V5_MIG_INTERFACE_REG_SEL_TEST && sel_target == sel_reg){
+        test_busy = 1;
+        if(test_is_write){
+            test_pattern(test_op & V5_MIG_INTERFACE_TEST_OP_WR_INV, test_wrdata);
+        }
+        submit_request(test_is_write ? CTRL_WRSTROBE_MASK : CTRL_RDSTROBE_MASK, at_ps);
+    }
+}
+
+uint32_t host_mig_model::get_user_addr(void){
+    // the dma when it has the MIG;
+    // the hw test circuit when it has the MIG;
+    // the fifo head while posted writes are pending;
+    // the next line while a fill runs;
+    // the read in flight in the read-ahead mode;
+    if(sel_reg == V5_MIG_INTERFACE_REG_SEL_DMA){
+        return dma_addr;
+    }
+    if(sel_reg == V5_MIG_INTERFACE_REG_SEL_TEST){
+        return test_addr;
+    }
+    if(post_level){
+        return post_fifo[post_head].addr;
+    }
+    if(fill_left){
+        return fill_addr;
+    }
+    return pf_busy ? pf_addr : addr_reg;
+}
+
+const uint32_t *host_mig_model::get_user_wrdata(void){
+    if(sel_reg == V5_MIG_INTERFACE_REG_SEL_DMA){
+        return dma_wrdata;
+    }
+    if(sel_reg == V5_MIG_INTERFACE_REG_SEL_TEST){
+        return test_wrdata;
+    }
+    return post_level ? post_fifo[post_head].data : wrdata_reg;
+}
+
+uint32_t host_mig_model::get_user_wrmask(void){
+    // the other sources write all bytes;
+    if(sel_reg != V5_MIG_INTERFACE_REG_SEL_CPU){
+        return 0;
+    }
+    return post_level ? post_fifo[post_head].mask : wrmask_reg;
+}
+
+void host_mig_model::complete(void){
+    /*
+    @brief  : transaction_complete_async;
+    @param  : none
+    @retval : none
+    @note   : the pulse reaches the cpu complete flag after the toggle synchronizer;
+    */
+    stat.complete_cnt++;
+    if(complete_pending == 4){
+        // cannot happen at the modelled rates; keep the latest;
+        memmove(&complete_due_ps[0], &complete_due_ps[1], 3*sizeof(uint64_t));
+        complete_pending--;
+    }
+    complete_due_ps[complete_pending++] = ui_edge_ps + COMPLETE_SYNC_STAGE*sys_period_ps;
+}
+
+void host_mig_model::step(void){
+    /*
+    @brief  : one ui clock cycle of user_mig_DDR2_sync_ctrl.sv;
+    @param  : none
+    @retval : none
+    @note   : app_wdf_rdy is taken to follow app_rdy;
+    @note   : a resubmitted read discards the data of the first one;
+    */
+    uint32_t strobe_sync = get_strobe_sync();
+    uint32_t request_sync = get_request_sync();
+    uint32_t *line;
+    uint32_t byte_keep;
+    int init = (ui_cycle >= init_done_cycle);
+    int i, j;
+
+    // MIG app_rdy for this cycle;
+    if(!init){
+        app_rdy = 0;
+    }
+    else if(busy_left){
+        busy_left--;
+        app_rdy = 0;
+    }
+    else if(roll(config.busy_rate)){
+        busy_left = config.busy_length ? config.busy_length - 1 : 0;
+        app_rdy = 0;
+        row_close_all();
+    }
+    else{
+        app_rdy = 1;
+    }
+    if(init && !app_rdy){
+        stat.busy_cycle++;
+    }
+    stat.state_cycle[state]++;
+
+    switch(state){
+        case ST_WAIT_INIT_COMPLETE:
+            if(init && app_rdy){
+                state = ST_IDLE;
+            }
+            break;
+
+        case ST_IDLE:
+            if(app_rdy && (strobe_sync || request_sync)){
+                // the strobe is a level; it starts over if it is still HIGH;
+                // a one-shot request is taken once;
+                if((strobe_sync | request_sync) & CTRL_WRSTROBE_MASK){
+                    state = ST_WRITE_FIRST;
+                    request &= ~(uint32_t)CTRL_WRSTROBE_MASK;
+                }
+                else{
+                    state = ST_READ_SUBMIT;
+                    request &= ~(uint32_t)CTRL_RDSTROBE_MASK;
+                }
+                if(strobe_sync && strobe_txn_cnt++){
+                    stat.repeat_cnt++;
+                }
+            }
+            break;
+
+        case ST_WRITE_FIRST:
+            if(app_rdy){
+                wdf_data[0] = get_user_wrdata()[0];
+                wdf_data[1] = get_user_wrdata()[1];
+                wdf_mask = get_user_wrmask() & 0x00FF;
+                state = ST_WRITE_SECOND;
+            }
+            break;
+
+        case ST_WRITE_SECOND:
+            if(app_rdy){
+                wdf_data[2] = get_user_wrdata()[2];
+                wdf_data[3] = get_user_wrdata()[3];
+                wdf_mask |= get_user_wrmask() & 0xFF00;
+                state = ST_WRITE_SUBMIT;
+            }
+            break;
+
+        case ST_WRITE_SUBMIT:
+            if(app_rdy){
+                // app_en with MIG_CMD_WRITE; the address is sampled here;
+                // a masked byte is kept;
+                line = &mem[(size_t)(get_user_addr() & ADDR_MASK)*LINE_WORD];
+                for(i = 0; i < LINE_WORD; i++){
+                    byte_keep = 0;
+                    for(j = 0; j < 4; j++){
+                        if(wdf_mask & BIT_MASK(4*i + j)){
+                            byte_keep |= 0xFFu << (8*j);
+                        }
+                    }
+                    line[i] = (line[i] & byte_keep) | (wdf_data[i] & ~byte_keep);
+                }
+                if(wdf_mask){
+                    stat.masked_wr_cnt++;
+                }
+                stat.wr_cnt++;
+                wr_due = row_access(get_user_addr() & ADDR_MASK);
+                state = ST_WRITE_DONE;
+            }
+            break;
+
+        case ST_WRITE_DONE:
+            if(wr_due){
+                // the activate (and the precharge) of the row;
+                wr_due--;
+            }
+            else if(app_rdy && !roll(config.retry_rate)){
+                complete();
+                state = ST_IDLE;
+            }
+            else{
+                stat.wr_retry_cnt++;
+                state = ST_WRITE_RETRY;
+            }
+            break;
+
+        case ST_WRITE_RETRY:
+            if(app_rdy){
+                state = ST_WRITE_FIRST;
+            }
+            break;
+
+        case ST_READ_SUBMIT:
+            if(app_rdy){
+                // app_en with MIG_CMD_READ;
+                rd_addr = get_user_addr() & ADDR_MASK;
+                rd_due = ui_cycle + (config.rd_latency ? config.rd_latency : 1) + row_access(rd_addr);
+                stat.rd_cnt++;
+                state = ST_READ_WAIT;
+            }
+            break;
+
+        case ST_READ_WAIT:
+            if(app_rdy && !roll(config.retry_rate)){
+                line = &mem[(size_t)rd_addr*LINE_WORD];
+                if(ui_cycle == rd_due){
+                    // app_rd_data_valid; first batch;
+                    ui_rddata[0] = line[0];
+                    ui_rddata[1] = line[1];
+                }
+                else if(ui_cycle > rd_due){
+                    // app_rd_data_end; second batch;
+                    ui_rddata[2] = line[2];
+                    ui_rddata[3] = line[3];
+                    // the cpu registers follow user_rd_data unless in the read-ahead mode;
+                    if(!(mode_reg & MODE_PREFETCH_MASK)){
+                        memcpy(rddata_reg, ui_rddata, sizeof(rddata_reg));
+                    }
+                    complete();
+                    state = ST_IDLE;
+                }
+            }
+            else{
+                stat.rd_resubmit_cnt++;
+                state = ST_READ_SUBMIT;
+            }
+            break;
+
+        default:
+            state = ST_WAIT_INIT_COMPLETE;
+            break;
+    }
+}
+
+void host_mig_model::update(void){
+    /*
+    @brief  : to advance the model up to the current bus cycle;
+    @param  : none
+    @retval : none
+    */
+    run_to(bus->get_cycle()*sys_period_ps);
+}
+
+void host_mig_model::service_complete(uint64_t until_ps){
+    /*
+    @brief  : complete pulses which have reached the system clock domain by until_ps;
+    @param  : time limit;
+    @retval : none
+    @note   : the flag is only set while no strobe is held;
+    @note   : a posted write is popped; the next one is submitted a cycle later;
+    @note   : stream mode: the address register post-increments (not for a posted write);
+    @note   : read-ahead: the line is taken; the next read goes out a cycle later;
+    @note   : fill: the next line goes out a cycle later;
+    @note   : dma: the pulse and user_rd_data go to the dma;
+    @note   : hw test: the line read is checked; the write goes out a cycle later;
+                the next line two cycles later (ST_BENCH_NEXT);
+    */
+    uint64_t due_ps;
+    uint32_t expect[LINE_WORD];
+    int i;
+
+    while(complete_pending && complete_due_ps[0] <= until_ps){
+        due_ps = complete_due_ps[0];
+        // before the source is told; it may submit the next one right away;
+        owner_busy = 0;
+        if(sel_reg == V5_MIG_INTERFACE_REG_SEL_CPU){
+            complete_cnt_reg = (complete_cnt_reg + 1) & 0xFF;
+            if(post_busy){
+                post_head = (post_head + 1) % POST_FIFO_DEPTH;
+                post_level--;
+                post_busy = 0;
+                post_issue((due_ps/sys_period_ps + 1)*sys_period_ps);
+            }
+            else if(pf_busy){
+                // into Register 8-11 if free, else into the shadow;
+                pf_busy = 0;
+                if(pf_drop){
+                    pf_drop = 0;
+                    stat.pf_drop_cnt++;
+                }
+                else if(mode_reg & MODE_PREFETCH_MASK){
+                    if(!pf_line_valid){
+                        memcpy(rddata_reg, ui_rddata, sizeof(rddata_reg));
+                        pf_line_valid = 1;
+                    }
+                    else{
+                        memcpy(pf_next, ui_rddata, sizeof(pf_next));
+                        pf_next_valid = 1;
+                    }
+                }
+                prefetch_issue((due_ps/sys_period_ps + 1)*sys_period_ps);
+            }
+            else if(fill_busy){
+                fill_busy = 0;
+                fill_left--;
+                fill_line = (fill_line + 1) & FILL_LEN_MASK;
+                fill_addr = (fill_addr + 1) & ADDR_MASK;
+                stat.fill_line_cnt++;
+                if(fill_left == 0){
+                    fill_done = 1;
+                }
+                fill_issue((due_ps/sys_period_ps + 1)*sys_period_ps);
+            }
+            else if(mode_reg & MODE_STREAM_MASK){
+                addr_reg = (addr_reg + 1) & ADDR_MASK;
+            }
+        }
+        else if(sel_reg == V5_MIG_INTERFACE_REG_SEL_DMA && dma != NULL){
+            dma->mig_complete(ui_rddata, due_ps);
+        }
+        else if(sel_reg == V5_MIG_INTERFACE_REG_SEL_TEST && test_busy){
+            test_busy = 0;
+            if(!test_is_write){
+                test_pattern(test_op & V5_MIG_INTERFACE_TEST_OP_RD_INV, expect);
+                if(memcmp(expect, ui_rddata, sizeof(expect)) != 0){
+                    stat.test_err_cnt++;
+                    if(test_err != TEST_ERR_MAX){
+                        test_err++;
+                    }
+                }
+            }
+            if(!test_is_write && (test_op & V5_MIG_INTERFACE_TEST_OP_WR)){
+                test_is_write = 1;
+                test_issue((due_ps/sys_period_ps + 1)*sys_period_ps);
+            }
+            else{
+                test_left--;
+                test_addr = (test_op & V5_MIG_INTERFACE_TEST_OP_DOWN) ? ((test_addr - 1) & ADDR_MASK) : ((test_addr + 1) & ADDR_MASK);
+                stat.test_line_cnt++;
+                if(test_left == 0){
+                    test_done = 1;
+                }
+                test_is_write = !(test_op & V5_MIG_INTERFACE_TEST_OP_RD);
+                test_issue((due_ps/sys_period_ps + 2)*sys_period_ps);
+            }
+        }
+        if(get_strobe()){
+            stat.complete_lost_cnt++;
+        }
+        else{
+            cpu_complete_reg = 1;
+        }
+        for(i = 1; i < complete_pending; i++){
+            complete_due_ps[i - 1] = complete_due_ps[i];
+        }
+        complete_pending--;
+
+        // a pending hand-over is taken a cycle later;
+        handover_take((due_ps/sys_period_ps + 1)*sys_period_ps);
+    }
+}
+
+void host_mig_model::handover_take(uint64_t at_ps){
+    /*
+    @brief  : the source written in register 0 takes the MIG;
+    @param  : system clock edge;
+    @retval : none
+    @note   : only once the source that has the MIG waits for nothing;
+    @note   : the work held back goes out; a dma waiting for the MIG goes on;
+    */
+    if(sel_target != sel_reg && (owner_busy || get_strobe())){
+        return;
+    }
+    sel_reg = sel_target;
+    post_issue(at_ps);
+    prefetch_issue(at_ps);
+    fill_issue(at_ps);
+    test_issue(at_ps);
+    if(sel_reg == V5_MIG_INTERFACE_REG_SEL_DMA && dma != NULL){
+        dma->mig_grant(at_ps);
+    }
+}
+
+uint32_t host_mig_model::read(uint32_t reg_offset){
+    uint32_t status;
+
+    update();
+    switch(reg_offset){
+        case REG_SEL_OFFSET:
+            return sel_reg | ((sel_target != sel_reg) ? SEL_PENDING_MASK : 0);
+
+        case REG_STATUS_OFFSET:
+            // {complete count, fill done, fill running, read-ahead in flight, outstanding posts, read-ahead lines, posted mode, stream mode, ctrl_idle, cpu complete, app_rdy, init_calib_complete};
+            status = 0;
+            if(ui_cycle >= init_done_cycle){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_MIG_INIT);
+            }
+            if(app_rdy){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_MIG_RDY);
+            }
+            if(cpu_complete_reg){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_COMPLETE);
+            }
+            if(state == ST_IDLE){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_CTRL_IDLE);
+            }
+            if(mode_reg & MODE_STREAM_MASK){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_STREAM);
+            }
+            if(mode_reg & MODE_POSTED_MASK){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_POSTED);
+            }
+            if(pf_line_valid){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_PF_LINE);
+            }
+            if(pf_next_valid){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_PF_NEXT);
+            }
+            if(pf_busy){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_PF_BUSY);
+            }
+            if(fill_left){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_FILL_BUSY);
+            }
+            if(fill_done){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_STATUS_FILL_DONE);
+            }
+            status |= (uint32_t)post_level << V5_MIG_INTERFACE_REG_BIT_POS_STATUS_POST_CNT;
+            status |= complete_cnt_reg << V5_MIG_INTERFACE_REG_BIT_POS_STATUS_COMPLETE_CNT;
+            return status;
+
+        case REG_ADDR_OFFSET:
+            return addr_reg;
+
+        case REG_FILL_OFFSET:
+            return fill_line;
+
+        case REG_WRMASK_OFFSET:
+            return wrmask_reg;
+
+        case REG_TEST_OFFSET:
+            // {bench mode, done, running, lines read back wrong};
+            status = test_err;
+            if(test_left){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_TEST_BUSY);
+            }
+            if(test_done){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_TEST_DONE);
+            }
+            if(test_mode){
+                status |= BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_TEST_MODE);
+            }
+            return status;
+
+        case V5_MIG_INTERFACE_REG_RDDATA_01:
+        case V5_MIG_INTERFACE_REG_RDDATA_02:
+        case V5_MIG_INTERFACE_REG_RDDATA_03:
+            return rddata_reg[reg_offset - REG_RDDATA_01_OFFSET];
+
+        case V5_MIG_INTERFACE_REG_RDDATA_04:
+            // read-ahead mode: the line is taken;
+            status = rddata_reg[3];
+            if(mode_reg & MODE_PREFETCH_MASK){
+                prefetch_pop();
+            }
+            return status;
+
+        default:
+            // write only or unused;
+            return 0;
+    }
+}
+
+void host_mig_model::write(uint32_t reg_offset, uint32_t wr_data){
+    uint32_t strobe_next;
+
+    update();
+    switch(reg_offset){
+        case REG_SEL_OFFSET:
+            // the posted writes held back while another source had the MIG go out;
+            // deferred while the source that has it waits for a complete pulse;
+            sel_target = wr_data & SEL_MASK;
+            handover_take(bus->get_cycle()*sys_period_ps + sys_period_ps);
+            break;
+
+        case REG_ADDR_OFFSET:
+            addr_reg = wr_data & ADDR_MASK;
+            prefetch_restart();
+            break;
+
+        case REG_CTRL_OFFSET:
+            // stream mode: one-shot; nothing is held;
+            if(mode_reg & MODE_STREAM_MASK){
+                ctrl_reg = 0;
+                post_request(wr_data & (CTRL_WRSTROBE_MASK | CTRL_RDSTROBE_MASK), bus->get_cycle()*sys_period_ps);
+            }
+            else{
+                ctrl_reg = wr_data;
+            }
+            break;
+
+        case V5_MIG_INTERFACE_REG_WRDATA_01:
+        case V5_MIG_INTERFACE_REG_WRDATA_02:
+        case V5_MIG_INTERFACE_REG_WRDATA_03:
+        case V5_MIG_INTERFACE_REG_WRDATA_04:
+            wrdata_reg[reg_offset - REG_WRDATA_01_OFFSET] = wr_data;
+            // posted mode: the last word posts the write;
+            // stream mode: the last word submits the write;
+            if(reg_offset == V5_MIG_INTERFACE_REG_WRDATA_04){
+                if(mode_reg & MODE_POSTED_MASK){
+                    post_write();
+                }
+                else if(mode_reg & MODE_STREAM_MASK){
+                    post_request(CTRL_WRSTROBE_MASK, bus->get_cycle()*sys_period_ps);
+                }
+            }
+            break;
+
+        case REG_MODE_OFFSET:
+            mode_reg = wr_data;
+            prefetch_restart();
+            break;
+
+        case REG_FILL_OFFSET:
+            fill_start(wr_data & FILL_LEN_MASK);
+            break;
+
+        case REG_WRMASK_OFFSET:
+            wrmask_reg = wr_data & WRMASK_MASK;
+            break;
+
+        case REG_TEST_OFFSET:
+            test_start(wr_data);
+            break;
+
+        default:
+            break;
+    }
+
+    // strobe after the source mux;
+    strobe_next = get_strobe();
+    if(strobe_next != strobe){
+        if(strobe == 0){
+            strobe_txn_cnt = 0;
+            owner_busy = 1;
+        }
+        strobe_prev = strobe;
+        strobe = strobe_next;
+        strobe_change_ps = bus->get_cycle()*sys_period_ps;
+    }
+
+    // a hand-over held by a strobe;
+    if(sel_target != sel_reg){
+        handover_take(bus->get_cycle()*sys_period_ps + sys_period_ps);
+    }
+
+    // a held strobe clears the cpu complete flag;
+    if(strobe){
+        cpu_complete_reg = 0;
+    }
+}
+
+void host_mig_model::report(FILE *fp){
+    /*
+    @brief  : to print the configuration, the event count and the FSM occupancy;
+    @param  : output stream;
+    @retval : none
+    */
+    uint64_t total = 0;
+    int i;
+
+    update();
+    for(i = 0; i < TOTAL_STATE; i++){
+        total += stat.state_cycle[i];
+    }
+
+    fprintf(fp, "\n---- ddr2 mig model (ui clock %u MHz, read latency %u, busy %u/1000 x %u, retry %u/1000) ----\n",
+        config.ui_clk_mhz, config.rd_latency, config.busy_rate, config.busy_length, config.retry_rate);
+    fprintf(fp, "write cmd       : %" PRIu64 " (masked: %" PRIu64 ")\n", stat.wr_cnt, stat.masked_wr_cnt);
+    fprintf(fp, "read cmd        : %" PRIu64 "\n", stat.rd_cnt);
+    fprintf(fp, "complete        : %" PRIu64 " (not latched: %" PRIu64 ")\n",
+        stat.complete_cnt, stat.complete_lost_cnt);
+    fprintf(fp, "repeated by held strobe : %" PRIu64 "\n", stat.repeat_cnt);
+    fprintf(fp, "posted write    : %" PRIu64 " (dropped: %" PRIu64 ", peak outstanding: %u)\n",
+        stat.post_cnt, stat.post_drop_cnt, stat.post_peak);
+    fprintf(fp, "read ahead      : %" PRIu64 " (dropped: %" PRIu64 ", taken: %" PRIu64 ", next line ready: %" PRIu64 ")\n",
+        stat.pf_rd_cnt, stat.pf_drop_cnt, stat.pf_pop_cnt, stat.pf_pop_next_cnt);
+    fprintf(fp, "fill            : %" PRIu64 " (lines: %" PRIu64 ")\n",
+        stat.fill_cnt, stat.fill_line_cnt);
+    fprintf(fp, "hw test element : %" PRIu64 " (lines: %" PRIu64 ", read back wrong: %" PRIu64 ")\n",
+        stat.test_cnt, stat.test_line_cnt, stat.test_err_cnt);
+    fprintf(fp, "write retry     : %" PRIu64 "\n", stat.wr_retry_cnt);
+    fprintf(fp, "read resubmit   : %" PRIu64 "\n", stat.rd_resubmit_cnt);
+    fprintf(fp, "app_rdy low     : %" PRIu64 " ui cycles\n", stat.busy_cycle);
+    fprintf(fp, "row buffer      : %" PRIu64 " hit, %" PRIu64 " empty, %" PRIu64 " conflict (hit rate %.1f%%, %" PRIu64 " ui cycles added)\n",
+        stat.row_hit_cnt, stat.row_empty_cnt, stat.row_conflict_cnt,
+        100.0*(double)stat.row_hit_cnt/(double)((stat.row_hit_cnt + stat.row_empty_cnt + stat.row_conflict_cnt) ? 
+                                                (stat.row_hit_cnt + stat.row_empty_cnt + stat.row_conflict_cnt) : 1),
+        stat.row_wait_cycle);
+    for(i = 0; i < TOTAL_STATE; i++){
+        if(stat.state_cycle[i] == 0){
+            continue;
+        }
+        fprintf(fp, "%-24s: %12" PRIu64 " ui cycles (%5.1f%%)\n", state_name[i],
+            stat.state_cycle[i], 100.0*(double)stat.state_cycle[i]/(double)total);
+    }
+}
@@ -0,0 +1,380 @@
+#ifndef _HOST_MIG_MODEL_H
+#define _HOST_MIG_MODEL_H
+
+/* ---------------------------------------------
+Purpose: behavioral model of the DDR2 path of the video system;
+1. V5_MIG_INTERFACE: core_video_mig_interface.sv (register file, source mux,
+    cpu transaction complete flag);
+2. user_mig_DDR2_sync_ctrl.sv: the FSM in the MIG UI clock domain,
+    the synchronizers between both clock domains;
+3. the MIG itself and the DDR2 SDRAM: a flat 128MB backing store
+    (2^23 lines of 128-bit) with a configurable read latency,
+    app_rdy back-pressure and retry injection;
+4. the row buffers of the DDR2 banks; open page; see below;
+
+Construction:
+1. the model is lazy; the FSM is advanced up to the current
+    bus cycle whenever a register is accessed;
+2. the FSM is stepped once per UI clock edge while it is busy;
+    idle stretches and the calibration wait are skipped over;
+3. the state names and transitions follow user_mig_DDR2_sync_ctrl.sv;
+
+Clock domain crossing (as the HW does it):
+1. cpu strobes    : 2FF synchronizer into the UI clock domain;
+2. status         : 2FF synchronizer into the system clock domain;
+3. complete pulse : toggle synchronizer into the system clock domain;
+4. cpu requests   : (stream mode) toggle synchronizer into the UI clock domain;
+                    held pending there until the FSM takes it;
+
+Known HW behavior which is reproduced, not fixed:
+1. the strobes are levels; the driver clears them with a second bus write;
+    the FSM may finish a transaction and start it again before
+    the clear arrives; see host_mig_stat::repeat_cnt;
+2. the cpu complete flag ignores a complete pulse while a strobe is held;
+    see host_mig_stat::complete_lost_cnt;
+3. by 1 and 2: with app_rdy back-pressure (busy_rate > 0), the FSM may miss
+    the restart while the strobe is still HIGH after a lost complete pulse;
+    the flag then never sets and write_ddr2()/read_ddr2() wait until their budget
+    runs out (WAIT_TIMEOUT); see video_core_mig_interface::set_wait_budget();
+    retry injection alone (retry_rate) does not cause this;
+
+Stream mode (register 12): the cpu requests are one-shot; none of the above applies;
+the address register post-increments on every complete pulse;
+
+Posted mode (register 12): the last write data word posts {address, data} into
+the command fifo; the head is submitted by a one-shot request; one at a time;
+
+Read-ahead mode (register 12): the core reads the next line by itself whenever
+none is in flight and the shadow is free; reading RDDATA_04 takes the line;
+the read data is taken into the system clock domain on the complete pulse;
+
+Fill (register 13): the lines from the address register onwards are written with
+the write data registers; one-shot requests, one at a time, as the posted writes;
+
+Write mask (register 14): a masked byte is left as it is in the backing store;
+the cpu writes take the register, a posted write the mask it was posted with;
+the other sources write all bytes;
+
+HW test circuit (select: V5_MIG_INTERFACE_REG_SEL_TEST; register 15): the bench mode only;
+one march element at a time over the lines from the address register onwards;
+the address in address as the data; one-shot requests as the dma; the LED demo is not modelled;
+
+DMA port (select: V5_MIG_INTERFACE_REG_SEL_DMA): one-shot requests as in the stream mode;
+the address and the write data come from the dma; the dma is told of the complete pulse
+and of the hand-over; see host_dma_model.h;
+
+Row buffers: the MIG maps the line address as bank-row-column;
+bank = bit[22:20], row = bit[19:7], column = bit[6:0] (128 lines of 16 bytes per row);
+one row open per bank; a command to it is a hit; to a bank with no row open,
+the row is activated first (row_open_latency); to a bank with another row open,
+it is precharged first (row_close_latency); the command waits as much longer:
+a read for its data, a write for its complete pulse;
+a drop of app_rdy (busy_rate) is taken as a refresh and closes every row;
+
+Hand-over (register 0): a write takes effect once the source that has the MIG has
+no one-shot request waiting for its complete pulse; meanwhile that source
+issues nothing new (the dma is held until it is granted the MIG again);
+a level strobe counts from its rising edge and holds the hand-over while HIGH;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "io_map.h"
+#include "io_reg_util.h"
+#include "host_core_model.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+class host_dma_model;   // forward declaration;
+
+/*-------------------------------------------------------
+* configuration;
+* latency is in UI clock cycles;
+* rates are in parts per 1000 per UI clock cycle;
+-------------------------------------------------------*/
+struct host_mig_config{
+    uint32_t ui_clk_mhz;        // MIG UI clock; 150MHz on this board;
+    uint32_t init_latency;      // reset to init_calib_complete;
+    uint32_t rd_latency;        // read command (app_en) to the first app_rd_data_valid;
+    uint32_t busy_rate;         // chance that app_rdy drops (refresh, full queue);
+    uint32_t busy_length;       // how long app_rdy stays LOW once it drops;
+    uint32_t retry_rate;        // chance that app_rdy is LOW in ST_WRITE_DONE or ST_READ_WAIT;
+    uint32_t row_open_latency;  // activate to a column command (tRCD);
+    uint32_t row_close_latency; // precharge to an activate (tRP);
+    uint32_t seed;              // for the back-pressure and retry pattern;
+};
+
+// event count;
+struct host_mig_stat{
+    uint64_t wr_cnt;            // write commands accepted by the MIG;
+    uint64_t rd_cnt;            // read commands accepted by the MIG;
+    uint64_t complete_cnt;      // complete pulses into the system clock domain;
+    uint64_t complete_lost_cnt; // complete pulses not latched; strobe still HIGH;
+    uint64_t repeat_cnt;        // transactions started again by a strobe held HIGH;
+    uint64_t post_cnt;          // posted writes taken into the command fifo;
+    uint64_t post_drop_cnt;     // posted writes dropped; fifo full;
+    uint32_t post_peak;         // most posted writes outstanding at once;
+    uint64_t pf_rd_cnt;         // reads issued ahead;
+    uint64_t pf_drop_cnt;       // reads ahead dropped by a restart;
+    uint64_t pf_pop_cnt;        // lines taken by the cpu;
+    uint64_t pf_pop_next_cnt;   // ... with the next line already in the shadow;
+    uint64_t fill_cnt;          // fills started;
+    uint64_t fill_line_cnt;     // lines written by the fill;
+    uint64_t test_cnt;          // march elements started (hw test circuit);
+    uint64_t test_line_cnt;     // lines done by them;
+    uint64_t test_err_cnt;      // lines read back wrong by them;
+    uint64_t masked_wr_cnt;     // write commands with some bytes masked;
+    uint64_t wr_retry_cnt;      // ST_WRITE_DONE to ST_WRITE_RETRY;
+    uint64_t rd_resubmit_cnt;   // ST_READ_WAIT back to ST_READ_SUBMIT;
+    uint64_t busy_cycle;        // UI clock cycles with app_rdy LOW after calibration;
+    uint64_t row_hit_cnt;       // commands to the open row of their bank;
+    uint64_t row_empty_cnt;     // ... to a bank with no row open;
+    uint64_t row_conflict_cnt;  // ... to a bank with another row open;
+    uint64_t row_wait_cycle;    // UI clock cycles added by the activates and precharges;
+    uint64_t state_cycle[16];   // UI clock cycles spent in each state; host_mig_model::ST_*;
+};
+
+/*-------------------------------------------------------
+* V5_MIG_INTERFACE + user_mig_DDR2_sync_ctrl + MIG + DDR2;
+-------------------------------------------------------*/
+class host_mig_model : public host_core_model{
+    // register map and fields; see io_map.h;
+    enum{
+        REG_SEL_OFFSET      = V5_MIG_INTERFACE_REG_SEL,
+        REG_STATUS_OFFSET   = V5_MIG_INTERFACE_REG_STATUS,
+        REG_ADDR_OFFSET     = V5_MIG_INTERFACE_REG_ADDR,
+        REG_CTRL_OFFSET     = V5_MIG_INTERFACE_REG_CTRL,
+        REG_WRDATA_01_OFFSET = V5_MIG_INTERFACE_REG_WRDATA_01,
+        REG_RDDATA_01_OFFSET = V5_MIG_INTERFACE_REG_RDDATA_01,
+        REG_MODE_OFFSET     = V5_MIG_INTERFACE_REG_MODE,
+        REG_FILL_OFFSET     = V5_MIG_INTERFACE_REG_FILL,
+        REG_WRMASK_OFFSET   = V5_MIG_INTERFACE_REG_WRMASK,
+        REG_TEST_OFFSET     = V5_MIG_INTERFACE_REG_TEST,
+
+        SEL_MASK            = 0x7,
+        SEL_PENDING_MASK    = BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_SEL_PENDING),
+        ADDR_MASK           = 0x7FFFFF,     // 23-bit;
+        CTRL_WRSTROBE_MASK  = BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_WRSTROBE),
+        CTRL_RDSTROBE_MASK  = BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_RDSTROBE),
+        MODE_STREAM_MASK    = BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_MODE_STREAM),
+        MODE_POSTED_MASK    = BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_MODE_POSTED),
+        MODE_PREFETCH_MASK  = BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_MODE_PREFETCH),
+        POST_FIFO_DEPTH     = V5_MIG_INTERFACE_POST_FIFO_DEPTH,
+        FILL_LEN_MASK       = BIT_MASK(V5_MIG_INTERFACE_FILL_LEN_WIDTH) - 1,
+        WRMASK_MASK         = BIT_MASK(V5_MIG_INTERFACE_WRMASK_WIDTH) - 1,
+        TEST_LEN_MASK       = BIT_MASK(V5_MIG_INTERFACE_TEST_LEN_WIDTH) - 1,
+        TEST_OP_MASK        = 0x1F,
+        TEST_ERR_MAX        = 0xFFFF
+    };
+
+    // synchronizer depth;
+    enum{
+        STROBE_SYNC_STAGE   = 2,    // ui clock cycles; FF_synchronizer_slow_to_fast;
+        COMPLETE_SYNC_STAGE = 3,    // system clock cycles; toggle_synchronizer + status register;
+        REQUEST_SYNC_STAGE  = 3     // ui clock cycles; toggle_synchronizer;
+    };
+
+    public:
+        // user_mig_DDR2_sync_ctrl.sv;
+        enum{
+            ST_WAIT_INIT_COMPLETE = 0,
+            ST_IDLE,
+            ST_WRITE_FIRST,
+            ST_WRITE_SECOND,
+            ST_WRITE_SUBMIT,
+            ST_WRITE_DONE,
+            ST_WRITE_RETRY,
+            ST_READ_SUBMIT,
+            ST_READ_WAIT,
+            TOTAL_STATE
+        };
+
+        // backing store;
+        enum{
+            TOTAL_LINE  = BIT_MASK(23),     // 2^23 x 128-bit = 128MB;
+            LINE_WORD   = 4                 // 32-bit words per line;
+        };
+
+        // bank-row-column; line address;
+        enum{
+            BANK_NUM    = 8,
+            BANK_SHIFT  = 20,
+            ROW_SHIFT   = 7,
+            ROW_MASK    = BIT_MASK(13) - 1,
+            ROW_NONE    = 0xFFFFFFFF        // no row open;
+        };
+
+        host_mig_model(host_bus *bus);
+        ~host_mig_model();
+
+        uint32_t read(uint32_t reg_offset);
+        void write(uint32_t reg_offset, uint32_t wr_data);
+
+        /* configuration;
+        set_config() keeps the state and the memory content;
+        reset() restarts the calibration from the current bus cycle;
+        */
+        void set_config(host_mig_config usr_config);
+        host_mig_config get_config(void);
+        void reset(void);
+
+        /* direct access to the backing store; no timing, no counting; */
+        void peek_line(uint32_t addr, uint32_t *data);
+        void poke_line(uint32_t addr, const uint32_t *data);
+
+        /* dma port;
+        dma_request() is a one-shot request pulse of the dma at a system clock edge;
+        it is not taken (-1) unless the dma has the MIG;
+        run_to() advances the model up to the given time; for the models run in lock step;
+        */
+        void set_dma(host_dma_model *dma);
+        int dma_request(int is_write, uint32_t addr, const uint32_t *wr_data, uint64_t at_ps);
+        void run_to(uint64_t at_ps);
+
+        /* observation */
+        int get_state(void);
+        host_mig_stat get_stat(void);
+        void clear_stat(void);
+        void report(FILE *fp);
+
+    private:
+        host_bus *bus;
+        host_mig_config config;
+        host_mig_stat stat;
+
+        // backing store;
+        uint32_t *mem;
+
+        // registers of core_video_mig_interface.sv;
+        uint32_t sel_reg;           // the source that has the MIG;
+        uint32_t sel_target;        // the source written; a hand-over is pending if different;
+        int owner_busy;             // a one-shot request waits for its complete pulse;
+        uint32_t addr_reg;
+        uint32_t ctrl_reg;
+        uint32_t mode_reg;
+        uint32_t wrmask_reg;
+        uint32_t wrdata_reg[LINE_WORD];
+        uint32_t rddata_reg[LINE_WORD];
+        int cpu_complete_reg;
+
+        // strobe after the source mux; last change for the synchronizer;
+        uint32_t strobe;
+        uint32_t strobe_prev;
+        uint64_t strobe_change_ps;
+        uint32_t strobe_txn_cnt;        // transactions since the strobe went HIGH;
+
+        // one-shot requests (stream mode); CTRL_WRSTROBE_MASK/CTRL_RDSTROBE_MASK;
+        // in flight or pending in the ui clock domain; a second one merges;
+        uint32_t request;
+        uint64_t request_due_ps[2];     // [0] write; [1] read;
+
+        // posted writes; command fifo; the head is at post_head;
+        struct post_entry{
+            uint32_t addr;
+            uint32_t mask;
+            uint32_t data[LINE_WORD];
+        };
+        post_entry post_fifo[POST_FIFO_DEPTH];
+        int post_head;
+        int post_level;                 // entries in the fifo; the head included;
+        int post_busy;                  // head submitted; waiting for its completion;
+        uint32_t complete_cnt_reg;      // 8-bit; completed cpu transactions;
+
+        // read-ahead;
+        int pf_busy;                    // a read in flight;
+        int pf_drop;                    // ... from before a restart;
+        int pf_line_valid;              // rddata_reg holds line N;
+        int pf_next_valid;              // pf_next holds line N+1;
+        uint32_t pf_addr;               // address of the read in flight;
+        uint32_t pf_next[LINE_WORD];    // shadow registers;
+        uint32_t ui_rddata[LINE_WORD];  // user_rd_data; ui clock domain;
+
+        // fill;
+        uint32_t fill_left;             // lines not written yet;
+        uint32_t fill_line;             // lines written since the start;
+        uint32_t fill_addr;             // address of the next line;
+        int fill_busy;                  // a write in flight;
+        int fill_done;                  // the last line is written;
+
+        // hw test circuit; bench mode;
+        int test_mode;                  // register 15 bit[31];
+        uint32_t test_op;               // march element; V5_MIG_INTERFACE_TEST_OP_*;
+        uint32_t test_left;             // lines left; the element runs while not zero;
+        uint32_t test_addr;             // line being tested;
+        uint32_t test_err;              // lines read back wrong; saturates;
+        int test_done;                  // the last line is done;
+        int test_busy;                  // a transaction in flight;
+        int test_is_write;              // ... and it is the write;
+        uint32_t test_wrdata[LINE_WORD];
+
+        // dma port;
+        host_dma_model *dma;
+        uint32_t dma_addr;
+        uint32_t dma_wrdata[LINE_WORD];
+
+        // complete pulses on their way into the system clock domain;
+        uint64_t complete_due_ps[4];
+        int complete_pending;
+
+        // user_mig_DDR2_sync_ctrl.sv;
+        int state;
+        int app_rdy;
+        uint32_t busy_left;
+        uint32_t wdf_data[LINE_WORD];   // app_wdf_data of both batches;
+        uint32_t wdf_mask;              // app_wdf_mask of both batches; HIGH masks the byte;
+        uint64_t rd_due;                // ui cycle of the first app_rd_data_valid;
+        uint32_t rd_addr;
+        uint32_t wr_due;                // ui cycles before the write is done; row open;
+
+        // DDR2 row buffers;
+        uint32_t open_row[BANK_NUM];
+
+        // time;
+        uint64_t sys_period_ps;
+        uint64_t ui_period_ps;
+        uint64_t ui_edge_ps;            // next ui clock edge;
+        uint64_t ui_cycle;              // ui clock edges since reset;
+        uint64_t init_done_cycle;
+
+        // pseudo random pattern; xorshift32;
+        uint32_t rand_state;
+        int roll(uint32_t rate);
+
+        uint32_t row_access(uint32_t addr);
+        void row_close_all(void);
+
+        void init_state(void);
+        uint32_t get_strobe(void);
+        uint32_t get_strobe_sync(void);
+        uint32_t get_request_sync(void);
+        void post_request(uint32_t mask, uint64_t at_ps);
+        void submit_request(uint32_t mask, uint64_t at_ps);
+        void post_write(void);
+        void post_issue(uint64_t at_ps);
+        void prefetch_restart(void);
+        void prefetch_issue(uint64_t at_ps);
+        void prefetch_pop(void);
+        void fill_start(uint32_t nlines);
+        void fill_issue(uint64_t at_ps);
+        void test_start(uint32_t wr_data);
+        void test_issue(uint64_t at_ps);
+        void test_pattern(int inv, uint32_t *data);
+        void handover_take(uint64_t at_ps);
+        uint32_t get_user_addr(void);
+        const uint32_t *get_user_wrdata(void);
+        uint32_t get_user_wrmask(void);
+        void service_complete(uint64_t until_ps);
+        void update(void);
+        void step(void);
+        void complete(void);
+};
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_HOST_MIG_MODEL_H
@@ -0,0 +1,272 @@
+#include "host_ov7670_model.h"
+
+/*-------------------------------------------------------
+* bit level i2c device;
+-------------------------------------------------------*/
+host_i2c_device::host_i2c_device(const char *dev_name, uint8_t dev_id){
+    name = dev_name;
+    id = dev_id;
+    state = ST_IDLE;
+    bit_cnt = 0;
+    shift_reg = 0;
+    ack = 0;
+    is_read = 0;
+    addressed = 0;
+}
+
+host_i2c_device::~host_i2c_device(){}
+
+const char *host_i2c_device::get_name(void){
+    return name;
+}
+
+uint8_t host_i2c_device::get_id(void){
+    return id;
+}
+
+void host_i2c_device::start(void){
+    // a repeated start also ends the current transaction;
+    state = ST_ADDR;
+    bit_cnt = 0;
+    shift_reg = 0;
+    ack = 0;
+}
+
+void host_i2c_device::stop(void){
+    if(addressed){
+        end();
+    }
+    addressed = 0;
+    state = ST_IDLE;
+}
+
+int host_i2c_device::drive(void){
+    /*
+    @brief  : sda level the device drives for the coming bit;
+    @param  : none
+    @retval : 1 if released (open drain); 0 if driven LOW;
+    */
+    switch(state){
+        case ST_ADDR:
+        case ST_WRITE:
+            // acknowledge bit;
+            if(bit_cnt == 8){
+                return ack ? 0 : 1;
+            }
+            return 1;
+        case ST_READ:
+            // data bits; msb first; the acknowledge bit is the master's;
+            if(bit_cnt < 8){
+                return (shift_reg >> (7 - bit_cnt)) & 1;
+            }
+            return 1;
+        default:
+            return 1;
+    }
+}
+
+void host_i2c_device::sample(int sda){
+    /*
+    @brief  : scl rising edge;
+    @param  : sda, the bus level (wired-AND of all the drivers);
+    @retval : none
+    */
+    if(state == ST_IDLE || state == ST_IGNORE){
+        return;
+    }
+
+    // data bits;
+    if(bit_cnt < 8){
+        if(state != ST_READ){
+            shift_reg = (uint8_t)((shift_reg << 1) | (sda & 1));
+        }
+        bit_cnt++;
+
+        // the byte is complete; decide the acknowledge before bit 8 is driven;
+        if(bit_cnt == 8){
+            if(state == ST_ADDR){
+                ack = ((shift_reg >> 1) == id);
+                is_read = shift_reg & 1;
+            }
+            else if(state == ST_WRITE){
+                ack = write_byte(shift_reg);
+            }
+        }
+        return;
+    }
+
+    // acknowledge bit;
+    bit_cnt = 0;
+    switch(state){
+        case ST_ADDR:
+            if(!ack){
+                state = ST_IGNORE;
+                return;
+            }
+            addressed = 1;
+            begin(is_read);
+            if(is_read){
+                state = ST_READ;
+                shift_reg = read_byte();
+            }else{
+                state = ST_WRITE;
+                shift_reg = 0;
+            }
+            break;
+        case ST_WRITE:
+            // a NACK'ed byte ends the transfer;
+            if(!ack){
+                state = ST_IGNORE;
+            }
+            shift_reg = 0;
+            break;
+        case ST_READ:
+            // master NACK: no more bytes;
+            if(sda){
+                state = ST_IGNORE;
+            }else{
+                shift_reg = read_byte();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/*-------------------------------------------------------
+* OV7670;
+-------------------------------------------------------*/
+// register reset values; OV7670 datasheet (v1.4), table 5;
+// reserved registers are taken as 0x00;
+static const uint8_t ov7670_reset_value[OV7670_REG_LAST] = {
+    /* 0x00 */ 0x00, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* 0x08 */ 0x00, 0x01, 0x76, 0x73, 0x00, 0x00, 0x01, 0x43,
+    /* 0x10 */ 0x40, 0x80, 0x00, 0x8F, 0x4A, 0x00, 0x00, 0x11,
+    /* 0x18 */ 0x61, 0x03, 0x7B, 0x00, 0x7F, 0xA2, 0x00, 0x00,
+    /* 0x20 */ 0x04, 0x02, 0x01, 0x00, 0x75, 0x63, 0xD4, 0x80,
+    /* 0x28 */ 0x80, 0x07, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00,
+    /* 0x30 */ 0x08, 0x30, 0x80, 0x08, 0x11, 0x00, 0x00, 0x3F,
+    /* 0x38 */ 0x01, 0x00, 0x0D, 0x00, 0x68, 0x88, 0x00, 0x00,
+    /* 0x40 */ 0xC0, 0x08, 0x00, 0x14, 0xF0, 0x45, 0x61, 0x51,
+    /* 0x48 */ 0x79, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,
+    /* 0x50 */ 0x34, 0x0C, 0x17, 0x29, 0x40, 0x00, 0x40, 0x80,
+    /* 0x58 */ 0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* 0x60 */ 0x00, 0x00, 0x00, 0x00, 0x50, 0x30, 0x00, 0x80,
+    /* 0x68 */ 0x80, 0x00, 0x00, 0x0A, 0x02, 0x55, 0xC0, 0x9A,
+    /* 0x70 */ 0x3A, 0x35, 0x11, 0x00, 0x00, 0x0F, 0x01, 0x10,
+    /* 0x78 */ 0x00, 0x00, 0x24, 0x04, 0x07, 0x10, 0x28, 0x36,
+    /* 0x80 */ 0x44, 0x52, 0x60, 0x6C, 0x78, 0x8C, 0x9E, 0xBB,
+    /* 0x88 */ 0xD2, 0xE5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* 0x90 */ 0x00, 0x00, 0x00, 0x00, 0x50, 0x50, 0x00, 0x00,
+    /* 0x98 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x99, 0x7F, 0xC0,
+    /* 0xA0 */ 0x90, 0x00, 0x02, 0x00, 0x00, 0x0F, 0xF0, 0xC1,
+    /* 0xA8 */ 0xF0, 0xC1, 0x14, 0x0F, 0x00, 0x80, 0x80, 0x80,
+    /* 0xB0 */ 0x00, 0x00, 0x00, 0x80, 0x00, 0x04, 0x00, 0x00,
+    /* 0xB8 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* 0xC0 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* 0xC8 */ 0x00, 0xC0
+};
+
+host_ov7670_model::host_ov7670_model() : host_i2c_device("ov7670", OV7670_DEV_ID){
+    reg_ptr = 0;
+    phase = 0;
+    reset();
+    clear_stat();
+}
+
+host_ov7670_model::~host_ov7670_model(){}
+
+void host_ov7670_model::reset(void){
+    for(int i = 0; i < TOTAL_REG; i++){
+        reg[i] = ov7670_reset_value[i];
+    }
+}
+
+int host_ov7670_model::is_read_only(uint8_t reg_addr){
+    return (reg_addr == OV7670_REG_PID) || (reg_addr == OV7670_REG_VER) ||
+            (reg_addr == OV7670_REG_MIDH) || (reg_addr == OV7670_REG_MIDL) ||
+            (reg_addr >= TOTAL_REG);
+}
+
+uint8_t host_ov7670_model::get_reg(uint8_t reg_addr){
+    return (reg_addr < TOTAL_REG) ? reg[reg_addr] : 0;
+}
+
+void host_ov7670_model::set_reg(uint8_t reg_addr, uint8_t reg_val){
+    if(reg_addr < TOTAL_REG){
+        reg[reg_addr] = reg_val;
+    }
+}
+
+uint8_t host_ov7670_model::get_reset_value(uint8_t reg_addr){
+    return (reg_addr < TOTAL_REG) ? ov7670_reset_value[reg_addr] : 0;
+}
+
+void host_ov7670_model::begin(int is_read){
+    // SCCB: [id W][reg] sets the pointer; [id R] reads from it;
+    phase = 0;
+    stat.txn_cnt++;
+}
+
+int host_ov7670_model::write_byte(uint8_t data){
+    // first byte after [id W] is the sub-address;
+    if(phase == 0){
+        reg_ptr = data;
+        phase++;
+        return 1;
+    }
+    phase++;
+    stat.wr_cnt++;
+
+    if(is_read_only(reg_ptr)){
+        stat.ro_wr_cnt++;
+        return 1;
+    }
+
+    // SCCB register reset; the reset bit itself does not stick;
+    if((reg_ptr == OV7670_REG_COM7) && (data & OV7670_COM7_SOFT_RESET)){
+        stat.soft_reset_cnt++;
+        reset();
+        return 1;
+    }
+    reg[reg_ptr] = data;
+    return 1;
+}
+
+uint8_t host_ov7670_model::read_byte(void){
+    stat.rd_cnt++;
+    return get_reg(reg_ptr);
+}
+
+void host_ov7670_model::end(void){}
+
+host_ov7670_stat host_ov7670_model::get_stat(void){
+    return stat;
+}
+
+void host_ov7670_model::clear_stat(void){
+    stat.wr_cnt = 0;
+    stat.rd_cnt = 0;
+    stat.ro_wr_cnt = 0;
+    stat.soft_reset_cnt = 0;
+    stat.txn_cnt = 0;
+}
+
+void host_ov7670_model::report(FILE *fp){
+    int changed = 0;
+
+    for(int i = 0; i < TOTAL_REG; i++){
+        if(reg[i] != ov7670_reset_value[i]){
+            changed++;
+        }
+    }
+    fprintf(fp, "\n---- ov7670 camera model (id 0x%02X) ----\n", get_id());
+    fprintf(fp, "transactions    : %" PRIu64 "\n", stat.txn_cnt);
+    fprintf(fp, "register write  : %" PRIu64 " (dropped: %" PRIu64 ")\n", stat.wr_cnt, stat.ro_wr_cnt);
+    fprintf(fp, "register read   : %" PRIu64 "\n", stat.rd_cnt);
+    fprintf(fp, "sccb reset      : %" PRIu64 "\n", stat.soft_reset_cnt);
+    fprintf(fp, "changed from reset value: %d of %d registers\n", changed, (int)TOTAL_REG);
+    fprintf(fp, "COM7 0x%02X, COM15 0x%02X, COM3 0x%02X, COM14 0x%02X, TSLB 0x%02X\n",
+            reg[OV7670_REG_COM7], reg[OV7670_REG_COM15], reg[OV7670_REG_COM3],
+            reg[OV7670_REG_COM14], reg[OV7670_REG_TSLB]);
+}
@@ -0,0 +1,142 @@
+#ifndef _HOST_OV7670_MODEL_H
+#define _HOST_OV7670_MODEL_H
+
+/* ---------------------------------------------
+Purpose: model of the OV7670 camera control interface (SCCB);
+1. it sits on the i2c bus of host_i2c_model (S6_I2C_MASTER)
+    and answers at the device id OV7670_DEV_ID (0x21);
+2. the register file covers 0x00 to OV7670_REG_LAST - 1 (0xC9);
+    every register starts with the reset value of the datasheet;
+3. writing COM7 with the SCCB reset bit restores the reset values;
+4. PID, VER, MIDH and MIDL are read only;
+5. the camera is a bit level i2c device; see host_i2c_device;
+
+SCCB (as the driver uses it; see cam_ov7670.cpp):
+1. write : START, [id W], [reg], [value], STOP;
+2. read  : START, [id W], [reg], STOP, START, [id R], value, NACK, STOP;
+3. the register pointer does not advance;
+    further bytes in the same transaction go to the same register;
+4. registers past 0xC9 are acknowledged; writes are dropped, reads return 0;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "cam_ov7670_reg.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+/*-------------------------------------------------------
+* bit level i2c device (slave);
+* the i2c master drives the bus one bit (one scl pulse) at a time:
+* 1. drive()  : while scl is LOW; the sda level the device drives;
+* 2. sample() : on the scl rising edge; the wired-AND sda level;
+* the device tracks the address and acknowledge phases itself;
+* a derived device only deals with whole bytes;
+-------------------------------------------------------*/
+class host_i2c_device{
+    // bit level state;
+    enum{
+        ST_IDLE = 0,    // waiting for a start condition;
+        ST_ADDR,        // receiving the address byte;
+        ST_WRITE,       // master to device;
+        ST_READ,        // device to master;
+        ST_IGNORE       // not addressed (or NACK); until the next start condition;
+    };
+
+    public:
+        host_i2c_device(const char *dev_name, uint8_t dev_id);
+        virtual ~host_i2c_device();
+
+        /* bus conditions */
+        void start(void);       // start or repeated start;
+        void stop(void);
+
+        /* one bit; 1 is released (pulled HIGH), 0 is driven LOW; */
+        int drive(void);
+        void sample(int sda);
+
+        const char *get_name(void);
+        uint8_t get_id(void);
+
+    protected:
+        /* byte level hooks;
+        begin()     : the device is addressed; is_read for [id R];
+        write_byte(): a byte from the master; return 1 to ACK, 0 to NACK;
+        read_byte() : the next byte to the master;
+        end()       : stop condition after the device was addressed;
+        */
+        virtual void begin(int is_read) = 0;
+        virtual int write_byte(uint8_t data) = 0;
+        virtual uint8_t read_byte(void) = 0;
+        virtual void end(void) = 0;
+
+    private:
+        const char *name;
+        uint8_t id;
+
+        int state;
+        int bit_cnt;            // 0 to 7: data bits; 8: acknowledge bit;
+        uint8_t shift_reg;
+        int ack;                // device ACK due at bit 8 of ADDR or WRITE;
+        int is_read;            // R/W bit of the address byte;
+        int addressed;          // for end();
+};
+
+// register access count;
+struct host_ov7670_stat{
+    uint64_t wr_cnt;            // register writes; including the dropped ones;
+    uint64_t rd_cnt;            // register reads;
+    uint64_t ro_wr_cnt;         // writes to read only registers or past 0xC9; dropped;
+    uint64_t soft_reset_cnt;    // COM7 SCCB reset;
+    uint64_t txn_cnt;           // transactions addressed to the camera;
+};
+
+/*-------------------------------------------------------
+* OV7670 control registers;
+-------------------------------------------------------*/
+class host_ov7670_model : public host_i2c_device{
+    enum{
+        TOTAL_REG   = OV7670_REG_LAST   // 0x00 to 0xC9;
+    };
+
+    public:
+        host_ov7670_model();
+        ~host_ov7670_model();
+
+        /* reset (the RESETB pin or the COM7 SCCB reset) */
+        void reset(void);
+
+        /* direct access to the registers; no counting; */
+        uint8_t get_reg(uint8_t reg_addr);
+        void set_reg(uint8_t reg_addr, uint8_t reg_val);
+        uint8_t get_reset_value(uint8_t reg_addr);
+
+        /* observation */
+        host_ov7670_stat get_stat(void);
+        void clear_stat(void);
+        void report(FILE *fp);
+
+    protected:
+        void begin(int is_read);
+        int write_byte(uint8_t data);
+        uint8_t read_byte(void);
+        void end(void);
+
+    private:
+        int is_read_only(uint8_t reg_addr);
+
+        uint8_t reg[TOTAL_REG];
+        uint8_t reg_ptr;            // sub-address;
+        int phase;                  // bytes after the address byte;
+        host_ov7670_stat stat;
+};
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_HOST_OV7670_MODEL_H
@@ -0,0 +1,388 @@
+#include "host_trace.h"
+#include "host_bus.h"
+#include "host_core_model.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/*-------------------------------------------------------
+* writer;
+-------------------------------------------------------*/
+host_trace_writer::host_trace_writer(){
+    fp = NULL;
+    slot_mask = 0;
+    has_pending = 0;
+    record_cnt = 0;
+    access_cnt = 0;
+}
+
+host_trace_writer::~host_trace_writer(){
+    close();
+}
+
+int host_trace_writer::open(const char *path, uint64_t slot_mask){
+    /*
+    @brief  : start a new trace file;
+    @param  :
+        path        : file to (over)write;
+        slot_mask   : slots to record; see MMIO_TRACE_MASK_ALL;
+    @retval : 0 if OK; -1 otherwise;
+    */
+    close();
+    fp = fopen(path, "wb");
+    if(fp == NULL){
+        return -1;
+    }
+    this->slot_mask = slot_mask;
+    mmio_trace_init_header(&header, slot_mask);
+    has_pending = 0;
+    record_cnt = 0;
+    access_cnt = 0;
+    if(fwrite(&header, sizeof(header), 1, fp) != 1){
+        fclose(fp);
+        fp = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int host_trace_writer::close(void){
+    /*
+    @brief  : complete the header and close the file;
+    @param  : none
+    @retval : 0 if OK; -1 otherwise;
+    @note   : a trace beyond 2^32 records keeps record_cnt zero;
+                the reader then counts by the file size;
+    */
+    int status = 0;
+
+    if(fp == NULL){
+        return 0;
+    }
+    flush_pending();
+    header.record_cnt = (record_cnt >> 32) ? 0 : (uint32_t)record_cnt;
+    if((fseek(fp, 0, SEEK_SET) != 0) || (fwrite(&header, sizeof(header), 1, fp) != 1)){
+        status = -1;
+    }
+    if(fclose(fp) != 0){
+        status = -1;
+    }
+    fp = NULL;
+    return status;
+}
+
+void host_trace_writer::flush_pending(void){
+    if(has_pending){
+        fwrite(&pending, sizeof(pending), 1, fp);
+        record_cnt++;
+        has_pending = 0;
+    }
+}
+
+void host_trace_writer::record(uint64_t time, uint32_t base_addr, uint32_t offset, int is_write, uint32_t value){
+    /*
+    @brief  : record one register access;
+    @param  : as mmio_trace_make_record();
+    @retval : none
+    @note   : the last record is kept back until it can no longer be folded;
+    */
+    mmio_trace_record_t next;
+
+    if(fp == NULL){
+        return;
+    }
+    if(!mmio_trace_make_record(&next, time, base_addr, offset, is_write, value)){
+        return;
+    }
+    if(!(mmio_trace_get_slot_bit(&next) & slot_mask)){
+        return;
+    }
+    access_cnt++;
+    if(has_pending && mmio_trace_fold(&pending, &next)){
+        return;
+    }
+    flush_pending();
+    pending = next;
+    has_pending = 1;
+}
+
+uint64_t host_trace_writer::get_record_cnt(void){
+    return record_cnt + has_pending;
+}
+
+uint64_t host_trace_writer::get_access_cnt(void){
+    return access_cnt;
+}
+
+/*-------------------------------------------------------
+* reader;
+-------------------------------------------------------*/
+host_trace_file::host_trace_file(){
+    path = "";
+    map = NULL;
+    map_size = 0;
+    record_cnt = 0;
+}
+
+host_trace_file::~host_trace_file(){
+    close();
+}
+
+int host_trace_file::open(const char *path){
+    /*
+    @brief  : map a trace file into memory;
+    @param  : path
+    @retval : 0 if OK; -1 if the file cannot be mapped or is not a trace;
+    @note   : a trace still being captured (record_cnt zero)
+                is counted by the file size; a partial record at the end is ignored;
+    */
+    const mmio_trace_header_t *header;
+    struct stat st;
+    uint64_t file_cnt;
+    int fd;
+
+    close();
+    fd = ::open(path, O_RDONLY);
+    if(fd < 0){
+        return -1;
+    }
+    if((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(mmio_trace_header_t))){
+        ::close(fd);
+        return -1;
+    }
+    map_size = (size_t)st.st_size;
+    map = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(map == MAP_FAILED){
+        map = NULL;
+        return -1;
+    }
+
+    header = get_header();
+    if(mmio_trace_check_header(header) != 0){
+        close();
+        return -1;
+    }
+    file_cnt = (map_size - sizeof(mmio_trace_header_t))/sizeof(mmio_trace_record_t);
+    record_cnt = header->record_cnt;
+    if((record_cnt == 0) || (record_cnt > file_cnt)){
+        record_cnt = file_cnt;
+    }
+    this->path = path;
+    return 0;
+}
+
+void host_trace_file::close(void){
+    if(map != NULL){
+        munmap(map, map_size);
+    }
+    map = NULL;
+    map_size = 0;
+    record_cnt = 0;
+}
+
+const mmio_trace_header_t *host_trace_file::get_header(void) const{
+    return (const mmio_trace_header_t *)map;
+}
+
+uint64_t host_trace_file::get_record_cnt(void) const{
+    return record_cnt;
+}
+
+const mmio_trace_record_t *host_trace_file::get_record(uint64_t index) const{
+    const mmio_trace_record_t *record = (const mmio_trace_record_t *)((const uint8_t *)map + sizeof(mmio_trace_header_t));
+    return &record[index];
+}
+
+const char *host_trace_file::get_path(void) const{
+    return path;
+}
+
+/*-------------------------------------------------------
+* replay;
+-------------------------------------------------------*/
+host_trace_replay_stat host_trace_replay(host_bus &bus, const host_trace_file &trace, FILE *fp, int max_print){
+    /*
+    @brief  : issue the records of a trace on the bus;
+    @param  :
+        bus         : the bus; normally in its reset state;
+        trace       : the trace;
+        fp          : mismatches are printed here; NULL for none;
+        max_print   : most mismatches to print;
+    @retval : replay outcome;
+    @note   : the folded reads of a record are issued back to back;
+    */
+    host_trace_replay_stat stat;
+    const mmio_trace_record_t *record;
+    uint32_t base_addr;
+    uint32_t rd_data;
+    uint64_t time;
+    int printed = 0;
+
+    memset(&stat, 0, sizeof(stat));
+    for(uint64_t i = 0; i < trace.get_record_cnt(); i++){
+        record = trace.get_record(i);
+        base_addr = mmio_trace_get_base_addr(record);
+        time = mmio_trace_get_time(record);
+
+        if(bus.get_cycle() <= time){
+            bus.advance_to(time);
+        }else{
+            stat.late_cnt++;
+        }
+
+        stat.record_cnt++;
+        if(record->flag & MMIO_TRACE_FLAG_WRITE){
+            bus.write(base_addr, record->offset, record->value);
+            stat.wr_cnt++;
+            continue;
+        }
+        for(uint32_t j = 0; j <= record->repeat; j++){
+            rd_data = bus.read(base_addr, record->offset);
+            stat.rd_cnt++;
+            if(rd_data == record->value){
+                continue;
+            }
+            if(stat.rd_mismatch_cnt == 0){
+                stat.first_mismatch = i;
+            }
+            stat.rd_mismatch_cnt++;
+            if(fp && (printed < max_print)){
+                fprintf(fp, "record %" PRIu64 " (+%u) at %" PRIu64 ": %s %u offset %u read 0x%08X, recorded 0x%08X\n",
+                        i, j, time, (record->flag & MMIO_TRACE_FLAG_VIDEO) ? "video" : "mmio",
+                        record->slot, record->offset, rd_data, record->value);
+                printed++;
+            }
+            // the rest of the run would only repeat the same mismatch;
+            break;
+        }
+    }
+    return stat;
+}
+
+/*-------------------------------------------------------
+* diff;
+-------------------------------------------------------*/
+// summary of one core slot in one trace;
+struct host_trace_slot{
+    uint64_t rd_cnt;
+    uint64_t wr_cnt;
+    std::vector<uint64_t> wr_seq;   // {offset, value};
+};
+
+static void trace_summarise(const host_trace_file &trace, std::vector<host_trace_slot> &slot, uint64_t *span){
+    /*
+    @brief  : per slot access count and write sequence;
+    @param  :
+        trace   : the trace;
+        slot    : (output) indexed as the slot mask bits;
+        span    : (output) system clock cycles from the first to the last record;
+    @retval : none
+    */
+    const mmio_trace_record_t *record;
+    uint64_t first = 0;
+    uint64_t last = 0;
+    int index;
+
+    slot.resize(MIMO_CORE_TOTAL_G + VIDEO_CORE_TOTAL_G);
+    for(uint64_t i = 0; i < trace.get_record_cnt(); i++){
+        record = trace.get_record(i);
+        index = record->slot + ((record->flag & MMIO_TRACE_FLAG_VIDEO) ? MIMO_CORE_TOTAL_G : 0);
+        if(record->flag & MMIO_TRACE_FLAG_WRITE){
+            slot[index].wr_cnt++;
+            slot[index].wr_seq.push_back(((uint64_t)record->offset << 32) | record->value);
+        }else{
+            slot[index].rd_cnt += (uint64_t)record->repeat + 1;
+        }
+        if(i == 0){
+            first = mmio_trace_get_time(record);
+        }
+        last = mmio_trace_get_time(record);
+    }
+    *span = last - first;
+}
+
+static const char *trace_slot_name(int index){
+    host_bus &bus = host_bus_get();
+    if(index < MIMO_CORE_TOTAL_G){
+        return bus.get_mmio_core(index)->get_name();
+    }
+    return bus.get_video_core(index - MIMO_CORE_TOTAL_G)->get_name();
+}
+
+int host_trace_diff(const host_trace_file &before, const host_trace_file &after, FILE *fp){
+    /*
+    @brief  : compare two traces;
+    @param  :
+        before, after   : the traces;
+        fp              : report;
+    @retval : number of core slots whose write sequence differs; 0 if equivalent;
+    @note   :
+        1. two traces are taken as equivalent when every core slot sees
+            the same writes (offset and value) in the same order;
+            the interleaving across the cores and the reads are free to change;
+        2. reads are compared by count only;
+    */
+    std::vector<host_trace_slot> a;
+    std::vector<host_trace_slot> b;
+    uint64_t span_a;
+    uint64_t span_b;
+    uint64_t total_a = 0;
+    uint64_t total_b = 0;
+    int differ = 0;
+    size_t n;
+    size_t k;
+
+    trace_summarise(before, a, &span_a);
+    trace_summarise(after, b, &span_b);
+
+    if(mmio_trace_get_slot_mask(before.get_header()) != mmio_trace_get_slot_mask(after.get_header())){
+        fprintf(fp, "warning: the traces do not record the same core slots\n");
+    }
+    fprintf(fp, "%-8s %-4s %-20s %12s %12s %10s %12s %12s %10s  %s\n", "system", "slot", "core",
+            "reads", "reads", "delta", "writes", "writes", "delta", "write sequence");
+
+    for(int i = 0; i < MIMO_CORE_TOTAL_G + VIDEO_CORE_TOTAL_G; i++){
+        if((a[i].rd_cnt + a[i].wr_cnt + b[i].rd_cnt + b[i].wr_cnt) == 0){
+            continue;
+        }
+        total_a += a[i].rd_cnt + a[i].wr_cnt;
+        total_b += b[i].rd_cnt + b[i].wr_cnt;
+        fprintf(fp, "%-8s %-4d %-20s %12" PRIu64 " %12" PRIu64 " %+10" PRId64 " %12" PRIu64 " %12" PRIu64 " %+10" PRId64 "  ",
+                (i < MIMO_CORE_TOTAL_G) ? "mmio" : "video", i % MIMO_CORE_TOTAL_G, trace_slot_name(i),
+                a[i].rd_cnt, b[i].rd_cnt, (int64_t)(b[i].rd_cnt - a[i].rd_cnt),
+                a[i].wr_cnt, b[i].wr_cnt, (int64_t)(b[i].wr_cnt - a[i].wr_cnt));
+
+        // first write that differs;
+        n = (a[i].wr_seq.size() < b[i].wr_seq.size()) ? a[i].wr_seq.size() : b[i].wr_seq.size();
+        for(k = 0; k < n; k++){
+            if(a[i].wr_seq[k] != b[i].wr_seq[k]){
+                break;
+            }
+        }
+        if((k == n) && (a[i].wr_seq.size() == b[i].wr_seq.size())){
+            fprintf(fp, "same\n");
+            continue;
+        }
+        differ++;
+        if(k == n){
+            fprintf(fp, "differs from write #%zu; one trace stops there\n", k);
+        }else{
+            fprintf(fp, "differs from write #%zu; offset %u 0x%08X vs offset %u 0x%08X\n", k,
+                    (uint32_t)(a[i].wr_seq[k] >> 32), (uint32_t)a[i].wr_seq[k],
+                    (uint32_t)(b[i].wr_seq[k] >> 32), (uint32_t)b[i].wr_seq[k]);
+        }
+    }
+
+    fprintf(fp, "%-34s %12" PRIu64 " %12" PRIu64 " %+10" PRId64 "\n", "total access",
+            total_a, total_b, (int64_t)(total_b - total_a));
+    fprintf(fp, "%-34s %12.1f %12.1f %+10.1f\n", "elapsed (us)",
+            (double)span_a/SYS_CLK_FREQ_MHZ, (double)span_b/SYS_CLK_FREQ_MHZ,
+            ((double)span_b - (double)span_a)/SYS_CLK_FREQ_MHZ);
+    fprintf(fp, "behaviour: %s\n", differ ? "differs" : "equivalent");
+    return differ;
+}
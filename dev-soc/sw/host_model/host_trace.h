@@ -0,0 +1,108 @@
+#ifndef _HOST_TRACE_H
+#define _HOST_TRACE_H
+
+/* ---------------------------------------------
+Purpose: host side of the register access trace;
+1. the format is in user_src/util/mmio_trace.h;
+    the same file comes from the board (_MMIO_TRACE) or from the host bus;
+2. writer: attached to the host bus; see host_bus::set_trace();
+3. reader: the file is mapped into memory and indexed as is;
+4. replay: issue the records again on the host bus, at their
+    recorded time, and compare the read data with the recorded one;
+5. diff: compare two traces, e.g. before and after a driver change;
+    behaviour: the write sequence of every core slot;
+    cost: the access count per core slot and the elapsed time;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "stdio.h"
+#include "mmio_trace.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+class host_bus;     // forward declaration;
+
+/*-------------------------------------------------------
+* trace file writer;
+-------------------------------------------------------*/
+class host_trace_writer{
+    public:
+        host_trace_writer();
+        ~host_trace_writer();
+
+        /* retval 0 if OK; -1 otherwise */
+        int open(const char *path, uint64_t slot_mask);
+        int close(void);    // the header is completed with the record count;
+
+        void record(uint64_t time, uint32_t base_addr, uint32_t offset, int is_write, uint32_t value);
+        uint64_t get_record_cnt(void);
+        uint64_t get_access_cnt(void);
+
+    private:
+        void flush_pending(void);
+
+        FILE *fp;
+        mmio_trace_header_t header;
+        uint64_t slot_mask;
+        mmio_trace_record_t pending;    // last record; kept back for folding;
+        int has_pending;
+        uint64_t record_cnt;
+        uint64_t access_cnt;
+};
+
+/*-------------------------------------------------------
+* trace file reader; memory mapped;
+-------------------------------------------------------*/
+class host_trace_file{
+    public:
+        host_trace_file();
+        ~host_trace_file();
+
+        /* retval 0 if OK; -1 otherwise */
+        int open(const char *path);
+        void close(void);
+
+        const mmio_trace_header_t *get_header(void) const;
+        uint64_t get_record_cnt(void) const;
+        const mmio_trace_record_t *get_record(uint64_t index) const;
+        const char *get_path(void) const;
+
+    private:
+        const char *path;
+        void *map;
+        size_t map_size;
+        uint64_t record_cnt;
+};
+
+// replay outcome;
+struct host_trace_replay_stat{
+    uint64_t record_cnt;
+    uint64_t rd_cnt;            // reads issued, folded ones included;
+    uint64_t wr_cnt;
+    uint64_t rd_mismatch_cnt;   // reads returning other than the recorded value;
+    uint64_t late_cnt;          // records issued after their recorded time;
+    uint64_t first_mismatch;    // record index; valid if rd_mismatch_cnt;
+};
+
+/* issue the records of a trace on the bus;
+1. the bus time is moved forward to the recorded issue time of each record;
+2. a folded read is issued (repeat + 1) times;
+    the read data is compared every time;
+3. up to max_print mismatches are printed to fp (if not NULL);
+*/
+host_trace_replay_stat host_trace_replay(host_bus &bus, const host_trace_file &trace, FILE *fp, int max_print);
+
+/* compare two traces; a report is printed to fp;
+retval: number of core slots whose write sequence differs; 0 if equivalent;
+*/
+int host_trace_diff(const host_trace_file &before, const host_trace_file &after, FILE *fp);
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_HOST_TRACE_H
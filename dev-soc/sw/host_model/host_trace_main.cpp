@@ -0,0 +1,82 @@
+/* ---------------------------------------------
+Purpose: register access trace tool;
+1. the trace comes from the board (_MMIO_TRACE) or from host_run;
+2. usage:
+    host_trace info <trace>             : header and record count;
+    host_trace replay <trace>           : issue the trace on the register models;
+                                          the read data is compared with the recorded one;
+    host_trace diff <before> <after>    : behaviour and access count change;
+3. exit status: 0 if the replay matches (or the traces are equivalent);
+    1 otherwise; 2 on a usage or file error;
+---------------------------------------------*/
+
+#include "host_bus.h"
+#include "host_core_model.h"
+#include "host_trace.h"
+
+#include <string.h>
+
+static int open_trace(host_trace_file &trace, const char *path){
+    if(trace.open(path) != 0){
+        fprintf(stderr, "%s: not a readable trace\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static void print_info(const host_trace_file &trace){
+    const mmio_trace_header_t *header = trace.get_header();
+    uint64_t span = 0;
+
+    if(trace.get_record_cnt()){
+        span = mmio_trace_get_time(trace.get_record(trace.get_record_cnt() - 1))
+            - mmio_trace_get_time(trace.get_record(0));
+    }
+    printf("trace           : %s (version %u)\n", trace.get_path(), header->version);
+    printf("records         : %" PRIu64 " (dropped on capture: %u)\n", trace.get_record_cnt(), header->drop_cnt);
+    printf("slot mask       : 0x%012" PRIX64 "\n", mmio_trace_get_slot_mask(header));
+    printf("elapsed         : %.1f us at %u MHz\n", (double)span/header->clk_freq_mhz, header->clk_freq_mhz);
+}
+
+int main(int argc, char **argv){
+    host_trace_file trace_a;
+    host_trace_file trace_b;
+
+    if((argc == 3) && (strcmp(argv[1], "info") == 0)){
+        if(open_trace(trace_a, argv[2]) != 0){
+            return 2;
+        }
+        print_info(trace_a);
+        return 0;
+    }
+
+    if((argc == 3) && (strcmp(argv[1], "replay") == 0)){
+        host_bus &bus = host_bus_get();
+        host_trace_replay_stat stat;
+
+        if(open_trace(trace_a, argv[2]) != 0){
+            return 2;
+        }
+        ((host_uart_model *)bus.get_mmio_core(S1_UART_DEBUG))->set_stream(NULL);
+        print_info(trace_a);
+        stat = host_trace_replay(bus, trace_a, stdout, 10);
+        printf("replayed        : %" PRIu64 " records, %" PRIu64 " reads, %" PRIu64 " writes\n",
+                stat.record_cnt, stat.rd_cnt, stat.wr_cnt);
+        printf("late            : %" PRIu64 " records issued after their recorded time\n", stat.late_cnt);
+        printf("read mismatch   : %" PRIu64 "\n", stat.rd_mismatch_cnt);
+        bus.report(stdout);
+        return stat.rd_mismatch_cnt ? 1 : 0;
+    }
+
+    if((argc == 4) && (strcmp(argv[1], "diff") == 0)){
+        if((open_trace(trace_a, argv[2]) != 0) || (open_trace(trace_b, argv[3]) != 0)){
+            return 2;
+        }
+        return host_trace_diff(trace_a, trace_b, stdout) ? 1 : 0;
+    }
+
+    fprintf(stderr, "usage: host_trace info <trace>\n");
+    fprintf(stderr, "       host_trace replay <trace>\n");
+    fprintf(stderr, "       host_trace diff <before> <after>\n");
+    return 2;
+}
@@ -186,6 +186,7 @@ void ov7670_write_array(const uint8_t input_array[][2]){
 	uint8_t reg_value;
 
 	// start the machinery;
+	row = 0;
 	reg_address = OV7670_REG_LAST - 1; // dummy initialized;
 	while(reg_address != OV7670_REG_LAST){
 		reg_address = input_array[row][0];
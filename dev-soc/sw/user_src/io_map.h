@@ -333,6 +333,7 @@ video address space;
 #define V3_CAM_DCMI_IF              3   // camera dcmi interface (with a dual-clock fifo embedded);
 #define V4_PIXEL_COLOUR_CONVERTER   4   // transform Y of YUV422 to RGB565;
 #define V5_MIG_INTERFACE            5   // DDR2 MIG synchronous interface;
+#define V6_DMA                      6   // moves DDR2 lines: DDR2 to DDR2, DDR2 to LCD and DCMI to DDR2;
 
 /**************************************************************
 * V0_DISP_LCD
@@ -476,6 +477,7 @@ Register Map
         bit[2:0] for multiplexing;
         3'b001: test pattern generator;
         3'b010: camera ov7670;
+        3'b011: dma (V6_DMA);
         3'b100: none;
         
 Register Definition:
@@ -490,6 +492,7 @@ Register IO access:
 // multiplexing;
 #define V2_DISP_SRC_MUX_REG_SEL_TEST     1 // 3'b001  // from the test pattern generator;
 #define V2_DISP_SRC_MUX_REG_SEL_CAM      2 // 3'b010  // from the camera OV7670;
+#define V2_DISP_SRC_MUX_REG_SEL_DMA      3 // 3'b011  // from the dma;
 #define V2_DISP_SRC_MUX_REG_SEL_NONE     4 // 3'b100  // nothing by blanking;
 
 /**************************************************************
@@ -672,6 +675,7 @@ It is either interfacing with:
 1. CPU;
 2. other video core: motion detection?
 3. a HW testing circuit;
+4. the dma core (V6_DMA);
 
 Construction:
 1. DDR2 read/write transaction is 128-bit.
@@ -712,7 +716,16 @@ Register Definition:
         3'b000: NONE
         3'b001: CPU
         3'b010: Motion Detection Core
+        3'b011: DMA Core (V6_DMA);
         3'b100: HW Testing Circuit;
+    hand-over: a write takes effect once the source that has the MIG is out of
+        its transaction (request sent, complete pulse not back yet);
+        meanwhile the MIG ready seen by that source is LOW (no new request);
+        so are the posted writes, the read-ahead and the fill of the cpu;
+        writing the source that has the MIG cancels a pending hand-over;
+    read:
+        bit[2:0]: the source that has the MIG;
+        bit[3]: hand-over pending; active high;
         
 2. Register 1 (Offset 1): Status Register
         bit[0]: MIG DDR2 initialization complete status; active high;
@@ -721,6 +734,15 @@ Register Definition:
                 common for both read and write; 
                 once asserted, it will remain as it is until new write/read strobe is requested;                
         bit[3]: MIG controller idle status; active high;
+        bit[4]: stream mode as set in Register 12; active high;
+        bit[5]: posted mode as set in Register 12; active high;
+        bit[6]: read-ahead line ready in Register 8-11; active high;
+        bit[7]: read-ahead next line ready in the shadow registers; active high;
+        bit[10:8]: posted writes outstanding (in the command fifo or in flight);
+        bit[11]: read-ahead read in flight; active high;
+        bit[12]: fill running (Register 13); active high;
+        bit[13]: fill done; set as the last line is written; cleared by the next start;
+        bit[23:16]: cpu transactions completed; wraps around; never cleared;
             
 3. Register 2 (Offset 2): address common for read and write;
         bit[22:0] address;
@@ -736,6 +758,63 @@ Register Definition:
        
 9. Register 8-11: to store the 128-bit read data as noted in the construction;
 
+10. Register 12 (Offset 12): Mode Register;
+        bit[0]: stream mode for the cpu; active high;
+            1. the address register post-increments after every cpu transaction;
+            2. writing Register 7 submits the write request by itself;
+            3. writing Register 3 submits a one-shot request; no clear is needed;
+        bit[1]: posted mode for the cpu writes; active high;
+            1. writing Register 7 posts {address, write data} into a command fifo (4 deep);
+                and post-increments the address register;
+            2. the fifo is drained to the MIG one write at a time;
+            3. a post into a full fifo is dropped; see the outstanding count;
+            4. no other cpu request until the outstanding count is zero;
+        bit[2]: read-ahead mode for the cpu reads; active high;
+            1. the core reads from the address register onwards by itself;
+                the address register post-increments on every read;
+            2. line N is held in Register 8-11 while line N+1 is read into shadow registers;
+            3. reading Register 11 takes line N; the shadow moves in and line N+2 is read;
+            4. writing Register 2 or Register 12 restarts it; a read in flight is dropped;
+            5. no other cpu request until no read is in flight (status bit[11]);
+
+11. Register 13 (Offset 13): Fill Register;
+        write: bit[23:0] number of lines; starts the fill;
+            1. the lines from Register 2 onwards are written with the 128-bit pattern in Register 4-7;
+            2. one write at a time; the next one goes out a cycle after the complete pulse;
+            3. the address register is left as it is;
+            4. ignored for 0 lines, while a fill runs, while posted writes are outstanding
+                or while a read-ahead read is in flight;
+            5. no other cpu request until the fill is done (status bit[12]);
+            6. it holds while another source has the MIG;
+            7. the pattern is pushed with the stream and posted modes off;
+                Register 7 would submit (post) a write otherwise;
+        read: bit[23:0] lines written since the start;
+
+12. Register 14 (Offset 14): Write Mask Register;
+        bit[15:0]: byte mask of the 128-bit write data; bit i HIGH masks byte i (write_data[8i+7:8i]);
+            1. a masked byte is not written; the DDR2 keeps it (MIG app_wdf_mask);
+            2. 16'h0000 writes all bytes; reset value;
+            3. it applies to every cpu write: single, stream, posted and fill;
+                a posted write takes the mask along with its address and data;
+            4. the other sources always write all bytes;
+
+13. Register 15 (Offset 15): HW Test Register; the hw testing circuit in the bench mode;
+        write:
+            bit[23:0]: number of lines;
+            bit[28:24]: march element; bit[0] write; bit[1] write the complement;
+                        bit[2] read and check first; bit[3] expect the complement;
+                        bit[4] from the last line down to the first;
+            bit[31]: bench mode; active high; the LED demo otherwise;
+            1. a write with bit[31] HIGH and a non-zero number of lines starts the element
+                from Register 2 onwards; ignored while one runs;
+            2. the data is the address in address: every 32-bit word of line A holds A;
+            3. the circuit only reaches the DDR2 while selected in Register 0;
+        read:
+            bit[15:0]: lines read back wrong since the start; saturates;
+            bit[16]: element running; active high;
+            bit[17]: element done; cleared by the next start;
+            bit[31]: bench mode;
+
 Register IO:
 1. Register 0: read and write;
 2. Register 1: read only;
@@ -748,7 +827,11 @@ Register IO:
 9. Register 8: read only;
 10. Register 9: read only;
 11. Register 10: read only;
-12. Register 11: read only;
+12. Register 11: read only; (read-ahead mode: reading it takes the line);
+13. Register 12: write only;
+14. Register 13: read and write;
+15. Register 14: read and write;
+16. Register 15: read and write;
  
 *****************************************************************/#define V5_MIG_INTERFACE_REG_SEL       0    // 4'b0000     // 0;
 #define V5_MIG_INTERFACE_REG_STATUS    1    // 4'b0001     // 1;
@@ -765,22 +848,182 @@ Register IO:
 #define V5_MIG_INTERFACE_REG_RDDATA_03  10  //4'b1010     // 10
 #define V5_MIG_INTERFACE_REG_RDDATA_04  11  //4'b1011     // 11
 
+#define V5_MIG_INTERFACE_REG_MODE       12  //4'b1100     // 12
+#define V5_MIG_INTERFACE_REG_FILL       13  //4'b1101     // 13
+#define V5_MIG_INTERFACE_REG_WRMASK     14  //4'b1110     // 14
+#define V5_MIG_INTERFACE_REG_TEST       15  //4'b1111     // 15
+
 // register 0: multiplexing;
 #define V5_MIG_INTERFACE_REG_SEL_NONE     0 //3'b000  // none;
 #define V5_MIG_INTERFACE_REG_SEL_CPU      1 //3'b001  // cpu;
 #define V5_MIG_INTERFACE_REG_SEL_MOTION   2 //3'b010  // motion detection video cores;
+#define V5_MIG_INTERFACE_REG_SEL_DMA      3 //3'b011  // dma core;
 #define V5_MIG_INTERFACE_REG_SEL_TEST     4 //3'b100  // hw testing circuit;
+#define V5_MIG_INTERFACE_REG_BIT_POS_SEL_PENDING  3   // read; hand-over pending;
 
 // register 1: status;
 #define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_MIG_INIT    0
 #define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_MIG_RDY     1
 #define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_COMPLETE    2
 #define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_CTRL_IDLE   3
+#define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_STREAM      4
+#define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_POSTED      5
+#define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_PF_LINE     6
+#define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_PF_NEXT     7
+#define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_POST_CNT    8   // 3-bit field;
+#define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_PF_BUSY     11
+#define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_FILL_BUSY   12
+#define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_FILL_DONE   13
+#define V5_MIG_INTERFACE_REG_BIT_POS_STATUS_COMPLETE_CNT 16 // 8-bit field;
 
 // register 3: control;
 #define V5_MIG_INTERFACE_REG_BIT_POS_WRSTROBE 0
 #define V5_MIG_INTERFACE_REG_BIT_POS_RDSTROBE 1
 
+// register 12: mode;
+#define V5_MIG_INTERFACE_REG_BIT_POS_MODE_STREAM 0
+#define V5_MIG_INTERFACE_REG_BIT_POS_MODE_POSTED 1
+#define V5_MIG_INTERFACE_REG_BIT_POS_MODE_PREFETCH 2
+
+// posted write command fifo;
+#define V5_MIG_INTERFACE_POST_FIFO_DEPTH 4
+
+// register 13: fill;
+#define V5_MIG_INTERFACE_FILL_LEN_WIDTH 24   // up to 2^23 lines;
+
+// register 14: write mask;
+#define V5_MIG_INTERFACE_WRMASK_WIDTH 16     // one bit per byte;
+
+// register 15: hw test circuit (bench mode);
+#define V5_MIG_INTERFACE_REG_BIT_POS_TEST_ERR_CNT   0   // 16-bit field; read;
+#define V5_MIG_INTERFACE_REG_BIT_POS_TEST_BUSY      16  // read;
+#define V5_MIG_INTERFACE_REG_BIT_POS_TEST_DONE      17  // read;
+#define V5_MIG_INTERFACE_REG_BIT_POS_TEST_OP        24  // 5-bit field; write;
+#define V5_MIG_INTERFACE_REG_BIT_POS_TEST_MODE      31
+#define V5_MIG_INTERFACE_TEST_LEN_WIDTH 24   // up to 2^23 lines;
+#define V5_MIG_INTERFACE_TEST_OP_WR         0x01    // 5'b00001    // write;
+#define V5_MIG_INTERFACE_TEST_OP_WR_INV     0x02    // 5'b00010    // write the complement;
+#define V5_MIG_INTERFACE_TEST_OP_RD         0x04    // 5'b00100    // read and check first;
+#define V5_MIG_INTERFACE_TEST_OP_RD_INV     0x08    // 5'b01000    // expect the complement;
+#define V5_MIG_INTERFACE_TEST_OP_DOWN       0x10    // 5'b10000    // descending addresses;
+
+/*****************************************************************
+V6_DMA
+-----------------
+Purpose: to move DDR2 lines (128-bit) without the cpu;
+1. DDR2 to DDR2;
+2. DDR2 to the LCD stream fifo;
+3. DCMI (camera fifo) to DDR2;
+
+Construction:
+1. a chain of descriptors is run in order; up to 8 descriptors;
+2. a descriptor moves a block of lines: rows x lines per row;
+    each row starts a stride away from the previous row;
+3. a descriptor is written through the window of Register 4-7;
+    Register 3 selects the descriptor; writing Register 7 moves to the next one;
+4. the DDR2 is reached through V5_MIG_INTERFACE with its select set to the dma;
+    one line in flight at a time;
+    the dma waits (busy) until the mig is handed over;
+5. DDR2 to LCD: a line is streamed byte by byte from bit[7:0] onwards;
+    V2_DISP_SRC_MUX must select the dma and the lcd must be in the stream mode;
+6. DCMI to DDR2: 16 bytes make a line; the first byte goes to bit[7:0];
+    the pixel converter is cut off from the dcmi fifo while such a descriptor runs;
+7. the done counter counts the descriptors completed;
+
+Register Map
+1. Register 0 (Offset 0): control register;
+2. Register 1 (Offset 1): status register;
+3. Register 2 (Offset 2): chain length;
+4. Register 3 (Offset 3): descriptor select;
+5. Register 4 (Offset 4): descriptor source address;
+6. Register 5 (Offset 5): descriptor destination address;
+7. Register 6 (Offset 6): descriptor size and kind;
+8. Register 7 (Offset 7): descriptor strides;
+
+Register Definition:
+1. Register 0 (Offset 0): control register;
+        bit[0]: start the chain from descriptor 0; ignored when busy;
+        bit[1]: abort the chain; after the line in flight, if any;
+            at once while waiting for the mig (no request in flight),
+            for the dcmi or for the lcd; the line being collected or streamed is dropped;
+        both are one-shot; no clear is needed;
+
+2. Register 1 (Offset 1): status register;
+        bit[0]: busy; active high;
+        bit[1]: error; the chain stopped at a descriptor of the reserved kind; cleared by a start;
+        bit[2]: aborted; the chain stopped on an abort; cleared by a start;
+        bit[6:4]: descriptor being run;
+        bit[15:8]: descriptors completed; wraps around; never cleared;
+        bit[31:16]: lines moved since the start; wraps around;
+
+3. Register 2 (Offset 2): chain length;
+        bit[3:0]: number of descriptors to run; 1 to 8; 0 runs none;
+
+4. Register 3 (Offset 3): descriptor select;
+        bit[2:0]: descriptor written through Register 4-7;
+
+5. Register 4 (Offset 4): bit[22:0]: source line address; (DDR2 sources only);
+6. Register 5 (Offset 5): bit[22:0]: destination line address; (DDR2 destinations only);
+7. Register 6 (Offset 6): size and kind;
+        bit[15:0]: lines per row; 0 is taken as 1;
+        bit[27:16]: rows; 0 is taken as 1;
+        bit[29:28]: kind;
+            2'b00: DDR2 to DDR2;
+            2'b01: DDR2 to LCD;
+            2'b10: DCMI to DDR2;
+            2'b11: reserved; error;
+8. Register 7 (Offset 7): strides;
+        bit[15:0]: source row stride in lines;
+        bit[31:16]: destination row stride in lines;
+        writing it moves the descriptor select to the next descriptor;
+
+Register IO:
+1. Register 0: write only;
+2. Register 1: read only;
+3. Register 2: read and write;
+4. Register 3: read and write;
+5. Register 4-7: write only;
+
+*****************************************************************/
+// register offset;
+#define V6_DMA_REG_CTRL         0
+#define V6_DMA_REG_STATUS       1
+#define V6_DMA_REG_CHAIN        2
+#define V6_DMA_REG_DESC_SEL     3
+#define V6_DMA_REG_DESC_SRC     4
+#define V6_DMA_REG_DESC_DST     5
+#define V6_DMA_REG_DESC_LEN     6
+#define V6_DMA_REG_DESC_STRIDE  7
+
+// register 0: control;
+#define V6_DMA_REG_BIT_POS_CTRL_START  0
+#define V6_DMA_REG_BIT_POS_CTRL_ABORT  1
+
+// register 1: status;
+#define V6_DMA_REG_BIT_POS_STATUS_BUSY     0
+#define V6_DMA_REG_BIT_POS_STATUS_ERROR    1
+#define V6_DMA_REG_BIT_POS_STATUS_ABORTED  2
+#define V6_DMA_REG_BIT_POS_STATUS_DESC     4   // 3-bit field;
+#define V6_DMA_REG_BIT_POS_STATUS_DONE_CNT 8   // 8-bit field;
+#define V6_DMA_REG_BIT_POS_STATUS_LINE_CNT 16  // 16-bit field;
+
+// register 6: size and kind;
+#define V6_DMA_REG_BIT_POS_LEN_LINE    0   // 16-bit field;
+#define V6_DMA_REG_BIT_POS_LEN_ROW     16  // 12-bit field;
+#define V6_DMA_REG_BIT_POS_LEN_KIND    28  // 2-bit field;
+
+// register 7: strides;
+#define V6_DMA_REG_BIT_POS_STRIDE_SRC  0   // 16-bit field;
+#define V6_DMA_REG_BIT_POS_STRIDE_DST  16  // 16-bit field;
+
+// kind;
+#define V6_DMA_KIND_DDR2_TO_DDR2   0
+#define V6_DMA_KIND_DDR2_TO_LCD    1
+#define V6_DMA_KIND_DCMI_TO_DDR2   2
+
+// descriptor table;
+#define V6_DMA_DESC_NUM 8
+
  
 
 #ifdef __cpluscplus
@@ -47,6 +47,26 @@ extern "C" {
 
 /************* REGISTER OPERATION **************/
 
+/*
+* @note: bus backend;
+*   1. by default, a register is accessed by dereferencing its IO bus address;
+*   2. define _HOST_MODEL (compiler flag) to build the drivers on a host;
+*       every register access is then routed to the register models
+*       of the host bus; see ../host_model/host_bus.h;
+*   3. define _MMIO_TRACE (compiler flag) on the board to record
+*       every register access; see util/mmio_trace.h;
+*   4. define _COSIM (compiler flag) to drive every register access
+*       into the verilated RTL; see ../cosim/cosim_bus.h;
+*/
+#ifdef _HOST_MODEL
+#include "host_bus.h"
+#elif defined(_COSIM)
+#include "cosim_bus.h"
+#elif defined(_MMIO_TRACE)
+uint32_t mmio_trace_read(uint32_t base_addr, uint32_t offset);
+void mmio_trace_write(uint32_t base_addr, uint32_t offset, uint32_t wr_data);
+#endif
+
 /*
 * @macro        : GET_IO_CORE_ADDR();
 * @purpose      : get the base address of a specified IO core;
@@ -74,7 +94,15 @@ extern "C" {
 *   base_addr   : base address of the register
 *   offset      : offset of the register;
 */
+#ifdef _HOST_MODEL
+#define REG_READ(base_addr, offset) (host_bus_read((uint32_t)(base_addr), (uint32_t)(offset)))
+#elif defined(_COSIM)
+#define REG_READ(base_addr, offset) (cosim_bus_read((uint32_t)(base_addr), (uint32_t)(offset)))
+#elif defined(_MMIO_TRACE)
+#define REG_READ(base_addr, offset) (mmio_trace_read((uint32_t)(base_addr), (uint32_t)(offset)))
+#else
 #define REG_READ(base_addr, offset) (*(volatile uint32_t *)((base_addr) + REG_WORD_BYTE*(offset)))
+#endif
 
 /*
 * @macro        : REG_WRITE();
@@ -84,7 +112,15 @@ extern "C" {
 *   offset      : offset of the register;
 *   data        : 32-bit data to write;
 */
+#ifdef _HOST_MODEL
+#define REG_WRITE(base_addr, offset, wr_data) (host_bus_write((uint32_t)(base_addr), (uint32_t)(offset), (uint32_t)(wr_data)))
+#elif defined(_COSIM)
+#define REG_WRITE(base_addr, offset, wr_data) (cosim_bus_write((uint32_t)(base_addr), (uint32_t)(offset), (uint32_t)(wr_data)))
+#elif defined(_MMIO_TRACE)
+#define REG_WRITE(base_addr, offset, wr_data) (mmio_trace_write((uint32_t)(base_addr), (uint32_t)(offset), (uint32_t)(wr_data)))
+#else
 #define REG_WRITE(base_addr, offset, wr_data) (*(volatile uint32_t *)((base_addr) + REG_WORD_BYTE*(offset)) = (wr_data))
+#endif
 
 
 #ifdef __cpluscplus
@@ -1,4 +1,5 @@
 #include "main.h"
+#include "memtest_util.h"
 
 /* global instance of each class representation of the IO cores*/
 // mmio system;
@@ -13,6 +14,9 @@ video_core_test_pattern_gen vid_test_pattern(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_
 video_core_pixel_converter_monoY2RGB565 vid_grayscale(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, V4_PIXEL_COLOUR_CONVERTER));
 video_core_mig_interface vid_mig(GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, V5_MIG_INTERFACE));
 
+// DDR2 regions;
+ddr2_arena ddr2_pool(DDR2_ARENA_BASE);
+
 int main(){
     //////////////////////////////////////////
     // signal declaration;
@@ -26,22 +30,28 @@ int main(){
     // for reading;
     uint32_t read_buffer[4];
     
-    // for sequential testing;
+    // for the memory test;
     uint32_t number_of_address;
-
-    // for burst testing;
-    uint32_t start_addr;    // starting address of DDR2 to test;
-    uint32_t range_addr;    // how many DDR2 address to cover?
-    uint32_t init_value;    // common value to populate the DDR2;
+    uint32_t memtest_err_cnt;
 
     // some test data;
-    uint32_t test_address = (uint32_t)0x1F;        
+    ddr2_region_t test_region;
+    uint32_t test_address;
     uint32_t test_wrdata01 = (uint32_t)0x12ABCDEF;
     uint32_t test_wrdata02 = (uint32_t)0x12345678;
     uint32_t test_wrdata03 = (uint32_t)0xAFBFCFDF;
     uint32_t test_wrdata04 = (uint32_t)0x10203040;
     uint32_t test_wrarray[4] = {test_wrdata01, test_wrdata02, test_wrdata03, test_wrdata04};
 
+    // one line from the arena;
+    if(ddr2_pool.alloc_lines(&test_region, 1) != 0){
+        debug_str("DDR2 arena allocation FAILED; abort\r\n");
+        while(1){
+            ;
+        }
+    }
+    test_address = test_region.addr;
+
     debug_str("Video Core DDR2 MIG Test\r\n");
     debug_str("///////////////////////////////////\r\n");
     ////////////////////////////////////////////////////////
@@ -55,7 +65,12 @@ int main(){
     
     // set the ddr2 to interface with the cpu;
     debug_str("Setting to cpu interface for MIG.\r\n");
-    vid_mig.set_core_cpu();
+    if(vid_mig.set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        debug_str("Setting to cpu interface FAILED; abort\r\n");
+        while(1){
+            ;
+        }
+    }
     
     
     ////////////////////////////////////////////////////////
@@ -147,13 +162,14 @@ int main(){
 
 
     //////////////////////////////////////////////////////////////////////
-    // test: sequential write->read;
-    // use the address as the write data;
+    // test: March C- by the cpu; one line at a time;
     ////////////////////////////////////////////////////////////////////    
     /*
     debug_str("///////////////////////////////////\r\n");
     number_of_address = 1000;
-    vid_mig.sw_test_sequential(number_of_address);
+    memtest_result_t march_result;
+    memtest_march_c(&vid_mig, 0, number_of_address, &march_result);
+    memtest_print_uart(&march_result, 1);
     */
     
     //////////////////////////////////////////////////////////////////////
@@ -161,9 +177,9 @@ int main(){
     ////////////////////////////////////////////////////////////////////    
     /*
     debug_str("///////////////////////////////////\r\n");
-    start_addr = 0;                        // starting address of DDR2 to test;
-    range_addr = 1000;                      // how many DDR2 address to cover?
-    init_value = (uint32_t)0xFA97AB01;     // common value to populate the DDR2;
+    uint32_t start_addr = 0;                        // starting address of DDR2 to test;
+    uint32_t range_addr = 1000;                     // how many DDR2 address to cover?
+    uint32_t init_value = (uint32_t)0xFA97AB01;     // common value to populate the DDR2;
 
     debug_str("Test: Burst write using a common write value; followed by a burst read\r\n");
     debug_str("Setup: \r\n");
@@ -173,7 +189,9 @@ int main(){
     
     // initialize the DDR2 to a common value;
     debug_str("Burst Write starts.\r\n");
-    vid_mig.init_ddr2(init_value, start_addr, range_addr);
+    if(vid_mig.init_ddr2(init_value, start_addr, range_addr) != 0){
+        debug_str("Burst Write FAILED\r\n");
+    }
     debug_str("Burst Write ends.\r\n");
 
     // check the initialization;
@@ -183,11 +201,15 @@ int main(){
     */
 
     //////////////////////////////////////////////////////////////////////////
-    // test: burst write using with address index as the data -> burst read;
+    // test: memory test suite; patterns, bandwidth and latency;
+    // the cpu and the hw test circuit; below the arena;
     /////////////////////////////////////////////////////////////////////////    
     debug_str("///////////////////////////////////\r\n");
     number_of_address = 1000;
-    vid_mig.sw_test_burst(number_of_address);
+    memtest_err_cnt = memtest_run_uart(&vid_mig, NULL, 0, number_of_address);
+    debug_str("Memory test errors: ");
+    debug_dec(memtest_err_cnt);
+    debug_str("\r\n");
 
 
 
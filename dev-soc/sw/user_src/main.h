@@ -27,6 +27,7 @@ Purpose: top level directives;
 // test driver;
 #include "test_util.h"
 #include "user_util.h"
+#include "ddr2_arena.h"
 
 // device drivers;
 #include "cam_ov7670.h"
@@ -0,0 +1,398 @@
+#include "bench_util.h"
+#ifdef _MMIO_TRACE
+#include "mmio_trace.h"
+#endif
+
+// from user_util.cpp;
+extern core_timer sys_timer;
+extern core_uart sys_uart;
+
+/* ------------------------------------------------
+* time and access count;
+--------------------------------------------------*/
+static uint64_t bench_read_cycle(void){
+#ifdef _HOST_MODEL
+    return host_bus_get().get_cycle();
+#elif defined(_COSIM)
+    return cosim_bus_get().get_cycle();
+#else
+    return sys_timer.read_counter();
+#endif
+}
+
+static uint64_t bench_read_access(void){
+#ifdef _HOST_MODEL
+    return host_bus_get().get_total_access();
+#elif defined(_COSIM)
+    return cosim_bus_get().get_total_access();
+#elif defined(_MMIO_TRACE)
+    return mmio_trace_get_access_cnt();
+#else
+    return 0;
+#endif
+}
+
+/* ------------------------------------------------
+* cases;
+* setup is not timed; run does op_cnt ops; both 0 if OK;
+--------------------------------------------------*/
+static const char bench_uart_str[] = "0123456789abcdef\r\n";
+
+static int bench_setup_none(bench_target_t *target){
+    return 0;
+}
+
+static int bench_setup_lcd(bench_target_t *target){
+    target->lcd->set_area(0, 0, LCD_ILI9341_DIMENSION_LOW_240 - 1, LCD_ILI9341_DIMENSION_HIGH_320 - 1);
+    target->lcd->enable_memwr();
+    return 0;
+}
+
+static int bench_setup_mig(bench_target_t *target){
+    if(target->mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        return -1;
+    }
+    target->mig->set_stream_mode(0);
+    while(!target->mig->is_mig_app_ready()){};
+    return 0;
+}
+
+static int bench_setup_mig_stream(bench_target_t *target){
+    // falls back to the level strobes on a core without the stream mode;
+    if(target->mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        return -1;
+    }
+    target->mig->set_stream_mode(1);
+    while(!target->mig->is_mig_app_ready()){};
+    return 0;
+}
+
+static int bench_setup_dma(bench_target_t *target){
+    // the cpu has no access to the DDR2 until the next case takes it back;
+    if(target->mig->set_core_dma() != video_core_mig_interface::WAIT_OK){
+        return -1;
+    }
+    while(!target->mig->is_mig_app_ready()){};
+    return 0;
+}
+
+static int bench_lcd_write_pixel(bench_target_t *target, uint32_t op_cnt){
+    for(uint32_t i = 0; i < op_cnt; i++){
+        target->lcd->write_pixel((uint16_t)i);
+    }
+    return 0;
+}
+
+static int bench_lcd_fill_colour(bench_target_t *target, uint32_t op_cnt){
+    for(uint32_t i = 0; i < op_cnt; i++){
+        target->lcd->fill_colour((i & 1) ? RGB565_COLOUR_BLUE : RGB565_COLOUR_RED);
+    }
+    return 0;
+}
+
+static int bench_lcd_set_area(bench_target_t *target, uint32_t op_cnt){
+    for(uint32_t i = 0; i < op_cnt; i++){
+        target->lcd->set_area(0, 0, (uint16_t)(i % LCD_ILI9341_DIMENSION_LOW_240), LCD_ILI9341_DIMENSION_HIGH_320 - 1);
+    }
+    return 0;
+}
+
+static int bench_mig_write_ddr2(bench_target_t *target, uint32_t op_cnt){
+    for(uint32_t i = 0; i < op_cnt; i++){
+        if(target->mig->write_ddr2(i, i, ~i, i << 16, i >> 16) != 0){
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int bench_mig_post_write(bench_target_t *target, uint32_t op_cnt){
+    // the fence is part of the figure; every line is written on return;
+    for(uint32_t i = 0; i < op_cnt; i++){
+        if(target->mig->post_write(i, i, ~i, i << 16, i >> 16) != 0){
+            return -1;
+        }
+    }
+    return target->mig->fence();
+}
+
+static int bench_mig_read_ddr2(bench_target_t *target, uint32_t op_cnt){
+    uint32_t read_buffer[4];
+    for(uint32_t i = 0; i < op_cnt; i++){
+        if(target->mig->read_ddr2(i, read_buffer) != 0){
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// one burst call moves at most this many lines; the buffer is on the MCS memory;
+enum{
+    BENCH_BURST_LINE_NUM = 64
+};
+static uint32_t bench_burst_buffer[4*BENCH_BURST_LINE_NUM];
+
+// the dma copies the lines the mig cases wrote to here;
+enum{
+    BENCH_DMA_DST_ADDR = 0x10000
+};
+
+static int bench_mig_write_ddr2_burst(bench_target_t *target, uint32_t op_cnt){
+    // one op is one DDR2 line; distinct data per line;
+    for(uint32_t i = 0; i < 4*BENCH_BURST_LINE_NUM; i++){
+        bench_burst_buffer[i] = i;
+    }
+    for(uint32_t i = 0; i < op_cnt; i += BENCH_BURST_LINE_NUM){
+        if(target->mig->write_ddr2_burst(i, bench_burst_buffer, (op_cnt - i < BENCH_BURST_LINE_NUM) ? op_cnt - i : BENCH_BURST_LINE_NUM) != 0){
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int bench_mig_read_ddr2_burst(bench_target_t *target, uint32_t op_cnt){
+    for(uint32_t i = 0; i < op_cnt; i += BENCH_BURST_LINE_NUM){
+        if(target->mig->read_ddr2_burst(i, bench_burst_buffer, (op_cnt - i < BENCH_BURST_LINE_NUM) ? op_cnt - i : BENCH_BURST_LINE_NUM) != 0){
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int bench_mig_read_ddr2_prefetch(bench_target_t *target, uint32_t op_cnt){
+    // same chunks as the burst; each chunk continues the read-ahead;
+    video_core_mig_reader reader(target->mig);
+    uint32_t n;
+    for(uint32_t i = 0; i < op_cnt; i += BENCH_BURST_LINE_NUM){
+        n = (op_cnt - i < BENCH_BURST_LINE_NUM) ? op_cnt - i : BENCH_BURST_LINE_NUM;
+        if(reader.open(i, n) != 0 || reader.read_lines(bench_burst_buffer, BENCH_BURST_LINE_NUM) != n){
+            return -1;
+        }
+    }
+    return reader.close();
+}
+
+static int bench_mig_writer_write16(bench_target_t *target, uint32_t op_cnt){
+    // one op is one RGB565 pixel in raster order; eight per line; the flush is part of the figure;
+    video_core_mig_writer writer(target->mig);
+    for(uint32_t i = 0; i < op_cnt; i++){
+        if(writer.write16(2*i, (uint16_t)i) != 0){
+            return -1;
+        }
+    }
+    return writer.flush();
+}
+
+static int bench_mig_init_ddr2(bench_target_t *target, uint32_t op_cnt){
+    // one op is one DDR2 line;
+    return target->mig->init_ddr2(0, 0, op_cnt);
+}
+
+static int bench_dma_copy_ddr2(bench_target_t *target, uint32_t op_cnt){
+    // one op is one DDR2 line read and written; the wait is part of the figure;
+    if(target->dma->copy_ddr2(0, BENCH_DMA_DST_ADDR, op_cnt) != 0){
+        return -1;
+    }
+    return (target->dma->wait_done() == video_core_dma::DONE_OK) ? 0 : -1;
+}
+
+static int bench_ov7670_write(bench_target_t *target, uint32_t op_cnt){
+    for(uint32_t i = 0; i < op_cnt; i++){
+        ov7670_write(OV7670_REG_COM10, 0x00);
+    }
+    return 0;
+}
+
+static int bench_spi_transfer(bench_target_t *target, uint32_t op_cnt){
+    for(uint32_t i = 0; i < op_cnt; i++){
+        target->spi->full_duplex_transfer((uint8_t)i);
+    }
+    return 0;
+}
+
+static int bench_uart_print(bench_target_t *target, uint32_t op_cnt){
+    for(uint32_t i = 0; i < op_cnt; i++){
+        target->uart->print(bench_uart_str);
+    }
+    return 0;
+}
+
+typedef struct{
+    const char *name;
+    uint32_t op_cnt;
+    uint32_t byte_per_op;
+    int (*setup)(bench_target_t *target);                   // 0 if OK;
+    int (*run)(bench_target_t *target, uint32_t op_cnt);     // 0 if OK;
+} bench_case_t;
+
+static const bench_case_t bench_case[] = {
+    // lcd; bytes on the 8080 bus;
+    {"lcd.write_pixel",             1000,   2,                          bench_setup_lcd,    bench_lcd_write_pixel},
+    {"lcd.fill_colour",             2,      2*LCD_ILI9341_PIXEL_NUM,    bench_setup_none,   bench_lcd_fill_colour},
+    {"lcd.set_area",                1000,   10,                         bench_setup_none,   bench_lcd_set_area},
+
+    // ddr2; one 128-bit line;
+    {"mig.write_ddr2",              1000,   16,                         bench_setup_mig,    bench_mig_write_ddr2},
+    {"mig.post_write",              1000,   16,                         bench_setup_mig,    bench_mig_post_write},
+    {"mig.read_ddr2",               1000,   16,                         bench_setup_mig,    bench_mig_read_ddr2},
+    {"mig.init_ddr2",               1024,   16,                         bench_setup_mig,    bench_mig_init_ddr2},
+    {"mig.write_ddr2_burst",        1024,   16,                         bench_setup_mig,    bench_mig_write_ddr2_burst},
+    {"mig.read_ddr2_burst",         1024,   16,                         bench_setup_mig,    bench_mig_read_ddr2_burst},
+    {"mig.read_ddr2_prefetch",      1024,   16,                         bench_setup_mig,    bench_mig_read_ddr2_prefetch},
+    {"mig_writer.write16",          1024,   2,                          bench_setup_mig,    bench_mig_writer_write16},
+    {"mig.init_ddr2_stream",        1024,   16,                         bench_setup_mig_stream, bench_mig_init_ddr2},
+    {"mig.write_ddr2_burst_stream", 1024,   16,                         bench_setup_mig_stream, bench_mig_write_ddr2_burst},
+    {"mig.read_ddr2_burst_stream",  1024,   16,                         bench_setup_mig_stream, bench_mig_read_ddr2_burst},
+    {"dma.copy_ddr2",               1024,   16,                         bench_setup_dma,    bench_dma_copy_ddr2},
+
+    // i2c; device id, register, data;
+    {"ov7670_write",                20,     3,                          bench_setup_none,   bench_ov7670_write},
+
+    // spi, uart;
+    {"spi.full_duplex_transfer",    1000,   1,                          bench_setup_none,   bench_spi_transfer},
+    {"uart.print",                  100,    sizeof(bench_uart_str) - 1, bench_setup_none,   bench_uart_print}
+};
+
+/* ------------------------------------------------
+* suite;
+--------------------------------------------------*/
+int bench_get_case_num(void){
+    return (int)(sizeof(bench_case)/sizeof(bench_case[0]));
+}
+
+const char *bench_get_case_name(int index){
+    if((index < 0) || (index >= bench_get_case_num())){
+        return "";
+    }
+    return bench_case[index].name;
+}
+
+int bench_run_case(bench_target_t *target, int index, bench_result_t *result){
+    /*
+    @brief  : run one case;
+    @param  :
+        target  : drivers under test;
+        index   : which case; see bench_get_case_name();
+        result  : (output);
+    @retval : 0 if OK; -1 if the index is out of range;
+                -2 if the case or its setup failed (e.g. a wait timed out); result is not valid;
+    @note   : the time is read first and last so that
+                its own register reads are outside the access count;
+    */
+    const bench_case_t *c;
+    uint64_t cycle_start;
+    uint64_t access_start;
+
+    if((index < 0) || (index >= bench_get_case_num())){
+        return -1;
+    }
+    c = &bench_case[index];
+    if(c->setup(target) != 0){
+        return -2;
+    }
+
+    cycle_start = bench_read_cycle();
+    access_start = bench_read_access();
+    if(c->run(target, c->op_cnt) != 0){
+        return -2;
+    }
+    result->access_cnt = bench_read_access() - access_start;
+    result->cycle = bench_read_cycle() - cycle_start;
+
+    result->name = c->name;
+    result->op_cnt = c->op_cnt;
+    result->byte_per_op = c->byte_per_op;
+    return 0;
+}
+
+int bench_run_all(bench_target_t *target, bench_result_t *result, int max_result){
+    // a case which failed is left out; the compare reports it as missing;
+    int result_num = 0;
+    for(int i = 0; (i < bench_get_case_num()) && (result_num < max_result); i++){
+        if(bench_run_case(target, i, &result[result_num]) == 0){
+            result_num++;
+        }
+    }
+    return result_num;
+}
+
+uint64_t bench_get_op_per_sec(const bench_result_t *result){
+    if(result->cycle == 0){
+        return 0;
+    }
+    return (uint64_t)result->op_cnt*SYS_CLK_FREQ_HZ/result->cycle;
+}
+
+uint64_t bench_get_byte_per_sec(const bench_result_t *result){
+    if(result->cycle == 0){
+        return 0;
+    }
+    return (uint64_t)result->op_cnt*result->byte_per_op*SYS_CLK_FREQ_HZ/result->cycle;
+}
+
+uint32_t bench_get_access_per_op_x100(const bench_result_t *result){
+    if(result->op_cnt == 0){
+        return 0;
+    }
+    return (uint32_t)(result->access_cnt*100/result->op_cnt);
+}
+
+void bench_print_uart(const bench_result_t *result, int result_num){
+    /*
+    @brief  : one line per case over the debug uart;
+    @param  :
+        result      : results of bench_run_all();
+        result_num  : number of results;
+    @retval : none
+    @note   : name, ops, cycles, ops/s, accesses/op, bytes/s; tab separated;
+    */
+    uint32_t access_x100;
+
+    sys_uart.print("case\tops\tcycles\tops/s\taccess/op\tbytes/s\r\n");
+    for(int i = 0; i < result_num; i++){
+        access_x100 = bench_get_access_per_op_x100(&result[i]);
+        sys_uart.print(result[i].name);
+        sys_uart.print("\t");
+        sys_uart.print((int)result[i].op_cnt);
+        sys_uart.print("\t");
+        sys_uart.print((int)result[i].cycle);
+        sys_uart.print("\t");
+        sys_uart.print((int)bench_get_op_per_sec(&result[i]));
+        sys_uart.print("\t");
+        sys_uart.print((int)(access_x100/100));
+        sys_uart.print((access_x100 % 100 < 10) ? ".0" : ".");
+        sys_uart.print((int)(access_x100 % 100));
+        sys_uart.print("\t");
+        sys_uart.print((int)bench_get_byte_per_sec(&result[i]));
+        sys_uart.print("\r\n");
+    }
+}
+
+void bench_print_json_uart(const bench_result_t *result, int result_num){
+    /*
+    @brief  : the results as JSON over the debug uart;
+    @param  :
+        result      : results of bench_run_all();
+        result_num  : number of results;
+    @retval : none
+    @note   : one case per line; the format of host_bench_write_json()
+                less the derived figures (no fpu on the MCS);
+    */
+    sys_uart.print("{\r\n  \"source\": \"board\",\r\n  \"clk_freq_hz\": ");
+    sys_uart.print((int)SYS_CLK_FREQ_HZ);
+    sys_uart.print(",\r\n  \"cases\": [\r\n");
+    for(int i = 0; i < result_num; i++){
+        sys_uart.print("    {\"name\": \"");
+        sys_uart.print(result[i].name);
+        sys_uart.print("\", \"ops\": ");
+        sys_uart.print((int)result[i].op_cnt);
+        sys_uart.print(", \"byte_per_op\": ");
+        sys_uart.print((int)result[i].byte_per_op);
+        sys_uart.print(", \"cycle\": ");
+        sys_uart.print((int)result[i].cycle);
+        sys_uart.print(", \"access\": ");
+        sys_uart.print((int)result[i].access_cnt);
+        sys_uart.print((i + 1 < result_num) ? "},\r\n" : "}\r\n");
+    }
+    sys_uart.print("  ]\r\n}\r\n");
+}
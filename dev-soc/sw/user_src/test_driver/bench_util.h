@@ -0,0 +1,102 @@
+#ifndef _BENCH_UTIL_H
+#define _BENCH_UTIL_H
+
+#include "io_reg_util.h"
+#include "io_map.h"
+
+// mmio system;
+#include "core_timer.h"
+#include "core_uart.h"
+#include "core_spi.h"
+
+// util;
+#include "user_util.h"
+
+// video system;
+#include "video_core_mig_interface.h"
+#include "video_core_dma.h"
+
+// device driver;
+#include "cam_ov7670.h"
+#include "lcd_ili9341.h"
+
+/* ------------------------------------------------
+Purpose: driver microbenchmark suite;
+1. a fixed list of cases; one per driver hot path;
+2. the same suite runs on the board and on the host models;
+3. time:
+    board: the system timer (core_timer);
+    host : the modelled bus time; see host_model/host_bench_main.cpp;
+    cosim: the RTL system clock; see cosim/cosim_bus.h;
+4. register access count:
+    host : the host bus;
+    cosim: the co-simulation bus;
+    board: the trace recorder when built with _MMIO_TRACE;
+            not counted (zero) otherwise;
+5. per case: ops/s, register accesses per op and bytes/s;
+    bytes are the payload of one op on its device bus
+    (lcd 8080 bus, DDR2 line, i2c, spi, uart);
+6. results as JSON for the regression check against a baseline;
+    see host_model/host_bench_json.h;
+
+preconditions:
+1. the lcd is initialised (lcd_ili9341_sw_driver::init());
+2. the MIG is up (init complete); the cases take the cpu as the source;
+3. the camera is on the i2c bus for the ov7670 case;
+4. the dma core is there for the dma cases; they hand the MIG to it;
+--------------------------------------------------*/
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+// drivers under test;
+typedef struct{
+    lcd_ili9341_sw_driver *lcd;
+    video_core_mig_interface *mig;
+    video_core_dma *dma;
+    core_spi *spi;
+    core_uart *uart;
+} bench_target_t;
+
+// outcome of one case;
+typedef struct{
+    const char *name;
+    uint32_t op_cnt;        // ops timed;
+    uint32_t byte_per_op;   // payload bytes of one op;
+    uint64_t cycle;         // system clock cycles of all the ops;
+    uint64_t access_cnt;    // register accesses of all the ops; 0 if not counted;
+} bench_result_t;
+
+/* function prototypes */
+int bench_get_case_num(void);
+const char *bench_get_case_name(int index);
+
+/* run one case / every case;
+retval: bench_run_case: 0 if OK; -1 if the index is out of range; -2 if the case or its setup failed;
+        bench_run_all  : number of results filled in; the cases which failed are left out;
+*/
+int bench_run_case(bench_target_t *target, int index, bench_result_t *result);
+int bench_run_all(bench_target_t *target, bench_result_t *result, int max_result);
+
+/* derived figures; integer only (no fpu on the MCS); */
+uint64_t bench_get_op_per_sec(const bench_result_t *result);
+uint64_t bench_get_byte_per_sec(const bench_result_t *result);
+uint32_t bench_get_access_per_op_x100(const bench_result_t *result);  // x100 for two decimals;
+
+// one line per case over the debug uart;
+void bench_print_uart(const bench_result_t *result, int result_num);
+
+/* the same as JSON; raw figures only;
+capture the uart into a file and check it with host_bench diff;
+see host_model/host_bench_json.h;
+*/
+void bench_print_json_uart(const bench_result_t *result, int result_num);
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif // _BENCH_UTIL_H
@@ -0,0 +1,711 @@
+#include "memtest_util.h"
+
+// from user_util.cpp;
+extern core_timer sys_timer;
+extern core_uart sys_uart;
+
+/* ------------------------------------------------
+* time; see bench_util.cpp;
+--------------------------------------------------*/
+static uint64_t memtest_read_cycle(void){
+#ifdef _HOST_MODEL
+    return host_bus_get().get_cycle();
+#elif defined(_COSIM)
+    return cosim_bus_get().get_cycle();
+#else
+    return sys_timer.read_counter();
+#endif
+}
+
+/* ------------------------------------------------
+* helpers;
+--------------------------------------------------*/
+static uint32_t memtest_buffer[4*MEMTEST_CHUNK_LINE_NUM];
+
+static int memtest_check_region(uint32_t addr, uint32_t nlines){
+    // within the 23-bit line address space;
+    if(nlines == 0 || addr + nlines > BIT_MASK(video_core_mig_interface::REG_MIG_ADDR_SIZE) || addr + nlines < addr){
+        return -1;
+    }
+    return 0;
+}
+
+static void memtest_begin(memtest_result_t *result, const char *name, uint32_t addr, uint32_t nlines){
+    result->name = name;
+    result->addr = addr;
+    result->line_num = nlines;
+    result->err_cnt = 0;
+    result->first_err_addr = MEMTEST_ADDR_NONE;
+    result->cycle = memtest_read_cycle();
+}
+
+static void memtest_check_line(memtest_result_t *result, uint32_t line, const uint32_t *data, const uint32_t *expect){
+    // words read back wrong; the first line in error is kept;
+    for(int i = 0; i < 4; i++){
+        if(data[i] != expect[i]){
+            if(result->first_err_addr == MEMTEST_ADDR_NONE){
+                result->first_err_addr = line;
+            }
+            result->err_cnt++;
+        }
+    }
+}
+
+static void memtest_fill_solid(uint32_t *line, uint32_t value){
+    line[0] = value;
+    line[1] = value;
+    line[2] = value;
+    line[3] = value;
+}
+
+/* ------------------------------------------------
+* patterns; cpu;
+--------------------------------------------------*/
+int memtest_march_c(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result){
+    /*
+    @brief  : March C- over a region; the cpu reads and writes one line at a time;
+    @param  :
+        mig     : mig interface; the cpu is made the source;
+        addr    : first line;
+        nlines  : number of lines;
+        result  : (output);
+    @retval : 0 if run; -1 if the region is out of range or the MIG is not handed to the cpu;
+    @note   : {any(w0); up(r0,w1); up(r1,w0); down(r0,w1); down(r1,w0); any(r0)};
+                0 is all zeros, 1 all ones; 10 transactions per line;
+    */
+   // elements after the first; the expected value, then the one written (if any);
+   static const struct{
+        int down;
+        int is_write;
+        uint32_t rd;
+        uint32_t wr;
+   } element[] = {
+        {0, 1, 0x00000000, 0xFFFFFFFF},
+        {0, 1, 0xFFFFFFFF, 0x00000000},
+        {1, 1, 0x00000000, 0xFFFFFFFF},
+        {1, 1, 0xFFFFFFFF, 0x00000000},
+        {0, 0, 0x00000000, 0x00000000}
+   };
+   uint32_t expect[4];
+   uint32_t i, line;
+
+   if(memtest_check_region(addr, nlines) != 0){
+        return -1;
+   }
+   if(mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        return -1;
+   }
+   memtest_begin(result, "march_c", addr, nlines);
+
+   // any(w0);
+   for(i = 0; i < nlines; i++){
+        mig->write_ddr2(addr + i, 0, 0, 0, 0);
+   }
+   for(uint32_t e = 0; e < sizeof(element)/sizeof(element[0]); e++){
+        memtest_fill_solid(expect, element[e].rd);
+        for(i = 0; i < nlines; i++){
+            line = element[e].down ? addr + nlines - 1 - i : addr + i;
+            mig->read_ddr2(line, memtest_buffer);
+            memtest_check_line(result, line, memtest_buffer, expect);
+            if(element[e].is_write){
+                mig->write_ddr2(line, element[e].wr, element[e].wr, element[e].wr, element[e].wr);
+            }
+        }
+   }
+   result->cycle = memtest_read_cycle() - result->cycle;
+   return 0;
+}
+
+int memtest_walking_ones(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result){
+    /*
+    @brief  : walking ones over the data bits, then over the address bits;
+    @param  : see memtest_march_c();
+    @retval : 0 if run; -1 if the region is out of range or the MIG is not handed to the cpu;
+    @note   : data: a single 1 in each of the 128 bits of the first line; written and read back;
+    @note   : address: the first line and the lines at power-of-two offsets inside the region;
+                each of them is written with the complement in turn;
+                the others must keep the pattern (a shorted or stuck address bit);
+    */
+   const uint32_t pattern = 0xAAAAAAAA;
+   const uint32_t antipattern = 0x55555555;
+   uint32_t line[4];
+   uint32_t expect[4];
+   uint32_t offset, test_offset;
+
+   if(memtest_check_region(addr, nlines) != 0){
+        return -1;
+   }
+   if(mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        return -1;
+   }
+   memtest_begin(result, "walking_ones", addr, nlines);
+
+   // data bits;
+   for(uint32_t bit = 0; bit < 128; bit++){
+        memtest_fill_solid(line, 0);
+        line[bit / 32] = BIT_MASK(bit % 32);
+        mig->write_ddr2(addr, line[0], line[1], line[2], line[3]);
+        mig->read_ddr2(addr, memtest_buffer);
+        memtest_check_line(result, addr, memtest_buffer, line);
+   }
+
+   // address bits; offset 0 and the powers of two;
+   memtest_fill_solid(expect, pattern);
+   mig->write_ddr2(addr, pattern, pattern, pattern, pattern);
+   for(offset = 1; offset < nlines; offset <<= 1){
+        mig->write_ddr2(addr + offset, pattern, pattern, pattern, pattern);
+   }
+   for(test_offset = 0; test_offset < nlines; test_offset = (test_offset == 0) ? 1 : test_offset << 1){
+        mig->write_ddr2(addr + test_offset, antipattern, antipattern, antipattern, antipattern);
+        for(offset = 0; offset < nlines; offset = (offset == 0) ? 1 : offset << 1){
+            if(offset != test_offset){
+                mig->read_ddr2(addr + offset, memtest_buffer);
+                memtest_check_line(result, addr + offset, memtest_buffer, expect);
+            }
+        }
+        mig->write_ddr2(addr + test_offset, pattern, pattern, pattern, pattern);
+   }
+   result->cycle = memtest_read_cycle() - result->cycle;
+   return 0;
+}
+
+int memtest_addr_in_addr(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result){
+    /*
+    @brief  : address in address; every 32-bit word of line A holds A; then ~A;
+    @param  : see memtest_march_c();
+    @retval : 0 if run; -1 if the region is out of range or the MIG is not handed to the cpu;
+    @note   : the whole region is written before it is read back; bursts of MEMTEST_CHUNK_LINE_NUM lines;
+    */
+   uint32_t i, n, j;
+   uint32_t expect[4];
+
+   if(memtest_check_region(addr, nlines) != 0){
+        return -1;
+   }
+   if(mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        return -1;
+   }
+   memtest_begin(result, "addr_in_addr", addr, nlines);
+
+   for(uint32_t inv = 0; inv < 2; inv++){
+        for(i = 0; i < nlines; i += n){
+            n = (nlines - i < MEMTEST_CHUNK_LINE_NUM) ? nlines - i : MEMTEST_CHUNK_LINE_NUM;
+            for(j = 0; j < n; j++){
+                memtest_fill_solid(&memtest_buffer[4*j], inv ? ~(addr + i + j) : addr + i + j);
+            }
+            mig->write_ddr2_burst(addr + i, memtest_buffer, n);
+        }
+        for(i = 0; i < nlines; i += n){
+            n = (nlines - i < MEMTEST_CHUNK_LINE_NUM) ? nlines - i : MEMTEST_CHUNK_LINE_NUM;
+            mig->read_ddr2_burst(addr + i, memtest_buffer, n);
+            for(j = 0; j < n; j++){
+                memtest_fill_solid(expect, inv ? ~(addr + i + j) : addr + i + j);
+                memtest_check_line(result, addr + i + j, &memtest_buffer[4*j], expect);
+            }
+        }
+   }
+   result->cycle = memtest_read_cycle() - result->cycle;
+   return 0;
+}
+
+/* ------------------------------------------------
+* patterns; HW test circuit;
+--------------------------------------------------*/
+static int memtest_hw_run(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, const uint32_t *op, int op_num,
+                            const char *name, memtest_result_t *result){
+    // one element after the other; the MIG is back to the cpu after;
+    // -1 if an element does not end within its budget or the MIG is not handed over;
+    // test_end() is called on an error too; the MIG back to the cpu if it can be;
+   uint32_t err_cnt;
+
+   if(memtest_check_region(addr, nlines) != 0){
+        return -1;
+   }
+   memtest_begin(result, name, addr, nlines);
+   for(int i = 0; i < op_num; i++){
+        if(mig->test_start(addr, nlines, op[i]) != 0 || mig->test_wait(&err_cnt) != video_core_mig_interface::WAIT_OK){
+            mig->test_end();
+            return -1;
+        }
+        result->err_cnt += err_cnt;
+   }
+   result->cycle = memtest_read_cycle() - result->cycle;
+   return (mig->test_end() == video_core_mig_interface::WAIT_OK) ? 0 : -1;
+}
+
+int memtest_hw_march_c(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result){
+    /*
+    @brief  : March C- by the HW test circuit; see memtest_march_c();
+    @param  : see memtest_march_c();
+    @retval : 0 if run; -1 if the region is out of range or the MIG is not handed over;
+    @note   : 0 is the address in address P(A); 1 is ~P(A);
+    @note   : the errors are lines; the first line in error is not known;
+    */
+   static const uint32_t op[] = {
+        video_core_mig_interface::TEST_OP_WR,
+        video_core_mig_interface::TEST_OP_RD | video_core_mig_interface::TEST_OP_WR | video_core_mig_interface::TEST_OP_WR_INV,
+        video_core_mig_interface::TEST_OP_RD | video_core_mig_interface::TEST_OP_RD_INV | video_core_mig_interface::TEST_OP_WR,
+        video_core_mig_interface::TEST_OP_DOWN | video_core_mig_interface::TEST_OP_RD | video_core_mig_interface::TEST_OP_WR | video_core_mig_interface::TEST_OP_WR_INV,
+        video_core_mig_interface::TEST_OP_DOWN | video_core_mig_interface::TEST_OP_RD | video_core_mig_interface::TEST_OP_RD_INV | video_core_mig_interface::TEST_OP_WR,
+        video_core_mig_interface::TEST_OP_RD
+   };
+   return memtest_hw_run(mig, addr, nlines, op, sizeof(op)/sizeof(op[0]), "hw_march_c", result);
+}
+
+int memtest_hw_addr_in_addr(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result){
+    /*
+    @brief  : address in address by the HW test circuit; see memtest_addr_in_addr();
+    @param  : see memtest_march_c();
+    @retval : 0 if run; -1 if the region is out of range or the MIG is not handed over;
+    */
+   static const uint32_t op[] = {
+        video_core_mig_interface::TEST_OP_WR,
+        video_core_mig_interface::TEST_OP_RD,
+        video_core_mig_interface::TEST_OP_WR | video_core_mig_interface::TEST_OP_WR_INV,
+        video_core_mig_interface::TEST_OP_RD | video_core_mig_interface::TEST_OP_RD_INV
+   };
+   return memtest_hw_run(mig, addr, nlines, op, sizeof(op)/sizeof(op[0]), "hw_addr_in_addr", result);
+}
+
+/* ------------------------------------------------
+* bandwidth;
+--------------------------------------------------*/
+int memtest_bw_cpu(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_bw_t *bw){
+    /*
+    @brief  : write, read and copy bandwidth through the cpu;
+    @param  :
+        mig     : mig interface; the cpu is made the source;
+        addr    : first line;
+        nlines  : number of lines; at least 2;
+        bw      : (output);
+    @retval : 0 if run; -1 if the region is out of range or under two lines,
+                or the MIG is not handed to the cpu;
+    @note   : in the stream mode if the driver is in it; see set_stream_mode();
+    */
+   video_core_mig_reader reader(mig);
+   uint32_t half = nlines / 2;
+   uint32_t i, n;
+   uint64_t start;
+
+   if(nlines < 2 || memtest_check_region(addr, nlines) != 0){
+        return -1;
+   }
+   if(mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        return -1;
+   }
+   bw->name = "cpu";
+   for(i = 0; i < 4*MEMTEST_CHUNK_LINE_NUM; i++){
+        memtest_buffer[i] = i;
+   }
+
+   // write;
+   start = memtest_read_cycle();
+   for(i = 0; i < nlines; i += n){
+        n = (nlines - i < MEMTEST_CHUNK_LINE_NUM) ? nlines - i : MEMTEST_CHUNK_LINE_NUM;
+        mig->write_ddr2_burst(addr + i, memtest_buffer, n);
+   }
+   bw->wr_cycle = memtest_read_cycle() - start;
+   bw->wr_byte = 16*nlines;
+
+   // read; read-ahead over the whole region;
+   start = memtest_read_cycle();
+   reader.open(addr, nlines);
+   for(i = 0; i < nlines; i += n){
+        n = reader.read_lines(memtest_buffer, MEMTEST_CHUNK_LINE_NUM);
+   }
+   reader.close();
+   bw->rd_cycle = memtest_read_cycle() - start;
+   bw->rd_byte = 16*nlines;
+
+   // copy; first half onto the second half;
+   start = memtest_read_cycle();
+   for(i = 0; i < half; i += n){
+        n = (half - i < MEMTEST_CHUNK_LINE_NUM) ? half - i : MEMTEST_CHUNK_LINE_NUM;
+        mig->read_ddr2_burst(addr + i, memtest_buffer, n);
+        mig->write_ddr2_burst(addr + half + i, memtest_buffer, n);
+   }
+   bw->copy_cycle = memtest_read_cycle() - start;
+   bw->copy_byte = 16*half;
+   return 0;
+}
+
+int memtest_bw_hw(video_core_mig_interface *mig, video_core_dma *dma, uint32_t addr, uint32_t nlines, memtest_bw_t *bw){
+    /*
+    @brief  : write, read and copy bandwidth without the cpu;
+    @param  :
+        mig     : mig interface;
+        dma     : dma core for the copy; NULL for none;
+        addr    : first line;
+        nlines  : number of lines; at least 2;
+        bw      : (output);
+    @retval : 0 if run; -1 if the region is out of range or under two lines,
+                if an element of the HW test circuit does not end within its budget,
+                if the MIG is not handed over, or the dma copy did not run to the end (it is aborted);
+    @note   : write and read: one element of the HW test circuit each;
+                the time includes the register writes that start it and the polls for its end;
+    @note   : the MIG is back to the cpu after;
+    */
+   uint32_t half = nlines / 2;
+   uint64_t start;
+
+   if(nlines < 2 || memtest_check_region(addr, nlines) != 0){
+        return -1;
+   }
+   bw->name = "hw";
+
+   // write; read and check;
+   start = memtest_read_cycle();
+   if(mig->test_start(addr, nlines, video_core_mig_interface::TEST_OP_WR) != 0 || mig->test_wait(NULL) != video_core_mig_interface::WAIT_OK){
+        mig->test_end();
+        return -1;
+   }
+   bw->wr_cycle = memtest_read_cycle() - start;
+   bw->wr_byte = 16*nlines;
+
+   start = memtest_read_cycle();
+   if(mig->test_start(addr, nlines, video_core_mig_interface::TEST_OP_RD) != 0 || mig->test_wait(NULL) != video_core_mig_interface::WAIT_OK){
+        mig->test_end();
+        return -1;
+   }
+   bw->rd_cycle = memtest_read_cycle() - start;
+   bw->rd_byte = 16*nlines;
+   if(mig->test_end() != video_core_mig_interface::WAIT_OK){
+        return -1;
+   }
+
+   // copy;
+   bw->copy_cycle = 0;
+   bw->copy_byte = 0;
+   if(dma != NULL){
+        if(mig->set_core_dma() != video_core_mig_interface::WAIT_OK){
+            return -1;
+        }
+        start = memtest_read_cycle();
+        if(dma->copy_ddr2(addr, addr + half, half) != 0 || dma->wait_done() != video_core_dma::DONE_OK){
+            dma->abort();
+            dma->wait_done();
+            mig->set_core_cpu();
+            return -1;
+        }
+        bw->copy_cycle = memtest_read_cycle() - start;
+        bw->copy_byte = 16*half;
+        if(mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+            return -1;
+        }
+   }
+   return 0;
+}
+
+uint64_t memtest_get_byte_per_sec(uint32_t byte, uint64_t cycle){
+   if(cycle == 0){
+        return 0;
+   }
+   return (uint64_t)byte*SYS_CLK_FREQ_HZ/cycle;
+}
+
+/* ------------------------------------------------
+* plane streams;
+--------------------------------------------------*/
+int memtest_planes_cpu(video_core_mig_interface *mig, const uint32_t *plane, int plane_num, uint32_t nlines, 
+                        const char *name, memtest_plane_t *result){
+    /*
+    @brief  : the motion detector pattern over planes through the cpu;
+    @param  :
+        mig         : mig interface; the cpu is made the source;
+        plane       : first line of each plane;
+        plane_num   : 2 to MEMTEST_PLANE_MAX; the first is the frame;
+        nlines      : lines per plane;
+        name        : label of the placement;
+        result      : (output);
+    @retval : 0 if run; -1 otherwise;
+    @note   : per line index: read_ddr2() of every plane; then write_ddr2() of every plane
+                but the first with the line read plus one;
+    @note   : nothing is checked; the content of the planes is lost;
+    */
+   uint32_t line[MEMTEST_PLANE_MAX][4];
+   uint32_t i;
+   int k;
+   uint64_t start;
+
+   if(plane_num < 2 || plane_num > MEMTEST_PLANE_MAX){
+        return -1;
+   }
+   for(k = 0; k < plane_num; k++){
+        if(memtest_check_region(plane[k], nlines) != 0){
+            return -1;
+        }
+   }
+   if(mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        return -1;
+   }
+
+   start = memtest_read_cycle();
+   for(i = 0; i < nlines; i++){
+        for(k = 0; k < plane_num; k++){
+            mig->read_ddr2(plane[k] + i, line[k]);
+        }
+        for(k = 1; k < plane_num; k++){
+            mig->write_ddr2(plane[k] + i, line[k][0] + 1, line[k][1] + 1, line[k][2] + 1, line[k][3] + 1);
+        }
+   }
+   result->cycle = memtest_read_cycle() - start;
+   result->name = name;
+   result->plane_num = plane_num;
+   result->line_num = nlines;
+   result->byte = 16*nlines*(2*plane_num - 1);
+   return 0;
+}
+
+int memtest_planes_dma(video_core_mig_interface *mig, video_core_dma *dma, const uint32_t *plane, uint32_t nlines,
+                        const char *name, memtest_plane_t *result){
+    /*
+    @brief  : the first plane copied onto the second by the dma;
+    @param  : see memtest_planes_cpu(); two planes;
+    @retval : 0 if run; -1 otherwise;
+    @note   : the MIG is back to the cpu after;
+    */
+   uint64_t start;
+
+   if(memtest_check_region(plane[0], nlines) != 0 || memtest_check_region(plane[1], nlines) != 0){
+        return -1;
+   }
+   if(mig->set_core_dma() != video_core_mig_interface::WAIT_OK){
+        return -1;
+   }
+   start = memtest_read_cycle();
+   if(dma->copy_ddr2(plane[0], plane[1], nlines) != 0 || dma->wait_done() != video_core_dma::DONE_OK){
+        dma->abort();
+        dma->wait_done();
+        mig->set_core_cpu();
+        return -1;
+   }
+   result->cycle = memtest_read_cycle() - start;
+   if(mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        return -1;
+   }
+   result->name = name;
+   result->plane_num = 2;
+   result->line_num = nlines;
+   result->byte = 2*16*nlines;
+   return 0;
+}
+
+/* ------------------------------------------------
+* latency;
+--------------------------------------------------*/
+int memtest_latency(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, int is_write, uint32_t bin_cycle, memtest_hist_t *hist){
+    /*
+    @brief  : latency histogram of single line transactions;
+    @param  :
+        mig         : mig interface; the cpu is made the source;
+        addr        : first line;
+        nlines      : number of lines; one transaction each;
+        is_write    : 1 for write_ddr2(); 0 for read_ddr2();
+        bin_cycle   : bin width in system clock cycles; 0 for log2 bins;
+        hist        : (output);
+    @retval : 0 if run; -1 if the region is out of range or the MIG is not handed to the cpu;
+    @note   : each transaction is timed on its own; from the call to the return;
+    */
+   uint64_t start;
+   uint32_t cycle;
+   uint32_t bin;
+
+   if(memtest_check_region(addr, nlines) != 0){
+        return -1;
+   }
+   if(mig->set_core_cpu() != video_core_mig_interface::WAIT_OK){
+        return -1;
+   }
+   hist->is_write = is_write;
+   hist->bin_cycle = bin_cycle;
+   for(bin = 0; bin < MEMTEST_HIST_BIN_NUM; bin++){
+        hist->bin[bin] = 0;
+   }
+   hist->cnt = 0;
+   hist->min = 0xFFFFFFFF;
+   hist->max = 0;
+   hist->sum = 0;
+
+   for(uint32_t i = 0; i < nlines; i++){
+        start = memtest_read_cycle();
+        if(is_write){
+            mig->write_ddr2(addr + i, i, ~i, i, ~i);
+        }
+        else{
+            mig->read_ddr2(addr + i, memtest_buffer);
+        }
+        cycle = (uint32_t)(memtest_read_cycle() - start);
+
+        if(bin_cycle){
+            bin = cycle / bin_cycle;
+        }
+        else{
+            for(bin = 0; (cycle >> (bin + 1)) != 0; bin++){};
+        }
+        if(bin >= MEMTEST_HIST_BIN_NUM){
+            bin = MEMTEST_HIST_BIN_NUM - 1;
+        }
+        hist->bin[bin]++;
+        hist->cnt++;
+        hist->sum += cycle;
+        if(cycle < hist->min){
+            hist->min = cycle;
+        }
+        if(cycle > hist->max){
+            hist->max = cycle;
+        }
+   }
+   return 0;
+}
+
+/* ------------------------------------------------
+* reports;
+--------------------------------------------------*/
+static void memtest_print_x100(uint64_t value_x100){
+    // two decimals;
+    sys_uart.print((int)(value_x100/100));
+    sys_uart.print((value_x100 % 100 < 10) ? ".0" : ".");
+    sys_uart.print((int)(value_x100 % 100));
+}
+
+void memtest_print_uart(const memtest_result_t *result, int result_num){
+    /*
+    @brief  : one line per pattern over the debug uart;
+    @param  :
+        result      : results of the patterns;
+        result_num  : number of results;
+    @retval : none
+    @note   : name, first line, lines, errors, first line in error, cycles, PASS/FAIL; tab separated;
+    */
+    sys_uart.print("pattern\taddr\tlines\terrors\tfirst\tcycles\r\n");
+    for(int i = 0; i < result_num; i++){
+        sys_uart.print(result[i].name);
+        sys_uart.print("\t");
+        sys_uart.print((int)result[i].addr, 16);
+        sys_uart.print("\t");
+        sys_uart.print((int)result[i].line_num);
+        sys_uart.print("\t");
+        sys_uart.print((int)result[i].err_cnt);
+        sys_uart.print("\t");
+        if(result[i].first_err_addr == MEMTEST_ADDR_NONE){
+            sys_uart.print("-");
+        }
+        else{
+            sys_uart.print((int)result[i].first_err_addr, 16);
+        }
+        sys_uart.print("\t");
+        sys_uart.print((int)result[i].cycle);
+        sys_uart.print((result[i].err_cnt == 0) ? "\tPASS\r\n" : "\tFAIL\r\n");
+    }
+}
+
+void memtest_print_bw_uart(const memtest_bw_t *bw){
+    /*
+    @brief  : write, read and copy bandwidth in MB/s over the debug uart;
+    @param  : bandwidth of memtest_bw_cpu() or memtest_bw_hw();
+    @retval : none
+    */
+    sys_uart.print(bw->name);
+    sys_uart.print("\twrite MB/s ");
+    memtest_print_x100(memtest_get_byte_per_sec(bw->wr_byte, bw->wr_cycle)/10000);
+    sys_uart.print("\tread MB/s ");
+    memtest_print_x100(memtest_get_byte_per_sec(bw->rd_byte, bw->rd_cycle)/10000);
+    sys_uart.print("\tcopy MB/s ");
+    if(bw->copy_byte){
+        memtest_print_x100(memtest_get_byte_per_sec(bw->copy_byte, bw->copy_cycle)/10000);
+    }
+    else{
+        sys_uart.print("-");
+    }
+    sys_uart.print("\r\n");
+}
+
+void memtest_print_hist_uart(const memtest_hist_t *hist){
+    /*
+    @brief  : latency histogram over the debug uart;
+    @param  : histogram of memtest_latency();
+    @retval : none
+    @note   : min, mean and max; then one line per bin with a count;
+    */
+    uint32_t low;
+
+    sys_uart.print(hist->is_write ? "write_ddr2" : "read_ddr2");
+    sys_uart.print(" latency (cycles) min ");
+    sys_uart.print((int)hist->min);
+    sys_uart.print(" mean ");
+    sys_uart.print(hist->cnt ? (int)(hist->sum/hist->cnt) : 0);
+    sys_uart.print(" max ");
+    sys_uart.print((int)hist->max);
+    sys_uart.print("\r\n");
+    for(uint32_t i = 0; i < MEMTEST_HIST_BIN_NUM; i++){
+        if(hist->bin[i] == 0){
+            continue;
+        }
+        low = hist->bin_cycle ? i*hist->bin_cycle : ((i == 0) ? 0 : BIT_MASK(i));
+        sys_uart.print("  >= ");
+        sys_uart.print((int)low);
+        sys_uart.print("\t");
+        sys_uart.print((int)hist->bin[i]);
+        sys_uart.print("\r\n");
+    }
+}
+
+void memtest_print_plane_uart(const memtest_plane_t *result){
+    /*
+    @brief  : plane stream over the debug uart;
+    @param  : result of memtest_planes_cpu() or memtest_planes_dma();
+    @retval : none
+    */
+    sys_uart.print(result->name);
+    sys_uart.print("\tplanes ");
+    sys_uart.print((int)result->plane_num);
+    sys_uart.print("\tlines ");
+    sys_uart.print((int)result->line_num);
+    sys_uart.print("\tcycles ");
+    sys_uart.print((int)result->cycle);
+    sys_uart.print("\tMB/s ");
+    memtest_print_x100(memtest_get_byte_per_sec(result->byte, result->cycle)/10000);
+    sys_uart.print("\r\n");
+}
+
+uint32_t memtest_run_uart(video_core_mig_interface *mig, video_core_dma *dma, uint32_t addr, uint32_t nlines){
+    /*
+    @brief  : every pattern, both bandwidths and both latency histograms over one region;
+    @param  :
+        mig     : mig interface;
+        dma     : dma core for the hw copy; NULL for none;
+        addr    : first line;
+        nlines  : number of lines;
+    @retval : total errors; 0 if every pattern passed (or none could run);
+    @note   : the reports are printed once everything has run;
+    */
+    memtest_result_t result[5];
+    memtest_bw_t bw[2];
+    memtest_hist_t hist[2];
+    int result_num = 0;
+    int bw_num = 0;
+    int hist_num = 0;
+    uint32_t err_cnt = 0;
+
+    result_num += (memtest_march_c(mig, addr, nlines, &result[result_num]) == 0);
+    result_num += (memtest_walking_ones(mig, addr, nlines, &result[result_num]) == 0);
+    result_num += (memtest_addr_in_addr(mig, addr, nlines, &result[result_num]) == 0);
+    result_num += (memtest_hw_march_c(mig, addr, nlines, &result[result_num]) == 0);
+    result_num += (memtest_hw_addr_in_addr(mig, addr, nlines, &result[result_num]) == 0);
+    bw_num += (memtest_bw_cpu(mig, addr, nlines, &bw[bw_num]) == 0);
+    bw_num += (memtest_bw_hw(mig, dma, addr, nlines, &bw[bw_num]) == 0);
+    hist_num += (memtest_latency(mig, addr, nlines, 1, 0, &hist[hist_num]) == 0);
+    hist_num += (memtest_latency(mig, addr, nlines, 0, 0, &hist[hist_num]) == 0);
+
+    memtest_print_uart(result, result_num);
+    for(int i = 0; i < bw_num; i++){
+        memtest_print_bw_uart(&bw[i]);
+    }
+    for(int i = 0; i < hist_num; i++){
+        memtest_print_hist_uart(&hist[i]);
+    }
+    for(int i = 0; i < result_num; i++){
+        err_cnt += result[i].err_cnt;
+    }
+    return err_cnt;
+}
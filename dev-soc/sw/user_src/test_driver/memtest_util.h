@@ -0,0 +1,161 @@
+#ifndef _MEMTEST_UTIL_H
+#define _MEMTEST_UTIL_H
+
+#include "io_reg_util.h"
+#include "io_map.h"
+
+// mmio system;
+#include "core_timer.h"
+#include "core_uart.h"
+
+// util;
+#include "user_util.h"
+
+// video system;
+#include "video_core_mig_interface.h"
+#include "video_core_dma.h"
+
+/* ------------------------------------------------
+Purpose: DDR2 memory test and bandwidth benchmark;
+1. patterns over any region of lines [addr, addr + nlines):
+    (a) March C-: {any(w0); up(r0,w1); up(r1,w0); down(r0,w1); down(r1,w0); any(r0)};
+        0 is all zeros and 1 all ones;
+    (b) walking ones: a single 1 across the 128 data bits at the first line;
+        then across the address bits (the lines at power-of-two offsets);
+    (c) address in address: every 32-bit word of line A holds A; then ~A;
+2. two drivers:
+    cpu : through the mig interface (write_ddr2(), read_ddr2(), the bursts);
+    hw  : the HW test circuit in the bench mode (user_mig_HW_test_sequential.sv);
+          one march element per command; the data is the address in address;
+          0 is P(A) and 1 is ~P(A) for March C-;
+          see video_core_mig_interface::test_start();
+3. bandwidth (MB/s) of write, read and copy:
+    cpu : write_ddr2_burst(), the read-ahead (video_core_mig_reader),
+          read_ddr2_burst() then write_ddr2_burst() for the copy;
+    hw  : a write and a read element of the HW test circuit;
+          the dma (copy_ddr2()) for the copy;
+    the copy moves the first half of the region onto the second half;
+    its figure is the bytes copied (not read plus written);
+4. latency histogram of single line transactions (read_ddr2() or write_ddr2());
+4a. plane streams; the access pattern of the motion detector over 2 to 4 planes:
+    cpu : per line index, a read of every plane then a write of every plane but the first
+          (the frame is read; the state planes are read, updated and written back);
+    hw  : the dma copies the first plane onto the second;
+    the placement of the planes is up to the caller; to compare the same planes
+    in one bank (back to back) against planes in different banks; see ddr2_arena.h;
+5. time:
+    board: the system timer (core_timer); its own reads are in the latency;
+    host : the modelled bus time; cosim: the RTL system clock; as bench_util;
+6. nothing is printed while a test runs; memtest_print_*_uart() after;
+
+preconditions:
+1. the MIG is up (init complete); the cpu tests take the cpu as the source;
+2. the region is not used by anything else; its content is lost;
+3. the hw tests hand the MIG to the HW test circuit and take it back to the cpu;
+    the bench mode is left on while they run; the LED demo stays off;
+--------------------------------------------------*/
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+#define MEMTEST_ADDR_NONE       0xFFFFFFFF  // no error;
+#define MEMTEST_HIST_BIN_NUM    16          // bins of the latency histogram;
+#define MEMTEST_PLANE_MAX       4           // planes per stream;
+
+// lines per burst; the buffer is on the MCS memory;
+#ifndef MEMTEST_CHUNK_LINE_NUM
+#define MEMTEST_CHUNK_LINE_NUM  64
+#endif
+
+// outcome of one pattern;
+typedef struct{
+    const char *name;
+    uint32_t addr;              // first line;
+    uint32_t line_num;
+    uint32_t err_cnt;           // cpu: 32-bit words read back wrong; hw: lines;
+    uint32_t first_err_addr;    // line; MEMTEST_ADDR_NONE if none; cpu only;
+    uint64_t cycle;             // system clock cycles;
+} memtest_result_t;
+
+// bandwidth; bytes moved and the cycles it took; per kind;
+typedef struct{
+    const char *name;
+    uint32_t wr_byte;
+    uint32_t rd_byte;
+    uint32_t copy_byte;         // 0 if not run (hw without a dma);
+    uint64_t wr_cycle;
+    uint64_t rd_cycle;
+    uint64_t copy_cycle;
+} memtest_bw_t;
+
+// latency histogram; system clock cycles per transaction;
+typedef struct{
+    int is_write;
+    uint32_t bin_cycle;                     // bin width; 0 for log2 bins [2^i, 2^(i+1));
+    uint32_t bin[MEMTEST_HIST_BIN_NUM];     // the last bin takes the rest;
+    uint32_t cnt;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} memtest_hist_t;
+
+// plane streams; bytes moved and the cycles it took;
+typedef struct{
+    const char *name;
+    uint32_t plane_num;
+    uint32_t line_num;          // lines per plane;
+    uint32_t byte;              // read and written; every plane;
+    uint64_t cycle;
+} memtest_plane_t;
+
+/* patterns;
+retval: 0 if run; -1 if the region is empty or past the 23-bit address space,
+        or the MIG is not handed over (see video_core_mig_interface::handover());
+        the errors are in the result;
+*/
+int memtest_march_c(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result);
+int memtest_walking_ones(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result);
+int memtest_addr_in_addr(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result);
+int memtest_hw_march_c(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result);
+int memtest_hw_addr_in_addr(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_result_t *result);
+
+/* bandwidth; dma may be NULL (no copy);
+retval: 0 if run; -1 if the region is out of range or under two lines, or the MIG is not handed over;
+*/
+int memtest_bw_cpu(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, memtest_bw_t *bw);
+int memtest_bw_hw(video_core_mig_interface *mig, video_core_dma *dma, uint32_t addr, uint32_t nlines, memtest_bw_t *bw);
+uint64_t memtest_get_byte_per_sec(uint32_t byte, uint64_t cycle);
+
+/* plane streams; plane: first line of each plane; name: label of the placement;
+retval: 0 if run; -1 if a plane is out of range, the number of planes is not 2 to MEMTEST_PLANE_MAX,
+        or the MIG is not handed over;
+*/
+int memtest_planes_cpu(video_core_mig_interface *mig, const uint32_t *plane, int plane_num, uint32_t nlines, 
+                        const char *name, memtest_plane_t *result);
+int memtest_planes_dma(video_core_mig_interface *mig, video_core_dma *dma, const uint32_t *plane, uint32_t nlines,
+                        const char *name, memtest_plane_t *result);
+
+/* latency; one transaction per line; bin_cycle: see memtest_hist_t;
+retval: 0 if run; -1 if the region is empty or past the 23-bit address space, or the MIG is not handed over;
+*/
+int memtest_latency(video_core_mig_interface *mig, uint32_t addr, uint32_t nlines, int is_write, uint32_t bin_cycle, memtest_hist_t *hist);
+
+/* reports over the debug uart; one line per pattern; MB/s with two decimals; */
+void memtest_print_uart(const memtest_result_t *result, int result_num);
+void memtest_print_bw_uart(const memtest_bw_t *bw);
+void memtest_print_hist_uart(const memtest_hist_t *hist);
+void memtest_print_plane_uart(const memtest_plane_t *result);
+
+/* the whole suite over one region with the reports;
+retval: total errors; 0 if every pattern passed;
+*/
+uint32_t memtest_run_uart(video_core_mig_interface *mig, video_core_dma *dma, uint32_t addr, uint32_t nlines);
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif // _MEMTEST_UTIL_H
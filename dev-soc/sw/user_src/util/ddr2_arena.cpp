@@ -0,0 +1,217 @@
+#include "ddr2_arena.h"
+
+ddr2_arena::ddr2_arena(uint32_t base_line){
+    /*
+    @brief  : constructor; to cut the arena into the pools;
+    @param  : base_line : first line of the arena;
+    @retval : none
+    @note   : the blocks are dealt over the banks from the one of base_line up;
+                in every bank, the pools are back to back from the offset of base_line;
+                smallest block first;
+    @note   : every pool is left empty if the arena does not fit;
+    */
+   const uint32_t line_num[DDR2_ARENA_POOL_NUM] = {DDR2_ARENA_RING_LINE_NUM, DDR2_ARENA_PLANE_LINE_NUM, DDR2_ARENA_FRAME_LINE_NUM};
+   const uint16_t block_num[DDR2_ARENA_POOL_NUM] = {DDR2_ARENA_RING_NUM, DDR2_ARENA_PLANE_NUM, DDR2_ARENA_FRAME_NUM};
+   uint32_t addr = base_line & (DDR2_ARENA_BANK_LINE_NUM - 1);
+   uint16_t first = 0;
+   uint16_t i;
+   int fit;
+
+   base = base_line;
+   bank_first = (base_line < DDR2_ARENA_ADDR_SPACE) ? (base_line >> DDR2_ARENA_BANK_SHIFT) : DDR2_ARENA_BANK_NUM - 1;
+   bank_span = DDR2_ARENA_BANK_NUM - bank_first;
+   for(int pool = 0; pool < DDR2_ARENA_POOL_NUM; pool++){
+      addr += ((block_num[pool] + bank_span - 1) / bank_span)*line_num[pool];
+   }
+   fit = (base_line < DDR2_ARENA_ADDR_SPACE && addr <= DDR2_ARENA_BANK_LINE_NUM);
+
+   addr = base_line & (DDR2_ARENA_BANK_LINE_NUM - 1);
+   for(int pool = 0; pool < DDR2_ARENA_POOL_NUM; pool++){
+      pool_base[pool] = addr;
+      pool_line_num[pool] = line_num[pool];
+      pool_first[pool] = first;
+      pool_block_num[pool] = fit ? block_num[pool] : 0;
+      pool_free_num[pool] = pool_block_num[pool];
+
+      // lowest line on top of the stack;
+      for(i = 0; i < block_num[pool]; i++){
+         free_block[first + i] = first + block_num[pool] - 1 - i;
+         block_used[first + i] = 0;
+      }
+      addr += ((block_num[pool] + bank_span - 1) / bank_span)*line_num[pool];
+      first += block_num[pool];
+   }
+}
+
+// destructor; not used;
+ddr2_arena::~ddr2_arena(){};
+
+uint32_t ddr2_arena::block_addr(int pool, uint16_t block){
+   // first line of a block; round robin over the banks;
+   uint32_t index = block - pool_first[pool];
+
+   return ((bank_first + index % bank_span) << DDR2_ARENA_BANK_SHIFT) + pool_base[pool] 
+            + (index / bank_span)*pool_line_num[pool];
+}
+
+int ddr2_arena::alloc(ddr2_region_t *region, uint16_t width, uint16_t height, int format){
+   return take(region, width, height, format, (const ddr2_region_t *)0, 0);
+}
+
+int ddr2_arena::alloc_apart(ddr2_region_t *region, uint16_t width, uint16_t height, int format,
+                              const ddr2_region_t *other, int other_num){
+   return take(region, width, height, format, other, other_num);
+}
+
+int ddr2_arena::take(ddr2_region_t *region, uint16_t width, uint16_t height, int format,
+                        const ddr2_region_t *other, int other_num){
+    /*
+    @brief  : to allocate a region of height rows of width pixels;
+    @param  :
+        1. region   : handle; filled in if OK;
+        2. width    : pixels per row (bytes for DDR2_ARENA_FMT_RAW);
+        3. height   : rows;
+        4. format   : DDR2_ARENA_FMT_*;
+        5. other    : regions whose banks are not to be taken; none if other_num is 0;
+        6. other_num: number of them;
+    @retval : 0 if OK; -1 otherwise; the region is then marked not allocated;
+    @note   : a row is padded to a whole line; stride = ceil(row bytes / 16);
+    @note   : the smallest free block that fits; a frame may take a frame block
+                if the plane blocks are used up, etc;
+    @note   : with other regions, the free stack is searched from the top;
+                the block found is swapped to the top; O(blocks of the pool);
+    */
+   uint32_t stride;
+   uint32_t nlines;
+   uint32_t bank_used = 0;
+   uint16_t block;
+   int top;
+   int slot;
+
+   region->pool = DDR2_ARENA_POOL_NONE;
+   if(width == 0 || height == 0 || get_row_byte(width, format) == 0){
+      return -1;
+   }
+   stride = (get_row_byte(width, format) + DDR2_ARENA_LINE_BYTE - 1) / DDR2_ARENA_LINE_BYTE;
+   nlines = stride*height;
+   for(int i = 0; i < other_num; i++){
+      bank_used |= 1UL << get_bank(other[i].addr);
+   }
+
+   for(int pool = 0; pool < DDR2_ARENA_POOL_NUM; pool++){
+      if(nlines > pool_line_num[pool] || pool_free_num[pool] == 0){
+         continue;
+      }
+      top = pool_first[pool] + pool_free_num[pool] - 1;
+      for(slot = top; slot >= pool_first[pool]; slot--){
+         if(!(bank_used & (1UL << get_bank(block_addr(pool, free_block[slot]))))){
+            break;
+         }
+      }
+      if(slot < pool_first[pool]){
+         continue;
+      }
+      block = free_block[slot];
+      free_block[slot] = free_block[top];
+      free_block[top] = block;
+      pool_free_num[pool]--;
+      block_used[block] = 1;
+
+      region->addr = block_addr(pool, block);
+      region->line_num = pool_line_num[pool];
+      region->width = width;
+      region->height = height;
+      region->stride = (uint16_t)stride;
+      region->format = (uint8_t)format;
+      region->pool = (uint8_t)pool;
+      region->block = block;
+      return 0;
+   }
+   return -1;
+}
+
+int ddr2_arena::alloc_lines(ddr2_region_t *region, uint32_t nlines){
+    /*
+    @brief  : to allocate nlines contiguous lines; ring buffers etc;
+    @param  : region : handle; nlines : lines;
+    @retval : 0 if OK; -1 otherwise;
+    @note   : a DDR2_ARENA_FMT_RAW region; one line (16 bytes) per row;
+    */
+   if(nlines > 0xFFFF){
+      region->pool = DDR2_ARENA_POOL_NONE;
+      return -1;
+   }
+   return alloc(region, DDR2_ARENA_LINE_BYTE, (uint16_t)nlines, DDR2_ARENA_FMT_RAW);
+}
+
+int ddr2_arena::release(ddr2_region_t *region){
+    /*
+    @brief  : to return a region to its pool;
+    @param  : region : handle from alloc(); marked not allocated on return;
+    @retval : 0 if OK; -1 if it is not allocated from this arena (or released already);
+    */
+   uint8_t pool = region->pool;
+   uint16_t block = region->block;
+
+   if(pool >= DDR2_ARENA_POOL_NUM){
+      return -1;
+   }
+   if(block < pool_first[pool] || block >= pool_first[pool] + pool_block_num[pool] || !block_used[block]){
+      return -1;
+   }
+   if(region->addr != block_addr(pool, block)){
+      return -1;
+   }
+
+   block_used[block] = 0;
+   free_block[pool_first[pool] + pool_free_num[pool]] = block;
+   pool_free_num[pool]++;
+   region->pool = DDR2_ARENA_POOL_NONE;
+   return 0;
+}
+
+uint32_t ddr2_arena::get_base(void){
+   return base;
+}
+
+uint32_t ddr2_arena::get_free_num(int pool){
+   return (pool >= 0 && pool < DDR2_ARENA_POOL_NUM) ? pool_free_num[pool] : 0;
+}
+
+uint32_t ddr2_arena::get_block_line_num(int pool){
+   return (pool >= 0 && pool < DDR2_ARENA_POOL_NUM) ? pool_line_num[pool] : 0;
+}
+
+uint32_t ddr2_arena::row_addr(const ddr2_region_t *region, uint32_t row){
+    /*
+    @brief  : first line of a row of a region;
+    @param  : region : handle; row : 0 to height - 1;
+    @retval : line address;
+    */
+   return region->addr + row*region->stride;
+}
+
+uint32_t ddr2_arena::get_row_byte(uint16_t width, int format){
+    /*
+    @brief  : bytes per row before the padding to a line;
+    @param  : width : pixels; format : DDR2_ARENA_FMT_*;
+    @retval : bytes; 0 if the format is not known;
+    */
+   switch(format){
+      case DDR2_ARENA_FMT_RAW:
+      case DDR2_ARENA_FMT_Y8:
+         return width;
+      case DDR2_ARENA_FMT_RGB565:
+         return 2*(uint32_t)width;
+      default:
+         return 0;
+   }
+}
+
+uint32_t ddr2_arena::get_bank(uint32_t addr){
+   return (addr >> DDR2_ARENA_BANK_SHIFT) & (DDR2_ARENA_BANK_NUM - 1);
+}
+
+uint32_t ddr2_arena::get_dram_row(uint32_t addr){
+   return (addr & (DDR2_ARENA_BANK_LINE_NUM - 1)) >> DDR2_ARENA_ROW_SHIFT;
+}
@@ -0,0 +1,202 @@
+#ifndef _DDR2_ARENA_H
+#define _DDR2_ARENA_H
+
+/* ---------------------------------------------
+Purpose: allocator of the DDR2 line address space;
+1. the DDR2 is addressed in lines (128-bit; 16 bytes); 23-bit line address;
+    see video_core_mig_interface.h;
+2. the arena starts at a base line; it is cut into pools of
+    fixed size blocks at construction; the sizes are set at compile time;
+    (a) FRAME : one RGB565 frame of the lcd; 240 x 320 x 2 bytes;
+    (b) PLANE : one 8-bit plane of the lcd; 240 x 320 x 1 byte;
+                the luma of the camera, the motion detector state;
+    (c) RING  : DDR2_ARENA_RING_LINE_NUM lines; ring buffers and the rest;
+3. a region is handed out as a handle (ddr2_region_t) that carries
+    the width, height, pixel format and stride along with the first line;
+    a row starts on a line; the stride is in lines, as the dma descriptor;
+4. alloc() takes the smallest block that fits; then the next pool up;
+    alloc() and release() are O(1); a stack of free blocks per pool;
+    no heap; the bookkeeping is in the object;
+5. the lines below the base are left to raw addresses
+    (the tests, the benchmark and the HW test circuit);
+6. bank interleaving; the MIG maps the line address as bank-row-column:
+    bank = bit[22:20], row = bit[19:7], column = bit[6:0]; a row is 128 lines (2KB);
+    (a) the blocks of a pool are dealt round robin over the banks from the base up;
+        block i is in bank (base bank + i mod banks); the pools are stacked
+        at the same offset in every bank; consecutive alloc() of a pool
+        land in different banks;
+    (b) planes streamed at once (the frame, the mean and the variance of the
+        motion detector) are to be in different banks; each bank then keeps
+        its own row open; in the same bank every step opens another row;
+        alloc_apart() takes a block in a bank none of the given regions is in;
+
+usage:
+    ddr2_arena arena(DDR2_ARENA_BASE);
+    ddr2_region_t frame;
+    if(arena.alloc(&frame, 240, 320, DDR2_ARENA_FMT_RGB565) != 0){ ... }
+    vid_dma.copy_ddr2(src, frame.addr, frame.stride*frame.height);
+    arena.release(&frame);
+
+    ddr2_region_t plane[3];     // luma, mean, variance;
+    arena.alloc(&plane[0], 240, 320, DDR2_ARENA_FMT_Y8);
+    arena.alloc_apart(&plane[1], 240, 320, DDR2_ARENA_FMT_Y8, plane, 1);
+    arena.alloc_apart(&plane[2], 240, 320, DDR2_ARENA_FMT_Y8, plane, 2);
+
+@note:
+1. the arena does not access the DDR2; a region is not cleared on alloc();
+    see video_core_mig_interface::fill_ddr2();
+2. not reentrant; one owner per arena;
+---------------------------------------------*/
+
+#include "inttypes.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+/*-------------------
+* Constants;
+-------------------*/
+#define DDR2_ARENA_LINE_BYTE        16          // bytes per line;
+#define DDR2_ARENA_ADDR_SPACE       0x800000    // lines; 23-bit;
+
+// first line of the arena; the 16MB below (bank 0) are left to raw addresses;
+#ifndef DDR2_ARENA_BASE
+#define DDR2_ARENA_BASE             0x100000
+#endif
+
+// block size per pool; in lines;
+#define DDR2_ARENA_FRAME_LINE_NUM   9600        // 240 x 320 x 2 / 16;
+#define DDR2_ARENA_PLANE_LINE_NUM   4800        // 240 x 320 x 1 / 16;
+#ifndef DDR2_ARENA_RING_LINE_NUM
+#define DDR2_ARENA_RING_LINE_NUM    1024        // 16KB;
+#endif
+
+// blocks per pool;
+#ifndef DDR2_ARENA_FRAME_NUM
+#define DDR2_ARENA_FRAME_NUM        8
+#endif
+#ifndef DDR2_ARENA_PLANE_NUM
+#define DDR2_ARENA_PLANE_NUM        16
+#endif
+#ifndef DDR2_ARENA_RING_NUM
+#define DDR2_ARENA_RING_NUM         32
+#endif
+
+#define DDR2_ARENA_BLOCK_NUM        (DDR2_ARENA_FRAME_NUM + DDR2_ARENA_PLANE_NUM + DDR2_ARENA_RING_NUM)
+#define DDR2_ARENA_LINE_NUM         (DDR2_ARENA_FRAME_NUM*DDR2_ARENA_FRAME_LINE_NUM + \
+                                     DDR2_ARENA_PLANE_NUM*DDR2_ARENA_PLANE_LINE_NUM + \
+                                     DDR2_ARENA_RING_NUM*DDR2_ARENA_RING_LINE_NUM)
+
+// DDR2 geometry in lines; see user_mig_DDR2_sync_ctrl.sv;
+#define DDR2_ARENA_BANK_NUM         8
+#define DDR2_ARENA_BANK_SHIFT       20
+#define DDR2_ARENA_BANK_LINE_NUM    (1UL << DDR2_ARENA_BANK_SHIFT)  // 16MB;
+#define DDR2_ARENA_ROW_SHIFT        7
+#define DDR2_ARENA_ROW_LINE_NUM     (1UL << DDR2_ARENA_ROW_SHIFT)   // 2KB;
+
+// banks the blocks are dealt over; lines per bank; by DDR2_ARENA_BASE;
+#define DDR2_ARENA_BANK_SPAN        (DDR2_ARENA_BANK_NUM - (DDR2_ARENA_BASE >> DDR2_ARENA_BANK_SHIFT))
+#define DDR2_ARENA_PER_BANK(num)    (((num) + DDR2_ARENA_BANK_SPAN - 1) / DDR2_ARENA_BANK_SPAN)
+#define DDR2_ARENA_BANK_USE_NUM     (DDR2_ARENA_PER_BANK(DDR2_ARENA_FRAME_NUM)*DDR2_ARENA_FRAME_LINE_NUM + \
+                                     DDR2_ARENA_PER_BANK(DDR2_ARENA_PLANE_NUM)*DDR2_ARENA_PLANE_LINE_NUM + \
+                                     DDR2_ARENA_PER_BANK(DDR2_ARENA_RING_NUM)*DDR2_ARENA_RING_LINE_NUM)
+
+#if DDR2_ARENA_BASE >= DDR2_ARENA_ADDR_SPACE
+#error "ddr2_arena: the base is past the 23-bit line address space"
+#endif
+#if (DDR2_ARENA_BASE & (DDR2_ARENA_BANK_LINE_NUM - 1)) + DDR2_ARENA_BANK_USE_NUM > DDR2_ARENA_BANK_LINE_NUM
+#error "ddr2_arena: the pools do not fit in a bank"
+#endif
+#if DDR2_ARENA_RING_LINE_NUM > DDR2_ARENA_PLANE_LINE_NUM
+#error "ddr2_arena: a ring block must not be larger than a plane block"
+#endif
+
+// pool; smallest block first;
+#define DDR2_ARENA_POOL_RING        0
+#define DDR2_ARENA_POOL_PLANE       1
+#define DDR2_ARENA_POOL_FRAME       2
+#define DDR2_ARENA_POOL_NUM         3
+#define DDR2_ARENA_POOL_NONE        0xFF    // the region is not allocated;
+
+// pixel format;
+#define DDR2_ARENA_FMT_RAW          0       // bytes; the width is in bytes;
+#define DDR2_ARENA_FMT_Y8           1       // 8-bit luma or state; one byte per pixel;
+#define DDR2_ARENA_FMT_RGB565       2       // two bytes per pixel;
+
+/*-------------------
+* Handle;
+-------------------*/
+typedef struct{
+    uint32_t addr;          // first line;
+    uint32_t line_num;      // lines of the block; at least stride x height;
+    uint16_t width;         // pixels per row;
+    uint16_t height;        // rows;
+    uint16_t stride;        // lines from the start of a row to the next;
+    uint8_t format;         // DDR2_ARENA_FMT_*;
+    uint8_t pool;           // DDR2_ARENA_POOL_*; set by the arena;
+    uint16_t block;         // block index in the arena; set by the arena;
+}ddr2_region_t;
+
+class ddr2_arena{
+    public:
+        ddr2_arena(uint32_t base_line);
+        ~ddr2_arena();
+
+        /* retval: 0 if OK; -1 if out of range or no block fits (region not allocated); */
+        int alloc(ddr2_region_t *region, uint16_t width, uint16_t height, int format);
+
+        /* contiguous lines; a FMT_RAW region one line wide; */
+        int alloc_lines(ddr2_region_t *region, uint32_t nlines);
+
+        /* as alloc(); in a bank none of the other regions is in;
+        other: allocated regions (e.g. the planes streamed along with it); other_num may be 0;
+        retval: 0 if OK; -1 if no free block fits in such a bank;
+        */
+        int alloc_apart(ddr2_region_t *region, uint16_t width, uint16_t height, int format,
+                        const ddr2_region_t *other, int other_num);
+
+        /* retval: 0 if OK; -1 if the region is not allocated from this arena; */
+        int release(ddr2_region_t *region);
+
+        /* observation */
+        uint32_t get_base(void);
+        uint32_t get_free_num(int pool);
+        uint32_t get_block_line_num(int pool);
+
+        /* addressing */
+        static uint32_t row_addr(const ddr2_region_t *region, uint32_t row);
+        static uint32_t get_row_byte(uint16_t width, int format);
+        static uint32_t get_bank(uint32_t addr);        // DDR2 bank of a line;
+        static uint32_t get_dram_row(uint32_t addr);    // DDR2 row of a line in its bank;
+
+    private:
+        uint32_t base;
+
+        // banks the blocks are dealt over from bank_first;
+        uint32_t bank_first;
+        uint32_t bank_span;
+
+        // pool; offset of the first block in every bank; blocks back to back from there;
+        uint32_t pool_base[DDR2_ARENA_POOL_NUM];
+        uint32_t pool_line_num[DDR2_ARENA_POOL_NUM];    // per block;
+        uint16_t pool_first[DDR2_ARENA_POOL_NUM];       // first block index;
+        uint16_t pool_block_num[DDR2_ARENA_POOL_NUM];
+        uint16_t pool_free_num[DDR2_ARENA_POOL_NUM];
+
+        // per pool, a stack of free blocks from free_block[pool_first];
+        uint16_t free_block[DDR2_ARENA_BLOCK_NUM];
+        uint8_t block_used[DDR2_ARENA_BLOCK_NUM];
+
+        uint32_t block_addr(int pool, uint16_t block);
+        int take(ddr2_region_t *region, uint16_t width, uint16_t height, int format,
+                    const ddr2_region_t *other, int other_num);
+};
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_DDR2_ARENA_H
@@ -0,0 +1,350 @@
+#include "mmio_trace.h"
+#include "string.h"
+
+/*-------------------
+* Record utility;
+-------------------*/
+void mmio_trace_init_header(mmio_trace_header_t *header, uint64_t slot_mask){
+    /*
+    @brief  : header of a new trace;
+    @param  :
+        header      : (output);
+        slot_mask   : slots recorded; see MMIO_TRACE_MASK_ALL;
+    @retval : none
+    @note   : record_cnt and drop_cnt are left zero for the producer to fill in;
+    */
+    memset(header, 0, sizeof(mmio_trace_header_t));
+    header->magic = MMIO_TRACE_MAGIC;
+    header->version = MMIO_TRACE_VERSION;
+    header->record_size = sizeof(mmio_trace_record_t);
+    header->clk_freq_mhz = SYS_CLK_FREQ_MHZ;
+    header->slot_mask_lo = (uint32_t)slot_mask;
+    header->slot_mask_hi = (uint32_t)(slot_mask >> 32);
+}
+
+int mmio_trace_check_header(const mmio_trace_header_t *header){
+    /*
+    @brief  : is this a trace this code can read?
+    @param  : header
+    @retval : 0 if so; -1 otherwise;
+    */
+    if(header->magic != MMIO_TRACE_MAGIC){
+        return -1;
+    }
+    if((header->version != MMIO_TRACE_VERSION) || (header->record_size != sizeof(mmio_trace_record_t))){
+        return -1;
+    }
+    return 0;
+}
+
+uint64_t mmio_trace_get_slot_mask(const mmio_trace_header_t *header){
+    return ((uint64_t)header->slot_mask_hi << 32) | header->slot_mask_lo;
+}
+
+int mmio_trace_make_record(mmio_trace_record_t *record, uint64_t time, uint32_t base_addr, uint32_t offset, int is_write, uint32_t value){
+    /*
+    @brief  : record of one register access;
+    @param  :
+        record      : (output);
+        time        : issue time in system clock cycles;
+        base_addr   : base address as given to REG_READ()/REG_WRITE();
+        offset      : offset as given to REG_READ()/REG_WRITE();
+        is_write    : 1 for write; 0 for read;
+        value       : read data or write data;
+    @retval : 1 if the address is in the user space; 0 otherwise (record not usable);
+    @note   : the address is decoded as mmio_ctrl.sv and video_ctrl.sv do;
+    */
+    uint32_t byte_addr = base_addr + REG_WORD_BYTE*offset;
+    uint32_t word_addr = byte_addr >> 2;
+
+    // bridge_en compares the 8 MSB only;
+    if((byte_addr & 0xFF000000) != (BUS_MICROBLAZE_IO_BASE_ADDR_G & 0xFF000000)){
+        return 0;
+    }
+
+    time &= MMIO_TRACE_TIME_MASK;
+    record->time_lo = (uint32_t)time;
+    record->time_hi = (uint16_t)(time >> 32);
+    record->repeat = 0;
+    record->value = value;
+    record->offset = (uint8_t)(word_addr & (TOTAL_VIDEO_REG_NUM - 1));
+    record->flag = is_write ? MMIO_TRACE_FLAG_WRITE : 0;
+    record->reserved = 0;
+    if(byte_addr & USER_VIDEO_BYTE_SELECT_BIT){
+        record->flag |= MMIO_TRACE_FLAG_VIDEO;
+        record->slot = (uint8_t)((word_addr >> REG_ADDR_SIZE_G) & (VIDEO_CORE_TOTAL_G - 1));
+    }else{
+        record->slot = (uint8_t)((word_addr >> REG_ADDR_SIZE_G) & (MIMO_CORE_TOTAL_G - 1));
+    }
+    return 1;
+}
+
+uint64_t mmio_trace_get_time(const mmio_trace_record_t *record){
+    return ((uint64_t)record->time_hi << 32) | record->time_lo;
+}
+
+uint64_t mmio_trace_get_slot_bit(const mmio_trace_record_t *record){
+    if(record->flag & MMIO_TRACE_FLAG_VIDEO){
+        return MMIO_TRACE_VIDEO_SLOT(record->slot);
+    }
+    return MMIO_TRACE_MMIO_SLOT(record->slot);
+}
+
+uint32_t mmio_trace_get_base_addr(const mmio_trace_record_t *record){
+    if(record->flag & MMIO_TRACE_FLAG_VIDEO){
+        return GET_VIDEO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, record->slot);
+    }
+    return GET_MMIO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, record->slot);
+}
+
+int mmio_trace_fold(mmio_trace_record_t *prev, const mmio_trace_record_t *record){
+    /*
+    @brief  : fold a repeated read into the record before it;
+    @param  :
+        prev    : the last record of the trace;
+        record  : the new record;
+    @retval : 1 if folded; 0 otherwise;
+    @note   : only reads with the same register and the same value fold;
+                a write in between, or a change of value, breaks the run;
+    */
+    if((prev->flag & MMIO_TRACE_FLAG_WRITE) || (record->flag & MMIO_TRACE_FLAG_WRITE)){
+        return 0;
+    }
+    if((prev->flag != record->flag) || (prev->slot != record->slot) || (prev->offset != record->offset)){
+        return 0;
+    }
+    if((prev->value != record->value) || (prev->repeat == MMIO_TRACE_REPEAT_MAX)){
+        return 0;
+    }
+    prev->repeat++;
+    return 1;
+}
+
+/*-------------------
+* Board recorder;
+-------------------*/
+#if defined(_MMIO_TRACE) && !defined(_HOST_MODEL)
+
+#include "core_uart.h"
+#include "video_core_mig_interface.h"
+
+// from user_util.cpp;
+extern core_uart sys_uart;
+
+// direct register access; not traced;
+#define TRACE_RAW_READ(base_addr, offset) (*(volatile uint32_t *)((base_addr) + REG_WORD_BYTE*(offset)))
+#define TRACE_RAW_WRITE(base_addr, offset, wr_data) (*(volatile uint32_t *)((base_addr) + REG_WORD_BYTE*(offset)) = (wr_data))
+
+static mmio_trace_record_t trace_buffer[MMIO_TRACE_BUFFER_SIZE];
+static uint32_t trace_cnt = 0;
+static uint32_t trace_drop_cnt = 0;
+static uint64_t trace_mask = 0;
+static uint64_t trace_access_cnt = 0;
+static int trace_on = 0;
+
+// ddr2 sink;
+static video_core_mig_interface *trace_mig = NULL;
+static uint32_t trace_ddr2_start = 0;
+static uint32_t trace_ddr2_range = 0;
+static uint32_t trace_ddr2_cnt = 0;
+
+static uint64_t trace_read_time(void){
+    /*
+    @brief  : system timer counter;
+    @param  : none
+    @retval : counter value;
+    @note   : the upper word is read again in case the lower word wrapped in between;
+    */
+    uint32_t timer_addr = GET_MMIO_CORE_ADDR(BUS_MICROBLAZE_IO_BASE_ADDR_G, S0_SYS_TIMER);
+    uint32_t hi;
+    uint32_t lo;
+
+    do{
+        hi = TRACE_RAW_READ(timer_addr, S0_SYS_TIMER_REG_CNTHIGH_OFFSET);
+        lo = TRACE_RAW_READ(timer_addr, S0_SYS_TIMER_REG_CNTLOW_OFFSET);
+    }while(hi != TRACE_RAW_READ(timer_addr, S0_SYS_TIMER_REG_CNTHIGH_OFFSET));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static void trace_append(uint64_t time, uint32_t base_addr, uint32_t offset, int is_write, uint32_t value){
+    mmio_trace_record_t record;
+
+    if(!mmio_trace_make_record(&record, time, base_addr, offset, is_write, value)){
+        return;
+    }
+    if(!(mmio_trace_get_slot_bit(&record) & trace_mask)){
+        return;
+    }
+    if(trace_cnt && mmio_trace_fold(&trace_buffer[trace_cnt - 1], &record)){
+        return;
+    }
+    if(trace_cnt == MMIO_TRACE_BUFFER_SIZE){
+        trace_drop_cnt++;
+        return;
+    }
+    trace_buffer[trace_cnt++] = record;
+}
+
+uint32_t mmio_trace_read(uint32_t base_addr, uint32_t offset){
+    /*
+    @brief  : REG_READ() with _MMIO_TRACE;
+    @param  : base_addr, offset as given to REG_READ();
+    @retval : read data;
+    */
+    uint64_t time;
+    uint32_t rd_data;
+
+    trace_access_cnt++;
+    if(!trace_on){
+        return TRACE_RAW_READ(base_addr, offset);
+    }
+    time = trace_read_time();
+    rd_data = TRACE_RAW_READ(base_addr, offset);
+    trace_append(time, base_addr, offset, 0, rd_data);
+    return rd_data;
+}
+
+void mmio_trace_write(uint32_t base_addr, uint32_t offset, uint32_t wr_data){
+    /*
+    @brief  : REG_WRITE() with _MMIO_TRACE;
+    @param  : base_addr, offset, wr_data as given to REG_WRITE();
+    @retval : none
+    */
+    uint64_t time;
+
+    trace_access_cnt++;
+    if(!trace_on){
+        TRACE_RAW_WRITE(base_addr, offset, wr_data);
+        return;
+    }
+    time = trace_read_time();
+    TRACE_RAW_WRITE(base_addr, offset, wr_data);
+    trace_append(time, base_addr, offset, 1, wr_data);
+}
+
+void mmio_trace_begin(uint64_t slot_mask){
+    /*
+    @brief  : start recording into an empty buffer;
+    @param  : slot_mask - slots to record; see MMIO_TRACE_MASK_ALL;
+    @retval : none
+    */
+    trace_cnt = 0;
+    trace_drop_cnt = 0;
+    trace_mask = slot_mask;
+    trace_on = 1;
+}
+
+void mmio_trace_end(void){
+    trace_on = 0;
+}
+
+uint32_t mmio_trace_get_record_cnt(void){
+    return trace_cnt;
+}
+
+uint32_t mmio_trace_get_drop_cnt(void){
+    return trace_drop_cnt;
+}
+
+uint64_t mmio_trace_get_access_cnt(void){
+    return trace_access_cnt;
+}
+
+static void trace_send(const void *data, uint32_t size){
+    const uint8_t *byte = (const uint8_t *)data;
+    for(uint32_t i = 0; i < size; i++){
+        sys_uart.print(byte[i]);
+    }
+}
+
+void mmio_trace_flush_uart(void){
+    /*
+    @brief  : send the header and the buffer over the debug uart;
+    @param  : none
+    @retval : none
+    @note   :
+        1. the byte stream is a trace file as it is;
+        2. the recorder is paused meanwhile;
+    */
+    mmio_trace_header_t header;
+    int was_on = trace_on;
+
+    trace_on = 0;
+    mmio_trace_init_header(&header, trace_mask);
+    header.record_cnt = trace_cnt;
+    header.drop_cnt = trace_drop_cnt;
+    trace_send(&header, sizeof(header));
+    trace_send(trace_buffer, trace_cnt*sizeof(mmio_trace_record_t));
+    trace_cnt = 0;
+    trace_on = was_on;
+}
+
+void mmio_trace_set_ddr2(video_core_mig_interface *mig, uint32_t start_addr, uint32_t range_addr){
+    /*
+    @brief  : set up the ddr2 sink;
+    @param  :
+        mig         : the mig interface; the cpu must own the MIG at the time of a flush;
+        start_addr  : first DDR2 line of the trace;
+        range_addr  : number of DDR2 lines for the trace;
+    @retval : none
+    */
+    trace_mig = mig;
+    trace_ddr2_start = start_addr;
+    trace_ddr2_range = range_addr;
+    trace_ddr2_cnt = 0;
+}
+
+int mmio_trace_flush_ddr2(void){
+    /*
+    @brief  : append the buffer to the DDR2; one record per line;
+    @param  : none
+    @retval : 0 if OK; -1 if the sink is not set up or the range is full;
+    @note   : the buffer is emptied in either case;
+    */
+    uint32_t line[4];
+    int was_on = trace_on;
+    int status = 0;
+
+    trace_on = 0;
+    for(uint32_t i = 0; i < trace_cnt; i++){
+        if((trace_mig == NULL) || (trace_ddr2_cnt == trace_ddr2_range)){
+            trace_drop_cnt += trace_cnt - i;
+            status = -1;
+            break;
+        }
+        memcpy(line, &trace_buffer[i], sizeof(line));
+        trace_mig->write_ddr2(trace_ddr2_start + trace_ddr2_cnt, line[0], line[1], line[2], line[3]);
+        trace_ddr2_cnt++;
+    }
+    trace_cnt = 0;
+    trace_on = was_on;
+    return status;
+}
+
+void mmio_trace_dump_ddr2_uart(void){
+    /*
+    @brief  : send the trace held in the DDR2 over the debug uart;
+    @param  : none
+    @retval : none
+    @note   : the cpu must own the MIG;
+    */
+    mmio_trace_header_t header;
+    uint32_t line[4];
+    int was_on = trace_on;
+
+    if(trace_mig == NULL){
+        return;
+    }
+    trace_on = 0;
+    mmio_trace_init_header(&header, trace_mask);
+    header.record_cnt = trace_ddr2_cnt;
+    header.drop_cnt = trace_drop_cnt;
+    trace_send(&header, sizeof(header));
+    for(uint32_t i = 0; i < trace_ddr2_cnt; i++){
+        trace_mig->read_ddr2(trace_ddr2_start + i, line);
+        trace_send(line, sizeof(line));
+    }
+    trace_on = was_on;
+}
+
+#endif
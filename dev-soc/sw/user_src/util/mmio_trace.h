@@ -0,0 +1,150 @@
+#ifndef _MMIO_TRACE_H
+#define _MMIO_TRACE_H
+
+/* ---------------------------------------------
+Purpose: binary trace of the register accesses;
+1. one fixed size record per REG_READ()/REG_WRITE():
+    issue time, system (mmio/video), core slot, register offset,
+    direction and the value read or written;
+2. a record is 16 bytes, i.e. exactly one DDR2 line (128-bit);
+3. a trace file is mmio_trace_header_t followed by the records
+    back to back (little endian, as the MicroBlaze);
+    a trace can be mapped into memory and indexed as is;
+4. a spin-poll is folded: identical consecutive reads
+    (same register, same value) are one record with a repeat count;
+5. producers:
+    (a) board: build with _MMIO_TRACE; REG_READ()/REG_WRITE()
+        are routed to the recorder below; the records are kept in
+        a buffer and flushed, at a point of your choice,
+        to the debug uart or to the DDR2;
+    (b) host: see ../host_model/host_trace.h;
+
+usage (board):
+    mmio_trace_begin(MMIO_TRACE_MASK_ALL & ~MMIO_TRACE_MMIO_SLOT(S0_SYS_TIMER));
+    ... code under test ...
+    mmio_trace_end();
+    mmio_trace_flush_uart();    // capture the uart into a file as it is;
+
+@note:
+1. the recorder time-stamps with the system timer (S0_SYS_TIMER),
+    read directly so that it is not traced itself;
+2. the flush drives the uart/mig drivers; the recorder is paused
+    meanwhile, hence the flush is not in the trace;
+3. do not flush to the uart with _DEBUG printing in between;
+    the capture would have the text mixed into the records;
+---------------------------------------------*/
+
+#include "inttypes.h"
+#include "io_map.h"
+#include "io_reg_util.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+/*-------------------
+* Constants;
+-------------------*/
+#define MMIO_TRACE_MAGIC            0x4352544D  // "MTRC";
+#define MMIO_TRACE_VERSION          1
+#define MMIO_TRACE_TIME_MASK        0xFFFFFFFFFFFFULL   // 48-bit time; 32 days at 100MHz;
+#define MMIO_TRACE_REPEAT_MAX       0xFFFF
+
+// record flag;
+#define MMIO_TRACE_FLAG_WRITE       0x01    // LOW for read;
+#define MMIO_TRACE_FLAG_VIDEO       0x02    // LOW for the mmio system;
+
+/* slot mask; which cores are recorded;
+bit 0 to 31 for the mmio cores; bit 32 to 47 for the video cores;
+*/
+#define MMIO_TRACE_MASK_ALL         0xFFFFFFFFFFFFULL
+#define MMIO_TRACE_MMIO_SLOT(X)     (1ULL << (X))
+#define MMIO_TRACE_VIDEO_SLOT(X)    (1ULL << (MIMO_CORE_TOTAL_G + (X)))
+
+// board recorder buffer; in records;
+#ifndef MMIO_TRACE_BUFFER_SIZE
+#define MMIO_TRACE_BUFFER_SIZE      256
+#endif
+
+/*-------------------
+* Format;
+-------------------*/
+// file header; 32 bytes;
+typedef struct{
+    uint32_t magic;         // MMIO_TRACE_MAGIC;
+    uint16_t version;       // MMIO_TRACE_VERSION;
+    uint16_t record_size;   // sizeof(mmio_trace_record_t);
+    uint32_t clk_freq_mhz;  // unit of the time stamp;
+    uint32_t record_cnt;    // 0: not known at the time of writing; see the file size;
+    uint32_t slot_mask_lo;  // slots recorded; see MMIO_TRACE_MASK_ALL;
+    uint32_t slot_mask_hi;
+    uint32_t drop_cnt;      // records lost to a full buffer;
+    uint32_t reserved;
+} mmio_trace_header_t;
+
+// one register access; 16 bytes;
+typedef struct{
+    uint32_t time_lo;       // issue time in system clock cycles; bit [31:0];
+    uint16_t time_hi;       // bit [47:32];
+    uint16_t repeat;        // number of identical reads folded after this one;
+    uint32_t value;         // read data or write data;
+    uint8_t slot;           // core slot within the system;
+    uint8_t offset;         // register offset;
+    uint8_t flag;           // MMIO_TRACE_FLAG_*;
+    uint8_t reserved;
+} mmio_trace_record_t;
+
+/*-------------------
+* Record utility; common for the board and the host;
+-------------------*/
+void mmio_trace_init_header(mmio_trace_header_t *header, uint64_t slot_mask);
+int mmio_trace_check_header(const mmio_trace_header_t *header);   // 0 if usable;
+uint64_t mmio_trace_get_slot_mask(const mmio_trace_header_t *header);
+
+/* address decoding of REG_READ()/REG_WRITE(); as mmio_ctrl.sv and video_ctrl.sv;
+retval 0 if the address is outside the user space; 1 otherwise;
+*/
+int mmio_trace_make_record(mmio_trace_record_t *record, uint64_t time, uint32_t base_addr, uint32_t offset, int is_write, uint32_t value);
+uint64_t mmio_trace_get_time(const mmio_trace_record_t *record);
+uint64_t mmio_trace_get_slot_bit(const mmio_trace_record_t *record);  // for the slot mask;
+uint32_t mmio_trace_get_base_addr(const mmio_trace_record_t *record); // to issue the record again;
+
+/* fold a read into the previous record if it repeats it;
+retval 1 if folded; 0 otherwise (the record is to be appended);
+*/
+int mmio_trace_fold(mmio_trace_record_t *prev, const mmio_trace_record_t *record);
+
+/*-------------------
+* Board recorder; _MMIO_TRACE;
+-------------------*/
+#if defined(_MMIO_TRACE) && !defined(_HOST_MODEL)
+
+// forward declaration;
+class video_core_mig_interface;
+
+void mmio_trace_begin(uint64_t slot_mask);
+void mmio_trace_end(void);
+uint32_t mmio_trace_get_record_cnt(void);   // in the buffer;
+uint32_t mmio_trace_get_drop_cnt(void);
+uint64_t mmio_trace_get_access_cnt(void);   // every REG_READ()/REG_WRITE(), recording or not;
+
+/* flush the buffer;
+1. uart: header + buffer; a raw byte stream;
+2. ddr2: one record per DDR2 line, appended at the ddr2 write pointer;
+    the cpu must own the MIG;
+the buffer is empty afterwards;
+*/
+void mmio_trace_flush_uart(void);
+void mmio_trace_set_ddr2(video_core_mig_interface *mig, uint32_t start_addr, uint32_t range_addr);
+int mmio_trace_flush_ddr2(void);            // 0: OK; -1: the DDR2 range is full (the buffer is dropped);
+void mmio_trace_dump_ddr2_uart(void);       // header + every record flushed to the DDR2 so far;
+
+#endif
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_MMIO_TRACE_H
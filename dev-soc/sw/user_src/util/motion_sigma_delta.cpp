@@ -0,0 +1,171 @@
+#include "motion_sigma_delta.h"
+#include "string.h"
+
+/*-------------------
+* SWAR; lanes of a 64-bit word;
+-------------------*/
+#define SD_L8       0x0101010101010101ULL   // bit 0 of every byte;
+#define SD_H8       0x8080808080808080ULL   // bit 7 of every byte;
+#define SD_LO16     0x00FF00FF00FF00FFULL   // low byte of every 16-bit lane;
+#define SD_H16      0x8000800080008000ULL   // bit 15 of every 16-bit lane;
+
+// bit 7 of a byte to the whole byte;
+#define SD_MASK(msb)    (((msb) >> 7)*0xFF)
+
+static inline uint64_t sd_lt(uint64_t a, uint64_t b, uint64_t h){
+   // per lane, unsigned a < b; the top bit of a lane set if so;
+   // d: a - b of the bits below the top; no borrow across the lanes;
+   uint64_t d = (a | h) - (b & ~h);
+
+   return ((~a & b) | (~(a ^ b) & ~d)) & h;
+}
+
+static inline uint64_t sd_zero(uint64_t x){
+   // per byte, x == 0; bit 7 set if so; exact (no false hit next to a zero byte);
+   return ~(((x & ~SD_H8) + ~SD_H8) | x) & SD_H8;
+}
+
+void motion_sd_init(const uint8_t *frame, uint8_t *mean, uint8_t *var, uint32_t npix){
+    /*
+    @brief  : to start the model on the first frame;
+    @param  :
+        frame   : I_0; npix bytes;
+        mean    : M_0 = I_0;
+        var     : V_0 = MOTION_SD_VAR_INIT;
+        npix    : pixels;
+    @retval : none
+    */
+   memcpy(mean, frame, npix);
+   memset(var, MOTION_SD_VAR_INIT, npix);
+}
+
+int motion_sd_step_ref(const uint8_t *frame, uint8_t *mean, uint8_t *var, uint8_t *detect, uint32_t npix, uint32_t amp){
+    /*
+    @brief  : one frame; one pixel at a time; the reference;
+    @param  :
+        frame   : I_t;
+        mean    : M_{t-1} in; M_t out;
+        var     : V_{t-1} in; V_t out;
+        detect  : D_t; MOTION_SD_DETECT_ON or MOTION_SD_DETECT_OFF;
+        npix    : pixels;
+        amp     : N; 1 to MOTION_SD_AMP_MAX;
+    @retval : 0 if OK; -1 if amp is out of range;
+    @note   : PE1 to PE4 of the README in that order; see motion_sigma_delta.h;
+    */
+   uint32_t m;
+   uint32_t v;
+   uint32_t delta;
+
+   if(amp == 0 || amp > MOTION_SD_AMP_MAX){
+      return -1;
+   }
+   for(uint32_t i = 0; i < npix; i++){
+      m = mean[i];
+      v = var[i];
+
+      // PE1; M >= I with M = 0 only if I = 0;
+      if(m < frame[i]){
+         m++;
+      }
+      else if(m > 0){
+         m--;
+      }
+
+      // PE2;
+      delta = (m < frame[i]) ? frame[i] - m : m - frame[i];
+
+      // PE3; V < N x D with V = 255 only if N x D > 255;
+      if(delta != 0){
+         if(v < amp*delta){
+            if(v < 0xFF){
+               v++;
+            }
+         }
+         else{
+            v--;
+         }
+      }
+
+      // PE4;
+      mean[i] = (uint8_t)m;
+      var[i] = (uint8_t)v;
+      detect[i] = (delta < v) ? MOTION_SD_DETECT_ON : MOTION_SD_DETECT_OFF;
+   }
+   return 0;
+}
+
+uint64_t motion_sd_word(uint64_t frame, uint64_t *mean, uint64_t *var, uint32_t amp){
+    /*
+    @brief  : PE1 to PE4 on 8 pixels at once;
+    @param  :
+        frame   : I_t; pixel k in bit[8k+7:8k];
+        mean    : M_{t-1} in; M_t out;
+        var     : V_{t-1} in; V_t out;
+        amp     : N; 1 to MOTION_SD_AMP_MAX; not checked;
+    @retval : D_t; 0xFF or 0x00 per byte;
+    @note   : a byte is only stepped by one where it cannot wrap;
+                the adds and subtracts of the word then stay within the bytes;
+    @note   : N x D in 16-bit lanes (at most 255 x 255); the even bytes, then the odd;
+    */
+   uint64_t m = *mean;
+   uint64_t v = *var;
+   uint64_t up;
+   uint64_t down;
+   uint64_t delta;
+   uint64_t nz;
+   uint64_t lt_even;
+   uint64_t lt_odd;
+
+   // PE1; not down where M = 0;
+   up = SD_MASK(sd_lt(m, frame, SD_H8));
+   down = ~up & ~SD_MASK(sd_zero(m));
+   m = (m + (up & SD_L8)) - (down & SD_L8);
+
+   // PE2; larger minus smaller per byte;
+   up = SD_MASK(sd_lt(m, frame, SD_H8));
+   delta = ((frame & up) | (m & ~up)) - ((m & up) | (frame & ~up));
+
+   // PE3; not up where V = 255;
+   lt_even = sd_lt(v & SD_LO16, (delta & SD_LO16)*amp, SD_H16) >> 15;
+   lt_odd = sd_lt((v >> 8) & SD_LO16, ((delta >> 8) & SD_LO16)*amp, SD_H16) >> 15;
+   up = (lt_even | (lt_odd << 8))*0xFF;
+   nz = ~SD_MASK(sd_zero(delta));
+   down = ~up & nz;
+   up &= nz & ~SD_MASK(sd_zero(~v));
+   v = (v + (up & SD_L8)) - (down & SD_L8);
+
+   *mean = m;
+   *var = v;
+
+   // PE4;
+   return SD_MASK(sd_lt(delta, v, SD_H8));
+}
+
+int motion_sd_step(const uint8_t *frame, uint8_t *mean, uint8_t *var, uint8_t *detect, uint32_t npix, uint32_t amp){
+    /*
+    @brief  : one frame; 8 pixels per 64-bit word;
+    @param  : as motion_sd_step_ref();
+    @retval : 0 if OK; -1 if amp is out of range;
+    @note   : the words are copied in and out (any alignment; no aliasing);
+    @note   : the npix % 8 pixels at the end by the reference;
+    */
+   uint64_t f;
+   uint64_t m;
+   uint64_t v;
+   uint64_t d;
+   uint32_t i;
+
+   if(amp == 0 || amp > MOTION_SD_AMP_MAX){
+      return -1;
+   }
+   for(i = 0; i + 8 <= npix; i += 8){
+      memcpy(&f, &frame[i], 8);
+      memcpy(&m, &mean[i], 8);
+      memcpy(&v, &var[i], 8);
+      d = motion_sd_word(f, &m, &v, amp);
+      memcpy(&mean[i], &m, 8);
+      memcpy(&var[i], &v, 8);
+      memcpy(&detect[i], &d, 8);
+   }
+   return motion_sd_step_ref(&frame[i], &mean[i], &var[i], &detect[i], npix - i, amp);
+}
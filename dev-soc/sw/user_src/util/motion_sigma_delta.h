@@ -0,0 +1,75 @@
+#ifndef _MOTION_SIGMA_DELTA_H
+#define _MOTION_SIGMA_DELTA_H
+
+/* ---------------------------------------------
+Purpose: golden model of the Σ-Δ motion detector; bit-exact;
+1. the algorithm is the one of the README (Motion Detection Overview);
+    per pixel x and frame t; every term is 8-bit unsigned:
+    (a) PE1 mean     : M < I  => M + 1;  M >= I => M - 1;
+    (b) PE2 delta    : D = |M - I| with the new M;
+    (c) PE3 variance : only if D != 0;  V < N x D => V + 1;  V >= N x D => V - 1;
+                       N x D is taken at full width (not 8-bit);
+    (d) PE4 detect   : D < V (the new V) => 0xFF; D >= V => 0x00;
+2. the two ends of the 8-bit range; the rule would leave [0, 255] in two cases only:
+    (a) M = 0 and I = 0 : M >= I; M stays 0 (no wrap to 255);
+    (b) V = 255 and N x D > 255 : V stays 255 (no wrap to 0);
+    every other case is within the range by the compare itself;
+    the core must saturate the same way;
+3. two kernels with the same outcome:
+    (a) motion_sd_step_ref() : one pixel at a time; the reference;
+    (b) motion_sd_step()     : SWAR; 8 pixels per 64-bit word; plain integer ops,
+                               no SIMD and no branch per pixel;
+                               the pixels past the last full word by the reference;
+    motion_sd_word() is the SWAR kernel on one word; pixel k in bit[8k+7:8k],
+    as the bytes of a DDR2 line (see video_core_mig_interface::read_ddr2());
+4. usage: the reference to check the core against; the software path
+    while the core is busy or not built;
+
+usage:
+    motion_sd_init(frame, mean, var, npix);                 // first frame;
+    motion_sd_step(frame, mean, var, detect, npix, amp);    // every frame after;
+
+@note:
+1. the planes are arrays of npix bytes; any alignment;
+    mean and var are updated in place; detect is written;
+2. the amplification N is 1 to MOTION_SD_AMP_MAX (an 8-bit field);
+---------------------------------------------*/
+
+#include "inttypes.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+/*-------------------
+* Constants;
+-------------------*/
+#define MOTION_SD_AMP_MAX       255         // N; 8-bit;
+#define MOTION_SD_DETECT_ON     0xFF        // D_t(x) true;
+#define MOTION_SD_DETECT_OFF    0x00
+
+// V_0(x); the mean starts at the first frame;
+#ifndef MOTION_SD_VAR_INIT
+#define MOTION_SD_VAR_INIT      0
+#endif
+
+/*-------------------
+* Kernels;
+-------------------*/
+/* first frame; mean = frame; var = MOTION_SD_VAR_INIT; */
+void motion_sd_init(const uint8_t *frame, uint8_t *mean, uint8_t *var, uint32_t npix);
+
+/* one frame; retval: 0 if OK; -1 if amp is out of range (nothing is written); */
+int motion_sd_step_ref(const uint8_t *frame, uint8_t *mean, uint8_t *var, uint8_t *detect, uint32_t npix, uint32_t amp);
+int motion_sd_step(const uint8_t *frame, uint8_t *mean, uint8_t *var, uint8_t *detect, uint32_t npix, uint32_t amp);
+
+/* 8 pixels; mean and var in place; retval: the detect word; amp is not checked; */
+uint64_t motion_sd_word(uint64_t frame, uint64_t *mean, uint64_t *var, uint32_t amp);
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+#endif //_MOTION_SIGMA_DELTA_H
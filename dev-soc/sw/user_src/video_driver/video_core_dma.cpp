@@ -0,0 +1,295 @@
+#include "video_core_dma.h"
+
+// from user_util.cpp; the wait budget;
+extern core_timer sys_timer;
+
+video_core_dma::video_core_dma(uint32_t core_base_addr){
+    /*
+    @brief  : constructor for this core: video_core_dma;
+    @param  : base address of the corresponding hw core;
+    @retval : none
+    @note   : nothing runs until a chain is loaded and started;
+    */
+   base_addr = core_base_addr;
+   wait_budget = DMA_WAIT_BUDGET_CYCLE;
+   REG_WRITE(base_addr, REG_CHAIN_OFFSET, 0);
+}
+
+// destructor; not used;
+video_core_dma::~video_core_dma(){};
+
+int video_core_dma::check_desc(const dma_desc_t *desc){
+    /*
+    @brief  : to check the fields of a descriptor against the register width;
+    @param  : descriptor;
+    @retval : 0 if OK; -1 otherwise;
+    */
+   if(desc->line_num == 0 || desc->line_num > LINE_NUM_MAX){
+      return -1;
+   }
+   if(desc->row_num == 0 || desc->row_num > ROW_NUM_MAX){
+      return -1;
+   }
+   if(desc->src_stride > STRIDE_MAX || desc->dst_stride > STRIDE_MAX){
+      return -1;
+   }
+   if(desc->src > ADDR_MASK || desc->dst > ADDR_MASK){
+      return -1;
+   }
+   if(desc->kind != KIND_DDR2_TO_DDR2 && desc->kind != KIND_DDR2_TO_LCD && desc->kind != KIND_DCMI_TO_DDR2){
+      return -1;
+   }
+   return 0;
+}
+
+int video_core_dma::set_desc(int index, const dma_desc_t *desc){
+    /*
+    @brief  : to write a descriptor into the table;
+    @param  :
+        index   : 0 to DESC_NUM - 1;
+        desc    : descriptor;
+    @retval : 0 if OK; -1 if the index or a field is out of range;
+    @note   : the table must not be written while busy;
+    @note   : the hw moves the select to the next descriptor on the stride register;
+    */
+   if(index < 0 || index >= DESC_NUM || check_desc(desc) != 0){
+      return -1;
+   }
+   REG_WRITE(base_addr, REG_DESC_SEL_OFFSET, index);
+   REG_WRITE(base_addr, REG_DESC_SRC_OFFSET, desc->src);
+   REG_WRITE(base_addr, REG_DESC_DST_OFFSET, desc->dst);
+   REG_WRITE(base_addr, REG_DESC_LEN_OFFSET,
+               (desc->line_num << BIT_POS_LEN_LINE) | (desc->row_num << BIT_POS_LEN_ROW) | ((uint32_t)desc->kind << BIT_POS_LEN_KIND));
+   REG_WRITE(base_addr, REG_DESC_STRIDE_OFFSET,
+               (desc->src_stride << BIT_POS_STRIDE_SRC) | (desc->dst_stride << BIT_POS_STRIDE_DST));
+   return 0;
+}
+
+int video_core_dma::load_chain(const dma_desc_t *desc, int num){
+    /*
+    @brief  : to load a chain of descriptors from descriptor 0 onwards;
+    @param  :
+        desc    : array of descriptors in the order to run;
+        num     : 1 to DESC_NUM;
+    @retval : 0 if OK; -1 if nothing is loaded;
+    @note   : all descriptors are checked before any is written;
+    @note   : the select post-increments; one select write for the whole chain;
+    */
+   int i;
+
+   if(num < 1 || num > DESC_NUM){
+      return -1;
+   }
+   for(i = 0; i < num; i++){
+      if(check_desc(&desc[i]) != 0){
+         return -1;
+      }
+   }
+
+   REG_WRITE(base_addr, REG_DESC_SEL_OFFSET, 0);
+   for(i = 0; i < num; i++){
+      REG_WRITE(base_addr, REG_DESC_SRC_OFFSET, desc[i].src);
+      REG_WRITE(base_addr, REG_DESC_DST_OFFSET, desc[i].dst);
+      REG_WRITE(base_addr, REG_DESC_LEN_OFFSET,
+                  (desc[i].line_num << BIT_POS_LEN_LINE) | (desc[i].row_num << BIT_POS_LEN_ROW) | ((uint32_t)desc[i].kind << BIT_POS_LEN_KIND));
+      REG_WRITE(base_addr, REG_DESC_STRIDE_OFFSET,
+                  (desc[i].src_stride << BIT_POS_STRIDE_SRC) | (desc[i].dst_stride << BIT_POS_STRIDE_DST));
+   }
+   REG_WRITE(base_addr, REG_CHAIN_OFFSET, num);
+   return 0;
+}
+
+void video_core_dma::start(void){
+    /*
+    @brief  : to run the chain from descriptor 0;
+    @param  : none
+    @retval : none
+    @note   : one-shot; ignored by the hw while busy;
+    */
+   REG_WRITE(base_addr, REG_CTRL_OFFSET, BIT_MASK(BIT_POS_CTRL_START));
+}
+
+void video_core_dma::abort(void){
+    /*
+    @brief  : to stop the chain after the line in flight;
+    @param  : none
+    @retval : none
+    @note   : at once if it waits for the mig (nothing in flight), the lcd or the dcmi;
+                the line being collected or streamed is dropped;
+    @note   : wait_done() (or is_busy()) for it to take effect; is_aborted() after;
+    */
+   REG_WRITE(base_addr, REG_CTRL_OFFSET, BIT_MASK(BIT_POS_CTRL_ABORT));
+}
+
+uint32_t video_core_dma::get_status(void){
+   return (uint32_t)REG_READ(base_addr, REG_STATUS_OFFSET);
+}
+
+int video_core_dma::is_busy(void){
+   return (int)((get_status() >> BIT_POS_STATUS_BUSY) & 0x01);
+}
+
+int video_core_dma::is_error(void){
+   return (int)((get_status() >> BIT_POS_STATUS_ERROR) & 0x01);
+}
+
+int video_core_dma::is_aborted(void){
+   return (int)((get_status() >> BIT_POS_STATUS_ABORTED) & 0x01);
+}
+
+int video_core_dma::get_desc_index(void){
+   return (int)((get_status() >> BIT_POS_STATUS_DESC) & (DESC_NUM - 1));
+}
+
+uint32_t video_core_dma::get_done_cnt(void){
+   return (get_status() >> BIT_POS_STATUS_DONE_CNT) & 0xFF;
+}
+
+uint32_t video_core_dma::get_line_cnt(void){
+   return (get_status() >> BIT_POS_STATUS_LINE_CNT) & 0xFFFF;
+}
+
+int video_core_dma::wait_done(void){
+    /*
+    @brief  : to block until the chain stops;
+    @param  : none
+    @retval : DONE_OK if it ran to the end; DONE_ERROR if it stopped on an error;
+                DONE_ABORTED if it stopped on abort();
+                DONE_TIMEOUT if no line has moved for the budget (e.g. the resources
+                are not handed over); the chain is left running;
+    @note   : the budget restarts whenever the line count or the descriptor moves;
+                a long chain is not cut short while it makes progress;
+    @note   : the system timer is read every DMA_WAIT_TIMER_STRIDE status reads;
+    */
+   uint32_t status;
+   uint32_t progress;
+   uint32_t seen = 0;
+   uint32_t spin = 0;
+   uint64_t start = 0;
+   uint64_t now;
+
+   while(1){
+      status = get_status();
+      if(!((status >> BIT_POS_STATUS_BUSY) & 0x01)){
+         break;
+      }
+      if(wait_budget && (++spin % DMA_WAIT_TIMER_STRIDE) == 0){
+         // {lines moved, descriptors completed, descriptor being run};
+         progress = status & ~(BIT_MASK(BIT_POS_STATUS_DESC) - 1);
+         now = sys_timer.read_counter();
+         if(spin == DMA_WAIT_TIMER_STRIDE || progress != seen){
+            seen = progress;
+            start = now;
+         }
+         else if(now - start >= wait_budget){
+            return DONE_TIMEOUT;
+         }
+      }
+   }
+   if((status >> BIT_POS_STATUS_ERROR) & 0x01){
+      return DONE_ERROR;
+   }
+   return ((status >> BIT_POS_STATUS_ABORTED) & 0x01) ? DONE_ABORTED : DONE_OK;
+}
+
+void video_core_dma::set_wait_budget(uint32_t budget_cycle){
+    /*
+    @brief  : to set the budget of wait_done();
+    @param  : system clock cycles with no line moved; 0 waits forever (as before the budget);
+    @retval : none
+    @note   : DMA_WAIT_BUDGET_CYCLE by default;
+    */
+   wait_budget = budget_cycle;
+}
+
+uint32_t video_core_dma::get_wait_budget(void){
+   return wait_budget;
+}
+
+int video_core_dma::start_lines(int kind, uint32_t src, uint32_t dst, uint32_t nlines){
+    /*
+    @brief  : to load and start a run of consecutive lines;
+    @param  :
+        kind    : KIND_*;
+        src     : first source line; ignored for the DCMI;
+        dst     : first destination line; ignored for the LCD;
+        nlines  : number of lines; 1 to 2^23;
+    @retval : 0 if started; -1 if busy or out of range;
+    @note   : a run longer than a descriptor row is split into rows of
+                SPLIT_LINE_NUM lines plus one descriptor for the rest;
+    */
+   dma_desc_t desc[2];
+   int num = 0;
+   uint32_t row_num;
+   uint32_t rest;
+
+   if(nlines == 0 || nlines > ADDR_MASK + 1 || is_busy()){
+      return -1;
+   }
+
+   if(nlines <= LINE_NUM_MAX){
+      row_num = 0;
+      rest = nlines;
+   }
+   else{
+      row_num = nlines / SPLIT_LINE_NUM;
+      rest = nlines % SPLIT_LINE_NUM;
+   }
+
+   if(row_num){
+      desc[num].src = src;
+      desc[num].dst = dst;
+      desc[num].line_num = SPLIT_LINE_NUM;
+      desc[num].row_num = row_num;
+      desc[num].src_stride = (kind == KIND_DCMI_TO_DDR2) ? 0 : SPLIT_LINE_NUM;
+      desc[num].dst_stride = (kind == KIND_DDR2_TO_LCD) ? 0 : SPLIT_LINE_NUM;
+      desc[num].kind = kind;
+      num++;
+   }
+   if(rest){
+      desc[num].src = (kind == KIND_DCMI_TO_DDR2) ? src : ((src + row_num*SPLIT_LINE_NUM) & ADDR_MASK);
+      desc[num].dst = (kind == KIND_DDR2_TO_LCD) ? dst : ((dst + row_num*SPLIT_LINE_NUM) & ADDR_MASK);
+      desc[num].line_num = rest;
+      desc[num].row_num = 1;
+      desc[num].src_stride = 0;
+      desc[num].dst_stride = 0;
+      desc[num].kind = kind;
+      num++;
+   }
+
+   if(load_chain(desc, num) != 0){
+      return -1;
+   }
+   start();
+   return 0;
+}
+
+int video_core_dma::copy_ddr2(uint32_t src, uint32_t dst, uint32_t nlines){
+    /*
+    @brief  : to copy DDR2 lines; src to dst;
+    @param  : first source line; first destination line; number of lines;
+    @retval : 0 if started; -1 otherwise;
+    @note   : overlapping runs are only safe with dst below src;
+    */
+   return start_lines(KIND_DDR2_TO_DDR2, src, dst, nlines);
+}
+
+int video_core_dma::ddr2_to_lcd(uint32_t src, uint32_t nlines){
+    /*
+    @brief  : to stream DDR2 lines to the lcd; 16 bytes per line from bit[7:0] onwards;
+    @param  : first source line; number of lines;
+    @retval : 0 if started; -1 otherwise;
+    @note   : the lcd must be in the stream mode with the memory write command issued;
+    */
+   return start_lines(KIND_DDR2_TO_LCD, src, 0, nlines);
+}
+
+int video_core_dma::dcmi_to_ddr2(uint32_t dst, uint32_t nlines){
+    /*
+    @brief  : to capture the dcmi fifo into DDR2; 16 bytes per line;
+    @param  : first destination line; number of lines;
+    @retval : 0 if started; -1 otherwise;
+    @note   : the pixel converter sees nothing of the camera until it is done;
+    */
+   return start_lines(KIND_DCMI_TO_DDR2, 0, dst, nlines);
+}
@@ -0,0 +1,161 @@
+#ifndef _VIDEO_CORE_DMA_H
+#define _VIDEO_CORE_DMA_H
+
+/* ---------------------------------------------
+Purpose : SW drivers for HW module as follows
+Module  : core_video_dma.sv
+---------------------------------------------*/
+#include "io_map.h"
+#include "io_reg_util.h"
+#include "user_util.h"
+
+// c and cpp linkage;
+// reference: https://igl.ethz.ch/teaching/tau/resources/cprog.htm
+#ifdef __cpluscplus
+extern "C" {
+#endif
+
+// wait budget of wait_done(); system clock cycles with no line moved; 0 waits forever;
+// a dcmi descriptor waits for the camera frame; see video_core_dma::set_wait_budget();
+#ifndef DMA_WAIT_BUDGET_CYCLE
+#define DMA_WAIT_BUDGET_CYCLE   (SYS_CLK_FREQ_HZ/5)     // 200ms;
+#endif
+
+// status reads between two looks at the system timer in wait_done();
+#ifndef DMA_WAIT_TIMER_STRIDE
+#define DMA_WAIT_TIMER_STRIDE   16
+#endif
+
+/**************************************************************
+* V6_DMA
+-----------------------
+see io_map.h for the register map;
+
+Purpose:
+1. to move DDR2 lines (128-bit) without the cpu;
+    DDR2 to DDR2, DDR2 to the LCD and DCMI to DDR2;
+2. a chain of up to 8 descriptors; each moves rows x lines;
+
+Usage:
+1. the caller hands the resources over before starting;
+    the DDR2: video_core_mig_interface::set_core_dma();
+    the LCD: video_core_src_mux::select_dma() and video_core_lcd_display::set_video_stream();
+2. the wrappers (copy_ddr2() etc) only start the chain;
+    wait_done() (or is_busy()) before handing the resources back;
+3. wait_done() gives up once no line has moved for the budget (set_wait_budget());
+    the chain is left running; abort() stops it, also while it waits
+    for the mig, the lcd or the dcmi; wait_done() again to see it stopped;
+******************************************************************/
+typedef struct{
+    uint32_t src;           // source line address; DDR2 sources only;
+    uint32_t dst;           // destination line address; DDR2 destinations only;
+    uint32_t line_num;      // lines per row; 1 to 65535;
+    uint32_t row_num;       // rows; 1 to 4095;
+    uint32_t src_stride;    // lines from the start of a row to the next; up to 65535;
+    uint32_t dst_stride;
+    int kind;               // video_core_dma::KIND_*;
+}dma_desc_t;
+
+
+class video_core_dma{
+    // register map;
+    enum{
+        REG_CTRL_OFFSET         = V6_DMA_REG_CTRL,
+        REG_STATUS_OFFSET       = V6_DMA_REG_STATUS,
+        REG_CHAIN_OFFSET        = V6_DMA_REG_CHAIN,
+        REG_DESC_SEL_OFFSET     = V6_DMA_REG_DESC_SEL,
+        REG_DESC_SRC_OFFSET     = V6_DMA_REG_DESC_SRC,
+        REG_DESC_DST_OFFSET     = V6_DMA_REG_DESC_DST,
+        REG_DESC_LEN_OFFSET     = V6_DMA_REG_DESC_LEN,
+        REG_DESC_STRIDE_OFFSET  = V6_DMA_REG_DESC_STRIDE
+    };
+
+    // field;
+    enum{
+        BIT_POS_CTRL_START      = V6_DMA_REG_BIT_POS_CTRL_START,
+        BIT_POS_CTRL_ABORT      = V6_DMA_REG_BIT_POS_CTRL_ABORT,
+        BIT_POS_STATUS_BUSY     = V6_DMA_REG_BIT_POS_STATUS_BUSY,
+        BIT_POS_STATUS_ERROR    = V6_DMA_REG_BIT_POS_STATUS_ERROR,
+        BIT_POS_STATUS_ABORTED  = V6_DMA_REG_BIT_POS_STATUS_ABORTED,
+        BIT_POS_STATUS_DESC     = V6_DMA_REG_BIT_POS_STATUS_DESC,
+        BIT_POS_STATUS_DONE_CNT = V6_DMA_REG_BIT_POS_STATUS_DONE_CNT,
+        BIT_POS_STATUS_LINE_CNT = V6_DMA_REG_BIT_POS_STATUS_LINE_CNT,
+        BIT_POS_LEN_LINE        = V6_DMA_REG_BIT_POS_LEN_LINE,
+        BIT_POS_LEN_ROW         = V6_DMA_REG_BIT_POS_LEN_ROW,
+        BIT_POS_LEN_KIND        = V6_DMA_REG_BIT_POS_LEN_KIND,
+        BIT_POS_STRIDE_SRC      = V6_DMA_REG_BIT_POS_STRIDE_SRC,
+        BIT_POS_STRIDE_DST      = V6_DMA_REG_BIT_POS_STRIDE_DST
+    };
+
+    // field limit;
+    enum{
+        ADDR_MASK       = 0x7FFFFF,     // 23-bit;
+        LINE_NUM_MAX    = 0xFFFF,
+        ROW_NUM_MAX     = 0xFFF,
+        STRIDE_MAX      = 0xFFFF,
+        SPLIT_LINE_NUM  = 4096          // lines per row when a long run is split into rows;
+    };
+
+    public:
+        // descriptor kind;
+        enum{
+            KIND_DDR2_TO_DDR2   = V6_DMA_KIND_DDR2_TO_DDR2,
+            KIND_DDR2_TO_LCD    = V6_DMA_KIND_DDR2_TO_LCD,
+            KIND_DCMI_TO_DDR2   = V6_DMA_KIND_DCMI_TO_DDR2,
+            DESC_NUM            = V6_DMA_DESC_NUM
+        };
+
+        // outcome of wait_done(); -1 as before for the error;
+        enum{
+            DONE_OK         = 0,    // ran to the end;
+            DONE_ERROR      = -1,   // stopped at a descriptor of the reserved kind;
+            DONE_TIMEOUT    = -2,   // no line moved within the budget; still running;
+            DONE_ABORTED    = -3    // stopped on abort();
+        };
+
+        video_core_dma(uint32_t core_base_addr);
+        ~video_core_dma();
+
+        /* descriptors */
+        int set_desc(int index, const dma_desc_t *desc);
+        int load_chain(const dma_desc_t *desc, int num);
+
+        /* control */
+        void start(void);
+        void abort(void);
+
+        /* status */
+        uint32_t get_status(void);
+        int is_busy(void);
+        int is_error(void);
+        int is_aborted(void);           // the last chain stopped on abort();
+        int get_desc_index(void);       // descriptor being run;
+        uint32_t get_done_cnt(void);    // descriptors completed; 8-bit; wraps around;
+        uint32_t get_line_cnt(void);    // lines moved since the start; 16-bit; wraps around;
+        int wait_done(void);            // DONE_*;
+        void set_wait_budget(uint32_t budget_cycle);
+        uint32_t get_wait_budget(void);
+
+        /* wrappers; load and start; they do not wait; */
+        int copy_ddr2(uint32_t src, uint32_t dst, uint32_t nlines);
+        int ddr2_to_lcd(uint32_t src, uint32_t nlines);
+        int dcmi_to_ddr2(uint32_t dst, uint32_t nlines);
+
+    private:
+        // this video core base address in the user-address space;
+        uint32_t base_addr;
+
+        // see wait_done();
+        uint32_t wait_budget;
+
+        int check_desc(const dma_desc_t *desc);
+        int start_lines(int kind, uint32_t src, uint32_t dst, uint32_t nlines);
+};
+
+
+#ifdef __cpluscplus
+} // extern "C";
+#endif
+
+
+#endif //_VIDEO_CORE_DMA_H
@@ -1,5 +1,8 @@
 #include "video_core_mig_interface.h"
 
+// from user_util.cpp; the wait budget;
+extern core_timer sys_timer;
+
 /*
     
     Note on CPU communicating with the DDR2 via the MIG interface;
@@ -28,9 +31,28 @@ video_core_mig_interface::video_core_mig_interface(uint32_t core_base_addr){
     */
    base_addr = core_base_addr;
 
+   // HW default; level strobes; one address write per line; blocking writes;
+   stream_mode = 0;
+   posted_mode = 0;
+   posted_absent = 0;
+   post_credit = 0;
+   post_next_addr = 0;
+   prefetch_mode = 0;
+   pf_line_ready = 0;
+   pf_next_addr = 0;
+   fill_mode = 0;
+   fill_line_num = 0;
+   test_line_num = 0;
+   wr_mask = REG_WRMASK_NONE;
+   handover_cnt = 0;
+   wait_budget = MIG_WAIT_BUDGET_CYCLE;
+   last_status = 0;
+   clear_wait_stat();
+
    // by default; cpu as the control;
+   // nothing is in flight out of reset; no wait for the hand-over;
    curr_source = REG_SEL_CPU;
-   set_source(curr_source);
+   REG_WRITE(base_addr, REG_SEL_OFFSET, (uint32_t)curr_source);
 
 }
 
@@ -38,58 +60,129 @@ video_core_mig_interface::video_core_mig_interface(uint32_t core_base_addr){
 video_core_mig_interface::~video_core_mig_interface(){}
 
 
-void video_core_mig_interface::set_source(int source){
+int video_core_mig_interface::handover(int source, uint32_t budget_cycle){
     /* 
-    @brief  : to set which source to interface with the DDR2;
-    @param  : int source
+    @brief  : to hand the DDR2 over to a source once the one that has it is drained;
+    @param  : 
+        1. source : 
                 1. none                     : REG_SEL_NONE
                 2. CPU                      : REG_SEL_CPU
                 3. Motion Detection Core    : V5_MIG_INTERFACE_REG_SEL_MOTION
                 4. HW test                  : V5_MIG_INTERFACE_REG_SEL_TEST
-    @retval : none            
+                5. DMA Core                 : V5_MIG_INTERFACE_REG_SEL_DMA
+        2. budget_cycle : system clock cycles; 0 waits forever;
+    @retval : WAIT_OK; WAIT_TIMEOUT if called off (the previous source keeps the MIG);
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the cpu work does not drain (nothing written);
+                -1 if the source is not one of the above (nothing written);
+    @note   : posted writes are fenced, the read-ahead is stopped and the fill is waited for first;
+                within the same budget (a fill adds MIG_WAIT_LINE_CYCLE per line);
+    @note   : the HW defers the switch while a request of the source that has the MIG
+                waits for its complete pulse; e.g. the line of the dma in flight;
+    @note   : a core other than the cpu may write the DDR2; see get_handover_cnt();
+    */
+   uint32_t wr_data = (uint32_t)source;
+   uint32_t saved_budget = wait_budget;
+   uint32_t rd;
+   int err;
+
+   if(source < REG_SEL_NONE || source > REG_SEL_TEST){
+        return -1;
+   }
+
+   // the drain waits take the budget of the hand-over;
+   wait_budget = budget_cycle;
+   err = mode_end();
+   wait_budget = saved_budget;
+   if(err != WAIT_OK){
+        return err;
+   }
+
+   REG_WRITE(base_addr, REG_SEL_OFFSET, wr_data);       
+   err = wait_reg(REG_SEL_OFFSET, REG_SEL_PENDING_MASK, 0, budget_cycle, &rd);
+   if(err != WAIT_OK){
+        // call it off; the source that has it stays; 
+        REG_WRITE(base_addr, REG_SEL_OFFSET, (uint32_t)curr_source);
+        return err;
+   }
+
+   if(source != curr_source && source != REG_SEL_CPU && source != REG_SEL_NONE){
+        handover_cnt++;
+   }
+
+   // the status of the last wait was about the previous source;
+   last_status = 0;
+
+   // update the private var;
+   curr_source = source;
+   return WAIT_OK;
+}
+
+int video_core_mig_interface::set_source(int source){
+    /* 
+    @brief  : to set which source to interface with the DDR2;
+    @param  : see handover();
+    @retval : as handover();
+    @note   : with the budget of set_wait_budget(); left as it is on a timeout;
     */
+   return handover(source, wait_budget);
+}
+
+int video_core_mig_interface::get_source(void){
+   return curr_source;
+}
 
-    uint32_t wr_data = (uint32_t)source;
-    REG_WRITE(base_addr, REG_SEL_OFFSET, wr_data);       
+int video_core_mig_interface::is_handover_pending(void){
+   return (int)(((uint32_t)REG_READ(base_addr, REG_SEL_OFFSET) & REG_SEL_PENDING_MASK) >> V5_MIG_INTERFACE_REG_BIT_POS_SEL_PENDING);
+}
 
-    // update the private var;
-    curr_source = source;
+uint32_t video_core_mig_interface::get_handover_cnt(void){
+    return handover_cnt;
 }
 
-void video_core_mig_interface::set_core_none(void){
+int video_core_mig_interface::set_core_none(void){
     /*
     @brief  : to set the DDR2 to interface with nothing;
     @param  : none;
-    @retval : none;
+    @retval : as set_source();
     */
-   set_source(REG_SEL_NONE);
+   return set_source(REG_SEL_NONE);
 }
 
-void video_core_mig_interface::set_core_cpu(void){
+int video_core_mig_interface::set_core_cpu(void){
     /*
     @brief  : to set the DDR2 to interface with the CPU;
     @param  : none;
-    @retval : none;
+    @retval : as set_source();
     */
-   set_source(REG_SEL_CPU);
+   return set_source(REG_SEL_CPU);
 }
 
-void video_core_mig_interface::set_core_test(void){
+int video_core_mig_interface::set_core_test(void){
     /*
     @brief  : to set the DDR2 to interface with the HW test;
     @param  : none;
-    @retval : none;
+    @retval : as set_source();
     */
-   set_source(REG_SEL_TEST);
+   return set_source(REG_SEL_TEST);
 }
 
-void video_core_mig_interface::set_core_motion(void){
+int video_core_mig_interface::set_core_motion(void){
     /*
     @brief  : to set the DDR2 to interface with the motion detection core;
     @param  : none;
-    @retval : none;
+    @retval : as set_source();
+    */
+   return set_source(REG_SEL_MOTION);
+}
+
+int video_core_mig_interface::set_core_dma(void){
+    /*
+    @brief  : to set the DDR2 to interface with the dma core;
+    @param  : none;
+    @retval : as set_source();
+    @note   : the dma waits until then; see video_core_dma;
     */
-   set_source(REG_SEL_MOTION);
+   return set_source(REG_SEL_DMA);
 }
 
 uint32_t video_core_mig_interface::get_status(void){
@@ -155,6 +248,204 @@ int video_core_mig_interface::is_mig_ctrl_idle(void){
    return (int)((rd & REG_STATUS_CTRL_IDLE_MASK) >> REG_STATUS_BIT_POS_CTRL_IDLE);
 }
 
+void video_core_mig_interface::get_status_snapshot(mig_status_t *snapshot){
+    /*
+    @brief  : to retrieve every status field from one read;
+    @param  : snapshot : (output);
+    @retval : none;
+    @note   : the complete flag is a one-cycle pulse; a snapshot rarely sees it;
+                see get_complete_cnt() or wait_transaction_complete();
+    */
+   decode_status(get_status(), snapshot);
+}
+
+void video_core_mig_interface::decode_status(uint32_t status, mig_status_t *snapshot){
+    /*
+    @brief  : to decode a status register read;
+    @param  :
+        1. status   : as get_status();
+        2. snapshot : (output);
+    @retval : none;
+    */
+   snapshot->raw = status;
+   snapshot->init_complete = (status & REG_STATUS_MIG_INIT_MASK) ? 1 : 0;
+   snapshot->app_ready = (status & REG_STATUS_MIG_RDY_MASK) ? 1 : 0;
+   snapshot->complete = (status & REG_STATUS_OP_COMPLETE_MASK) ? 1 : 0;
+   snapshot->ctrl_idle = (status & REG_STATUS_CTRL_IDLE_MASK) ? 1 : 0;
+   snapshot->stream = (status & REG_STATUS_STREAM_MASK) ? 1 : 0;
+   snapshot->posted = (status & REG_STATUS_POSTED_MASK) ? 1 : 0;
+   snapshot->pf_line = (status & REG_STATUS_PF_LINE_MASK) ? 1 : 0;
+   snapshot->pf_next = (status & REG_STATUS_PF_NEXT_MASK) ? 1 : 0;
+   snapshot->pf_busy = (status & REG_STATUS_PF_BUSY_MASK) ? 1 : 0;
+   snapshot->fill_busy = (status & REG_STATUS_FILL_BUSY_MASK) ? 1 : 0;
+   snapshot->fill_done = (status & REG_STATUS_FILL_DONE_MASK) ? 1 : 0;
+   snapshot->post_cnt = (uint8_t)((status & REG_STATUS_POST_CNT_MASK) >> REG_STATUS_BIT_POS_POST_CNT);
+   snapshot->complete_cnt = (uint8_t)((status & REG_STATUS_COMPLETE_CNT_MASK) >> REG_STATUS_BIT_POS_COMPLETE_CNT);
+}
+
+int video_core_mig_interface::wait_reg(uint32_t reg_offset, uint32_t mask, int level, uint32_t budget_cycle, uint32_t *rd_data){
+    /*
+    @brief  : to wait until a register is at a level;
+    @param  :
+        1. reg_offset   : register; REG_*_OFFSET;
+        2. mask         : bits of the register;
+        3. level        : 1 until any bit of the mask is HIGH; 0 until all are LOW;
+        4. budget_cycle : system clock cycles; 0 waits forever;
+        5. rd_data      : (output) the last read;
+    @retval : WAIT_OK; WAIT_TIMEOUT;
+    @note   : the budget starts at the first look at the timer (MIG_WAIT_TIMER_STRIDE reads in);
+                a short wait never reads the timer;
+    @note   : the reads are counted; see get_wait_stat();
+    */
+   uint32_t rd;
+   uint32_t spin = 0;
+   uint64_t start = 0;
+   uint64_t now;
+   int err = WAIT_OK;
+
+   while(1){
+        rd = (uint32_t)REG_READ(base_addr, reg_offset);
+        spin++;
+        if((rd & mask) ? level : !level){
+            break;
+        }
+        if(budget_cycle && (spin % MIG_WAIT_TIMER_STRIDE) == 0){
+            now = sys_timer.read_counter();
+            if(spin == MIG_WAIT_TIMER_STRIDE){
+                start = now;
+            }
+            else if(now - start >= budget_cycle){
+                err = WAIT_TIMEOUT;
+                break;
+            }
+        }
+   }
+
+   wait_stat.wait_cnt++;
+   wait_stat.spin_cnt += spin;
+   if(spin > wait_stat.spin_max){
+        wait_stat.spin_max = spin;
+   }
+   if(err != WAIT_OK){
+        wait_stat.timeout_cnt++;
+   }
+   wait_stat.last_err = err;
+   *rd_data = rd;
+   return err;
+}
+
+int video_core_mig_interface::wait_status(uint32_t mask, uint32_t budget_cycle, mig_status_t *snapshot){
+    /*
+    @brief  : to wait until any status bit of the mask is HIGH;
+    @param  :
+        1. mask         : REG_STATUS_*_MASK; or-ed;
+        2. budget_cycle : system clock cycles; 0 waits forever;
+        3. snapshot     : (output) the last status read; NULL if not needed;
+    @retval : WAIT_OK; WAIT_TIMEOUT; WAIT_NOT_INIT if the last read saw the calibration not complete;
+    @note   : see wait_reg();
+    */
+   uint32_t status;
+   int err;
+
+   err = wait_reg(REG_STATUS_OFFSET, mask, 1, budget_cycle, &status);
+   if(err != WAIT_OK && !(status & REG_STATUS_MIG_INIT_MASK)){
+        err = WAIT_NOT_INIT;
+        wait_stat.last_err = err;
+   }
+
+   last_status = status;
+   if(snapshot){
+        decode_status(status, snapshot);
+   }
+   return err;
+}
+
+int video_core_mig_interface::wait_status_clear(uint32_t mask, uint32_t budget_cycle){
+    /*
+    @brief  : to wait until every status bit of the mask is LOW;
+    @param  :
+        1. mask         : REG_STATUS_*_MASK; or-ed;
+        2. budget_cycle : system clock cycles; 0 waits forever;
+    @retval : as wait_status();
+    @note   : the last status read is kept in last_status;
+    */
+   uint32_t status;
+   int err;
+
+   err = wait_reg(REG_STATUS_OFFSET, mask, 0, budget_cycle, &status);
+   if(err != WAIT_OK && !(status & REG_STATUS_MIG_INIT_MASK)){
+        err = WAIT_NOT_INIT;
+        wait_stat.last_err = err;
+   }
+   last_status = status;
+   return err;
+}
+
+uint32_t video_core_mig_interface::line_budget(uint32_t nlines){
+    /*
+    @brief  : budget of a wait for a HW run over lines (fill, march element);
+    @param  : number of lines;
+    @retval : set_wait_budget() plus MIG_WAIT_LINE_CYCLE per line; saturates;
+                0 (forever) if the budget is 0;
+    */
+   uint64_t budget;
+
+   if(wait_budget == 0){
+        return 0;
+   }
+   budget = (uint64_t)wait_budget + (uint64_t)nlines*MIG_WAIT_LINE_CYCLE;
+   return (budget > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)budget;
+}
+
+int video_core_mig_interface::wait_init_complete(uint32_t budget_cycle){
+   return wait_status(REG_STATUS_MIG_INIT_MASK, budget_cycle, NULL);
+}
+
+int video_core_mig_interface::wait_app_ready(uint32_t budget_cycle){
+   return wait_status(REG_STATUS_MIG_RDY_MASK, budget_cycle, NULL);
+}
+
+int video_core_mig_interface::wait_transaction_complete(uint32_t budget_cycle){
+    /*
+    @brief  : to wait for the complete pulse of a submitted cpu transaction;
+    @param  : budget in system clock cycles; 0 waits forever;
+    @retval : WAIT_OK; WAIT_TIMEOUT; WAIT_NOT_INIT;
+    @note   : the pulse lasts one system clock; one status read per bus round trip
+                sees it (as is_transaction_complete()); submit first, then wait;
+    */
+   return wait_status(REG_STATUS_OP_COMPLETE_MASK, budget_cycle, NULL);
+}
+
+int video_core_mig_interface::wait_ctrl_idle(uint32_t budget_cycle){
+   return wait_status(REG_STATUS_CTRL_IDLE_MASK, budget_cycle, NULL);
+}
+
+void video_core_mig_interface::set_wait_budget(uint32_t budget_cycle){
+    /*
+    @brief  : to set the budget of every wait inside the blocking methods;
+    @param  : system clock cycles; 0 waits forever (as before the budget);
+    @retval : none;
+    @note   : MIG_WAIT_BUDGET_CYCLE by default;
+    */
+   wait_budget = budget_cycle;
+}
+
+uint32_t video_core_mig_interface::get_wait_budget(void){
+   return wait_budget;
+}
+
+void video_core_mig_interface::get_wait_stat(mig_wait_stat_t *stat){
+   *stat = wait_stat;
+}
+
+void video_core_mig_interface::clear_wait_stat(void){
+   wait_stat.wait_cnt = 0;
+   wait_stat.timeout_cnt = 0;
+   wait_stat.spin_cnt = 0;
+   wait_stat.spin_max = 0;
+   wait_stat.last_err = WAIT_OK;
+}
+
 void video_core_mig_interface::set_addr(uint32_t addr){
     /*
     @brief  : set up the address for writing/reading to/from the DDR2;
@@ -167,22 +458,41 @@ void video_core_mig_interface::set_addr(uint32_t addr){
    REG_WRITE(base_addr, REG_ADDR_OFFSET, addr);
 }
 
-void video_core_mig_interface::submit_write(void){
+int video_core_mig_interface::submit_write(void){
     /* 
     @brief  : to submit a write request;
     @param  : none
-    @retval : none
+    @retval : WAIT_OK; WAIT_TIMEOUT or WAIT_NOT_INIT if the MIG is not ready within the budget
+                (or the posts, read-ahead or fill before do not end);
     @note   : user needs to ensure data and address line are already set up;        
     @note   : this is a blocking method;
+    @note   : stream mode: no ready check; the HW holds the request until the MIG is ready;
     @assumption : CPU is controlling the MIG interface (set it apriori);
     */
+   int err;
+
+   err = mode_end();
+   if(err != WAIT_OK){
+        return err;
+   }
 
    // block until  the mig is ready to accept a new request;
-   while(!is_mig_app_ready()){};   
+   // a level strobe is only seen while it is;
+   if(!stream_mode){
+        err = wait_app_ready(wait_budget);
+        if(err != WAIT_OK){
+            return err;
+        }
+   }
 
    uint32_t wr_data = (uint32_t)REG_CTRL_MASK_WRSTROBE;   
    REG_WRITE(base_addr, REG_CTRL_OFFSET, wr_data);
 
+   // stream mode: one-shot; nothing to clear;
+   if(stream_mode){
+        return WAIT_OK;
+   }
+
    /*-------------------------------------------------------------
    * ??? LIMITATION ???
    * need to ensure the wrstrobe is two system clock periods wide;
@@ -193,24 +503,43 @@ void video_core_mig_interface::submit_write(void){
    // need to disable after one clock cycle; otherwise; it will keep 
    // on writing;
    REG_WRITE(base_addr, REG_CTRL_OFFSET, (uint32_t) 0x00);
+   return WAIT_OK;
 }
 
-void video_core_mig_interface::submit_read(void){
+int video_core_mig_interface::submit_read(void){
     /* 
     @brief  : to submit a read request;
     @param  : none
-    @retval : none
+    @retval : WAIT_OK; WAIT_TIMEOUT or WAIT_NOT_INIT if the MIG is not ready within the budget
+                (or the posts, read-ahead or fill before do not end);
     @note   : user needs to ensure the address line is already set up;        
     @note   : this is a blocking method;
+    @note   : stream mode: no ready check; see submit_write();
     @assumption : CPU is controlling the MIG interface (set it apriori);
     */
+   int err;
+
+   err = mode_end();
+   if(err != WAIT_OK){
+        return err;
+   }
 
    // block until  the mig is ready to accept a new request;
-   while(!is_mig_app_ready()){};
+   if(!stream_mode){
+        err = wait_app_ready(wait_budget);
+        if(err != WAIT_OK){
+            return err;
+        }
+   }
 
    uint32_t wr_data = (uint32_t)REG_CTRL_MASK_RDSTROBE;   
    REG_WRITE(base_addr, REG_CTRL_OFFSET, wr_data);
 
+   // stream mode: one-shot; nothing to clear;
+   if(stream_mode){
+        return WAIT_OK;
+   }
+
     /*-------------------------------------------------------------
    * ??? LIMITATION ???
    * need to ensure the rdstrobe is two system clock periods wide;
@@ -221,182 +550,906 @@ void video_core_mig_interface::submit_read(void){
    // need to disable after one clock cycle; otherwise; it will keep 
    // on reading;
    REG_WRITE(base_addr, REG_CTRL_OFFSET, (uint32_t) 0x00);
+   return WAIT_OK;
 }
 
-void video_core_mig_interface::push_wrdata_01(uint32_t wrdata){
+int video_core_mig_interface::set_stream_mode(int enable){
     /*
-    @brief  : to push a 32-bit data into the DDR2 128-bit wr_data[31:0];
-    @param  : write data;
-    @retval : none;    
-    @assumption : CPU is controlling the MIG interface (set it apriori);
+    @brief  : to enable/disable the stream mode for the cpu;
+    @param  : 1 to enable; 0 to disable;
+    @retval : 0 if OK; -1 if the HW does not have the stream mode;
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the cpu work before does not end (mode left as it is);
+    @note   : stream mode:
+                1. the address register post-increments after every transaction;
+                2. push_wrdata_04() submits the write; no strobe, no clear;
+                3. submit_write()/submit_read() are a single one-shot bus write;
+                4. the HW holds a request until the MIG is ready;
+    @note   : the HW reflects the mode in the status register;
+                a core without it reads back LOW;
+    @assumption : no transaction is in flight;
     */
-   REG_WRITE(base_addr, REG_WRDATA_01_OFFSET, wrdata);
+   int err;
+
+   err = mode_end();
+   if(err != WAIT_OK){
+        return err;
+   }
+   stream_mode = enable ? 1 : 0;
+   write_mode();
+   stream_mode = (get_status() & REG_STATUS_STREAM_MASK) ? 1 : 0;
+   return (stream_mode == (enable ? 1 : 0)) ? 0 : -1;
 }
 
-void video_core_mig_interface::push_wrdata_02(uint32_t wrdata){
+int video_core_mig_interface::is_stream_mode(void){
     /*
-    @brief  : to push a 32-bit data into the DDR2 128-bit wr_data[63:32];
-    @param  : write data;
-    @retval : none;    
-    @assumption : CPU is controlling the MIG interface (set it apriori);
+    @brief  : to retrieve the stream mode;
+    @param  : none;
+    @retval : 1 if enabled; 0 otherwise;
     */
-   REG_WRITE(base_addr, REG_WRDATA_02_OFFSET, wrdata);
+   return stream_mode;
 }
 
-void video_core_mig_interface::push_wrdata_03(uint32_t wrdata){
+int video_core_mig_interface::post_write(uint32_t addr, uint32_t wrbatch01, uint32_t wrbatch02, uint32_t wrbatch03, uint32_t wrbatch04){
     /*
-    @brief  : to push a 32-bit data into the DDR2 128-bit wr_data[95:64];
-    @param  : write data;
-    @retval : none;    
+    @brief  : to post a write to the DDR2; non-blocking;
+    @param  :
+           1. addr      : the address to write to;
+           2. wrbatch01 : forms the DDR2 128-bit wr data[31:0];
+           3. wrbatch02 : forms the DDR2 128-bit wr data[63:32];
+           4. wrbatch03 : forms the DDR2 128-bit wr data[95:64];
+           5. wrbatch04 : forms the DDR2 128-bit wr data[127:96];
+    @retval : 0 if OK; -1 if the address is past the 23-bit address space;
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the fifo stays full (nothing posted);
+                as write_ddr2() on a core without the posted mode;
+    @note   : returns once the line is in the HW command fifo;
+                the write itself completes later; see fence();
+    @note   : the HW address post-increments on every post;
+                the address is only written when the lines are not sequential;
+    @note   : the fifo space is only read back once the known space is used up;
+    @note   : falls back to write_ddr2() on a core without the posted mode;
+                the HW is only probed by the first call;
     @assumption : CPU is controlling the MIG interface (set it apriori);
     */
-   REG_WRITE(base_addr, REG_WRDATA_03_OFFSET, wrdata);
-}
+   int err;
+
+   if(addr >= BIT_MASK(REG_MIG_ADDR_SIZE)){
+        return -1;
+   }
+   if(posted_absent){
+        return write_ddr2(addr, wrbatch01, wrbatch02, wrbatch03, wrbatch04);
+   }
 
+   // switch the HW over; nothing is outstanding yet;
+   if(!posted_mode){
+        err = prefetch_end();
+        if(err == WAIT_OK){
+            err = fill_wait();
+        }
+        if(err != WAIT_OK){
+            return err;
+        }
+        write_wrmask(REG_WRMASK_NONE);
+        posted_mode = 1;
+        write_mode();
+        if(!(get_status() & REG_STATUS_POSTED_MASK)){
+            posted_mode = 0;
+            posted_absent = 1;
+            write_mode();
+            return write_ddr2(addr, wrbatch01, wrbatch02, wrbatch03, wrbatch04);
+        }
+        post_credit = POST_FIFO_DEPTH;
+        set_addr(addr);
+        post_next_addr = addr;
+   }
+   else if(addr != post_next_addr){
+        set_addr(addr);
+   }
 
-void video_core_mig_interface::push_wrdata_04(uint32_t wrdata){
-    /*
-    @brief  : to push a 32-bit data into the DDR2 128-bit wr_data[127:96];
-    @param  : write data;
-    @retval : none;    
-    @assumption : CPU is controlling the MIG interface (set it apriori);
-    */
-   REG_WRITE(base_addr, REG_WRDATA_04_OFFSET, wrdata);
-}
+   // a post into a full fifo is dropped;
+   if(post_credit == 0){
+        err = wait_status_clear(REG_STATUS_POST_FULL_MASK, wait_budget);
+        post_credit = POST_FIFO_DEPTH - ((last_status & REG_STATUS_POST_CNT_MASK) >> REG_STATUS_BIT_POS_POST_CNT);
+        if(err != WAIT_OK){
+            return err;
+        }
+   }
 
+   // the last word posts;
+   push_wrdata_01(wrbatch01);
+   push_wrdata_02(wrbatch02);
+   push_wrdata_03(wrbatch03);
+   push_wrdata_04(wrbatch04);
 
-uint32_t video_core_mig_interface::get_rddata_01(void){
+   post_credit--;
+   post_next_addr = (addr + 1) & (BIT_MASK(REG_MIG_ADDR_SIZE) - 1);
+   return 0;
+}
+
+int video_core_mig_interface::fence(void){
     /*
-    @brief  : to read off the 32-bit of the DDR2 128-bit data at addr[31:0];
+    @brief  : to wait until every posted write has been written;
     @param  : none;
-    @retval : 32-bit read data;
-    @assumption : CPU is controlling the MIG interface (set it apriori);
+    @retval : WAIT_OK; WAIT_TIMEOUT or WAIT_NOT_INIT if the fifo does not drain within the budget;
+    @note   : the posted mode stays on;
+    @note   : this is a blocking method;
     */
-   return REG_READ(base_addr, REG_RDDATA_01_OFFSET);
+   int err;
+
+   if(!posted_mode){
+        return WAIT_OK;
+   }
+   err = wait_status_clear(REG_STATUS_POST_CNT_MASK, wait_budget);
+   post_credit = POST_FIFO_DEPTH - ((last_status & REG_STATUS_POST_CNT_MASK) >> REG_STATUS_BIT_POS_POST_CNT);
+   return err;
 }
 
-uint32_t video_core_mig_interface::get_rddata_02(void){
+uint32_t video_core_mig_interface::get_complete_cnt(void){
     /*
-    @brief  : to read off the 32-bit of the DDR2 128-bit data at addr[63:32];
+    @brief  : to retrieve the sticky count of completed cpu transactions;
     @param  : none;
-    @retval : 32-bit read data;
-    @assumption : CPU is controlling the MIG interface (set it apriori);
+    @retval : 8-bit count; wraps around;
+    @note   : unlike is_transaction_complete(), a completion between two reads is not missed;
     */
-   return REG_READ(base_addr, REG_RDDATA_02_OFFSET);
+   return (get_status() & REG_STATUS_COMPLETE_CNT_MASK) >> REG_STATUS_BIT_POS_COMPLETE_CNT;
 }
 
-uint32_t video_core_mig_interface::get_rddata_03(void){
+void video_core_mig_interface::write_mode(void){
     /*
-    @brief  : to read off the 32-bit of the DDR2 128-bit data at addr[95:64];
+    @brief  : to write the mode register from stream_mode, posted_mode and prefetch_mode;
     @param  : none;
-    @retval : 32-bit read data;
-    @assumption : CPU is controlling the MIG interface (set it apriori);
+    @retval : none;
     */
-   return REG_READ(base_addr, REG_RDDATA_03_OFFSET);
+   uint32_t mode = 0;
+
+   if(stream_mode){
+        mode |= REG_MODE_MASK_STREAM;
+   }
+   if(posted_mode){
+        mode |= REG_MODE_MASK_POSTED;
+   }
+   if(prefetch_mode){
+        mode |= REG_MODE_MASK_PREFETCH;
+   }
+   REG_WRITE(base_addr, REG_MODE_OFFSET, mode);
 }
 
-uint32_t video_core_mig_interface::get_rddata_04(void){
+int video_core_mig_interface::post_end(void){
     /*
-    @brief  : to read off the 32-bit of the DDR2 128-bit data at addr[127:96];
+    @brief  : to fence and leave the posted mode before any other transaction;
     @param  : none;
-    @retval : 32-bit read data;
-    @assumption : CPU is controlling the MIG interface (set it apriori);
+    @retval : as fence(); the posted mode stays on if it fails;
     */
-   return REG_READ(base_addr, REG_RDDATA_04_OFFSET);
+   int err;
+
+   if(posted_mode){
+        err = fence();
+        if(err != WAIT_OK){
+            return err;
+        }
+        posted_mode = 0;
+        write_mode();
+   }
+   return WAIT_OK;
 }
 
-void video_core_mig_interface::write_ddr2(uint32_t addr, uint32_t wrbatch01, uint32_t wrbatch02, uint32_t wrbatch03, uint32_t wrbatch04){
+int video_core_mig_interface::prefetch_start(uint32_t addr){
     /*
-    @brief  : to write to the DDR2;
-    @param  :
-           1. addr      : the address to write to;
-           2. wrbatch01 : forms the DDR2 128-bit wr data[31:0];
-           3. wrbatch02 : forms the DDR2 128-bit wr data[63:32];
-           4. wrbatch03 : forms the DDR2 128-bit wr data[95:64];
-           5. wrbatch04 : forms the DDR2 128-bit wr data[127:96];
-    @retval : none
-    @note   : This is a blocking method; waiting for the MIG to acknowledge.
+    @brief  : to start the read-ahead from a line;
+    @param  : addr : the first address (line) to read;
+    @retval : 0 if OK; -1 if the address is past the 23-bit address space;
+                as fence() if the posted writes before do not drain;
+    @note   : the HW reads line N+1 into its shadow registers while
+                the cpu takes line N; see prefetch_read();
+    @note   : no restart if the read-ahead is already at this line;
+                a scan in chunks keeps the lines read ahead;
     @assumption : CPU is controlling the MIG interface (set it apriori);
     */
-    
-    // block until the controller is ready;
-    //while(!is_mig_ctrl_idle()){};
+   if(addr >= BIT_MASK(REG_MIG_ADDR_SIZE)){
+        return -1;
+   }
+   int err;
 
-    // one needs to setup the address and data before submitting the write request;
-    set_addr(addr);
-    push_wrdata_01(wrbatch01);
-    push_wrdata_02(wrbatch02);
-    push_wrdata_03(wrbatch03);
-    push_wrdata_04(wrbatch04);
+   if(prefetch_mode && (addr == pf_next_addr)){
+        return 0;
+   }
 
-    // submit;
-    submit_write();
+   err = post_end();
+   if(err != WAIT_OK){
+        return err;
+   }
 
-    //debug_str("waiting for transaction to complete.\r\n");
-    // block until the MIG has accepted and acknowledged the write request;
-    while(!is_transaction_complete()){};
-    //debug_str("write transaction is complete.\r\n");
+   // an address write restarts a read-ahead already on;
+   set_addr(addr);
+   if(!prefetch_mode){
+        prefetch_mode = 1;
+        write_mode();
+   }
+   pf_line_ready = 0;
+   pf_next_addr = addr;
+   return 0;
 }
 
-void video_core_mig_interface::read_ddr2(uint32_t addr, uint32_t *read_buffer){
+int video_core_mig_interface::prefetch_read(uint32_t *read_buffer){
     /*
-    @brief  : to get the data read from the DDR2;
-    @param  : 
-        1. address to read from;
-        2. pointer to an array to store the data read;
-    @retval : none;
-    @note   : this is a blocking method;
-    @assumption : CPU is controlling the MIG interface (set it apriori);
+    @brief  : to take the next line of the read-ahead;
+    @param  : read_buffer : four 32-bit words; as read_ddr2();
+    @retval : 0 if OK; -1 if the read-ahead is not on;
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the line does not arrive (buffer left as it is);
+    @note   : it only waits if the line has not arrived yet;
+    @note   : the status is not polled if the status before
+                has seen this line in the shadow registers already;
+    @note   : the last word read takes the line; the HW then reads the line after;
     */
-   
-   // block until the controller is ready;
-   //while(!is_mig_ctrl_idle()){};
+   uint32_t status;
+   int err;
 
-   // prepare the address;
-   set_addr(addr);
-   
-   // submit the read request;
-   submit_read();
-   
-   // debugging
-   //delay_busy_ms(10);
+   if(!prefetch_mode){
+        return -1;
+   }
+   if(pf_line_ready){
+        status = REG_STATUS_PF_LINE_MASK;
+   }
+   else{
+        err = wait_status(REG_STATUS_PF_LINE_MASK, wait_budget, NULL);
+        if(err != WAIT_OK){
+            return err;
+        }
+        status = last_status;
+   }
 
-   //debug_str("waiting for read transaction to complete.\r\n");
-   // block until the MIG says the data is valid to read;
-   while(!is_transaction_complete()){};
-   //debug_str("read transaction is complete.\r\n");
+   *(read_buffer + 0) = get_rddata_01();
+   *(read_buffer + 1) = get_rddata_02();
+   *(read_buffer + 2) = get_rddata_03();
+   *(read_buffer + 3) = get_rddata_04();
 
-   // data is valid to ready;
-   // store it to the pointed array;
-   // there are four batches to read to make the entire 128-bit DDR2 transaction;
-    *(read_buffer + 0) = get_rddata_01();
-    *(read_buffer + 1) = get_rddata_02();
-    *(read_buffer + 2) = get_rddata_03();
-    *(read_buffer + 3) = get_rddata_04();   
+   // the shadow has moved in;
+   pf_line_ready = (status & REG_STATUS_PF_NEXT_MASK) ? 1 : 0;
+   pf_next_addr = (pf_next_addr + 1) & (BIT_MASK(REG_MIG_ADDR_SIZE) - 1);
+   return 0;
 }
 
-void video_core_mig_interface::init_ddr2(uint32_t init_value, uint32_t start_addr, uint32_t range_addr){
+int video_core_mig_interface::prefetch_end(void){
     /*
-    @brief  : to initialize the DDR2 with common initial value;
-    @param  :
-        1. init_value   : the value to populate the DDR2;
-        2. start_addr   : start address of the DDR2 to write to;
-        3. range_addr   : the address range of the DDR2 to write to;
-    @retval : none    
-    @note   : each address represents a 128-bit transaction;
+    @brief  : to stop the read-ahead;
+    @param  : none;
+    @retval : WAIT_OK; WAIT_TIMEOUT or WAIT_NOT_INIT if the read in flight does not end;
+    @note   : waits for the read in flight; the HW drops its data;
+    @note   : the read-ahead is off even on a timeout;
+    */
+   int err = WAIT_OK;
+
+   if(prefetch_mode){
+        prefetch_mode = 0;
+        write_mode();
+        pf_line_ready = 0;
+        err = wait_status_clear(REG_STATUS_PF_BUSY_MASK, wait_budget);
+   }
+   return err;
+}
+
+int video_core_mig_interface::mode_end(void){
+    /*
+    @brief  : to fence the posted writes, stop the read-ahead and 
+                wait for the fill before any other transaction;
+    @param  : none;
+    @retval : WAIT_OK; the first error of post_end(), prefetch_end() or fill_wait();
+    */
+   int err;
+
+   err = post_end();
+   if(err == WAIT_OK){
+        err = prefetch_end();
+   }
+   if(err == WAIT_OK){
+        err = fill_wait();
+   }
+   return err;
+}
+
+int video_core_mig_interface::fill_start(uint32_t addr, const uint32_t *pattern, uint32_t nlines){
+    /*
+    @brief  : to start the HW fill of a contiguous region with one 128-bit pattern;
+    @param  :
+        1. addr     : first address (line) to write to;
+        2. pattern  : four 32-bit words; pattern[0] forms wr data[31:0];
+        3. nlines   : number of lines (128-bit each);
+    @retval : 0 if started; -1 if the region is empty or past the 23-bit address space;
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the cpu work before does not end (not started);
+    @note   : it does not wait; see fill_wait() and get_fill_cnt();
+    @note   : the pattern is pushed with the stream mode off;
+                the last word would submit a write otherwise;
+    @note   : the address register is left as it is; the HW keeps its own;
+    @note   : counts as a hand-over; see get_handover_cnt();
     @assumption : CPU is controlling the MIG interface (set it apriori);
     */
+   int err;
 
-   uint32_t i;  // loop index;
-   uint32_t address;
-   address = start_addr;
-   for(i = 0; i < range_addr; i++){
-        write_ddr2(address, init_value, init_value, init_value, init_value);
-        address++;
-        
-        // debugging
-        //delay_busy_ms(10);
-   }        
+   if(nlines == 0 || addr + nlines > BIT_MASK(REG_MIG_ADDR_SIZE) || addr + nlines < addr){
+        return -1;
+   }
+   err = mode_end();
+   if(err != WAIT_OK){
+        return err;
+   }
+   write_wrmask(REG_WRMASK_NONE);
+
+   if(stream_mode){
+        REG_WRITE(base_addr, REG_MODE_OFFSET, (uint32_t)0x00);
+   }
+   set_addr(addr);
+   push_wrdata_01(pattern[0]);
+   push_wrdata_02(pattern[1]);
+   push_wrdata_03(pattern[2]);
+   push_wrdata_04(pattern[3]);
+   REG_WRITE(base_addr, REG_FILL_OFFSET, nlines & REG_FILL_LEN_MASK);
+   if(stream_mode){
+        write_mode();
+   }
+   fill_mode = 1;
+   fill_line_num = nlines;
+   handover_cnt++;
+   return 0;
+}
+
+int video_core_mig_interface::fill_ddr2(uint32_t addr, const uint32_t *pattern, uint32_t nlines){
+    /*
+    @brief  : to fill a contiguous region with one 128-bit pattern; see fill_start();
+    @param  : see fill_start();
+    @retval : 0 if OK; -1 if the region is empty or past the 23-bit address space;
+                WAIT_TIMEOUT or WAIT_NOT_INIT as fill_start() and fill_wait();
+    @note   : This is a blocking method;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   int err;
+
+   err = fill_start(addr, pattern, nlines);
+   if(err != 0){
+        return err;
+   }
+   return fill_wait();
+}
+
+int video_core_mig_interface::fill_wait(void){
+    /*
+    @brief  : to wait until the HW fill is done;
+    @param  : none;
+    @retval : WAIT_OK; WAIT_TIMEOUT or WAIT_NOT_INIT if it is not done within the budget;
+    @note   : no status read unless a fill has been started;
+    @note   : the budget grows with the fill; see line_budget();
+                after a timeout, the fill is waited for again by the next call;
+    */
+   int err;
+
+   if(fill_mode){
+        err = wait_status_clear(REG_STATUS_FILL_BUSY_MASK, line_budget(fill_line_num));
+        if(err != WAIT_OK){
+            return err;
+        }
+        fill_mode = 0;
+   }
+   return WAIT_OK;
+}
+
+int video_core_mig_interface::is_fill_busy(void){
+    /*
+    @brief  : to check if the HW fill is running;
+    @param  : none;
+    @retval : 1 if running; 0 otherwise;
+    */
+   return (int)((get_status() & REG_STATUS_FILL_BUSY_MASK) >> REG_STATUS_BIT_POS_FILL_BUSY);
+}
+
+int video_core_mig_interface::is_fill_done(void){
+    /*
+    @brief  : to check if the last HW fill has written its last line;
+    @param  : none;
+    @retval : 1 if done; 0 otherwise (running or none since reset);
+    */
+   return (int)((get_status() & REG_STATUS_FILL_DONE_MASK) >> REG_STATUS_BIT_POS_FILL_DONE);
+}
+
+uint32_t video_core_mig_interface::get_fill_cnt(void){
+    /*
+    @brief  : progress of the HW fill;
+    @param  : none;
+    @retval : lines written since the last fill_start();
+    */
+   return (uint32_t)REG_READ(base_addr, REG_FILL_OFFSET) & REG_FILL_LEN_MASK;
+}
+
+int video_core_mig_interface::test_start(uint32_t addr, uint32_t nlines, uint32_t op){
+    /*
+    @brief  : to start one march element of the HW test circuit (bench mode);
+    @param  :
+        1. addr     : first address (line);
+        2. nlines   : number of lines (128-bit each);
+        3. op       : TEST_OP_*; or-ed;
+    @retval : 0 if started; -1 if the region is empty or past the 23-bit address space;
+                as set_core_test() if the hand-over fails (not started; back to the LED demo);
+    @note   : the MIG is handed to the circuit (set_core_test()) unless it has it already;
+                the bench mode is set before; the LED demo writes lines 0 to 31 otherwise;
+    @note   : the circuit starts from the address register; it is left as it is;
+    @note   : ignored by the HW while an element runs; see test_wait();
+    */
+   int err;
+
+   if(nlines == 0 || addr + nlines > BIT_MASK(REG_MIG_ADDR_SIZE) || addr + nlines < addr){
+        return -1;
+   }
+   if(curr_source != REG_SEL_TEST){
+        REG_WRITE(base_addr, REG_TEST_OFFSET, BIT_MASK(REG_TEST_BIT_POS_MODE));
+        err = set_core_test();
+        if(err != WAIT_OK){
+            REG_WRITE(base_addr, REG_TEST_OFFSET, (uint32_t)0x00);
+            return err;
+        }
+   }
+   set_addr(addr);
+   REG_WRITE(base_addr, REG_TEST_OFFSET, BIT_MASK(REG_TEST_BIT_POS_MODE) 
+                | ((op & REG_TEST_OP_MASK) << REG_TEST_BIT_POS_OP) | (nlines & REG_TEST_LEN_MASK));
+   test_line_num = nlines;
+   return 0;
+}
+
+int video_core_mig_interface::test_wait(uint32_t *err_cnt){
+    /*
+    @brief  : to wait until the march element of the HW test circuit is done;
+    @param  : err_cnt : (output) lines read back wrong; saturates at 0xFFFF; NULL if not needed;
+                left as it is on a timeout;
+    @retval : WAIT_OK; WAIT_TIMEOUT if it is not done within the budget
+                (e.g. the MIG is taken from the circuit meanwhile);
+    @note   : the budget grows with the element; see line_budget();
+    */
+   uint32_t rd;
+   int err;
+
+   err = wait_reg(REG_TEST_OFFSET, REG_TEST_BUSY_MASK, 0, line_budget(test_line_num), &rd);
+   if(err != WAIT_OK){
+        return err;
+   }
+   if(err_cnt){
+        *err_cnt = (rd & REG_TEST_ERR_CNT_MASK) >> REG_TEST_BIT_POS_ERR_CNT;
+   }
+   return WAIT_OK;
+}
+
+int video_core_mig_interface::is_test_busy(void){
+   return (int)(((uint32_t)REG_READ(base_addr, REG_TEST_OFFSET) & REG_TEST_BUSY_MASK) >> REG_TEST_BIT_POS_BUSY);
+}
+
+int video_core_mig_interface::is_test_done(void){
+   return (int)(((uint32_t)REG_READ(base_addr, REG_TEST_OFFSET) & REG_TEST_DONE_MASK) >> REG_TEST_BIT_POS_DONE);
+}
+
+uint32_t video_core_mig_interface::get_test_err_cnt(void){
+   return ((uint32_t)REG_READ(base_addr, REG_TEST_OFFSET) & REG_TEST_ERR_CNT_MASK) >> REG_TEST_BIT_POS_ERR_CNT;
+}
+
+int video_core_mig_interface::test_end(void){
+    /*
+    @brief  : to set the HW test circuit back to the LED demo and the MIG back to the cpu;
+    @param  : none;
+    @retval : WAIT_OK; as test_wait() if the element running does not end (left as it is);
+                as set_core_cpu() if the MIG is not taken back (the circuit is left as it is);
+    @note   : an element running is waited for first;
+    @note   : the MIG is taken back first; the LED demo does not reach the DDR2;
+    */
+   int err;
+
+   err = test_wait(NULL);
+   if(err == WAIT_OK){
+        err = set_core_cpu();
+   }
+   if(err != WAIT_OK){
+        return err;
+   }
+   REG_WRITE(base_addr, REG_TEST_OFFSET, (uint32_t)0x00);
+   return WAIT_OK;
+}
+
+void video_core_mig_interface::push_wrdata_01(uint32_t wrdata){
+    /*
+    @brief  : to push a 32-bit data into the DDR2 128-bit wr_data[31:0];
+    @param  : write data;
+    @retval : none;    
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   REG_WRITE(base_addr, REG_WRDATA_01_OFFSET, wrdata);
+}
+
+void video_core_mig_interface::push_wrdata_02(uint32_t wrdata){
+    /*
+    @brief  : to push a 32-bit data into the DDR2 128-bit wr_data[63:32];
+    @param  : write data;
+    @retval : none;    
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   REG_WRITE(base_addr, REG_WRDATA_02_OFFSET, wrdata);
+}
+
+void video_core_mig_interface::push_wrdata_03(uint32_t wrdata){
+    /*
+    @brief  : to push a 32-bit data into the DDR2 128-bit wr_data[95:64];
+    @param  : write data;
+    @retval : none;    
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   REG_WRITE(base_addr, REG_WRDATA_03_OFFSET, wrdata);
+}
+
+
+void video_core_mig_interface::push_wrdata_04(uint32_t wrdata){
+    /*
+    @brief  : to push a 32-bit data into the DDR2 128-bit wr_data[127:96];
+    @param  : write data;
+    @retval : none;    
+    @note   : stream mode: this submits the write request;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   REG_WRITE(base_addr, REG_WRDATA_04_OFFSET, wrdata);
+}
+
+
+uint32_t video_core_mig_interface::get_rddata_01(void){
+    /*
+    @brief  : to read off the 32-bit of the DDR2 128-bit data at addr[31:0];
+    @param  : none;
+    @retval : 32-bit read data;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   return REG_READ(base_addr, REG_RDDATA_01_OFFSET);
+}
+
+uint32_t video_core_mig_interface::get_rddata_02(void){
+    /*
+    @brief  : to read off the 32-bit of the DDR2 128-bit data at addr[63:32];
+    @param  : none;
+    @retval : 32-bit read data;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   return REG_READ(base_addr, REG_RDDATA_02_OFFSET);
+}
+
+uint32_t video_core_mig_interface::get_rddata_03(void){
+    /*
+    @brief  : to read off the 32-bit of the DDR2 128-bit data at addr[95:64];
+    @param  : none;
+    @retval : 32-bit read data;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   return REG_READ(base_addr, REG_RDDATA_03_OFFSET);
+}
+
+uint32_t video_core_mig_interface::get_rddata_04(void){
+    /*
+    @brief  : to read off the 32-bit of the DDR2 128-bit data at addr[127:96];
+    @param  : none;
+    @retval : 32-bit read data;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   return REG_READ(base_addr, REG_RDDATA_04_OFFSET);
+}
+
+int video_core_mig_interface::write_ddr2(uint32_t addr, uint32_t wrbatch01, uint32_t wrbatch02, uint32_t wrbatch03, uint32_t wrbatch04){
+    /*
+    @brief  : to write to the DDR2;
+    @param  :
+           1. addr      : the address to write to;
+           2. wrbatch01 : forms the DDR2 128-bit wr data[31:0];
+           3. wrbatch02 : forms the DDR2 128-bit wr data[63:32];
+           4. wrbatch03 : forms the DDR2 128-bit wr data[95:64];
+           5. wrbatch04 : forms the DDR2 128-bit wr data[127:96];
+    @retval : WAIT_OK; WAIT_TIMEOUT or WAIT_NOT_INIT if the MIG stalls; see set_wait_budget();
+    @note   : This is a blocking method; waiting for the MIG to acknowledge.
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+    int err;
+    
+    // block until the controller is ready;
+    //while(!is_mig_ctrl_idle()){};
+
+    err = mode_end();
+    if(err != WAIT_OK){
+        return err;
+    }
+    write_wrmask(REG_WRMASK_NONE);
+
+    // one needs to setup the address and data before submitting the write request;
+    set_addr(addr);
+    push_wrdata_01(wrbatch01);
+    push_wrdata_02(wrbatch02);
+    push_wrdata_03(wrbatch03);
+    push_wrdata_04(wrbatch04);
+
+    // submit; the stream mode has done so with the last push;
+    if(!stream_mode){
+        err = submit_write();
+        if(err != WAIT_OK){
+            return err;
+        }
+    }
+
+    //debug_str("waiting for transaction to complete.\r\n");
+    // block until the MIG has accepted and acknowledged the write request;
+    return wait_transaction_complete(wait_budget);
+}
+
+int video_core_mig_interface::write_ddr2_masked(uint32_t addr, const uint32_t *data, uint32_t byte_mask){
+    /*
+    @brief  : to write some bytes of a line of the DDR2; the others are kept;
+    @param  :
+           1. addr      : the address to write to;
+           2. data      : four 32-bit words; data[0] forms the DDR2 128-bit wr data[31:0];
+           3. byte_mask : bit i HIGH masks byte i (wr data[8i+7:8i]); it is not written;
+    @retval : as write_ddr2();
+    @note   : nothing is written (no transaction) if all bytes are masked;
+    @note   : the mask register is left as it is for the next masked write;
+    @note   : This is a blocking method; as write_ddr2();
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+    int err;
+
+    byte_mask &= REG_WRMASK_ALL;
+    if(byte_mask == REG_WRMASK_ALL){
+        return WAIT_OK;
+    }
+
+    err = mode_end();
+    if(err != WAIT_OK){
+        return err;
+    }
+    write_wrmask(byte_mask);
+
+    set_addr(addr);
+    push_wrdata_01(data[0]);
+    push_wrdata_02(data[1]);
+    push_wrdata_03(data[2]);
+    push_wrdata_04(data[3]);
+    if(!stream_mode){
+        err = submit_write();
+        if(err != WAIT_OK){
+            return err;
+        }
+    }
+    return wait_transaction_complete(wait_budget);
+}
+
+void video_core_mig_interface::write_wrmask(uint32_t mask){
+    /*
+    @brief  : to set the HW write mask register;
+    @param  : byte mask; see write_ddr2_masked();
+    @retval : none
+    @note   : only written if it differs from what the HW holds;
+    */
+   if(mask != wr_mask){
+        REG_WRITE(base_addr, REG_WRMASK_OFFSET, mask);
+        wr_mask = mask;
+   }
+}
+
+int video_core_mig_interface::read_ddr2(uint32_t addr, uint32_t *read_buffer){
+    /*
+    @brief  : to get the data read from the DDR2;
+    @param  : 
+        1. address to read from;
+        2. pointer to an array to store the data read;
+    @retval : WAIT_OK; WAIT_TIMEOUT or WAIT_NOT_INIT if the MIG stalls (buffer left as it is);
+    @note   : this is a blocking method;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   int err;
+   
+   // block until the controller is ready;
+   //while(!is_mig_ctrl_idle()){};
+
+   err = mode_end();
+   if(err != WAIT_OK){
+        return err;
+   }
+
+   // prepare the address;
+   set_addr(addr);
+   
+   // submit the read request;
+   err = submit_read();
+   
+   // debugging
+   //delay_busy_ms(10);
+
+   //debug_str("waiting for read transaction to complete.\r\n");
+   // block until the MIG says the data is valid to read;
+   if(err == WAIT_OK){
+        err = wait_transaction_complete(wait_budget);
+   }
+   if(err != WAIT_OK){
+        return err;
+   }
+   //debug_str("read transaction is complete.\r\n");
+
+   // data is valid to ready;
+   // store it to the pointed array;
+   // there are four batches to read to make the entire 128-bit DDR2 transaction;
+    *(read_buffer + 0) = get_rddata_01();
+    *(read_buffer + 1) = get_rddata_02();
+    *(read_buffer + 2) = get_rddata_03();
+    *(read_buffer + 3) = get_rddata_04();   
+    return WAIT_OK;
+}
+
+int video_core_mig_interface::init_ddr2(uint32_t init_value, uint32_t start_addr, uint32_t range_addr){
+    /*
+    @brief  : to initialize the DDR2 with common initial value;
+    @param  :
+        1. init_value   : the value to populate the DDR2;
+        2. start_addr   : start address of the DDR2 to write to;
+        3. range_addr   : the address range of the DDR2 to write to;
+    @retval : as fill_ddr2();
+    @note   : each address represents a 128-bit transaction;
+    @note   : the HW fills the region; see fill_ddr2();
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+
+   uint32_t line[4] = {init_value, init_value, init_value, init_value};
+   return fill_ddr2(start_addr, line, range_addr);
+}
+
+int video_core_mig_interface::write_ddr2_burst(uint32_t addr, const uint32_t *src, uint32_t nlines){
+    /*
+    @brief  : to write a contiguous region of the DDR2 from a cpu buffer;
+    @param  :
+        1. addr     : first address (line) to write to;
+        2. src      : four 32-bit words per line; src[0] forms wr data[31:0] of the first line;
+        3. nlines   : number of lines (128-bit each);
+    @retval : 0 if OK; -1 if the region is past the 23-bit address space (nothing written);
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the MIG stalls; the burst stops there;
+    @note   : same handshake as write_ddr2() per line, with less bus traffic:
+                1. a write data register is only pushed if its word differs
+                    from the line before (the registers hold their value);
+                2. the MIG ready check reuses the status read that saw
+                    the previous line complete;
+    @note   : stream mode: one address write per burst; the last word
+                is always pushed and submits the line; no strobe;
+    @note   : This is a blocking method;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   return burst_write(addr, src, 4, nlines);
+}
+
+int video_core_mig_interface::read_ddr2_burst(uint32_t addr, uint32_t *dst, uint32_t nlines){
+    /*
+    @brief  : to read a contiguous region of the DDR2 into a cpu buffer;
+    @param  :
+        1. addr     : first address (line) to read from;
+        2. dst      : four 32-bit words per line; as read_ddr2();
+        3. nlines   : number of lines (128-bit each);
+    @retval : 0 if OK; -1 if the region is past the 23-bit address space (nothing read);
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the MIG stalls; the burst stops there;
+    @note   : same handshake as read_ddr2() per line; the MIG ready check
+                reuses the status read that saw the previous line complete;
+    @note   : This is a blocking method;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   uint32_t i;
+   uint32_t status = 0;    // unknown; the first line checks the MIG ready status;
+   int err;
+
+   if(addr + nlines > BIT_MASK(REG_MIG_ADDR_SIZE) || addr + nlines < addr){
+        return -1;
+   }
+   err = mode_end();
+   if(err != WAIT_OK){
+        return err;
+   }
+   for(i = 0; i < nlines; i++){
+        burst_set_addr(addr + i, i);
+        err = burst_submit(REG_CTRL_MASK_RDSTROBE, &status);
+        if(err != WAIT_OK){
+            return err;
+        }
+        *(dst++) = get_rddata_01();
+        *(dst++) = get_rddata_02();
+        *(dst++) = get_rddata_03();
+        *(dst++) = get_rddata_04();
+   }
+   return 0;
+}
+
+int video_core_mig_interface::burst_write(uint32_t addr, const uint32_t *src, uint32_t src_stride, uint32_t nlines){
+    /*
+    @brief  : write lines from a cpu buffer;
+    @param  :
+        1. addr         : first address (line);
+        2. src          : four 32-bit words per line;
+        3. src_stride   : words from one line to the next in src; 0 to repeat the same line;
+        4. nlines       : number of lines;
+    @retval : 0 if OK; -1 if the region is past the 23-bit address space;
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the MIG stalls;
+    */
+   uint32_t i, j;
+   uint32_t status = 0;    // unknown; the first line checks the MIG ready status;
+   uint32_t pushed[4];     // what the write data registers hold;
+   int err;
+
+   if(addr + nlines > BIT_MASK(REG_MIG_ADDR_SIZE) || addr + nlines < addr){
+        return -1;
+   }
+   err = mode_end();
+   if(err != WAIT_OK){
+        return err;
+   }
+   write_wrmask(REG_WRMASK_NONE);
+   for(i = 0; i < nlines; i++){
+        burst_set_addr(addr + i, i);
+
+        // the first line pushes all four words;
+        // stream mode: the last word submits; always pushed;
+        for(j = 0; j < 4; j++){
+            if((i == 0) || (src[j] != pushed[j]) || (stream_mode && j == 3)){
+                REG_WRITE(base_addr, REG_WRDATA_01_OFFSET + j, src[j]);
+                pushed[j] = src[j];
+            }
+        }
+        src += src_stride;
+
+        err = burst_submit(REG_CTRL_MASK_WRSTROBE, &status);
+        if(err != WAIT_OK){
+            return err;
+        }
+   }
+   return 0;
+}
+
+void video_core_mig_interface::burst_set_addr(uint32_t addr, uint32_t line){
+    /*
+    @brief  : set the address of a line within a burst;
+    @param  :
+        1. addr : address of this line;
+        2. line : index of this line within the burst;
+    @retval : none
+    @note   : stream mode: the HW post-increments; only the first line sets it;
+    */
+   if(!stream_mode || (line == 0)){
+        set_addr(addr);
+   }
+}
+
+int video_core_mig_interface::burst_submit(uint32_t strobe_mask, uint32_t *status){
+    /*
+    @brief  : submit one request and wait for it to complete;
+    @param  :
+        1. strobe_mask  : REG_CTRL_MASK_WRSTROBE or REG_CTRL_MASK_RDSTROBE;
+        2. status       : last status read; 0 if unknown;
+                          (output) the status read that saw the request complete;
+    @retval : WAIT_OK; WAIT_TIMEOUT; WAIT_NOT_INIT;
+    @note   : as submit_write()/submit_read() followed by the complete wait,
+                except that the MIG ready check takes the status given first;
+    @note   : stream mode: the HW holds the request until the MIG is ready;
+                a write has been submitted by the last word pushed;
+                a read is one one-shot bus write;
+    */
+   int err;
+
+   if(stream_mode){
+        if(strobe_mask & REG_CTRL_MASK_RDSTROBE){
+            REG_WRITE(base_addr, REG_CTRL_OFFSET, strobe_mask);
+        }
+   }
+   else{
+        if(!(*status & REG_STATUS_MIG_RDY_MASK)){
+            err = wait_app_ready(wait_budget);
+            if(err != WAIT_OK){
+                return err;
+            }
+        }
+
+        // the strobe is a level; clear it right after;
+        REG_WRITE(base_addr, REG_CTRL_OFFSET, strobe_mask);
+        REG_WRITE(base_addr, REG_CTRL_OFFSET, (uint32_t) 0x00);
+   }
+
+   err = wait_transaction_complete(wait_budget);
+   *status = last_status;
+   return err;
 }
 
 int video_core_mig_interface::check_init_ddr2(uint32_t init_value, uint32_t start_addr, uint32_t range_addr){
@@ -408,19 +1461,30 @@ int video_core_mig_interface::check_init_ddr2(uint32_t init_value, uint32_t star
         3. range_addr   : the address range of the DDR2 to read from;
     @retval : binary
         HIGH (1) if the initialization check is OK; LOW (0) otherwise;
+    @note   : the lines are read ahead; see video_core_mig_reader;
+    @note   : the check stops at the first line which cannot be read (LOW);
     @assumption : CPU is controlling the MIG interface (set it apriori);
     */
 
+   video_core_mig_reader reader(this);
    uint32_t i; // loop index;
    uint32_t read_buffer[4]; // buffer to store the entire "128-bit" DDR2 data;
    uint32_t read_data;
    uint32_t address = start_addr;
    uint32_t check_status = 0;
    uint32_t count_match = 0;
+   int err;
    debug_str("Checking DDR2 initialization ... \r\n");
-   for(i = 0; i < range_addr; i++){
+   err = reader.open(start_addr, range_addr);
+   for(i = 0; i < range_addr && err == 0; i++){
         // read;        
-        read_ddr2(address, read_buffer);
+        err = reader.read(read_buffer);
+        if(err != 0){
+            debug_str("Index: ");
+            debug_dec(i);
+            debug_str(" ; read FAILED; check stopped\r\n");
+            break;
+        }
         
         // serial print formatting;
         check_status = 0;
@@ -458,180 +1522,519 @@ int video_core_mig_interface::check_init_ddr2(uint32_t init_value, uint32_t star
    debug_dec(count_match);
    debug_str("\r\n");    
 
-   if(count_match == range_addr){
+   if(err == 0 && count_match == range_addr){
         debug_str("Initialization Result: PASSED\r\n");
    }else{
         debug_str("Initialization Result: FAILED\r\n");        
    }
 
    // return binary status;
-   return (int)(count_match == range_addr);
+   return (int)(err == 0 && count_match == range_addr);
 }
 
-int video_core_mig_interface::sw_test_sequential(uint32_t number){
+/* ------------------------------------------------
+* sequential reader over the read-ahead;
+--------------------------------------------------*/
+video_core_mig_reader::video_core_mig_reader(video_core_mig_interface *mig){
     /*
-    @Test Purpose: To sequential write followed by a read; 
-    @param          : number of address to cover
-    @retval         :
-        HIGH (1) if OK; LOW (0) otherwise
+    @brief  : constructor;
+    @param  : the mig interface to read from;
+    @retval : none
+    */
+   this->mig = mig;
+   left = 0;
+}
 
-    @Test Setup:
-    1. Use the index as the address and the write data;
-    2. Start Address: 0x00;
-    3. End Address: Start Address + number;
+// destructor; not used;
+video_core_mig_reader::~video_core_mig_reader(){}
+
+int video_core_mig_reader::open(uint32_t addr, uint32_t nlines){
+    /*
+    @brief  : to start reading a contiguous region;
+    @param  :
+        1. addr     : first address (line) to read;
+        2. nlines   : number of lines (128-bit each);
+    @retval : 0 if OK; -1 if the region is past the 23-bit address space;
+                as prefetch_start() otherwise;
+    @note   : a region right after the last one continues the read-ahead;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
     */
+   int err;
 
-    uint32_t seq_j;
-    uint32_t seq_range = number;
-    uint32_t count;
-    uint32_t read_buffer[4];
-    uint32_t check_OK;
+   left = 0;
+   if(addr + nlines > BIT_MASK(video_core_mig_interface::REG_MIG_ADDR_SIZE) || addr + nlines < addr){
+        return -1;
+   }
+   err = mig->prefetch_start(addr);
+   if(err != 0){
+        return err;
+   }
+   left = nlines;
+   return 0;
+}
 
+int video_core_mig_reader::read(uint32_t *read_buffer){
+    /*
+    @brief  : to take the next line;
+    @param  : read_buffer : four 32-bit words; as read_ddr2();
+    @retval : 0 if OK; -1 past the region; as prefetch_read() otherwise;
+    @note   : a line which does not arrive is still left; the next call reads it again;
+    */
+   int err;
 
-    debug_str("Test: sequential write->read\r\n"); 
-    debug_str("Number of Address to Cover: ");
-    debug_dec(number);
-    debug_str("\r\n");
-    debug_str("Start Address: 0x00\r\n");
-    debug_str("----- test starts --------\r\n");
+   if(left == 0){
+        return -1;
+   }
+   err = mig->prefetch_read(read_buffer);
+   if(err == 0){
+        left--;
+   }
+   return err;
+}
 
-    count = 0;
-    for(seq_j = 0; seq_j < seq_range; seq_j++){
-        // write; 
-        write_ddr2((uint32_t)seq_j, seq_j, seq_j, seq_j, seq_j);
-        
-        //read immediately after the write;
-        read_ddr2((uint32_t)seq_j, read_buffer);
+uint32_t video_core_mig_reader::read_lines(uint32_t *dst, uint32_t nlines){
+    /*
+    @brief  : to take the next lines into a cpu buffer;
+    @param  :
+        1. dst      : four 32-bit words per line;
+        2. nlines   : number of lines wanted;
+    @retval : number of lines taken; fewer at the end of the region;
+    */
+   uint32_t i;
 
-        check_OK = 0;        
-        debug_str("Index: ");
-        debug_dec(seq_j);
-        debug_str(" ; ");
-        debug_str("Address: ");
-        debug_dec(seq_j);
-        debug_str(" ; ");                        
-        debug_str("Unpacked read data: "); 
+   for(i = 0; i < nlines; i++){
+        if(read(dst) != 0){
+            break;
+        }
+        dst += 4;
+   }
+   return i;
+}
 
-        // read in 32-bit batch data from a 128-bit DDR2 read transaction;
-        for(int i = 0; i < 4; i++){                                                
-            debug_hex(read_buffer[i]);
-            debug_str(" | ");
-            if(read_buffer[i] == seq_j){                
-                check_OK++;
-            }   
+uint32_t video_core_mig_reader::get_left(void){
+    // lines left in the region;
+    return left;
+}
+
+int video_core_mig_reader::close(void){
+    /*
+    @brief  : to stop the read-ahead;
+    @param  : none;
+    @retval : as prefetch_end();
+    @note   : optional; any other transaction of the mig interface stops it;
+                the HW reads at most two lines past the region;
+    */
+   left = 0;
+   return mig->prefetch_end();
+}
+
+
+/* ------------------------------------------------
+* write-combining line buffer;
+--------------------------------------------------*/
+video_core_mig_writer::video_core_mig_writer(video_core_mig_interface *mig){
+    /*
+    @brief  : constructor;
+    @param  : the mig interface to write to;
+    @retval : none
+    */
+   this->mig = mig;
+   line_addr = 0;
+   byte_valid = 0;
+   store_cnt = 0;
+   line_cnt = 0;
+   partial_cnt = 0;
+}
+
+// destructor; not used; the open line is not flushed;
+video_core_mig_writer::~video_core_mig_writer(){}
+
+int video_core_mig_writer::store(uint32_t byte_addr, uint32_t data, uint32_t nbytes){
+    /*
+    @brief  : to merge a store into the open line;
+    @param  :
+        1. byte_addr    : aligned to nbytes;
+        2. data         : bit[8*nbytes-1:0];
+        3. nbytes       : 1, 2 or 4;
+    @retval : 0 if OK; -1 otherwise; as write_line() if a line written fails;
+    @note   : an aligned store does not cross a line (nor a 32-bit word);
+    @note   : nothing is stored if the evict fails;
+                the store is in the open line if the full line write fails;
+    */
+   int err;
+   uint32_t addr = byte_addr >> 4;
+   uint32_t offset = byte_addr & 0x0F;
+   uint32_t shift = 8*(offset & 0x03);
+   uint32_t data_mask = (nbytes == 4) ? 0xFFFFFFFF : (BIT_MASK(8*nbytes) - 1);
+
+   if(addr >= BIT_MASK(video_core_mig_interface::REG_MIG_ADDR_SIZE) || (byte_addr & (nbytes - 1))){
+        return -1;
+   }
+
+   // evict;
+   if(byte_valid && addr != line_addr){
+        err = write_line();
+        if(err != 0){
+            return err;
         }
-        
-        // all batches within 128-bit data match?
-        if(check_OK == 4){
-            count++;
-            debug_str(" ; Status: OK\r\n");
-        }else{
-            debug_str(" ; Status: NOT OK\r\n");                                                                
+   }
+   line_addr = addr;
+   line[offset >> 2] = (line[offset >> 2] & ~(data_mask << shift)) | ((data & data_mask) << shift);
+   byte_valid |= (BIT_MASK(nbytes) - 1) << offset;
+   store_cnt++;
+
+   if(byte_valid == 0xFFFF){
+        return write_line();
+   }
+   return 0;
+}
+
+int video_core_mig_writer::write_line(void){
+    /*
+    @brief  : to write the open line out and close it;
+    @param  : none
+    @retval : 0 if OK; as post_write() or write_ddr2_masked() otherwise;
+    @note   : a full line is posted; a partial one is a masked write (blocking);
+    @note   : the line is left open on an error; the next evict or flush() tries again;
+    */
+   int err;
+
+   if(byte_valid == 0xFFFF){
+        err = mig->post_write(line_addr, line[0], line[1], line[2], line[3]);
+   }
+   else{
+        err = mig->write_ddr2_masked(line_addr, line, ~byte_valid & 0xFFFF);
+   }
+   if(err != 0){
+        return err;
+   }
+   if(byte_valid != 0xFFFF){
+        partial_cnt++;
+   }
+   line_cnt++;
+   byte_valid = 0;
+   return 0;
+}
+
+int video_core_mig_writer::write8(uint32_t byte_addr, uint8_t data){
+   return store(byte_addr, data, 1);
+}
+
+int video_core_mig_writer::write16(uint32_t byte_addr, uint16_t data){
+   return store(byte_addr, data, 2);
+}
+
+int video_core_mig_writer::write32(uint32_t byte_addr, uint32_t data){
+   return store(byte_addr, data, 4);
+}
+
+int video_core_mig_writer::flush(void){
+    /*
+    @brief  : to write the open line out, if any, and wait for every line written;
+    @param  : none
+    @retval : 0 if OK; as write_line() or fence() otherwise;
+    @note   : the lines are in the DDR2 on a return of 0;
+    */
+   int err;
+
+   if(byte_valid){
+        err = write_line();
+        if(err != 0){
+            return err;
         }
-    }
+   }
+   return mig->fence();
+}
+
+uint32_t video_core_mig_writer::get_store_cnt(void){
+    return store_cnt;
+}
+
+uint32_t video_core_mig_writer::get_line_cnt(void){
+    return line_cnt;
+}
+
+uint32_t video_core_mig_writer::get_partial_cnt(void){
+    return partial_cnt;
+}
 
 
-    debug_str("Test: Sequential write->read ends\r\n");
-    debug_str("Expected Matched Count: ");
-    debug_dec(seq_range);
-    debug_str("\r\n");
-    debug_str("Actual Matched Count: ");
-    debug_dec(count);
-    debug_str("\r\n");    
-    if(count == seq_range){
-        debug_str("Test Result: PASSED\r\n");
-    }else{
-        debug_str("Test Result: FAILED\r\n");
+/* ------------------------------------------------
+* direct-mapped read cache;
+--------------------------------------------------*/
+video_core_mig_cache::video_core_mig_cache(video_core_mig_interface *mig){
+    /*
+    @brief  : constructor;
+    @param  : the mig interface to read from;
+    @retval : none
+    */
+   this->mig = mig;
+   invalidate_all();
+   clear_cnt();
+}
+
+// destructor; not used;
+video_core_mig_cache::~video_core_mig_cache(){}
+
+int video_core_mig_cache::read(uint32_t addr, uint32_t *read_buffer){
+    /*
+    @brief  : to read a line through the cache;
+    @param  :
+        1. addr         : the address (line) to read;
+        2. read_buffer  : four 32-bit words; as read_ddr2();
+    @retval : 0 if OK; -1 if the address is past the 23-bit address space;
+                as read_ddr2() on a miss that fails (buffer and slot left as they are);
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   uint32_t slot = addr & (MIG_CACHE_LINE_NUM - 1);
+   int err;
+
+   if(addr >= BIT_MASK(video_core_mig_interface::REG_MIG_ADDR_SIZE)){
+        return -1;
+   }
+   if(handover_cnt != mig->get_handover_cnt()){
+        invalidate_all();
+   }
+
+   if(tag[slot] == addr){
+        hit_cnt++;
+   }
+   else{
+        // read_ddr2() leaves the slot as it is on an error;
+        err = mig->read_ddr2(addr, line[slot]);
+        if(err != video_core_mig_interface::WAIT_OK){
+            return err;
+        }
+        tag[slot] = addr;
+        miss_cnt++;
+   }
+   read_buffer[0] = line[slot][0];
+   read_buffer[1] = line[slot][1];
+   read_buffer[2] = line[slot][2];
+   read_buffer[3] = line[slot][3];
+   return 0;
+}
+
+int video_core_mig_cache::write(uint32_t addr, const uint32_t *data){
+    /*
+    @brief  : to write a line through the cache;
+    @param  :
+        1. addr : the address (line) to write to;
+        2. data : four 32-bit words; data[0] forms wr data[31:0];
+    @retval : 0 if OK; -1 if the address is past the 23-bit address space;
+                as write_ddr2() if it fails; the line is then dropped from the cache
+                (the DDR2 may or may not hold the new data);
+    @note   : no allocation on a write; a line not cached stays out;
+    @assumption : CPU is controlling the MIG interface (set it apriori);
+    */
+   uint32_t slot = addr & (MIG_CACHE_LINE_NUM - 1);
+   int err;
+
+   if(addr >= BIT_MASK(video_core_mig_interface::REG_MIG_ADDR_SIZE)){
+        return -1;
+   }
+   if(handover_cnt != mig->get_handover_cnt()){
+        invalidate_all();
+   }
+
+   err = mig->write_ddr2(addr, data[0], data[1], data[2], data[3]);
+   if(err != video_core_mig_interface::WAIT_OK){
+        invalidate(addr);
+        return err;
+   }
+   if(tag[slot] == addr){
+        line[slot][0] = data[0];
+        line[slot][1] = data[1];
+        line[slot][2] = data[2];
+        line[slot][3] = data[3];
+   }
+   return 0;
+}
+
+void video_core_mig_cache::invalidate(uint32_t addr){
+    // to drop one line, if cached;
+    if(tag[addr & (MIG_CACHE_LINE_NUM - 1)] == addr){
+        tag[addr & (MIG_CACHE_LINE_NUM - 1)] = TAG_NONE;
     }
+}
+
+void video_core_mig_cache::invalidate_all(void){
+    /*
+    @brief  : to drop every line;
+    @param  : none
+    @retval : none
+    @note   : also done by itself after a hand-over of the DDR2;
+    */
+   for(int i = 0; i < MIG_CACHE_LINE_NUM; i++){
+        tag[i] = TAG_NONE;
+   }
+   handover_cnt = mig->get_handover_cnt();
+   flush_cnt++;
+}
+
+uint32_t video_core_mig_cache::get_hit_cnt(void){
+    return hit_cnt;
+}
+
+uint32_t video_core_mig_cache::get_miss_cnt(void){
+    return miss_cnt;
+}
 
-    return (int)(count == seq_range);
+uint32_t video_core_mig_cache::get_flush_cnt(void){
+    return flush_cnt;
+}
 
+void video_core_mig_cache::clear_cnt(void){
+    hit_cnt = 0;
+    miss_cnt = 0;
+    flush_cnt = 0;
 }
 
-int video_core_mig_interface::sw_test_burst(uint32_t number){
+video_core_mig_share::video_core_mig_share(video_core_mig_interface *mig){
     /*
-    @Test Purpose: To burst write followed by a burst read; 
-    @param          : number of address to cover
-    @retval         :
-        HIGH (1) if OK; LOW (0) otherwise
+    @brief  : constructor; time-sliced sharing of the DDR2 over a mig interface;
+    @param  : the mig interface;
+    @retval : none
+    @note   : nothing is handed over until start();
+    */
+   this->mig = mig;
+   owner = V5_MIG_INTERFACE_REG_SEL_NONE;
+   window = 0;
+   window_start = 0;
+   window_budget = 0;
+   clear_cnt();
+}
+
+// destructor; not used;
+video_core_mig_share::~video_core_mig_share(){}
 
-    @Test Setup:
-    1. Use the index as the address and the write data;
-    2. Start Address: 0x00;
-    3. End Address: Start Address + number;
+int video_core_mig_share::start(int source){
+    /*
+    @brief  : to give the DDR2 to the HW owner for the share;
+    @param  : V5_MIG_INTERFACE_REG_SEL_MOTION, _DMA or _TEST;
+    @retval : WAIT_OK; WAIT_TIMEOUT; -1 if the source is the cpu (or none) or a window is open;
     */
+   int err;
 
-    uint32_t index;
-    uint32_t index_range = number;
-    uint32_t count = 0;
-    uint32_t read_buffer[4];
-    uint32_t check_OK;
+   if(window || source == V5_MIG_INTERFACE_REG_SEL_CPU || source == V5_MIG_INTERFACE_REG_SEL_NONE){
+        return -1;
+   }
+   err = mig->handover(source, mig->get_wait_budget());
+   if(err == video_core_mig_interface::WAIT_OK){
+        owner = source;
+   }
+   return err;
+}
 
+int video_core_mig_share::window_open(uint32_t budget_cycle){
+    /*
+    @brief  : to take the DDR2 from the owner for a cpu window;
+    @param  : budget of the window; system clock cycles;
+    @retval : WAIT_OK; WAIT_TIMEOUT (the owner keeps it); -1 if not started or open already;
+    @note   : the owner lets go after the request in flight; call it at a frame boundary;
+    @note   : the budget starts once the cpu has the MIG;
+    */
+   int err;
 
-    debug_str("Test: burst write-> burst read\r\n"); 
-    debug_str("Number of Address to Cover: ");
-    debug_dec(number);
-    debug_str("\r\n");
-    debug_str("Start Address: 0x00\r\n");
-    debug_str("----- test starts --------\r\n");
+   if(owner == V5_MIG_INTERFACE_REG_SEL_NONE || window){
+        return -1;
+   }
+   err = mig->handover(V5_MIG_INTERFACE_REG_SEL_CPU, mig->get_wait_budget());
+   if(err != video_core_mig_interface::WAIT_OK){
+        return err;
+   }
+   window = 1;
+   window_budget = budget_cycle;
+   window_start = sys_timer.read_counter();
+   window_cnt++;
+   return err;
+}
 
-    // burst write;
-    debug_str("Burst write starts\r\n");
-    for(index = 0; index < index_range; index++){
-        // write; 
-        write_ddr2((uint32_t)index, index, index, index, index);
-    }
-    debug_str("Burst write ends\r\n\r\n");
+uint32_t video_core_mig_share::window_left(void){
+    /*
+    @brief  : budget left in the window;
+    @param  : none
+    @retval : system clock cycles; 0 once over or if no window is open;
+    @note   : one system timer read;
+    */
+   uint64_t elapsed;
 
+   if(!window){
+        return 0;
+   }
+   elapsed = sys_timer.read_counter() - window_start;
+   return (elapsed >= window_budget) ? 0 : (uint32_t)(window_budget - elapsed);
+}
 
-    // burst read;
-    debug_str("Burst read starts\r\n");
-    for(index = 0; index < index_range; index++){
+int video_core_mig_share::window_close(void){
+    /*
+    @brief  : to give the DDR2 back to the owner;
+    @param  : none
+    @retval : WAIT_OK; WAIT_TIMEOUT (the window stays open); -1 if no window is open;
+    @note   : the posted writes of the window are fenced first; see handover();
+    */
+   uint64_t elapsed;
+   int err;
 
-        //read immediately after the write;
-        read_ddr2((uint32_t)index, read_buffer);
+   if(!window){
+        return -1;
+   }
+   err = mig->handover(owner, mig->get_wait_budget());
+   if(err != video_core_mig_interface::WAIT_OK){
+        return err;
+   }
+   elapsed = sys_timer.read_counter() - window_start;
+   if(elapsed > window_budget){
+        overrun_cnt++;
+   }
+   if(elapsed > window_max){
+        window_max = (elapsed > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)elapsed;
+   }
+   window = 0;
+   return err;
+}
 
-        check_OK = 0;        
-        debug_str("Index: ");
-        debug_dec(index);
-        debug_str(" ; ");
-        debug_str("Address: ");
-        debug_dec(index);
-        debug_str(" ; ");                        
-        debug_str("Unpacked read data: "); 
+int video_core_mig_share::end(void){
+    /*
+    @brief  : to end the share; the cpu keeps the DDR2;
+    @param  : none
+    @retval : WAIT_OK; WAIT_TIMEOUT (the share goes on); -1 if not started;
+    @note   : an open window is left as it is; it is not counted as closed;
+    */
+   int err = video_core_mig_interface::WAIT_OK;
 
-        // read in 32-bit batch data from a 128-bit DDR2 read transaction;
-        for(int i = 0; i < 4; i++){                                                
-            debug_hex(read_buffer[i]);
-            debug_str(" | ");
-            if(read_buffer[i] == index){                
-                check_OK++;
-            }   
-        }
-        
-        // all batches within 128-bit data match?
-        if(check_OK == 4){
-            count++;
-            debug_str(" ; Status: OK\r\n");
-        }else{
-            debug_str(" ; Status: NOT OK\r\n");                                                                
+   if(owner == V5_MIG_INTERFACE_REG_SEL_NONE){
+        return -1;
+   }
+   if(!window){
+        err = mig->handover(V5_MIG_INTERFACE_REG_SEL_CPU, mig->get_wait_budget());
+        if(err != video_core_mig_interface::WAIT_OK){
+            return err;
         }
-    }
+   }
+   owner = V5_MIG_INTERFACE_REG_SEL_NONE;
+   window = 0;
+   return err;
+}
 
+int video_core_mig_share::is_window_open(void){
+    return window;
+}
 
-    debug_str("Test: burst write-> burst read ends\r\n");
-    debug_str("Expected Matched Count: ");
-    debug_dec(index_range);
-    debug_str("\r\n");
-    debug_str("Actual Matched Count: ");
-    debug_dec(count);
-    debug_str("\r\n");    
-    if(count == index_range){
-        debug_str("Test Result: PASSED\r\n");
-    }else{
-        debug_str("Test Result: FAILED\r\n");
-    }
+uint32_t video_core_mig_share::get_window_cnt(void){
+    return window_cnt;
+}
 
-    return (int)(count == index_range);
+uint32_t video_core_mig_share::get_overrun_cnt(void){
+    return overrun_cnt;
+}
 
-}
\ No newline at end of file
+uint32_t video_core_mig_share::get_window_max(void){
+    return window_max;
+}
+
+void video_core_mig_share::clear_cnt(void){
+    window_cnt = 0;
+    overrun_cnt = 0;
+    window_max = 0;
+}
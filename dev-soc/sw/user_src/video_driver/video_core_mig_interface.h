@@ -19,6 +19,50 @@ Core: core_video_mig_interface
 extern "C" {
 #endif
 
+// wait budget of the blocking methods; system clock cycles; 0 waits forever;
+// see video_core_mig_interface::set_wait_budget();
+#ifndef MIG_WAIT_BUDGET_CYCLE
+#define MIG_WAIT_BUDGET_CYCLE   (SYS_CLK_FREQ_HZ/100)   // 10ms;
+#endif
+
+// status reads between two looks at the system timer in a wait;
+#ifndef MIG_WAIT_TIMER_STRIDE
+#define MIG_WAIT_TIMER_STRIDE   16
+#endif
+
+// added to the budget per line of a HW fill or march element; system clock cycles;
+// see video_core_mig_interface::fill_wait() and test_wait();
+#ifndef MIG_WAIT_LINE_CYCLE
+#define MIG_WAIT_LINE_CYCLE     256
+#endif
+
+// status register (register 1) decoded from one read;
+typedef struct{
+    uint32_t raw;
+    uint8_t init_complete;
+    uint8_t app_ready;
+    uint8_t complete;       // the one-cycle pulse; see get_complete_cnt();
+    uint8_t ctrl_idle;
+    uint8_t stream;
+    uint8_t posted;
+    uint8_t pf_line;
+    uint8_t pf_next;
+    uint8_t pf_busy;
+    uint8_t fill_busy;
+    uint8_t fill_done;
+    uint8_t post_cnt;       // lines in the posted write fifo;
+    uint8_t complete_cnt;   // wraps around;
+}mig_status_t;
+
+// waits on the status register since the last clear;
+typedef struct{
+    uint32_t wait_cnt;
+    uint32_t timeout_cnt;
+    uint64_t spin_cnt;      // status reads; all waits;
+    uint32_t spin_max;      // status reads; longest wait;
+    int last_err;           // video_core_mig_interface::WAIT_*; of the last wait;
+}mig_wait_stat_t;
+
 
 
 /*****************************************************************
@@ -29,6 +73,7 @@ It is either interfacing with:
 1. CPU;
 2. other video core: motion detection?
 3. a HW testing circuit;
+4. the dma core (V6_DMA);
 
 Construction:
 1. DDR2 read/write transaction is 128-bit.
@@ -69,7 +114,16 @@ Register Definition:
         3'b000: NONE
         3'b001: CPU
         3'b010: Motion Detection Core
+        3'b011: DMA Core (V6_DMA);
         3'b100: HW Testing Circuit;
+    hand-over: a write takes effect once the source that has the MIG is out of
+        its transaction (request sent, complete pulse not back yet);
+        meanwhile the MIG ready seen by that source is LOW (no new request);
+        so are the posted writes, the read-ahead and the fill of the cpu;
+        writing the source that has the MIG cancels a pending hand-over;
+    read:
+        bit[2:0]: the source that has the MIG;
+        bit[3]: hand-over pending; active high;
         
 2. Register 1 (Offset 1): Status Register
         bit[0]: MIG DDR2 initialization complete status; active high;
@@ -78,6 +132,15 @@ Register Definition:
                 common for both read and write; 
                 once asserted, it will remain as it is until new write/read strobe is requested;                
         bit[3]: MIG controller idle status; active high;
+        bit[4]: stream mode as set in Register 12; active high;
+        bit[5]: posted mode as set in Register 12; active high;
+        bit[6]: read-ahead line ready in Register 8-11; active high;
+        bit[7]: read-ahead next line ready in the shadow registers; active high;
+        bit[10:8]: posted writes outstanding (in the command fifo or in flight);
+        bit[11]: read-ahead read in flight; active high;
+        bit[12]: fill running (Register 13); active high;
+        bit[13]: fill done; set as the last line is written; cleared by the next start;
+        bit[23:16]: cpu transactions completed; wraps around; never cleared;
             
 3. Register 2 (Offset 2): address common for read and write;
         bit[22:0] address;
@@ -93,6 +156,63 @@ Register Definition:
        
 9. Register 8-11: to store the 128-bit read data as noted in the construction;
 
+10. Register 12 (Offset 12): Mode Register;
+        bit[0]: stream mode for the cpu; active high;
+            1. the address register post-increments after every cpu transaction;
+            2. writing Register 7 submits the write request by itself;
+            3. writing Register 3 submits a one-shot request; no clear is needed;
+        bit[1]: posted mode for the cpu writes; active high;
+            1. writing Register 7 posts {address, write data} into a command fifo (4 deep);
+                and post-increments the address register;
+            2. the fifo is drained to the MIG one write at a time;
+            3. a post into a full fifo is dropped; see the outstanding count;
+            4. no other cpu request until the outstanding count is zero;
+        bit[2]: read-ahead mode for the cpu reads; active high;
+            1. the core reads from the address register onwards by itself;
+                the address register post-increments on every read;
+            2. line N is held in Register 8-11 while line N+1 is read into shadow registers;
+            3. reading Register 11 takes line N; the shadow moves in and line N+2 is read;
+            4. writing Register 2 or Register 12 restarts it; a read in flight is dropped;
+            5. no other cpu request until no read is in flight (status bit[11]);
+
+11. Register 13 (Offset 13): Fill Register;
+        write: bit[23:0] number of lines; starts the fill;
+            1. the lines from Register 2 onwards are written with the 128-bit pattern in Register 4-7;
+            2. one write at a time; the next one goes out a cycle after the complete pulse;
+            3. the address register is left as it is;
+            4. ignored for 0 lines, while a fill runs, while posted writes are outstanding
+                or while a read-ahead read is in flight;
+            5. no other cpu request until the fill is done (status bit[12]);
+            6. it holds while another source has the MIG;
+            7. the pattern is pushed with the stream and posted modes off;
+                Register 7 would submit (post) a write otherwise;
+        read: bit[23:0] lines written since the start;
+
+12. Register 14 (Offset 14): Write Mask Register;
+        bit[15:0]: byte mask of the 128-bit write data; bit i HIGH masks byte i (write_data[8i+7:8i]);
+            1. a masked byte is not written; the DDR2 keeps it (MIG app_wdf_mask);
+            2. 16'h0000 writes all bytes; reset value;
+            3. it applies to every cpu write: single, stream, posted and fill;
+                a posted write takes the mask along with its address and data;
+            4. the other sources always write all bytes;
+
+13. Register 15 (Offset 15): HW Test Register; the hw testing circuit in the bench mode;
+        write:
+            bit[23:0]: number of lines;
+            bit[28:24]: march element; bit[0] write; bit[1] write the complement;
+                        bit[2] read and check first; bit[3] expect the complement;
+                        bit[4] from the last line down to the first;
+            bit[31]: bench mode; active high; the LED demo otherwise;
+            1. a write with bit[31] HIGH and a non-zero number of lines starts the element
+                from Register 2 onwards; ignored while one runs;
+            2. the data is the address in address: every 32-bit word of line A holds A;
+            3. the circuit only reaches the DDR2 while selected in Register 0;
+        read:
+            bit[15:0]: lines read back wrong since the start; saturates;
+            bit[16]: element running; active high;
+            bit[17]: element done; cleared by the next start;
+            bit[31]: bench mode;
+
 Register IO:
 1. Register 0: read and write;
 2. Register 1: read only;
@@ -105,7 +225,11 @@ Register IO:
 9. Register 8: read only;
 10. Register 9: read only;
 11. Register 10: read only;
-12. Register 11: read only;
+12. Register 11: read only; (read-ahead mode: reading it takes the line);
+13. Register 12: write only;
+14. Register 13: read and write;
+15. Register 14: read and write;
+16. Register 15: read and write;
  
 *****************************************************************/
 class video_core_mig_interface{
@@ -147,7 +271,19 @@ class video_core_mig_interface{
         REG_RDDATA_01_OFFSET = V5_MIG_INTERFACE_REG_RDDATA_01,
         REG_RDDATA_02_OFFSET = V5_MIG_INTERFACE_REG_RDDATA_02,
         REG_RDDATA_03_OFFSET = V5_MIG_INTERFACE_REG_RDDATA_03,
-        REG_RDDATA_04_OFFSET = V5_MIG_INTERFACE_REG_RDDATA_04
+        REG_RDDATA_04_OFFSET = V5_MIG_INTERFACE_REG_RDDATA_04,
+
+        // mode register;
+        REG_MODE_OFFSET     = V5_MIG_INTERFACE_REG_MODE,
+
+        // fill register;
+        REG_FILL_OFFSET     = V5_MIG_INTERFACE_REG_FILL,
+
+        // write mask register;
+        REG_WRMASK_OFFSET   = V5_MIG_INTERFACE_REG_WRMASK,
+
+        // hw test register;
+        REG_TEST_OFFSET     = V5_MIG_INTERFACE_REG_TEST
 
     };
 
@@ -156,7 +292,11 @@ class video_core_mig_interface{
         REG_SEL_NONE    = V5_MIG_INTERFACE_REG_SEL_NONE,
         REG_SEL_CPU     = V5_MIG_INTERFACE_REG_SEL_CPU,
         REG_SEL_MOTION  = V5_MIG_INTERFACE_REG_SEL_MOTION,
-        REG_SEL_TEST    = V5_MIG_INTERFACE_REG_SEL_TEST
+        REG_SEL_DMA     = V5_MIG_INTERFACE_REG_SEL_DMA,
+        REG_SEL_TEST    = V5_MIG_INTERFACE_REG_SEL_TEST,
+
+        REG_SEL_MASK            = 0x7,
+        REG_SEL_PENDING_MASK    = BIT_MASK(V5_MIG_INTERFACE_REG_BIT_POS_SEL_PENDING)
     };
     
     // register 1 - status - field and bit maskings;
@@ -166,17 +306,32 @@ class video_core_mig_interface{
         REG_STATUS_BIT_POS_MIG_RDY      = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_MIG_RDY,
         REG_STATUS_BIT_POS_OP_COMPLETE  = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_COMPLETE,
         REG_STATUS_BIT_POS_CTRL_IDLE    = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_CTRL_IDLE,
+        REG_STATUS_BIT_POS_STREAM       = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_STREAM,
+        REG_STATUS_BIT_POS_POSTED       = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_POSTED,
+        REG_STATUS_BIT_POS_PF_LINE      = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_PF_LINE,
+        REG_STATUS_BIT_POS_PF_NEXT      = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_PF_NEXT,
+        REG_STATUS_BIT_POS_PF_BUSY      = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_PF_BUSY,
+        REG_STATUS_BIT_POS_FILL_BUSY    = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_FILL_BUSY,
+        REG_STATUS_BIT_POS_FILL_DONE    = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_FILL_DONE,
+        REG_STATUS_BIT_POS_POST_CNT     = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_POST_CNT,
+        REG_STATUS_BIT_POS_COMPLETE_CNT = V5_MIG_INTERFACE_REG_BIT_POS_STATUS_COMPLETE_CNT,
 
         // bit masking;
         REG_STATUS_MIG_INIT_MASK    = BIT_MASK(REG_STATUS_BIT_POS_MIG_INIT),
         REG_STATUS_MIG_RDY_MASK     = BIT_MASK(REG_STATUS_BIT_POS_MIG_RDY),
         REG_STATUS_OP_COMPLETE_MASK = BIT_MASK(REG_STATUS_BIT_POS_OP_COMPLETE),
-        REG_STATUS_CTRL_IDLE_MASK   = BIT_MASK(REG_STATUS_BIT_POS_CTRL_IDLE)
-    };
-
-    // register 2 - address;
-    enum{
-        REG_MIG_ADDR_SIZE = 23  
+        REG_STATUS_CTRL_IDLE_MASK   = BIT_MASK(REG_STATUS_BIT_POS_CTRL_IDLE),
+        REG_STATUS_STREAM_MASK      = BIT_MASK(REG_STATUS_BIT_POS_STREAM),
+        REG_STATUS_POSTED_MASK      = BIT_MASK(REG_STATUS_BIT_POS_POSTED),
+        REG_STATUS_PF_LINE_MASK     = BIT_MASK(REG_STATUS_BIT_POS_PF_LINE),
+        REG_STATUS_PF_NEXT_MASK     = BIT_MASK(REG_STATUS_BIT_POS_PF_NEXT),
+        REG_STATUS_PF_BUSY_MASK     = BIT_MASK(REG_STATUS_BIT_POS_PF_BUSY),
+        REG_STATUS_FILL_BUSY_MASK   = BIT_MASK(REG_STATUS_BIT_POS_FILL_BUSY),
+        REG_STATUS_FILL_DONE_MASK   = BIT_MASK(REG_STATUS_BIT_POS_FILL_DONE),
+        REG_STATUS_POST_CNT_MASK    = 0x7 << REG_STATUS_BIT_POS_POST_CNT,
+        // the posted write fifo is full; the count is at the depth (a power of two);
+        REG_STATUS_POST_FULL_MASK   = V5_MIG_INTERFACE_POST_FIFO_DEPTH << REG_STATUS_BIT_POS_POST_CNT,
+        REG_STATUS_COMPLETE_CNT_MASK = 0xFF << REG_STATUS_BIT_POS_COMPLETE_CNT
     };
 
     // register 3 - control register;
@@ -188,33 +343,218 @@ class video_core_mig_interface{
         REG_CTRL_MASK_RDSTROBE = BIT_MASK(REG_CTRL_BIT_POS_RDSTROBE)        
     };
 
+    // register 12 - mode register;
+    enum{
+        REG_MODE_BIT_POS_STREAM = V5_MIG_INTERFACE_REG_BIT_POS_MODE_STREAM,
+        REG_MODE_BIT_POS_POSTED = V5_MIG_INTERFACE_REG_BIT_POS_MODE_POSTED,
+        REG_MODE_BIT_POS_PREFETCH = V5_MIG_INTERFACE_REG_BIT_POS_MODE_PREFETCH,
+        REG_MODE_MASK_STREAM    = BIT_MASK(REG_MODE_BIT_POS_STREAM),
+        REG_MODE_MASK_POSTED    = BIT_MASK(REG_MODE_BIT_POS_POSTED),
+        REG_MODE_MASK_PREFETCH  = BIT_MASK(REG_MODE_BIT_POS_PREFETCH),
+
+        // posted write command fifo;
+        POST_FIFO_DEPTH         = V5_MIG_INTERFACE_POST_FIFO_DEPTH
+    };
+
+    // register 13 - fill register;
+    enum{
+        REG_FILL_LEN_MASK = BIT_MASK(V5_MIG_INTERFACE_FILL_LEN_WIDTH) - 1
+    };
+
+    // register 14 - write mask register;
+    enum{
+        REG_WRMASK_NONE = 0x0000,                                       // all bytes written;
+        REG_WRMASK_ALL  = BIT_MASK(V5_MIG_INTERFACE_WRMASK_WIDTH) - 1   // nothing written;
+    };
+
+    // register 15 - hw test register;
+    enum{
+        REG_TEST_BIT_POS_ERR_CNT    = V5_MIG_INTERFACE_REG_BIT_POS_TEST_ERR_CNT,
+        REG_TEST_BIT_POS_BUSY       = V5_MIG_INTERFACE_REG_BIT_POS_TEST_BUSY,
+        REG_TEST_BIT_POS_DONE       = V5_MIG_INTERFACE_REG_BIT_POS_TEST_DONE,
+        REG_TEST_BIT_POS_OP         = V5_MIG_INTERFACE_REG_BIT_POS_TEST_OP,
+        REG_TEST_BIT_POS_MODE       = V5_MIG_INTERFACE_REG_BIT_POS_TEST_MODE,
+
+        REG_TEST_ERR_CNT_MASK   = 0xFFFF << REG_TEST_BIT_POS_ERR_CNT,
+        REG_TEST_BUSY_MASK      = BIT_MASK(REG_TEST_BIT_POS_BUSY),
+        REG_TEST_DONE_MASK      = BIT_MASK(REG_TEST_BIT_POS_DONE),
+        REG_TEST_OP_MASK        = 0x1F,
+        REG_TEST_LEN_MASK       = BIT_MASK(V5_MIG_INTERFACE_TEST_LEN_WIDTH) - 1
+    };
+
     
     public:
+        // register 2 - address;
+        enum{
+            REG_MIG_ADDR_SIZE = 23  
+        };
+
+        // outcome of a wait; -1 is left to the bad arguments;
+        enum{
+            WAIT_OK         = 0,
+            WAIT_TIMEOUT    = -2,   // the budget ran out;
+            WAIT_NOT_INIT   = -3    // ... with the MIG calibration not complete;
+        };
+
+        // register 15 - march element of the hw test circuit; or-ed;
+        enum{
+            TEST_OP_WR      = V5_MIG_INTERFACE_TEST_OP_WR,      // write the address in address;
+            TEST_OP_WR_INV  = V5_MIG_INTERFACE_TEST_OP_WR_INV,  // ... its complement;
+            TEST_OP_RD      = V5_MIG_INTERFACE_TEST_OP_RD,      // read and check first;
+            TEST_OP_RD_INV  = V5_MIG_INTERFACE_TEST_OP_RD_INV,  // ... against the complement;
+            TEST_OP_DOWN    = V5_MIG_INTERFACE_TEST_OP_DOWN     // last line first;
+        };
+
         video_core_mig_interface(uint32_t core_base_addr);
         ~video_core_mig_interface();
 
-        /* select which core to interface with the DDR2 via MIG; */
-        void set_source(int source);
-        /// wrappers for the above;        
-        void set_core_none(void);
-        void set_core_cpu(void);    // communicate via cpu;
-        void set_core_test(void);   // hw test;
-        void set_core_motion(void); // with the motion detection core;
+        /* select which core to interface with the DDR2 via MIG;
+        1. handover() fences the cpu work (posts, read-ahead, fill) and writes register 0;
+            the HW takes the new source once the one that has the MIG waits for
+            no complete pulse (the MIG controller is idle at the source mux);
+            nothing new is issued meanwhile; it waits until then (bit[3] LOW);
+        2. a hand-over not taken within the budget is called off:
+            the previous source is written back; it keeps the MIG;
+        3. set_source() is handover() with the budget of set_wait_budget();
+        4. the cpu work is drained within the same budget; nothing is written if it is not;
+        retval: WAIT_OK; WAIT_TIMEOUT; WAIT_NOT_INIT (the drain only); -1 if the source is out of range;
+        */
+        int handover(int source, uint32_t budget_cycle);
+        int set_source(int source);
+        int get_source(void);
+        int is_handover_pending(void);
+        /// wrappers for the above; retval: as set_source();
+        int set_core_none(void);
+        int set_core_cpu(void);     // communicate via cpu;
+        int set_core_test(void);    // hw test;
+        int set_core_motion(void);  // with the motion detection core;
+        int set_core_dma(void);     // with the dma core (V6_DMA);
+
+        /* hand-overs of the DDR2 from the cpu; wraps around;
+        counts up when handover() gives the MIG to the motion, test or dma core
+        and when a HW fill starts; the DDR2 may have changed behind the cpu since;
+        see video_core_mig_cache;
+        */
+        uint32_t get_handover_cnt(void);
 
         /* check mig status */
         uint32_t get_status(void);
-        // wrapper for the above;
+        // wrapper for the above; one status read each;
         int is_mig_init_complete(void);
         int is_mig_app_ready(void);
         int is_transaction_complete(void);  // common for both read and write;
         int is_mig_ctrl_idle(void);
 
+        /* every field from one status read; */
+        void get_status_snapshot(mig_status_t *snapshot);
+        static void decode_status(uint32_t status, mig_status_t *snapshot);
+
+        /* bounded waits on the status register;
+        1. wait_status() spins until any bit of the mask is HIGH or the budget runs out;
+            budget_cycle: system clock cycles; 0 waits forever;
+            snapshot: the last status read; may be NULL;
+        2. the system timer is only read every MIG_WAIT_TIMER_STRIDE status reads;
+            a wait that ends before costs no timer read; the budget may run over by as much;
+        3. the blocking methods below wait with the budget of set_wait_budget();
+            a timeout returns WAIT_TIMEOUT (or WAIT_NOT_INIT) from them;
+            fill_wait() and test_wait() add MIG_WAIT_LINE_CYCLE per line of the run;
+        4. every wait counts its status reads; see get_wait_stat();
+        retval: WAIT_OK; WAIT_TIMEOUT; WAIT_NOT_INIT;
+        */
+        int wait_status(uint32_t mask, uint32_t budget_cycle, mig_status_t *snapshot);
+        int wait_init_complete(uint32_t budget_cycle);
+        int wait_app_ready(uint32_t budget_cycle);
+        int wait_transaction_complete(uint32_t budget_cycle);
+        int wait_ctrl_idle(uint32_t budget_cycle);
+        void set_wait_budget(uint32_t budget_cycle);
+        uint32_t get_wait_budget(void);
+        void get_wait_stat(mig_wait_stat_t *stat);
+        void clear_wait_stat(void);
+
         /* set the address, common for read and write */
         void set_addr(uint32_t addr);
 
-        /* set control */        
-        void submit_write(void);
-        void submit_read(void);
+        /* set control; 
+        waits for the MIG ready first; no ready check in the stream mode,
+        the HW holds a request until the MIG is ready;
+        retval: WAIT_OK; WAIT_TIMEOUT; WAIT_NOT_INIT (nothing submitted);
+        */
+        int submit_write(void);
+        int submit_read(void);
+
+        /* stream mode for the cpu (register 12);
+        1. the HW address post-increments after every transaction;
+        2. push_wrdata_04() submits the write by itself;
+        3. submit_write()/submit_read() are one bus write each;
+        retval: 0 if OK; -1 if the HW does not have it (mode left off);
+        */
+        int set_stream_mode(int enable);
+        int is_stream_mode(void);
+
+        /* posted (non-blocking) writes;
+        1. post_write() returns once the line is in the HW command fifo;
+            it only waits while the fifo is full;
+        2. fence() waits until every posted line has been written;
+        3. any other transaction method fences first;
+        4. a core without the posted mode: post_write() is write_ddr2() after the first call (the probe);
+        retval: 0 if OK; -1 if the address is past the 23-bit address space;
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the fifo stays full (post) or does not drain (fence);
+                as write_ddr2() on a core without the posted mode;
+        */
+        int post_write(uint32_t addr, uint32_t wrbatch01, uint32_t wrbatch02, uint32_t wrbatch03, uint32_t wrbatch04);
+        int fence(void);
+
+        /* sticky count of completed cpu transactions; 8-bit; wraps around; */
+        uint32_t get_complete_cnt(void);
+
+        /* read-ahead (sequential reads);
+        1. prefetch_start() points the HW at the first line; it reads ahead by itself;
+        2. prefetch_read() takes the next line; it only waits if the line has not arrived;
+        3. prefetch_end() stops it; any other transaction method stops it first;
+        see video_core_mig_reader below for a bounded region;
+        retval: 0 if OK; -1 if the address is past the 23-bit address space (start)
+                or the read-ahead is not on (read);
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the line does not arrive (read)
+                or the read in flight does not end (end);
+        */
+        int prefetch_start(uint32_t addr);
+        int prefetch_read(uint32_t *read_buffer);
+        int prefetch_end(void);
+
+        /* fill (memset) in the HW;
+        1. fill_start() pushes the 128-bit pattern and starts the HW; it does not wait;
+        2. get_fill_cnt() is the progress; lines written since the start;
+        3. fill_wait() waits until it is done; any other transaction method waits first;
+        4. fill_ddr2() is the blocking form;
+        pattern: four 32-bit words; pattern[0] forms wr data[31:0];
+        retval: 0 if OK; -1 if the region is empty or past the 23-bit address space (nothing written);
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the fill is not done within its budget;
+        */
+        int fill_start(uint32_t addr, const uint32_t *pattern, uint32_t nlines);
+        int fill_ddr2(uint32_t addr, const uint32_t *pattern, uint32_t nlines);
+        int fill_wait(void);
+        int is_fill_busy(void);
+        int is_fill_done(void);
+        uint32_t get_fill_cnt(void);
+
+        /* HW test circuit in the bench mode (register 15);
+        1. test_start() hands the MIG to the circuit and starts one march element
+            over a region; it does not wait; see test_wait();
+        2. the data is the address in address: every 32-bit word of line A holds A;
+            op: TEST_OP_*; e.g. TEST_OP_RD | TEST_OP_WR | TEST_OP_WR_INV;
+        3. test_wait() waits until the element is done;
+            err_cnt: lines read back wrong (saturates at 0xFFFF); may be NULL;
+            retval: WAIT_OK; WAIT_TIMEOUT (e.g. the MIG is taken from the circuit);
+        4. test_end() sets the circuit back to the LED demo and the MIG to the cpu;
+            retval: WAIT_OK; WAIT_TIMEOUT (the element does not end; left as it is);
+        retval: 0 if started; -1 if the region is empty or past the 23-bit address space;
+        */
+        int test_start(uint32_t addr, uint32_t nlines, uint32_t op);
+        int test_wait(uint32_t *err_cnt);
+        int is_test_busy(void);
+        int is_test_done(void);
+        uint32_t get_test_err_cnt(void);
+        int test_end(void);
 
         /* setup the write data 
         underlying MIG DDR2 write transaction is 128-bit;
@@ -242,16 +582,30 @@ class video_core_mig_interface{
         /* utility;
         the purpose of using cpu to communicate with the ddr2 
         is to initialize the ddr2 for other applications;
+        retval: WAIT_OK; WAIT_TIMEOUT or WAIT_NOT_INIT if the MIG stalls;
+                see set_wait_budget();
         */
         
-        void write_ddr2(uint32_t addr, uint32_t wrbatch01, uint32_t wrbatch02, uint32_t wrbatch03, uint32_t wrbatch04);
-        void read_ddr2(uint32_t addr, uint32_t *read_buffer);
-        void init_ddr2(uint32_t init_value, uint32_t start_addr, uint32_t range_addr);
+        int write_ddr2(uint32_t addr, uint32_t wrbatch01, uint32_t wrbatch02, uint32_t wrbatch03, uint32_t wrbatch04);
+
+        /* partial write; one transaction instead of a read-modify-write;
+        1. data: four 32-bit words; as write_ddr2();
+        2. byte_mask: bit i HIGH leaves byte i of the line as it is;
+            byte i is data[i/4] bit[8(i%4)+7 : 8(i%4)]; 0x0000 writes all; 
+        3. the HW mask register is held; the other write methods set it back to 0x0000 first;
+        */
+        int write_ddr2_masked(uint32_t addr, const uint32_t *data, uint32_t byte_mask);
+        int read_ddr2(uint32_t addr, uint32_t *read_buffer);  // buffer left as it is on a timeout;
+        int init_ddr2(uint32_t init_value, uint32_t start_addr, uint32_t range_addr);    // as fill_ddr2();
         int check_init_ddr2(uint32_t init_value, uint32_t start_addr, uint32_t range_addr); // sanity check for init_ddr2();
 
-        /* testing purpose*/
-        int sw_test_sequential(uint32_t number);
-        int sw_test_burst(uint32_t number);
+        /* burst; a contiguous region of lines from/to a cpu buffer;
+        buffer layout: four 32-bit words per line, as read_ddr2();
+        retval: 0 if OK; -1 if the region is past the 23-bit address space;
+                WAIT_TIMEOUT or WAIT_NOT_INIT if the MIG stalls; the burst stops there;
+        */
+        int write_ddr2_burst(uint32_t addr, const uint32_t *src, uint32_t nlines);
+        int read_ddr2_burst(uint32_t addr, uint32_t *dst, uint32_t nlines);
 
     private:
         // this video core base address in the user-address space;
@@ -259,9 +613,227 @@ class video_core_mig_interface{
         
         // current source;
         int curr_source;
+
+        // HIGH in the stream mode; see set_stream_mode();
+        // the burst methods then set the start address only;
+        int stream_mode;
+
+        // posted writes; HIGH once post_write() has switched the HW over;
+        int posted_mode;
+        int posted_absent;          // HIGH once the HW read back without it; post_write() is write_ddr2() then;
+        uint32_t post_credit;       // free fifo entries as of the last status read;
+        uint32_t post_next_addr;    // where the HW address register points next;
+
+        // read-ahead; HIGH once prefetch_start() has switched the HW over;
+        int prefetch_mode;
+        int pf_line_ready;          // the last status read saw the next line in the shadow;
+        uint32_t pf_next_addr;      // line prefetch_read() takes next;
+
+        // HIGH once fill_start() has started the HW; cleared by fill_wait();
+        int fill_mode;
+        uint32_t fill_line_num;     // lines of the last fill; see line_budget();
+        uint32_t test_line_num;     // lines of the last march element;
+
+        // what the HW write mask register holds; see write_ddr2_masked();
+        uint32_t wr_mask;
+
+        // see get_handover_cnt();
+        uint32_t handover_cnt;
+
+        // bounded waits; see wait_status();
+        uint32_t wait_budget;
+        uint32_t last_status;       // status read of the last wait; 0 after a hand-over;
+        mig_wait_stat_t wait_stat;
+
+        int wait_reg(uint32_t reg_offset, uint32_t mask, int level, uint32_t budget_cycle, uint32_t *rd_data);
+        int wait_status_clear(uint32_t mask, uint32_t budget_cycle);
+        uint32_t line_budget(uint32_t nlines);
+        void write_mode(void);
+        void write_wrmask(uint32_t mask);
+        int post_end(void);
+        int mode_end(void);
+
+        /* burst machinery; see write_ddr2_burst(); */
+        int burst_write(uint32_t addr, const uint32_t *src, uint32_t src_stride, uint32_t nlines);
+        void burst_set_addr(uint32_t addr, uint32_t line);
+        int burst_submit(uint32_t strobe_mask, uint32_t *status);
         
 };
 
+class video_core_mig_reader{
+    /*
+    sequential reader of a contiguous DDR2 region over the read-ahead;
+    1. open() at the first line; read() one line at a time;
+    2. line N+1 is on its way while the cpu takes line N;
+        the cost per line is the four data reads, plus a status read
+        when the line has not been seen yet;
+    3. close() is optional; any other transaction of the mig interface stops it;
+    */
+    public:
+        video_core_mig_reader(video_core_mig_interface *mig);
+        ~video_core_mig_reader();
+
+        /* retval: 0 if OK; -1 if the region is past the 23-bit address space;
+        WAIT_TIMEOUT or WAIT_NOT_INIT as prefetch_start();
+        */
+        int open(uint32_t addr, uint32_t nlines);
+
+        /* one line; four 32-bit words; retval: 0 if OK; -1 past the region; as prefetch_read();
+        a line which does not arrive is read again by the next call;
+        */
+        int read(uint32_t *read_buffer);
+
+        /* up to nlines lines; retval: lines taken; */
+        uint32_t read_lines(uint32_t *dst, uint32_t nlines);
+
+        uint32_t get_left(void);
+        int close(void);
+
+    private:
+        video_core_mig_interface *mig;
+        uint32_t left;      // lines left in the region;
+};
+
+class video_core_mig_writer{
+    /*
+    write-combining line buffer for byte, pixel and word stores;
+    1. a store is at a byte address: line address x 16 + byte in the line;
+        byte i of a line is wr data[8i+7:8i]; see write_ddr2_masked();
+    2. the stores are collected in one open line; the line is written
+        (a) when all 16 bytes are in: a posted write; see post_write();
+        (b) when a store falls in another line (evict): only the bytes stored;
+        (c) on flush(): as above; then fence();
+    3. eight RGB565 pixels in raster order are one DDR2 write instead of eight;
+    4. the open line is not seen by the reads of the mig interface; flush() first;
+        one writer per stream of stores (e.g. one per plane) to keep the lines open;
+    retval: 0 if OK; -1 if past the 23-bit address space or not aligned (nothing stored);
+            WAIT_TIMEOUT or WAIT_NOT_INIT if a line written (or the fence) fails;
+            the line is then left open; flush() tries again;
+    */
+    public:
+        video_core_mig_writer(video_core_mig_interface *mig);
+        ~video_core_mig_writer();
+
+        int write8(uint32_t byte_addr, uint8_t data);
+        int write16(uint32_t byte_addr, uint16_t data);    // 2-byte aligned;
+        int write32(uint32_t byte_addr, uint32_t data);    // 4-byte aligned;
+        int flush(void);
+
+        /* observation */
+        uint32_t get_store_cnt(void);   // stores taken;
+        uint32_t get_line_cnt(void);    // lines written; full and partial;
+        uint32_t get_partial_cnt(void); // lines written with bytes masked;
+
+    private:
+        int store(uint32_t byte_addr, uint32_t data, uint32_t nbytes);
+        int write_line(void);
+
+        video_core_mig_interface *mig;
+        uint32_t line_addr;     // the open line;
+        uint32_t line[4];
+        uint32_t byte_valid;    // bit i HIGH: byte i stored; 0 if no line is open;
+        uint32_t store_cnt;
+        uint32_t line_cnt;
+        uint32_t partial_cnt;
+};
+
+// lines of video_core_mig_cache; a power of two;
+#ifndef MIG_CACHE_LINE_NUM
+#define MIG_CACHE_LINE_NUM  64      // 1KB of data;
+#endif
+#if (MIG_CACHE_LINE_NUM & (MIG_CACHE_LINE_NUM - 1)) != 0
+#error "video_core_mig_cache: MIG_CACHE_LINE_NUM must be a power of two"
+#endif
+
+class video_core_mig_cache{
+    /*
+    direct-mapped read cache of DDR2 lines in the cpu memory;
+    1. read() takes a line from the cache; a miss reads it with read_ddr2()
+        into the slot of the line: addr mod MIG_CACHE_LINE_NUM;
+    2. write() writes through; the line is updated if it is cached;
+        the writes of the mig interface itself (write_ddr2() etc)
+        are not seen; invalidate() the lines, or write through the cache;
+    3. every line is dropped on the first access after a hand-over
+        of the DDR2 (motion, test or dma core; a HW fill);
+        see video_core_mig_interface::get_handover_cnt();
+    retval: 0 if OK; -1 if the address is past the 23-bit address space;
+            WAIT_TIMEOUT or WAIT_NOT_INIT if the DDR2 access fails:
+            a read miss caches nothing; a write drops the line;
+    */
+    public:
+        video_core_mig_cache(video_core_mig_interface *mig);
+        ~video_core_mig_cache();
+
+        int read(uint32_t addr, uint32_t *read_buffer);
+        int write(uint32_t addr, const uint32_t *data);
+        void invalidate(uint32_t addr);
+        void invalidate_all(void);
+
+        /* observation */
+        uint32_t get_hit_cnt(void);
+        uint32_t get_miss_cnt(void);
+        uint32_t get_flush_cnt(void);   // invalidate_all(), by call or by hand-over;
+        void clear_cnt(void);
+
+    private:
+        enum{
+            TAG_NONE = 0xFFFFFFFF       // slot empty; not a 23-bit address;
+        };
+
+        video_core_mig_interface *mig;
+        uint32_t handover_cnt;          // of the mig interface as of the last access;
+        uint32_t tag[MIG_CACHE_LINE_NUM];
+        uint32_t line[MIG_CACHE_LINE_NUM][4];
+        uint32_t hit_cnt;
+        uint32_t miss_cnt;
+        uint32_t flush_cnt;
+};
+
+class video_core_mig_share{
+    /*
+    time-sliced sharing of the DDR2 between a HW owner and the cpu;
+    1. start() gives the MIG to the owner (dma, motion or test core);
+    2. window_open() takes it for the cpu for a bounded window; at a frame
+        boundary of the owner (between two dma chains, two motion frames);
+        the owner is held meanwhile; its next request waits for window_close();
+    3. window_left() is the budget left; the cpu closes the window by 0;
+        the window is not cut short by anything; it is up to the cpu;
+    4. window_close() gives the MIG back to the owner;
+        a window longer than its budget counts as an overrun;
+    5. end() leaves the MIG with the cpu;
+    6. the caches of the cpu are dropped in every window;
+        see video_core_mig_interface::get_handover_cnt();
+    retval: WAIT_OK; WAIT_TIMEOUT if the MIG is not handed over (as before the call);
+            -1 if called out of order;
+    */
+    public:
+        video_core_mig_share(video_core_mig_interface *mig);
+        ~video_core_mig_share();
+
+        int start(int source);
+        int window_open(uint32_t budget_cycle);
+        uint32_t window_left(void);     // system clock cycles; 0 once over;
+        int window_close(void);
+        int end(void);
+        int is_window_open(void);
+
+        /* observation; system clock cycles; */
+        uint32_t get_window_cnt(void);
+        uint32_t get_overrun_cnt(void);
+        uint32_t get_window_max(void);  // longest window;
+        void clear_cnt(void);
+
+    private:
+        video_core_mig_interface *mig;
+        int owner;                      // REG_SEL_NONE if not started;
+        int window;                     // HIGH while the cpu has the MIG;
+        uint64_t window_start;          // system timer at the open;
+        uint32_t window_budget;
+        uint32_t window_cnt;
+        uint32_t overrun_cnt;
+        uint32_t window_max;
+};
+
 #ifdef __cpluscplus
 } // extern "C";
 #endif
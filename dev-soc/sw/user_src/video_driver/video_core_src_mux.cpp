@@ -55,6 +55,16 @@ void video_core_src_mux::select_camera(void){
    select_src(SEL_CAM);
 }
 
+void video_core_src_mux::select_dma(void){
+    /* 
+    @brief  : select the dma as the pixel source for the lcd display;
+    @param  : none
+    @retval : none
+    @note   : for the dma descriptors moving ddr2 lines to the lcd;
+    */
+   select_src(SEL_DMA);
+}
+
 void video_core_src_mux::disable_pixel_src(void){
     /* 
     @brief  : disable any HW pixel source (generation) for the lcd display;
@@ -31,6 +31,7 @@ Register Map
         bit[2:0] for multiplexing;
         3'b001: test pattern generator;
         3'b010: camera ov7670;
+        3'b011: dma (V6_DMA);
         3'b100: none;
         
 Register Definition:
@@ -53,6 +54,7 @@ class video_core_src_mux{
     enum{
         SEL_TEST  = 1,  //   3'b001  // from the test pattern generator;
         SEL_CAM   = 2,  //  3'b010  // from the camera OV7670;
+        SEL_DMA   = 3,  //  3'b011  // from the dma (V6_DMA);
         SEL_NONE  = 4   //   3'b100  // nothing;
     };
 
@@ -66,6 +68,7 @@ class video_core_src_mux{
         // wrapper for the above;
         void select_test(void);         // hw test pattern generator;
         void select_camera(void);       // from the camera ov7670;
+        void select_dma(void);          // from the dma; ddr2 to lcd;
         void disable_pixel_src(void);   // none;
 
         // read the hw register to check for which source is being selected;